@@ -0,0 +1,29 @@
+#-------------------------------------------------
+#
+# LibMan benchmarks
+#
+#-------------------------------------------------
+
+QT       += core gui network
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+TARGET = libman-bench
+TEMPLATE = app
+CONFIG += console
+
+SOURCES += main.cpp \
+    benchbaseline.cpp \
+    libmanbench.cpp \
+    projectgenerator.cpp
+
+HEADERS += benchbaseline.h \
+    libmanbench.h \
+    projectgenerator.h \
+    fsshim/fsshim.h
+
+INCLUDEPATH += fsshim
+
+unix: LIBS += -ldl
+
+include(../libman.pri)
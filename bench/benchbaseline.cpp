@@ -0,0 +1,277 @@
+#include <QFile>
+#include <QFileInfo>
+
+#if QT_VERSION >= 0x050000
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+#endif
+
+#include "benchbaseline.h"
+#include "libmanbench.h"
+#include "recordwriter.h"
+
+/*!*********************************************************************************************************************
+ * \brief Tolerance and noise factor used if the baseline file does not specify them.
+ **********************************************************************************************************************/
+static const double BASELINE_TOLERANCE = 0.10;
+static const double BASELINE_NOISE_FACTOR = 3.0;
+
+/*!*********************************************************************************************************************
+ * \brief Parameters which do not change the workload of a single sample, they may differ from the baseline.
+ **********************************************************************************************************************/
+static const char *const BASELINE_IGNORED_CONFIG[] = { "repeat", "runs", "filter", "baseline" };
+
+/*!*********************************************************************************************************************
+ * \brief Constructs an empty baseline.
+ **********************************************************************************************************************/
+BenchBaseline::BenchBaseline()
+    : m_defaultTolerance(BASELINE_TOLERANCE),
+      m_noiseFactor(BASELINE_NOISE_FACTOR)
+{
+}
+
+/*!*********************************************************************************************************************
+ * \brief Loads baseline file. A missing file gives an empty baseline, so it can be created by save().
+ * \param fileName      Path to the baseline JSON file.
+ * \return              False if the file exists but can not be read.
+ **********************************************************************************************************************/
+bool BenchBaseline::load(const QString &fileName)
+{
+    m_entries.clear();
+    m_config.clear();
+    m_errorList.clear();
+
+    if(!QFileInfo(fileName).exists()) {
+        return true;
+    }
+
+#if QT_VERSION >= 0x050000
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly)) {
+        m_errorList<<QString("Can not read file '%1':\n%2.").arg(fileName).arg(file.errorString());
+        return false;
+    }
+
+    QJsonParseError parseError;
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if(parseError.error != QJsonParseError::NoError || !document.isObject()) {
+        m_errorList<<QString("Can not parse baseline '%1': %2.").arg(fileName).arg(parseError.errorString());
+        return false;
+    }
+
+    QJsonObject root = document.object();
+    m_defaultTolerance = root.value("default_tolerance").toDouble(BASELINE_TOLERANCE);
+    m_noiseFactor = root.value("noise_factor").toDouble(BASELINE_NOISE_FACTOR);
+
+    QJsonObject config = root.value("config").toObject();
+    for(QJsonObject::const_iterator it = config.constBegin(); it != config.constEnd(); ++it) {
+        m_config[it.key()] = it.value().toString();
+    }
+
+    QJsonObject benchmarks = root.value("benchmarks").toObject();
+    for(QJsonObject::const_iterator it = benchmarks.constBegin(); it != benchmarks.constEnd(); ++it) {
+        QJsonObject benchmark = it.value().toObject();
+
+        Entry entry;
+        entry.median = qint64(benchmark.value("median").toDouble(0));
+        entry.mad = qint64(benchmark.value("mad").toDouble(0));
+        entry.tolerance = benchmark.value("tolerance").toDouble(m_defaultTolerance);
+
+        m_entries[it.key()] = entry;
+    }
+
+    return true;
+#else
+    m_errorList<<QString("Baseline '%1' can not be read: comparison requires Qt 5.").arg(fileName);
+    return false;
+#endif
+}
+
+/*!*********************************************************************************************************************
+ * \brief Writes baseline with median and MAD of the samples. Tolerances of the loaded baseline are kept.
+ * \param fileName      Path to the baseline JSON file.
+ * \param samples       Samples in nanoseconds per benchmark name.
+ * \param config        Parameters of the run, stored for reference.
+ **********************************************************************************************************************/
+bool BenchBaseline::save(const QString &fileName, const QMap<QString, QList<qint64> > &samples,
+                         const QMap<QString, QString> &config)
+{
+    QFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        m_errorList<<QString("Can not write to file '%1':\n%2.").arg(fileName).arg(file.errorString());
+        return false;
+    }
+
+    QMap<QString, Entry> entries = m_entries;
+
+    QMap<QString, QList<qint64> >::const_iterator sit;
+    for(sit = samples.constBegin(); sit != samples.constEnd(); ++sit) {
+        Entry entry;
+        entry.tolerance = m_entries.contains(sit.key()) ? m_entries[sit.key()].tolerance : m_defaultTolerance;
+        entry.median = LibManBench::getMedian(sit.value());
+        entry.mad = LibManBench::getMad(sit.value());
+
+        entries[sit.key()] = entry;
+    }
+
+    QTextStream out(&file);
+
+    out<<"{\n";
+    out<<"  \"default_tolerance\": "<<m_defaultTolerance<<",\n";
+    out<<"  \"noise_factor\": "<<m_noiseFactor<<",\n";
+    out<<"  \"config\": {";
+
+    QMap<QString, QString>::const_iterator cit;
+    for(cit = config.constBegin(); cit != config.constEnd(); ++cit) {
+        out<<(cit == config.constBegin() ? "\n" : ",\n");
+        out<<"    \""<<RecordWriter::escapeJson(cit.key())<<"\": \""<<RecordWriter::escapeJson(cit.value())<<"\"";
+    }
+
+    out<<"\n  },\n";
+    out<<"  \"benchmarks\": {";
+
+    QMap<QString, Entry>::const_iterator it;
+    for(it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        out<<(it == entries.constBegin() ? "\n" : ",\n");
+        out<<"    \""<<RecordWriter::escapeJson(it.key())<<"\": {\"median\": "<<it->median<<", \"mad\": "<<it->mad
+           <<", \"tolerance\": "<<it->tolerance<<"}";
+    }
+
+    out<<"\n  }\n}\n";
+    out.flush();
+
+    m_entries = entries;
+    m_config = config;
+
+    return file.error() == QFile::NoError;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Compares medians of the samples against the baseline and prints a table of all benchmarks.
+ * \param samples       Samples in nanoseconds per benchmark name.
+ * \param out           Stream the table is written to.
+ * \return              False if at least one benchmark has regressed.
+ **********************************************************************************************************************/
+bool BenchBaseline::compare(const QMap<QString, QList<qint64> > &samples, QTextStream &out) const
+{
+    int regressions = 0;
+    int compared = 0;
+
+    out<<QString("benchmark").leftJustified(28)
+       <<QString("baseline").rightJustified(12)
+       <<QString("current").rightJustified(12)
+       <<QString("mad").rightJustified(11)
+       <<QString("change").rightJustified(9)
+       <<QString("limit").rightJustified(9)
+       <<"  status\n";
+
+    QMap<QString, QList<qint64> >::const_iterator it;
+    for(it = samples.constBegin(); it != samples.constEnd(); ++it) {
+        qint64 median = LibManBench::getMedian(it.value());
+        qint64 mad = LibManBench::getMad(it.value());
+
+        QString baseline = "-";
+        QString change = "-";
+        QString limit = "-";
+        QString status = "no baseline";
+
+        if(m_entries.contains(it.key()) && m_entries[it.key()].median > 0) {
+            const Entry &entry = m_entries[it.key()];
+            ++compared;
+
+            // Spread of both runs widens the limit, so noise alone does not fail the comparison.
+            qint64 noise = qint64(m_noiseFactor * qMax(entry.mad, mad));
+            qint64 upper = qint64(entry.median * (1.0 + entry.tolerance)) + noise;
+            qint64 lower = qint64(entry.median * (1.0 - entry.tolerance)) - noise;
+
+            double ratio = double(median - entry.median) / entry.median;
+
+            baseline = formatDuration(entry.median);
+            change = QString("%1%2 %").arg(ratio >= 0 ? "+" : "").arg(ratio * 100.0, 0, 'f', 1);
+            limit = QString("+%1 %").arg(100.0 * (upper - entry.median) / entry.median, 0, 'f', 1);
+
+            if(median > upper) {
+                status = "REGRESSION";
+                regressions++;
+            }
+            else if(median < lower) {
+                status = "improved";
+            }
+            else {
+                status = "ok";
+            }
+        }
+
+        out<<it.key().leftJustified(28)
+           <<baseline.rightJustified(12)
+           <<formatDuration(median).rightJustified(12)
+           <<formatDuration(mad).rightJustified(11)
+           <<change.rightJustified(9)
+           <<limit.rightJustified(9)
+           <<"  "<<status<<"\n";
+    }
+
+    foreach(const QString &name, m_entries.keys()) {
+        if(!samples.contains(name)) {
+            qint64 median = m_entries[name].median;
+
+            out<<name.leftJustified(28)<<(median > 0 ? formatDuration(median) : QString("-")).rightJustified(12)
+               <<QString("-").rightJustified(12)<<QString("-").rightJustified(11)
+               <<QString("-").rightJustified(9)<<QString("-").rightJustified(9)<<"  not run\n";
+        }
+    }
+
+    if(!compared) {
+        out<<"\nThe baseline has no medians, record it with '--update-baseline' on the reference machine.\n";
+    }
+
+    if(regressions) {
+        out<<"\n"<<regressions<<" benchmark(s) regressed.\n";
+    }
+
+    out.flush();
+
+    return regressions == 0;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Checks that the run has the configuration the baseline was recorded with, so medians of different workloads
+ * are never compared. A baseline without medians is comparable, its entries are reported but never fail.
+ * \param config        Parameters of the run.
+ * \return              False if the run can not be compared, the reasons are in the error list.
+ **********************************************************************************************************************/
+bool BenchBaseline::isComparable(const QMap<QString, QString> &config)
+{
+    QStringList keys = m_config.keys() + config.keys();
+    keys.removeDuplicates();
+    keys.sort();
+
+    for(size_t i = 0; i < sizeof(BASELINE_IGNORED_CONFIG) / sizeof(BASELINE_IGNORED_CONFIG[0]); ++i) {
+        keys.removeAll(BASELINE_IGNORED_CONFIG[i]);
+    }
+
+    QStringList differences;
+    foreach(const QString &key, keys) {
+        if(m_config.value(key) != config.value(key)) {
+            differences<<QString("'%1' is '%2' instead of '%3'").arg(key).arg(config.value(key))
+                                                                 .arg(m_config.value(key));
+        }
+    }
+
+    if(!differences.isEmpty()) {
+        m_errorList<<QString("The run differs from the configuration of the baseline: %1.").arg(differences.join(", "));
+        return false;
+    }
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Formats duration in milliseconds.
+ * \param nsecs         Duration in nanoseconds.
+ **********************************************************************************************************************/
+QString BenchBaseline::formatDuration(qint64 nsecs)
+{
+    return QString("%1 ms").arg(nsecs / 1e6, 0, 'f', 3);
+}
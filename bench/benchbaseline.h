@@ -0,0 +1,59 @@
+#ifndef BENCHBASELINE_H
+#define BENCHBASELINE_H
+
+#include <QMap>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+
+/*!*********************************************************************************************************************
+ * \brief The BenchBaseline class compares benchmark samples against a stored baseline. A benchmark regresses if its
+ * median exceeds the baseline median by more than its relative tolerance plus a multiple of the median absolute
+ * deviation (MAD), so noisy benchmarks need a larger difference to fail. Baselines are machine specific; an entry
+ * without a median only carries the tolerance until '--update-baseline' records one. The configuration of the run
+ * which recorded the baseline is stored with it, runs of another workload are not compared.
+ **********************************************************************************************************************/
+class BenchBaseline
+{
+public:
+    /*!
+     * \brief The Entry struct keeps baseline statistics of a single benchmark.
+     */
+    struct Entry {
+        qint64                          median;             /*!< Baseline median in nanoseconds, 0 if unknown. */
+        qint64                          mad;                /*!< Baseline median absolute deviation in nanoseconds. */
+        double                          tolerance;          /*!< Allowed relative slowdown, e.g. 0.1 for 10 %. */
+    };
+
+    BenchBaseline();
+
+    bool                                load(const QString &fileName);
+    bool                                save(const QString &fileName, const QMap<QString, QList<qint64> > &samples,
+                                             const QMap<QString, QString> &config);
+
+    bool                                compare(const QMap<QString, QList<qint64> > &samples, QTextStream &out) const;
+    bool                                isComparable(const QMap<QString, QString> &config);
+
+    QStringList                         getErrors() const;
+
+private:
+    static QString                      formatDuration(qint64 nsecs);
+
+private:
+    double                              m_defaultTolerance; /*!< Tolerance of benchmarks without own tolerance. */
+    double                              m_noiseFactor;      /*!< Multiple of the MAD added to the allowed slowdown. */
+    QMap<QString, Entry>                m_entries;          /*!< Baseline per benchmark name. */
+    QMap<QString, QString>              m_config;           /*!< Parameters of the run which recorded the baseline. */
+    QStringList                         m_errorList;        /*!< Errors of loading, saving and checking. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Returns errors of loading, saving and checking.
+ **********************************************************************************************************************/
+inline QStringList BenchBaseline::getErrors() const
+{
+    return m_errorList;
+}
+
+#endif // BENCHBASELINE_H
@@ -0,0 +1,590 @@
+/*!********************************************************************************************************************
+ *  Copyright 2023 IHP LibMan Authors
+ * Licensed under the Apache License, Version 2.0 (the \"License\")
+ * you may not use this file except in compliance with the License
+ * You may obtain a copy of the License at
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an \"AS IS\" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************************************************************/
+
+//*********************************************************************************************************************
+// File system latency shim
+//
+// Loaded by LD_PRELOAD, it counts file system calls and delays those on paths below LIBMAN_FS_PREFIX, so benchmarks
+// on a local disk behave like on a network file system with high metadata latency:
+//
+//   LIBMAN_FS_PREFIX=/tmp/bench LIBMAN_FS_LATENCY_US=500 LD_PRELOAD=./libfsshim.so ./libman-bench ...
+//
+// Environment variables:
+//   LIBMAN_FS_PREFIX           Only paths starting with the prefix are counted and delayed (default: all paths);
+//                              relative paths are resolved against the working folder or the dirfd of *at() calls.
+//   LIBMAN_FS_LATENCY_US       Delay of every metadata call in microseconds (default 0).
+//   LIBMAN_FS_<CALL>_US        Delay of a single call group, e.g. LIBMAN_FS_STAT_US or LIBMAN_FS_READDIR_US.
+//   LIBMAN_FS_STATS            Counts are written on exit to this file, "-" for the standard error output.
+//
+// readdir is not delayed by default, a network file system returns many entries per round trip.
+//*********************************************************************************************************************
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "fsshim.h"
+
+#define FSSHIM_MAX_DIRS     4096
+#define FSSHIM_REMOVED_DIR  ((DIR*)1)
+
+#ifndef O_TMPFILE
+#define O_TMPFILE           0
+#endif
+
+static const char *s_callNames[FSSHIM_CALL_COUNT] = {
+    "stat", "access", "open", "opendir", "readdir", "mkdir", "unlink", "rename"
+};
+
+static const char *s_envNames[FSSHIM_CALL_COUNT] = {
+    "LIBMAN_FS_STAT_US", "LIBMAN_FS_ACCESS_US", "LIBMAN_FS_OPEN_US", "LIBMAN_FS_OPENDIR_US",
+    "LIBMAN_FS_READDIR_US", "LIBMAN_FS_MKDIR_US", "LIBMAN_FS_UNLINK_US", "LIBMAN_FS_RENAME_US"
+};
+
+static long long s_counts[FSSHIM_CALL_COUNT];
+static long long s_delays[FSSHIM_CALL_COUNT];
+static long s_latency[FSSHIM_CALL_COUNT];
+
+static char *s_prefix = 0;
+static size_t s_prefixLength = 0;
+
+static pthread_once_t s_once = PTHREAD_ONCE_INIT;
+
+static pthread_mutex_t s_dirMutex = PTHREAD_MUTEX_INITIALIZER;
+static DIR *s_dirs[FSSHIM_MAX_DIRS];
+
+//*********************************************************************************************************************
+// fsshim_init
+//*********************************************************************************************************************
+static void fsshim_init(void)
+{
+    const char *prefix = getenv("LIBMAN_FS_PREFIX");
+    if(prefix && *prefix) {
+        s_prefix = strdup(prefix);
+        s_prefixLength = strlen(s_prefix);
+    }
+
+    const char *latency = getenv("LIBMAN_FS_LATENCY_US");
+    long defaultLatency = latency ? atol(latency) : 0;
+
+    for(int i = 0; i < FSSHIM_CALL_COUNT; ++i) {
+        const char *value = getenv(s_envNames[i]);
+        if(value) {
+            s_latency[i] = atol(value);
+        }
+        else {
+            s_latency[i] = i == FSSHIM_READDIR ? 0 : defaultLatency;
+        }
+    }
+}
+
+//*********************************************************************************************************************
+// fsshim_next
+//
+// Returns the next definition of the symbol, i.e. the one of the C library.
+//*********************************************************************************************************************
+static void* fsshim_next(const char *name)
+{
+    void *function = dlsym(RTLD_NEXT, name);
+    if(!function) {
+        fprintf(stderr, "[ERROR] fsshim: can not find '%s'.\n", name);
+        abort();
+    }
+
+    return function;
+}
+
+//*********************************************************************************************************************
+// fsshim_matches
+//
+// Relative paths are resolved against the working folder, or against the folder of dirfd for the *at() calls, before
+// they are compared with the prefix. Symbolic links in the working folder are not resolved.
+//*********************************************************************************************************************
+static int fsshim_matches(int dirfd, const char *path)
+{
+    pthread_once(&s_once, fsshim_init);
+
+    if(!path) {
+        return 0;
+    }
+
+    if(!s_prefix) {
+        return 1;
+    }
+
+    if(path[0] == '/') {
+        return strncmp(path, s_prefix, s_prefixLength) == 0;
+    }
+
+    char resolved[2 * PATH_MAX];
+    int savedErrno = errno;
+
+    if(dirfd == AT_FDCWD) {
+        if(!getcwd(resolved, PATH_MAX)) {
+            errno = savedErrno;
+            return 0;
+        }
+    }
+    else {
+        char link[64];
+        snprintf(link, sizeof(link), "/proc/self/fd/%d", dirfd);
+
+        ssize_t length = readlink(link, resolved, PATH_MAX - 1);
+        if(length < 0) {
+            errno = savedErrno;
+            return 0;
+        }
+
+        resolved[length] = 0;
+    }
+
+    errno = savedErrno;
+
+    size_t length = strlen(resolved);
+    snprintf(resolved + length, sizeof(resolved) - length, "/%s", path);
+
+    return strncmp(resolved, s_prefix, s_prefixLength) == 0;
+}
+
+//*********************************************************************************************************************
+// fsshim_account
+//*********************************************************************************************************************
+static void fsshim_account(int call)
+{
+    __sync_fetch_and_add(&s_counts[call], 1);
+
+    long latency = s_latency[call];
+    if(latency <= 0) {
+        return;
+    }
+
+    struct timespec delay;
+    delay.tv_sec = latency / 1000000;
+    delay.tv_nsec = (latency % 1000000) * 1000;
+
+    int savedErrno = errno;
+    while(nanosleep(&delay, &delay) == -1 && errno == EINTR) {
+    }
+
+    errno = savedErrno;
+
+    __sync_fetch_and_add(&s_delays[call], latency);
+}
+
+//*********************************************************************************************************************
+// fsshim_path
+//*********************************************************************************************************************
+static void fsshim_path(int call, int dirfd, const char *path)
+{
+    if(fsshim_matches(dirfd, path)) {
+        fsshim_account(call);
+    }
+}
+
+//*********************************************************************************************************************
+// fsshim_dir_slot
+//
+// Folders opened below the prefix are kept in an open addressing table, so readdir of other folders stays cheap.
+//*********************************************************************************************************************
+static size_t fsshim_dir_slot(DIR *dir)
+{
+    return ((size_t)dir >> 4) % FSSHIM_MAX_DIRS;
+}
+
+//*********************************************************************************************************************
+// fsshim_add_dir
+//*********************************************************************************************************************
+static void fsshim_add_dir(DIR *dir)
+{
+    pthread_mutex_lock(&s_dirMutex);
+
+    size_t slot = fsshim_dir_slot(dir);
+    for(int i = 0; i < FSSHIM_MAX_DIRS; ++i) {
+        if(!s_dirs[slot] || s_dirs[slot] == FSSHIM_REMOVED_DIR) {
+            s_dirs[slot] = dir;
+            break;
+        }
+
+        slot = (slot + 1) % FSSHIM_MAX_DIRS;
+    }
+
+    pthread_mutex_unlock(&s_dirMutex);
+}
+
+//*********************************************************************************************************************
+// fsshim_find_dir
+//*********************************************************************************************************************
+static int fsshim_find_dir(DIR *dir, int remove)
+{
+    int found = 0;
+
+    pthread_mutex_lock(&s_dirMutex);
+
+    size_t slot = fsshim_dir_slot(dir);
+    for(int i = 0; i < FSSHIM_MAX_DIRS && s_dirs[slot]; ++i) {
+        if(s_dirs[slot] == dir) {
+            if(remove) {
+                s_dirs[slot] = FSSHIM_REMOVED_DIR;
+            }
+
+            found = 1;
+            break;
+        }
+
+        slot = (slot + 1) % FSSHIM_MAX_DIRS;
+    }
+
+    pthread_mutex_unlock(&s_dirMutex);
+
+    return found;
+}
+
+//*********************************************************************************************************************
+// fsshim_write_stats
+//*********************************************************************************************************************
+__attribute__((destructor))
+static void fsshim_write_stats(void)
+{
+    const char *fileName = getenv("LIBMAN_FS_STATS");
+    if(!fileName || !*fileName) {
+        return;
+    }
+
+    FILE *out = strcmp(fileName, "-") == 0 ? stderr : fopen(fileName, "a");
+    if(!out) {
+        return;
+    }
+
+    fprintf(out, "fsshim pid %d prefix '%s'\n", (int)getpid(), s_prefix ? s_prefix : "");
+    for(int i = 0; i < FSSHIM_CALL_COUNT; ++i) {
+        fprintf(out, "  %-8s calls %12lld  latency %8ld us  delay %12.3f s\n", s_callNames[i], s_counts[i],
+                s_latency[i], s_delays[i] / 1e6);
+    }
+
+    if(out != stderr) {
+        fclose(out);
+    }
+}
+
+//*********************************************************************************************************************
+// Public interface
+//*********************************************************************************************************************
+long long fsshim_get_count(int call)
+{
+    return call >= 0 && call < FSSHIM_CALL_COUNT ? s_counts[call] : 0;
+}
+
+long long fsshim_get_delay(int call)
+{
+    return call >= 0 && call < FSSHIM_CALL_COUNT ? s_delays[call] : 0;
+}
+
+const char* fsshim_get_name(int call)
+{
+    return call >= 0 && call < FSSHIM_CALL_COUNT ? s_callNames[call] : "";
+}
+
+void fsshim_reset(void)
+{
+    for(int i = 0; i < FSSHIM_CALL_COUNT; ++i) {
+        __sync_lock_test_and_set(&s_counts[i], 0);
+        __sync_lock_test_and_set(&s_delays[i], 0);
+    }
+}
+
+//*********************************************************************************************************************
+// Intercepted calls
+//*********************************************************************************************************************
+#define FSSHIM_NEXT(type, name) \
+    static type next = 0; \
+    if(!next) { \
+        next = (type)fsshim_next(name); \
+    }
+
+int stat(const char *path, struct stat *buf)
+{
+    typedef int (*Function)(const char*, struct stat*);
+    FSSHIM_NEXT(Function, "stat");
+    fsshim_path(FSSHIM_STAT, AT_FDCWD, path);
+    return next(path, buf);
+}
+
+int lstat(const char *path, struct stat *buf)
+{
+    typedef int (*Function)(const char*, struct stat*);
+    FSSHIM_NEXT(Function, "lstat");
+    fsshim_path(FSSHIM_STAT, AT_FDCWD, path);
+    return next(path, buf);
+}
+
+int fstatat(int dirfd, const char *path, struct stat *buf, int flags)
+{
+    typedef int (*Function)(int, const char*, struct stat*, int);
+    FSSHIM_NEXT(Function, "fstatat");
+    fsshim_path(FSSHIM_STAT, dirfd, path);
+    return next(dirfd, path, buf, flags);
+}
+
+#ifdef __USE_LARGEFILE64
+int stat64(const char *path, struct stat64 *buf)
+{
+    typedef int (*Function)(const char*, struct stat64*);
+    FSSHIM_NEXT(Function, "stat64");
+    fsshim_path(FSSHIM_STAT, AT_FDCWD, path);
+    return next(path, buf);
+}
+
+int lstat64(const char *path, struct stat64 *buf)
+{
+    typedef int (*Function)(const char*, struct stat64*);
+    FSSHIM_NEXT(Function, "lstat64");
+    fsshim_path(FSSHIM_STAT, AT_FDCWD, path);
+    return next(path, buf);
+}
+
+int fstatat64(int dirfd, const char *path, struct stat64 *buf, int flags)
+{
+    typedef int (*Function)(int, const char*, struct stat64*, int);
+    FSSHIM_NEXT(Function, "fstatat64");
+    fsshim_path(FSSHIM_STAT, dirfd, path);
+    return next(dirfd, path, buf, flags);
+}
+#endif
+
+// C libraries before glibc 2.33 export stat() and friends only through these versioned wrappers.
+int __xstat(int version, const char *path, struct stat *buf)
+{
+    typedef int (*Function)(int, const char*, struct stat*);
+    FSSHIM_NEXT(Function, "__xstat");
+    fsshim_path(FSSHIM_STAT, AT_FDCWD, path);
+    return next(version, path, buf);
+}
+
+int __lxstat(int version, const char *path, struct stat *buf)
+{
+    typedef int (*Function)(int, const char*, struct stat*);
+    FSSHIM_NEXT(Function, "__lxstat");
+    fsshim_path(FSSHIM_STAT, AT_FDCWD, path);
+    return next(version, path, buf);
+}
+
+int __xstat64(int version, const char *path, void *buf)
+{
+    typedef int (*Function)(int, const char*, void*);
+    FSSHIM_NEXT(Function, "__xstat64");
+    fsshim_path(FSSHIM_STAT, AT_FDCWD, path);
+    return next(version, path, buf);
+}
+
+int __lxstat64(int version, const char *path, void *buf)
+{
+    typedef int (*Function)(int, const char*, void*);
+    FSSHIM_NEXT(Function, "__lxstat64");
+    fsshim_path(FSSHIM_STAT, AT_FDCWD, path);
+    return next(version, path, buf);
+}
+
+#ifdef STATX_BASIC_STATS
+int statx(int dirfd, const char *path, int flags, unsigned int mask, struct statx *buf)
+{
+    typedef int (*Function)(int, const char*, int, unsigned int, struct statx*);
+    FSSHIM_NEXT(Function, "statx");
+    fsshim_path(FSSHIM_STAT, dirfd, path);
+    return next(dirfd, path, flags, mask, buf);
+}
+#endif
+
+int access(const char *path, int mode)
+{
+    typedef int (*Function)(const char*, int);
+    FSSHIM_NEXT(Function, "access");
+    fsshim_path(FSSHIM_ACCESS, AT_FDCWD, path);
+    return next(path, mode);
+}
+
+int faccessat(int dirfd, const char *path, int mode, int flags)
+{
+    typedef int (*Function)(int, const char*, int, int);
+    FSSHIM_NEXT(Function, "faccessat");
+    fsshim_path(FSSHIM_ACCESS, dirfd, path);
+    return next(dirfd, path, mode, flags);
+}
+
+int open(const char *path, int flags, ...)
+{
+    typedef int (*Function)(const char*, int, ...);
+    FSSHIM_NEXT(Function, "open");
+
+    mode_t mode = 0;
+    if(flags & (O_CREAT | O_TMPFILE)) {
+        va_list args;
+        va_start(args, flags);
+        mode = va_arg(args, mode_t);
+        va_end(args);
+    }
+
+    fsshim_path(FSSHIM_OPEN, AT_FDCWD, path);
+    return next(path, flags, mode);
+}
+
+int open64(const char *path, int flags, ...)
+{
+    typedef int (*Function)(const char*, int, ...);
+    FSSHIM_NEXT(Function, "open64");
+
+    mode_t mode = 0;
+    if(flags & (O_CREAT | O_TMPFILE)) {
+        va_list args;
+        va_start(args, flags);
+        mode = va_arg(args, mode_t);
+        va_end(args);
+    }
+
+    fsshim_path(FSSHIM_OPEN, AT_FDCWD, path);
+    return next(path, flags, mode);
+}
+
+int openat(int dirfd, const char *path, int flags, ...)
+{
+    typedef int (*Function)(int, const char*, int, ...);
+    FSSHIM_NEXT(Function, "openat");
+
+    mode_t mode = 0;
+    if(flags & (O_CREAT | O_TMPFILE)) {
+        va_list args;
+        va_start(args, flags);
+        mode = va_arg(args, mode_t);
+        va_end(args);
+    }
+
+    fsshim_path(FSSHIM_OPEN, dirfd, path);
+    return next(dirfd, path, flags, mode);
+}
+
+int openat64(int dirfd, const char *path, int flags, ...)
+{
+    typedef int (*Function)(int, const char*, int, ...);
+    FSSHIM_NEXT(Function, "openat64");
+
+    mode_t mode = 0;
+    if(flags & (O_CREAT | O_TMPFILE)) {
+        va_list args;
+        va_start(args, flags);
+        mode = va_arg(args, mode_t);
+        va_end(args);
+    }
+
+    fsshim_path(FSSHIM_OPEN, dirfd, path);
+    return next(dirfd, path, flags, mode);
+}
+
+DIR* opendir(const char *path)
+{
+    typedef DIR* (*Function)(const char*);
+    FSSHIM_NEXT(Function, "opendir");
+
+    int matches = fsshim_matches(AT_FDCWD, path);
+    if(matches) {
+        fsshim_account(FSSHIM_OPENDIR);
+    }
+
+    DIR *dir = next(path);
+    if(dir && matches) {
+        fsshim_add_dir(dir);
+    }
+
+    return dir;
+}
+
+int closedir(DIR *dir)
+{
+    typedef int (*Function)(DIR*);
+    FSSHIM_NEXT(Function, "closedir");
+
+    fsshim_find_dir(dir, 1);
+
+    return next(dir);
+}
+
+struct dirent* readdir(DIR *dir)
+{
+    typedef struct dirent* (*Function)(DIR*);
+    FSSHIM_NEXT(Function, "readdir");
+
+    if(fsshim_find_dir(dir, 0)) {
+        fsshim_account(FSSHIM_READDIR);
+    }
+
+    return next(dir);
+}
+
+#ifdef __USE_LARGEFILE64
+struct dirent64* readdir64(DIR *dir)
+{
+    typedef struct dirent64* (*Function)(DIR*);
+    FSSHIM_NEXT(Function, "readdir64");
+
+    if(fsshim_find_dir(dir, 0)) {
+        fsshim_account(FSSHIM_READDIR);
+    }
+
+    return next(dir);
+}
+#endif
+
+int mkdir(const char *path, mode_t mode)
+{
+    typedef int (*Function)(const char*, mode_t);
+    FSSHIM_NEXT(Function, "mkdir");
+    fsshim_path(FSSHIM_MKDIR, AT_FDCWD, path);
+    return next(path, mode);
+}
+
+int unlink(const char *path)
+{
+    typedef int (*Function)(const char*);
+    FSSHIM_NEXT(Function, "unlink");
+    fsshim_path(FSSHIM_UNLINK, AT_FDCWD, path);
+    return next(path);
+}
+
+int rmdir(const char *path)
+{
+    typedef int (*Function)(const char*);
+    FSSHIM_NEXT(Function, "rmdir");
+    fsshim_path(FSSHIM_UNLINK, AT_FDCWD, path);
+    return next(path);
+}
+
+int rename(const char *oldPath, const char *newPath)
+{
+    typedef int (*Function)(const char*, const char*);
+    FSSHIM_NEXT(Function, "rename");
+    fsshim_path(FSSHIM_RENAME, AT_FDCWD, oldPath);
+    return next(oldPath, newPath);
+}
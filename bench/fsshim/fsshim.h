@@ -0,0 +1,41 @@
+#ifndef FSSHIM_H
+#define FSSHIM_H
+
+/*!*********************************************************************************************************************
+ * \brief Interface of the file system latency shim (libfsshim.so). The shim is loaded by LD_PRELOAD, so programs do
+ * not link against it; they look the functions up with dlsym(RTLD_DEFAULT, ...) and work without the shim as well.
+ **********************************************************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * \brief The FSSHIM_CALL enum specifies groups of intercepted file system calls.
+ */
+enum FSSHIM_CALL {
+    FSSHIM_STAT             = 0,    /*!< stat, lstat, fstatat, statx and their 64-bit variants. */
+    FSSHIM_ACCESS,                  /*!< access, faccessat. */
+    FSSHIM_OPEN,                    /*!< open, openat and their 64-bit variants. */
+    FSSHIM_OPENDIR,                 /*!< opendir. */
+    FSSHIM_READDIR,                 /*!< readdir, readdir64 of folders opened below the prefix. */
+    FSSHIM_MKDIR,                   /*!< mkdir. */
+    FSSHIM_UNLINK,                  /*!< unlink, rmdir. */
+    FSSHIM_RENAME,                  /*!< rename. */
+    FSSHIM_CALL_COUNT
+};
+
+typedef long long (*FsShimGetCount)(int call);
+typedef const char* (*FsShimGetName)(int call);
+typedef void (*FsShimReset)(void);
+
+long long                   fsshim_get_count(int call);
+long long                   fsshim_get_delay(int call);
+const char*                 fsshim_get_name(int call);
+void                        fsshim_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FSSHIM_H */
@@ -0,0 +1,18 @@
+#-------------------------------------------------
+#
+# File system latency shim, used by LD_PRELOAD
+#
+#-------------------------------------------------
+
+TARGET = fsshim
+TEMPLATE = lib
+CONFIG += plugin
+CONFIG -= qt
+
+QMAKE_CFLAGS += -std=gnu99
+
+SOURCES += fsshim.c
+
+HEADERS += fsshim.h
+
+LIBS += -ldl -lpthread
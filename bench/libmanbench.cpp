@@ -0,0 +1,676 @@
+#include <QDir>
+#include <QFile>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QElapsedTimer>
+
+#include <algorithm>
+
+#ifdef Q_OS_UNIX
+#include <dlfcn.h>
+#endif
+
+#include "libmanbench.h"
+#include "mainwindow.h"
+#include "catalog.h"
+#include "batchscript.h"
+#include "catalogexport.h"
+#include "recordwriter.h"
+#include "gds/gdsreader.h"
+#include "gds/gdsscanner.h"
+
+/*!*********************************************************************************************************************
+ * \brief Name of the library created by copy benchmarks.
+ **********************************************************************************************************************/
+static const QString BENCH_COPY_LIBRARY = "bench_copy";
+
+/*!*********************************************************************************************************************
+ * \brief Name of the folder created by the folder copy benchmark.
+ **********************************************************************************************************************/
+static const QString BENCH_COPY_DIR = "bench_copy_dir";
+
+/*!*********************************************************************************************************************
+ * \brief Constructs LibManBench object. Application object has to exist before, GUI benchmarks use MainWindow. If
+ * the file system latency shim is preloaded, its counters are looked up.
+ * \param projFile      Path to the benchmarked project file.
+ * \param workDir       Folder for temporary files.
+ **********************************************************************************************************************/
+LibManBench::LibManBench(const QString &projFile, const QString &workDir)
+    : m_projFile(projFile),
+      m_workDir(workDir),
+      m_window(0),
+      m_fsGetCount(0),
+      m_fsGetName(0),
+      m_fsReset(0)
+{
+#ifdef Q_OS_UNIX
+    m_fsGetCount = (FsShimGetCount)dlsym(RTLD_DEFAULT, "fsshim_get_count");
+    m_fsGetName = (FsShimGetName)dlsym(RTLD_DEFAULT, "fsshim_get_name");
+    m_fsReset = (FsShimReset)dlsym(RTLD_DEFAULT, "fsshim_reset");
+#endif
+}
+
+/*!*********************************************************************************************************************
+ * \brief Destructs LibManBench object.
+ **********************************************************************************************************************/
+LibManBench::~LibManBench()
+{
+    delete m_window;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Adds benchmark to the execution list.
+ * \param name          Name of the benchmark.
+ * \param benchCase     Method returning duration of the benchmark in nanoseconds or -1 on failure.
+ **********************************************************************************************************************/
+void LibManBench::addCase(const QString &name, BenchCase benchCase)
+{
+    m_caseNames<<name;
+    m_cases<<benchCase;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Runs all benchmarks the requested number of times. Samples are added to those of previous runs, so several
+ * runs can be pooled; clearResults() starts from scratch.
+ * \param repeat        Number of repetitions.
+ * \param filter        Only benchmarks containing the text in their name are run. Empty to run all.
+ * \return              True if all benchmarks have succeeded, otherwise false and the reasons are in the error list.
+ **********************************************************************************************************************/
+bool LibManBench::run(int repeat, const QString &filter)
+{
+    m_caseNames.clear();
+    m_cases.clear();
+    m_errorList.clear();
+
+    Catalog catalog;
+    if(!catalog.loadProjectFile(m_projFile)) {
+        m_errorList<<catalog.getErrors();
+        return false;
+    }
+
+    QMap<QString, QString> libraries = catalog.getLibraries();
+    if(libraries.isEmpty()) {
+        m_errorList<<QString("Project '%1' has no libraries.").arg(m_projFile);
+        return false;
+    }
+
+    m_firstLibPath = libraries.constBegin().value();
+    m_firstLibCells = catalog.getCells(m_firstLibPath);
+
+    if(!m_window) {
+        m_window = new MainWindow(QString(), m_workDir);
+    }
+
+    addCase("catalog.load_project", &LibManBench::benchCatalogLoadProject);
+    addCase("catalog.scan_libraries", &LibManBench::benchCatalogScanLibraries);
+    addCase("catalog.export", &LibManBench::benchCatalogExport);
+    addCase("gui.load_project", &LibManBench::benchGuiLoadProject);
+    addCase("gui.load_groups", &LibManBench::benchGuiLoadGroups);
+    addCase("gui.load_views", &LibManBench::benchGuiLoadViews);
+    addCase("gui.filter_cells", &LibManBench::benchGuiFilterCells);
+    addCase("script.copy_cells", &LibManBench::benchScriptCopyCells);
+    addCase("script.delete_cells", &LibManBench::benchScriptDeleteCells);
+    addCase("gui.copy_dir", &LibManBench::benchGuiCopyDir);
+    addCase("gds.create", &LibManBench::benchGdsCreate);
+    addCase("gds.generate", &LibManBench::benchGdsGenerate);
+    addCase("gds.scan", &LibManBench::benchGdsScan);
+
+    for(int i = m_cases.count() - 1; i >= 0; --i) {
+        if(!filter.isEmpty() && !m_caseNames[i].contains(filter)) {
+            m_caseNames.removeAt(i);
+            m_cases.removeAt(i);
+        }
+    }
+
+    // Results of previous runs are kept in the order of the current cases.
+    QList<Result> results;
+    for(int i = 0; i < m_cases.count(); ++i) {
+        Result result;
+        result.name = m_caseNames[i];
+
+        foreach(const Result &previous, m_results) {
+            if(previous.name == result.name) {
+                result = previous;
+                break;
+            }
+        }
+
+        results<<result;
+    }
+
+    m_results = results;
+
+    for(int r = 0; r < repeat; ++r) {
+        for(int i = 0; i < m_cases.count(); ++i) {
+            m_fsCalls.clear();
+
+            qint64 duration = (this->*m_cases[i])();
+            if(duration < 0) {
+                m_errorList<<QString("Benchmark '%1' has failed.").arg(m_caseNames[i]);
+                return false;
+            }
+
+            m_results[i].samples<<duration;
+            m_results[i].fsCalls = m_fsCalls;
+        }
+    }
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Removes samples of all previous runs.
+ **********************************************************************************************************************/
+void LibManBench::clearResults()
+{
+    m_results.clear();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns samples in nanoseconds per benchmark name.
+ **********************************************************************************************************************/
+QMap<QString, QList<qint64> > LibManBench::getSamples() const
+{
+    QMap<QString, QList<qint64> > samples;
+    foreach(const Result &result, m_results) {
+        samples[result.name] = result.samples;
+    }
+
+    return samples;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Times loading of the project file by Catalog.
+ **********************************************************************************************************************/
+qint64 LibManBench::benchCatalogLoadProject()
+{
+    QElapsedTimer timer;
+    startTiming(timer);
+
+    Catalog catalog;
+    if(!catalog.loadProjectFile(m_projFile)) {
+        m_errorList<<catalog.getErrors();
+        return -1;
+    }
+
+    return stopTiming(timer);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Times scanning of cells and views of all libraries.
+ **********************************************************************************************************************/
+qint64 LibManBench::benchCatalogScanLibraries()
+{
+    Catalog catalog;
+    catalog.loadProjectFile(m_projFile);
+
+    QMap<QString, QString> libraries = catalog.getLibraries();
+
+    QElapsedTimer timer;
+    startTiming(timer);
+
+    foreach(const QString &libPath, libraries) {
+        catalog.scanLibrary(libPath);
+    }
+
+    return stopTiming(timer);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Times export of the full catalog table into a TSV file.
+ **********************************************************************************************************************/
+qint64 LibManBench::benchCatalogExport()
+{
+    Catalog catalog;
+    catalog.loadProjectFile(m_projFile);
+
+    QFile file(QDir::toNativeSeparators(m_workDir + "/export.tsv"));
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        m_errorList<<QString("Can not write to file '%1'.").arg(file.fileName());
+        return -1;
+    }
+
+    QTextStream out(&file);
+
+    QElapsedTimer timer;
+    startTiming(timer);
+
+    CatalogExport catalogExport(catalog.getLibraries());
+    RecordWriter writer(&out, RecordWriter::TSV, CatalogExport::getColumns());
+    bool isExported = catalogExport.exportTo(&writer);
+    writer.finish();
+
+    qint64 duration = stopTiming(timer);
+
+    file.close();
+    file.remove();
+
+    if(!isExported) {
+        m_errorList<<catalogExport.getErrors();
+        return -1;
+    }
+
+    return duration;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Times loading of the project file into the main window.
+ **********************************************************************************************************************/
+qint64 LibManBench::benchGuiLoadProject()
+{
+    QElapsedTimer timer;
+    startTiming(timer);
+
+    m_window->loadProjectFile(m_projFile);
+
+    return stopTiming(timer);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Times population of the cell list for every library.
+ **********************************************************************************************************************/
+qint64 LibManBench::benchGuiLoadGroups()
+{
+    QMap<QString, QString> libraries = m_window->getCurrentLibraries();
+
+    QElapsedTimer timer;
+    startTiming(timer);
+
+    foreach(const QString &libPath, libraries) {
+        m_window->loadGroups(libPath);
+    }
+
+    return stopTiming(timer);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Times population of the view list for every cell of the first library.
+ **********************************************************************************************************************/
+qint64 LibManBench::benchGuiLoadViews()
+{
+    m_window->loadGroups(m_firstLibPath);
+
+    QElapsedTimer timer;
+    startTiming(timer);
+
+    foreach(const QString &cellName, m_firstLibCells) {
+        m_window->loadViews(m_firstLibPath, cellName);
+    }
+
+    return stopTiming(timer);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Times typing a cell name into the cell filter of the first library and clearing it again.
+ **********************************************************************************************************************/
+qint64 LibManBench::benchGuiFilterCells()
+{
+    m_window->loadGroups(m_firstLibPath);
+
+    QString pattern = m_firstLibCells.isEmpty() ? QString("cell") : m_firstLibCells.last();
+
+    QElapsedTimer timer;
+    startTiming(timer);
+
+    for(int i = 1; i <= pattern.length(); ++i) {
+        m_window->on_txtCellSearch_textEdited(pattern.left(i));
+    }
+
+    m_window->on_txtCellSearch_textEdited(QString());
+
+    return stopTiming(timer);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Times copying all cells of the first library into a new library by a batch script.
+ **********************************************************************************************************************/
+qint64 LibManBench::benchScriptCopyCells()
+{
+    Catalog catalog;
+    catalog.loadProjectFile(m_projFile);
+
+    QString firstLibName = catalog.getLibraries().constBegin().key();
+
+    QStringList lines;
+    lines<<QString("ADD_LIBRARY %1 %2").arg(BENCH_COPY_LIBRARY).arg(m_workDir + "/" + BENCH_COPY_LIBRARY);
+    foreach(const QString &cellName, m_firstLibCells) {
+        lines<<QString("COPY_CELL %1 %2 %3").arg(firstLibName).arg(cellName).arg(BENCH_COPY_LIBRARY);
+    }
+
+    return runScript(lines);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Times deleting cells copied by the copy benchmark and removes the copied library afterwards. If the copy
+ * benchmark has not been run, cells are copied before the timing starts.
+ **********************************************************************************************************************/
+qint64 LibManBench::benchScriptDeleteCells()
+{
+    QString libPath = QDir::toNativeSeparators(m_workDir + "/" + BENCH_COPY_LIBRARY);
+    if(!QFileInfo(libPath).isDir() && benchScriptCopyCells() < 0) {
+        return -1;
+    }
+
+    QStringList lines;
+    lines<<QString("ADD_LIBRARY %1 %2").arg(BENCH_COPY_LIBRARY).arg(libPath);
+    foreach(const QString &cellName, m_firstLibCells) {
+        lines<<QString("DELETE_CELL %1 %2").arg(BENCH_COPY_LIBRARY).arg(cellName);
+    }
+
+    qint64 duration = runScript(lines);
+
+    QDir libDir(libPath);
+    foreach(const QString &viewName, libDir.entryList(QDir::AllDirs | QDir::NoDotAndDotDot)) {
+        libDir.rmdir(viewName);
+    }
+
+    QDir(m_workDir).rmdir(BENCH_COPY_LIBRARY);
+
+    return duration;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Times recursive copy of the first library folder as done by pasting a library in the main window. The copy
+ * is removed afterwards.
+ **********************************************************************************************************************/
+qint64 LibManBench::benchGuiCopyDir()
+{
+    QString copyPath = QDir::toNativeSeparators(m_workDir + "/" + BENCH_COPY_DIR);
+
+    QElapsedTimer timer;
+    startTiming(timer);
+
+    m_window->copyDir(m_firstLibPath, copyPath);
+
+    qint64 duration = stopTiming(timer);
+
+    if(!QFileInfo(copyPath).isDir()) {
+        m_errorList<<QString("Can not copy '%1' to '%2'.").arg(m_firstLibPath).arg(copyPath);
+        return -1;
+    }
+
+    m_window->removeDir(copyPath);
+
+    return duration;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Times creation of a layout view for every cell of the first library.
+ **********************************************************************************************************************/
+qint64 LibManBench::benchGdsCreate()
+{
+    QString gdsPath = QDir::toNativeSeparators(m_workDir + "/gds");
+    QDir().mkpath(gdsPath);
+
+    QElapsedTimer timer;
+    startTiming(timer);
+
+    foreach(const QString &cellName, m_firstLibCells) {
+        GdsReader gdsReader(QDir::toNativeSeparators(gdsPath + "/" + cellName + ".gds"));
+        gdsReader.gdsCreate(cellName);
+    }
+
+    qint64 duration = stopTiming(timer);
+
+    foreach(const QString &cellName, m_firstLibCells) {
+        QFile::remove(QDir::toNativeSeparators(gdsPath + "/" + cellName + ".gds"));
+    }
+
+    QDir(m_workDir).rmdir("gds");
+
+    return duration;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Times writing of a synthetic GDS stream through the buffered writer.
+ **********************************************************************************************************************/
+qint64 LibManBench::benchGdsGenerate()
+{
+    QString gdsPath = QDir::toNativeSeparators(m_workDir + "/synthetic.gds");
+
+    QElapsedTimer timer;
+    startTiming(timer);
+
+    bool isGenerated = m_gdsGenerator.generate(gdsPath);
+
+    qint64 duration = stopTiming(timer);
+
+    QFile::remove(gdsPath);
+
+    if(!isGenerated) {
+        m_errorList<<m_gdsGenerator.getErrors();
+        return -1;
+    }
+
+    return duration;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Times scanning of structures, references and labels of the synthetic GDS stream, which is generated before
+ * the timing starts.
+ **********************************************************************************************************************/
+qint64 LibManBench::benchGdsScan()
+{
+    QString gdsPath = QDir::toNativeSeparators(m_workDir + "/synthetic.gds");
+
+    if(!m_gdsGenerator.generate(gdsPath)) {
+        m_errorList<<m_gdsGenerator.getErrors();
+        QFile::remove(gdsPath);
+        return -1;
+    }
+
+    QElapsedTimer timer;
+    startTiming(timer);
+
+    GdsScanner scanner;
+    bool isScanned = scanner.scan(gdsPath);
+
+    qint64 duration = stopTiming(timer);
+
+    QFile::remove(gdsPath);
+
+    if(!isScanned) {
+        m_errorList<<scanner.getErrors();
+        return -1;
+    }
+
+    return duration;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Plans and executes batch script on a fresh copy of the project. Project file is not changed.
+ * \param lines         Lines of the script.
+ * \return              Duration of planning and execution or -1 on failure.
+ **********************************************************************************************************************/
+qint64 LibManBench::runScript(const QStringList &lines)
+{
+    Catalog catalog;
+    catalog.loadProjectFile(m_projFile);
+
+    QElapsedTimer timer;
+    startTiming(timer);
+
+    BatchScript script(&catalog);
+    if(!script.plan(lines) || !script.execute(0)) {
+        m_errorList<<script.getErrors();
+        return -1;
+    }
+
+    return stopTiming(timer);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Resets the counters of the file system shim and starts the timer, so setup of a benchmark is not counted.
+ * \param timer         Timer of the benchmark.
+ **********************************************************************************************************************/
+void LibManBench::startTiming(QElapsedTimer &timer)
+{
+    if(hasFsShim()) {
+        m_fsReset();
+    }
+
+    timer.start();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Reads the counters of the file system shim when the timer stops, so cleanup of a benchmark is not counted.
+ * \param timer         Timer started by startTiming().
+ * \return              Elapsed time in nanoseconds.
+ **********************************************************************************************************************/
+qint64 LibManBench::stopTiming(const QElapsedTimer &timer)
+{
+    qint64 duration = timer.nsecsElapsed();
+
+    if(hasFsShim()) {
+        m_fsCalls.clear();
+        for(int call = 0; call < FSSHIM_CALL_COUNT; ++call) {
+            m_fsCalls<<m_fsGetCount(call);
+        }
+    }
+
+    return duration;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns names of the files and folders benchmarks create in the work folder.
+ **********************************************************************************************************************/
+QStringList LibManBench::getTemporaryNames()
+{
+    return QStringList()<<"export.tsv"<<BENCH_COPY_LIBRARY<<BENCH_COPY_DIR<<"gds"<<"synthetic.gds";
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns median of the samples.
+ * \param samples       Samples in any order.
+ **********************************************************************************************************************/
+qint64 LibManBench::getMedian(QList<qint64> samples)
+{
+    if(samples.isEmpty()) {
+        return 0;
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    int middle = samples.count() / 2;
+    if(samples.count() % 2) {
+        return samples[middle];
+    }
+
+    return (samples[middle - 1] + samples[middle]) / 2;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns median absolute deviation of the samples, a spread estimate robust against outliers.
+ * \param samples       Samples in any order.
+ **********************************************************************************************************************/
+qint64 LibManBench::getMad(const QList<qint64> &samples)
+{
+    qint64 median = getMedian(samples);
+
+    QList<qint64> deviations;
+    foreach(qint64 sample, samples) {
+        deviations<<qAbs(sample - median);
+    }
+
+    return getMedian(deviations);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Writes results as JSON: benchmark configuration and all samples in nanoseconds per benchmark.
+ * \param fileName      Path to the result file, empty or "-" for the standard output.
+ * \param config        Parameters of the run (project size, repetitions, etc.).
+ **********************************************************************************************************************/
+bool LibManBench::writeResults(const QString &fileName, const QMap<QString, QString> &config) const
+{
+    QFile file;
+    if(fileName.isEmpty() || fileName == "-") {
+        if(!file.open(stdout, QIODevice::WriteOnly)) {
+            return false;
+        }
+    }
+    else {
+        file.setFileName(fileName);
+        if(!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            return false;
+        }
+    }
+
+    QTextStream out(&file);
+
+    out<<"{\n";
+    out<<"  \"benchmark\": \"libman\",\n";
+    out<<"  \"date\": \""<<QDateTime::currentDateTime().toUTC().toString(Qt::ISODate)<<"\",\n";
+    out<<"  \"qt\": \""<<qVersion()<<"\",\n";
+    out<<"  \"config\": {";
+
+    QMap<QString, QString>::const_iterator it;
+    for(it = config.constBegin(); it != config.constEnd(); ++it) {
+        out<<(it == config.constBegin() ? "\n" : ",\n");
+        out<<"    \""<<RecordWriter::escapeJson(it.key())<<"\": \""<<RecordWriter::escapeJson(it.value())<<"\"";
+    }
+
+    out<<"\n  },\n";
+    out<<"  \"results\": [";
+
+    for(int i = 0; i < m_results.count(); ++i) {
+        const Result &result = m_results[i];
+
+        QStringList samples;
+        foreach(qint64 sample, result.samples) {
+            samples<<QString::number(sample);
+        }
+
+        qint64 minimum = result.samples.isEmpty() ? 0 : *std::min_element(result.samples.begin(),
+                                                                          result.samples.end());
+
+        out<<(i ? ",\n" : "\n");
+        out<<"    {\"name\": \""<<RecordWriter::escapeJson(result.name)<<"\", \"unit\": \"ns\", "
+           <<"\"median\": "<<getMedian(result.samples)<<", \"mad\": "<<getMad(result.samples)<<", "
+           <<"\"min\": "<<minimum<<", "
+           <<"\"samples\": ["<<samples.join(", ")<<"]";
+
+        if(!result.fsCalls.isEmpty()) {
+            QStringList calls;
+            for(int call = 0; call < result.fsCalls.count(); ++call) {
+                calls<<QString("\"%1\": %2").arg(m_fsGetName(call)).arg(result.fsCalls[call]);
+            }
+
+            out<<", \"fs_calls\": {"<<calls.join(", ")<<"}";
+        }
+
+        out<<"}";
+    }
+
+    out<<"\n  ]\n}\n";
+    out.flush();
+
+    file.close();
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Prints median and minimal duration of every benchmark in milliseconds to the standard error output.
+ **********************************************************************************************************************/
+void LibManBench::printSummary() const
+{
+    QTextStream err(stderr, QIODevice::WriteOnly);
+
+    foreach(const Result &result, m_results) {
+        qint64 minimum = result.samples.isEmpty() ? 0 : *std::min_element(result.samples.begin(),
+                                                                          result.samples.end());
+
+        err<<result.name.leftJustified(28)
+           <<" median "<<QString::number(getMedian(result.samples) / 1e6, 'f', 3).rightJustified(12)<<" ms"
+           <<"   min "<<QString::number(minimum / 1e6, 'f', 3).rightJustified(12)<<" ms";
+
+        for(int call = 0; call < result.fsCalls.count(); ++call) {
+            if(result.fsCalls[call]) {
+                err<<"   "<<m_fsGetName(call)<<" "<<result.fsCalls[call];
+            }
+        }
+
+        err<<"\n";
+    }
+}
@@ -0,0 +1,122 @@
+#ifndef LIBMANBENCH_H
+#define LIBMANBENCH_H
+
+#include <QMap>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "fsshim.h"
+#include "gds/gdsgenerator.h"
+
+class MainWindow;
+class QElapsedTimer;
+
+/*!*********************************************************************************************************************
+ * \brief The LibManBench class times LibMan operations on a generated project and writes the samples as JSON, so
+ * results of two commits can be compared. Every repetition runs all benchmarks in the same order; copy and delete
+ * benchmarks restore the project, so repetitions start from the same state.
+ **********************************************************************************************************************/
+class LibManBench
+{
+    typedef qint64 (LibManBench::*BenchCase)();
+
+    /*!
+     * \brief The Result struct keeps samples of a single benchmark.
+     */
+    struct Result {
+        QString                         name;               /*!< Name of the benchmark. */
+        QList<qint64>                   samples;            /*!< Duration of every repetition in nanoseconds. */
+        QList<qint64>                   fsCalls;            /*!< File system calls of the last repetition per FSSHIM_CALL. */
+    };
+
+public:
+    LibManBench(const QString &projFile, const QString &workDir);
+    ~LibManBench();
+
+    void                                setGdsGenerator(const GdsGenerator &generator);
+
+    bool                                run(int repeat, const QString &filter = QString());
+    bool                                writeResults(const QString &fileName,
+                                                     const QMap<QString, QString> &config) const;
+    void                                printSummary() const;
+    void                                clearResults();
+
+    QMap<QString, QList<qint64> >       getSamples() const;
+
+    bool                                hasFsShim() const;
+
+    QStringList                         getErrors() const;
+
+    static QStringList                  getTemporaryNames();
+    static qint64                       getMedian(QList<qint64> samples);
+    static qint64                       getMad(const QList<qint64> &samples);
+
+private:
+    void                                addCase(const QString &name, BenchCase benchCase);
+
+    qint64                              benchCatalogLoadProject();
+    qint64                              benchCatalogScanLibraries();
+    qint64                              benchCatalogExport();
+    qint64                              benchGuiLoadProject();
+    qint64                              benchGuiLoadGroups();
+    qint64                              benchGuiLoadViews();
+    qint64                              benchGuiFilterCells();
+    qint64                              benchScriptCopyCells();
+    qint64                              benchScriptDeleteCells();
+    qint64                              benchGuiCopyDir();
+    qint64                              benchGdsCreate();
+    qint64                              benchGdsGenerate();
+    qint64                              benchGdsScan();
+
+    qint64                              runScript(const QStringList &lines);
+
+    void                                startTiming(QElapsedTimer &timer);
+    qint64                              stopTiming(const QElapsedTimer &timer);
+
+private:
+    QString                             m_projFile;         /*!< Path to the benchmarked project file. */
+    QString                             m_workDir;          /*!< Folder for temporary files. */
+    QString                             m_firstLibPath;     /*!< Path to the first library of the project. */
+    QStringList                         m_firstLibCells;    /*!< Cells of the first library. */
+
+    MainWindow                          *m_window;          /*!< Main window used by GUI benchmarks. */
+    GdsGenerator                        m_gdsGenerator;     /*!< Settings of the generated GDS stream. */
+
+    FsShimGetCount                      m_fsGetCount;       /*!< Call counter of the file system shim, NULL without it. */
+    FsShimGetName                       m_fsGetName;        /*!< Call group names of the file system shim. */
+    FsShimReset                         m_fsReset;          /*!< Resets counters of the file system shim. */
+    QList<qint64>                       m_fsCalls;          /*!< Shim counters read when the timer stopped. */
+
+    QList<QString>                      m_caseNames;        /*!< Names of the benchmarks in execution order. */
+    QList<BenchCase>                    m_cases;            /*!< Benchmarks in execution order. */
+    QList<Result>                       m_results;          /*!< Samples of executed benchmarks. */
+    QStringList                         m_errorList;        /*!< Errors of the benchmarks. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Sets generator used by the GDS stream benchmark.
+ * \param generator     Configured generator.
+ **********************************************************************************************************************/
+inline void LibManBench::setGdsGenerator(const GdsGenerator &generator)
+{
+    m_gdsGenerator = generator;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if the file system latency shim is preloaded, so file system calls are counted per benchmark.
+ **********************************************************************************************************************/
+inline bool LibManBench::hasFsShim() const
+{
+    return m_fsGetCount && m_fsGetName && m_fsReset;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns errors of the benchmarks.
+ **********************************************************************************************************************/
+inline QStringList LibManBench::getErrors() const
+{
+    return m_errorList;
+}
+
+#endif // LIBMANBENCH_H
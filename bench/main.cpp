@@ -0,0 +1,437 @@
+/*!********************************************************************************************************************
+ *  Copyright 2023 IHP LibMan Authors
+ * Licensed under the Apache License, Version 2.0 (the \"License\")
+ * you may not use this file except in compliance with the License
+ * You may obtain a copy of the License at
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an \"AS IS\" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************************************************************/
+
+#include <iostream>
+
+#include <QDir>
+#include <QMap>
+#include <QSettings>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QApplication>
+#include <QCoreApplication>
+
+#include "libmanbench.h"
+#include "benchbaseline.h"
+#include "projectgenerator.h"
+#include "gds/gdsgenerator.h"
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+//*********************************************************************************************************************
+// printUsage
+//*********************************************************************************************************************
+static void printUsage()
+{
+    cout<<"Usage: libman-bench [options]\n"
+        <<"\n"
+        <<"Project options (a synthetic project is generated unless '--project' is given):\n"
+        <<"  --project <file>        Benchmark an existing project file.\n"
+        <<"  --libraries <n>         Number of libraries (default 4).\n"
+        <<"  --cells <n>             Number of cells per library (default 100).\n"
+        <<"  --views <list>          Comma separated view types (default gds,cdl,spice,verilog).\n"
+        <<"  --size <min>[:<max>]    Size range of netlist views in bytes (default 1024:16384).\n"
+        <<"  --categories <n>        Number of categories per library (default 4).\n"
+        <<"  --category-size <n>     Number of cells per category (default 20).\n"
+        <<"  --documents <n>         Number of documents per library (default 2).\n"
+        <<"  --seed <n>              Seed of the generator (default 1).\n"
+        <<"  --generate <dir>        Only generate the project into the folder and exit.\n"
+        <<"\n"
+        <<"GDS stream options (used by 'gds.generate', 'gds.scan' and '--generate-gds'):\n"
+        <<"  --gds-depth <n>         Hierarchy levels below the top cell (default 3).\n"
+        <<"  --gds-cells <n>         Cells per hierarchy level (default 16).\n"
+        <<"  --gds-fanout <n>        References per cell (default 8).\n"
+        <<"  --gds-aref <ratio>      Share of references written as AREF (default 0.25).\n"
+        <<"  --gds-array <c>[:<r>]   Maximal AREF columns and rows (default 8:8).\n"
+        <<"  --gds-polygons <n>      Shapes per leaf cell (default 1000).\n"
+        <<"  --gds-vertices <min>[:<max>]  Vertex range of non-rectangular polygons (default 4:32).\n"
+        <<"  --gds-rectangles <ratio>  Share of rectangles among polygons (default 0.7).\n"
+        <<"  --gds-paths <ratio>     Share of paths among shapes (default 0.1).\n"
+        <<"  --gds-texts <n>         Text labels per leaf cell (default 8).\n"
+        <<"  --gds-layers <spec>     Layer mix, e.g. 1/0:4,2/0:2,10/0:1 (layer/datatype:weight).\n"
+        <<"  --gds-size <bytes>      Approximate stream size, overrides '--gds-polygons'.\n"
+        <<"  --generate-gds <file>   Only write the GDS stream into the file and exit.\n"
+        <<"\n"
+        <<"Run options:\n"
+        <<"  --repeat <n>            Number of repetitions (default 5).\n"
+        <<"  --runs <n>              Run the whole suite n times and pool the samples (default 1).\n"
+        <<"  --filter <text>         Run only benchmarks containing the text.\n"
+        <<"  --output <file>         Write JSON results into the file (default: standard output).\n"
+        <<"  --work-dir <dir>        Folder for generated and temporary files (default: system temp folder).\n"
+        <<"  --keep                  Do not remove the generated project.\n"
+        <<"                          Only files created by the run are removed from the work folder.\n"
+        <<"\n"
+        <<"Regression options:\n"
+        <<"  --baseline <file>       Compare medians against the baseline, exit with 2 if a benchmark regressed.\n"
+        <<"                          Runs of another configuration than the baseline's are refused.\n"
+        <<"  --update-baseline       Write medians and MADs of this run into the baseline file.\n";
+}
+
+//*********************************************************************************************************************
+// removeDir
+//*********************************************************************************************************************
+static void removeDir(const QString &dirName)
+{
+    QDir dir(dirName);
+
+    foreach(const QFileInfo &entry, dir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden)) {
+        if(entry.isDir() && !entry.isSymLink()) {
+            removeDir(entry.absoluteFilePath());
+        }
+        else {
+            QFile::remove(entry.absoluteFilePath());
+        }
+    }
+
+    dir.rmdir(dir.absolutePath());
+}
+
+//*********************************************************************************************************************
+// removeWorkEntries
+//*********************************************************************************************************************
+static void removeWorkEntries(const QString &workDir, const QStringList &names)
+{
+    foreach(const QString &name, names) {
+        QFileInfo entry(workDir + "/" + name);
+
+        if(entry.isDir() && !entry.isSymLink()) {
+            removeDir(entry.absoluteFilePath());
+        }
+        else if(entry.exists() || entry.isSymLink()) {
+            QFile::remove(entry.absoluteFilePath());
+        }
+    }
+}
+
+//*********************************************************************************************************************
+// configureGdsGenerator
+//*********************************************************************************************************************
+static bool configureGdsGenerator(const QMap<QString, QString> &options, GdsGenerator *generator)
+{
+    generator->setSeed(options.value("seed", "1").toUInt());
+
+    if(options.contains("gds-depth")) {
+        generator->setDepth(options["gds-depth"].toInt());
+    }
+
+    if(options.contains("gds-cells")) {
+        generator->setCellsPerLevel(options["gds-cells"].toInt());
+    }
+
+    if(options.contains("gds-fanout")) {
+        generator->setFanout(options["gds-fanout"].toInt());
+    }
+
+    if(options.contains("gds-aref")) {
+        generator->setArefRatio(options["gds-aref"].toDouble());
+    }
+
+    if(options.contains("gds-array")) {
+        QStringList array = options["gds-array"].split(":");
+        generator->setArraySize(array[0].toInt(), array.value(1, array[0]).toInt());
+    }
+
+    if(options.contains("gds-polygons")) {
+        generator->setPolygonCount(options["gds-polygons"].toInt());
+    }
+
+    if(options.contains("gds-vertices")) {
+        QStringList vertices = options["gds-vertices"].split(":");
+        generator->setVertexRange(vertices[0].toInt(), vertices.value(1, vertices[0]).toInt());
+    }
+
+    if(options.contains("gds-rectangles")) {
+        generator->setRectangleRatio(options["gds-rectangles"].toDouble());
+    }
+
+    if(options.contains("gds-paths")) {
+        generator->setPathRatio(options["gds-paths"].toDouble());
+    }
+
+    if(options.contains("gds-texts")) {
+        generator->setTextCount(options["gds-texts"].toInt());
+    }
+
+    if(options.contains("gds-size")) {
+        generator->setTargetSize(options["gds-size"].toLongLong());
+    }
+
+    if(options.contains("gds-layers")) {
+        std::vector<GdsGenerator::Layer> layers;
+        if(!GdsGenerator::parseLayers(options["gds-layers"], &layers)) {
+            cerr<<"[ERROR] Incorrect layer mix '"<<options["gds-layers"].toStdString()<<"'."<<endl;
+            return false;
+        }
+
+        generator->setLayers(layers);
+    }
+
+    return true;
+}
+
+//*********************************************************************************************************************
+// main
+//*********************************************************************************************************************
+int main(int argc, char *argv[])
+{
+    QApplication a(argc, argv);
+
+    QStringList arguments = a.arguments().mid(1);
+
+    QMap<QString, QString> options;
+    options["libraries"] = "4";
+    options["cells"] = "100";
+    options["views"] = "gds,cdl,spice,verilog";
+    options["size"] = "1024:16384";
+    options["categories"] = "4";
+    options["category-size"] = "20";
+    options["documents"] = "2";
+    options["seed"] = "1";
+    options["repeat"] = "5";
+
+    // Options taking a value, any other option is rejected.
+    QStringList valueOptions;
+    valueOptions<<"project"<<"libraries"<<"cells"<<"views"<<"size"<<"categories"<<"category-size"<<"documents"
+                <<"seed"<<"generate"<<"gds-depth"<<"gds-cells"<<"gds-fanout"<<"gds-aref"<<"gds-array"
+                <<"gds-polygons"<<"gds-vertices"<<"gds-rectangles"<<"gds-paths"<<"gds-texts"<<"gds-layers"
+                <<"gds-size"<<"generate-gds"<<"repeat"<<"runs"<<"filter"<<"output"<<"work-dir"<<"baseline";
+
+    bool keep = false;
+    bool updateBaseline = false;
+
+    for(int i = 0; i < arguments.count(); ++i) {
+        QString key = arguments[i];
+
+        if(key == "-h" || key == "--help") {
+            printUsage();
+            return 0;
+        }
+        else if(key == "--keep") {
+            keep = true;
+        }
+        else if(key == "--update-baseline") {
+            updateBaseline = true;
+        }
+        else if(key.startsWith("--") && valueOptions.contains(key.mid(2)) && i + 1 < arguments.count()) {
+            options[key.mid(2)] = arguments[++i];
+        }
+        else {
+            cerr<<"[ERROR] Incorrect input argument '"<<key.toStdString()<<"'."<<endl;
+            return 1;
+        }
+    }
+
+    GdsGenerator gdsGenerator;
+    if(!configureGdsGenerator(options, &gdsGenerator)) {
+        return 1;
+    }
+
+    if(options.contains("generate-gds")) {
+        if(!gdsGenerator.generate(options["generate-gds"])) {
+            foreach(const QString &explain, gdsGenerator.getErrors()) {
+                cerr<<"[ERROR] "<<explain.toStdString()<<endl;
+            }
+
+            return 1;
+        }
+
+        cerr<<"[INFO] Generated "<<gdsGenerator.getShapeCount()<<" shapes ("<<gdsGenerator.getBytesWritten()
+            <<" bytes) in '"<<options["generate-gds"].toStdString()<<"'."<<endl;
+
+        return 0;
+    }
+
+    QString workDir = options.value("work-dir");
+    if(workDir.isEmpty()) {
+        workDir = QDir::tempPath() + QString("/libman-bench-%1").arg(QCoreApplication::applicationPid());
+    }
+
+    workDir = QDir(workDir).absolutePath();
+
+    // Only what the benchmark creates is removed at the end, files of the user in the work folder are kept.
+    bool isWorkDirCreated = !QFileInfo(workDir).exists();
+    QDir().mkpath(workDir);
+
+    QStringList workEntries;
+    workEntries<<"settings"<<"project"<<LibManBench::getTemporaryNames();
+
+    QStringList createdEntries;
+    foreach(const QString &name, workEntries) {
+        if(!QFileInfo(workDir + "/" + name).exists()) {
+            createdEntries<<name;
+        }
+    }
+
+    bool isProjectGenerated = options.value("project").isEmpty() && options.value("generate").isEmpty();
+    if(isProjectGenerated && !createdEntries.contains("project")) {
+        cerr<<"[ERROR] Folder '"<<QDir::toNativeSeparators(workDir + "/project").toStdString()
+            <<"' already exists. Please use another '--work-dir'."<<endl;
+        return 1;
+    }
+
+    if(!isProjectGenerated) {
+        createdEntries.removeAll("project");
+    }
+
+    // Recent projects and tool settings of the user must not be touched by the benchmarks.
+    QSettings::setPath(QSettings::NativeFormat, QSettings::UserScope, workDir + "/settings");
+    QSettings::setPath(QSettings::IniFormat, QSettings::UserScope, workDir + "/settings");
+
+    QString projFile = options.value("project");
+    QString generateDir = options.value("generate");
+    bool generated = false;
+
+    if(projFile.isEmpty()) {
+        QStringList size = options["size"].split(":");
+
+        ProjectGenerator generator;
+        generator.setLibraryCount(options["libraries"].toInt());
+        generator.setCellCount(options["cells"].toInt());
+        generator.setViews(options["views"].split(","));
+        generator.setViewSize(size[0].toLongLong(), size.value(1, size[0]).toLongLong());
+        generator.setCategoryCount(options["categories"].toInt());
+        generator.setCategorySize(options["category-size"].toInt());
+        generator.setDocumentCount(options["documents"].toInt());
+        generator.setSeed(options["seed"].toUInt());
+
+        QString projectDir = generateDir.isEmpty() ? workDir + "/project" : generateDir;
+        if(!generator.generate(projectDir)) {
+            foreach(const QString &explain, generator.getErrors()) {
+                cerr<<"[ERROR] "<<explain.toStdString()<<endl;
+            }
+
+            return 1;
+        }
+
+        cerr<<"[INFO] Generated "<<generator.getFileCount()<<" files ("<<generator.getByteCount()<<" bytes) in '"
+            <<QDir::toNativeSeparators(projectDir).toStdString()<<"'."<<endl;
+
+        if(!generateDir.isEmpty()) {
+            removeWorkEntries(workDir, createdEntries);
+            if(isWorkDirCreated) {
+                QDir().rmdir(workDir);
+            }
+
+            return 0;
+        }
+
+        projFile = generator.getProjectFile();
+        generated = true;
+    }
+
+    QString baselineFile = options.value("baseline");
+    if(updateBaseline && baselineFile.isEmpty()) {
+        cerr<<"[ERROR] '--update-baseline' requires '--baseline <file>'."<<endl;
+        return 1;
+    }
+
+    BenchBaseline baseline;
+    if(!baselineFile.isEmpty() && !baseline.load(baselineFile)) {
+        foreach(const QString &explain, baseline.getErrors()) {
+            cerr<<"[ERROR] "<<explain.toStdString()<<endl;
+        }
+
+        return 1;
+    }
+
+    LibManBench bench(projFile, workDir);
+    bench.setGdsGenerator(gdsGenerator);
+
+    QMap<QString, QString> config = options;
+    config.remove("output");
+    config.remove("work-dir");
+    config.remove("baseline");
+    config["project"] = generated ? QString("generated") : projFile;
+
+    if(bench.hasFsShim()) {
+        config["fs_prefix"] = QString::fromLocal8Bit(qgetenv("LIBMAN_FS_PREFIX"));
+        config["fs_latency_us"] = QString::fromLocal8Bit(qgetenv("LIBMAN_FS_LATENCY_US"));
+    }
+
+    // Medians of another workload say nothing, so the suite is not even run.
+    if(!updateBaseline && !baselineFile.isEmpty() && !baseline.isComparable(config)) {
+        foreach(const QString &explain, baseline.getErrors()) {
+            cerr<<"[ERROR] "<<explain.toStdString()<<endl;
+        }
+
+        if(!keep) {
+            removeWorkEntries(workDir, createdEntries);
+            if(isWorkDirCreated) {
+                QDir().rmdir(workDir);
+            }
+        }
+
+        return 1;
+    }
+
+    int runs = qMax(1, options.value("runs", "1").toInt());
+    bool isDone = true;
+
+    // Separate runs catch slow phases of the machine which a single run of repetitions would take for the norm.
+    for(int run = 0; run < runs && isDone; ++run) {
+        if(runs > 1) {
+            cerr<<"[INFO] Run "<<run + 1<<" of "<<runs<<"."<<endl;
+        }
+
+        isDone = bench.run(options["repeat"].toInt(), options.value("filter"));
+    }
+
+    bool isRegressed = false;
+
+    foreach(const QString &explain, bench.getErrors()) {
+        cerr<<"[ERROR] "<<explain.toStdString()<<endl;
+    }
+
+    if(isDone) {
+        bench.printSummary();
+
+        if(!bench.writeResults(options.value("output"), config)) {
+            cerr<<"[ERROR] Can not write results to '"<<options.value("output").toStdString()<<"'."<<endl;
+            isDone = false;
+        }
+
+        if(updateBaseline) {
+            if(baseline.save(baselineFile, bench.getSamples(), config)) {
+                cerr<<"[INFO] Baseline written to '"<<baselineFile.toStdString()<<"'."<<endl;
+            }
+            else {
+                foreach(const QString &explain, baseline.getErrors()) {
+                    cerr<<"[ERROR] "<<explain.toStdString()<<endl;
+                }
+
+                isDone = false;
+            }
+        }
+        else if(!baselineFile.isEmpty()) {
+            QTextStream out(stderr);
+            out<<"\n";
+
+            isRegressed = !baseline.compare(bench.getSamples(), out);
+        }
+    }
+
+    if(!keep) {
+        removeWorkEntries(workDir, createdEntries);
+        if(isWorkDirCreated) {
+            QDir().rmdir(workDir);
+        }
+    }
+
+    if(!isDone) {
+        return 1;
+    }
+
+    return isRegressed ? 2 : 0;
+}
@@ -0,0 +1,309 @@
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+
+#include "catalog.h"
+#include "projectgenerator.h"
+#include "gds/gdsreader.h"
+
+/*!*********************************************************************************************************************
+ * \brief Constructs ProjectGenerator object with a small default project.
+ **********************************************************************************************************************/
+ProjectGenerator::ProjectGenerator()
+    : m_libraryCount(4),
+      m_cellCount(100),
+      m_views(Catalog::getValidViewList()),
+      m_minSize(1024),
+      m_maxSize(16 * 1024),
+      m_categoryCount(4),
+      m_categorySize(20),
+      m_documentCount(2),
+      m_seed(1),
+      m_state(1),
+      m_fileCount(0),
+      m_byteCount(0)
+{
+}
+
+/*!*********************************************************************************************************************
+ * \brief Sets number of libraries.
+ * \param count         Number of libraries.
+ **********************************************************************************************************************/
+void ProjectGenerator::setLibraryCount(int count)
+{
+    m_libraryCount = count;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Sets number of cells per library.
+ * \param count         Number of cells.
+ **********************************************************************************************************************/
+void ProjectGenerator::setCellCount(int count)
+{
+    m_cellCount = count;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Sets view types created for every cell.
+ * \param views         Names of the view types (gds, cdl, spice, verilog).
+ **********************************************************************************************************************/
+void ProjectGenerator::setViews(const QStringList &views)
+{
+    m_views = views;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Sets size range of text views. Layout views are always created as an empty cell structure.
+ * \param minSize       Minimal size in bytes.
+ * \param maxSize       Maximal size in bytes.
+ **********************************************************************************************************************/
+void ProjectGenerator::setViewSize(qint64 minSize, qint64 maxSize)
+{
+    m_minSize = qMin(minSize, maxSize);
+    m_maxSize = qMax(minSize, maxSize);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Sets number of categories per library.
+ * \param count         Number of categories.
+ **********************************************************************************************************************/
+void ProjectGenerator::setCategoryCount(int count)
+{
+    m_categoryCount = count;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Sets number of cells listed in every category.
+ * \param size          Number of cells.
+ **********************************************************************************************************************/
+void ProjectGenerator::setCategorySize(int size)
+{
+    m_categorySize = size;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Sets number of documents per library.
+ * \param count         Number of documents.
+ **********************************************************************************************************************/
+void ProjectGenerator::setDocumentCount(int count)
+{
+    m_documentCount = count;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Sets seed of the pseudo random generator.
+ * \param seed          Seed, 0 is replaced by 1.
+ **********************************************************************************************************************/
+void ProjectGenerator::setSeed(quint32 seed)
+{
+    m_seed = seed ? seed : 1;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns name of the generated library.
+ * \param index         Index of the library.
+ **********************************************************************************************************************/
+QString ProjectGenerator::getLibraryName(int index)
+{
+    return QString("lib_%1").arg(index, 4, 10, QChar('0'));
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns name of the generated cell.
+ * \param index         Index of the cell.
+ **********************************************************************************************************************/
+QString ProjectGenerator::getCellName(int index)
+{
+    return QString("cell_%1").arg(index, 6, 10, QChar('0'));
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns names of the generated libraries.
+ **********************************************************************************************************************/
+QStringList ProjectGenerator::getLibraryNames() const
+{
+    QStringList libNames;
+    for(int i = 0; i < m_libraryCount; ++i) {
+        libNames<<getLibraryName(i);
+    }
+
+    return libNames;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Creates the project in the folder. Existing files with the same names are replaced.
+ * \param rootDir       Folder where libraries and the project file are created.
+ * \return              True on success, otherwise false and the reasons are added to the error list.
+ **********************************************************************************************************************/
+bool ProjectGenerator::generate(const QString &rootDir)
+{
+    m_state = m_seed;
+    m_fileCount = 0;
+    m_byteCount = 0;
+    m_errorList.clear();
+
+    QString rootPath = QDir(rootDir).absolutePath();
+    if(!QDir().mkpath(rootPath)) {
+        m_errorList<<QString("Can not create folder '%1'.").arg(rootPath);
+        return false;
+    }
+
+    Catalog catalog;
+
+    for(int lib = 0; lib < m_libraryCount; ++lib) {
+        QString libName = getLibraryName(lib);
+        QString libPath = QDir::toNativeSeparators(rootPath + "/" + libName);
+
+        foreach(const QString &viewName, m_views) {
+            QDir().mkpath(QDir::toNativeSeparators(libPath + "/" + viewName));
+        }
+
+        for(int cell = 0; cell < m_cellCount; ++cell) {
+            QString cellName = getCellName(cell);
+            foreach(const QString &viewName, m_views) {
+                if(!writeView(Catalog::getViewPath(libPath, cellName, viewName), cellName, viewName)) {
+                    return false;
+                }
+            }
+        }
+
+        for(int cat = 0; cat < m_categoryCount && m_cellCount > 0; ++cat) {
+            QByteArray content;
+            for(int i = 0; i < m_categorySize; ++i) {
+                content += getCellName(random() % m_cellCount).toLatin1() + "\n";
+            }
+
+            QString catPath = QDir::toNativeSeparators(libPath + QString("/cat_%1.group").arg(cat, 2, 10, QChar('0')));
+            if(!writeText(catPath, content, 0, QByteArray())) {
+                return false;
+            }
+        }
+
+        if(m_documentCount > 0) {
+            QDir().mkpath(QDir::toNativeSeparators(libPath + "/doc"));
+        }
+
+        for(int doc = 0; doc < m_documentCount; ++doc) {
+            QString docPath = QDir::toNativeSeparators(libPath + QString("/doc/readme_%1.txt").arg(doc, 2, 10, QChar('0')));
+            if(!writeText(docPath, QByteArray("Synthetic library ") + libName.toLatin1() + "\n", randomSize(),
+                          QByteArray())) {
+                return false;
+            }
+        }
+
+        catalog.setLibrary(libName, libPath);
+    }
+
+    if(m_libraryCount > 1) {
+        catalog.setCombinedLib("all_libs", getLibraryNames());
+    }
+
+    m_projFile = QDir::toNativeSeparators(rootPath + "/bench.projects");
+    if(!catalog.saveProjectFile(m_projFile)) {
+        m_errorList<<catalog.getErrors();
+        return false;
+    }
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Writes a view file. Netlist views get a subcircuit (module) with device (instance) lines up to a random size.
+ * \param viewPath      Path to the view.
+ * \param cellName      Name of the cell.
+ * \param viewName      Type of the view.
+ **********************************************************************************************************************/
+bool ProjectGenerator::writeView(const QString &viewPath, const QString &cellName, const QString &viewName)
+{
+    QByteArray name = cellName.toLatin1();
+
+    if(viewName == "gds") {
+        GdsReader gdsReader(viewPath);
+        gdsReader.gdsCreate(cellName);
+
+        if(gdsReader.getErrors().count() || !QFileInfo(viewPath).exists()) {
+            m_errorList<<QString("Can not create view '%1'.").arg(viewPath);
+            m_errorList<<gdsReader.getErrors();
+            return false;
+        }
+
+        m_fileCount++;
+        m_byteCount += QFileInfo(viewPath).size();
+
+        return true;
+    }
+    else if(viewName == "verilog") {
+        return writeText(viewPath, "module " + name + " (A, B, Y);\n  input A, B;\n  output Y;\n", randomSize(),
+                         "endmodule\n");
+    }
+
+    return writeText(viewPath, ".SUBCKT " + name + " A B Y VDD VSS\n", randomSize(), ".ENDS " + name + "\n");
+}
+
+/*!*********************************************************************************************************************
+ * \brief Writes a text file of about the requested size. Space between head and tail is filled with device lines.
+ * \param filePath      Path to the file.
+ * \param head          First lines of the file.
+ * \param size          Requested size in bytes.
+ * \param tail          Last lines of the file.
+ **********************************************************************************************************************/
+bool ProjectGenerator::writeText(const QString &filePath, const QByteArray &head, qint64 size, const QByteArray &tail)
+{
+    QFile file(filePath);
+    if(!file.open(QIODevice::WriteOnly)) {
+        m_errorList<<QString("Can not write to file '%1':\n%2.").arg(filePath).arg(file.errorString());
+        return false;
+    }
+
+    QByteArray content = head;
+    content.reserve(int(qMax(size, qint64(head.size() + tail.size()))) + 64);
+
+    bool isVerilog = tail.startsWith("endmodule");
+    for(int i = 0; content.size() + tail.size() < size; ++i) {
+        if(isVerilog) {
+            content += "  NAND2 u" + QByteArray::number(i) + " (.A(A), .B(n" + QByteArray::number(random() % 64)
+                     + "), .Y(n" + QByteArray::number(i) + "));\n";
+        }
+        else {
+            content += "M" + QByteArray::number(i) + " n" + QByteArray::number(random() % 64) + " A VSS VSS nmos W="
+                     + QByteArray::number(1 + random() % 20) + "u L=0.13u\n";
+        }
+    }
+
+    content += tail;
+
+    if(file.write(content) != content.size()) {
+        m_errorList<<QString("Can not write to file '%1':\n%2.").arg(filePath).arg(file.errorString());
+        return false;
+    }
+
+    file.close();
+
+    m_fileCount++;
+    m_byteCount += content.size();
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns the next value of the xorshift32 pseudo random generator.
+ **********************************************************************************************************************/
+quint32 ProjectGenerator::random()
+{
+    m_state ^= m_state << 13;
+    m_state ^= m_state >> 17;
+    m_state ^= m_state << 5;
+
+    return m_state;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns random size of a text file within the configured range.
+ **********************************************************************************************************************/
+qint64 ProjectGenerator::randomSize()
+{
+    qint64 range = m_maxSize - m_minSize + 1;
+
+    return m_minSize + qint64(random()) % range;
+}
@@ -0,0 +1,96 @@
+#ifndef PROJECTGENERATOR_H
+#define PROJECTGENERATOR_H
+
+#include <QString>
+#include <QStringList>
+
+/*!*********************************************************************************************************************
+ * \brief The ProjectGenerator class creates synthetic LibMan projects for benchmarks: N libraries with M cells each,
+ * the requested view types with file sizes drawn from a range, category files and documents. The content depends on
+ * the seed only, so two runs with the same parameters create identical projects.
+ **********************************************************************************************************************/
+class ProjectGenerator
+{
+public:
+    ProjectGenerator();
+
+    void                                setLibraryCount(int count);
+    void                                setCellCount(int count);
+    void                                setViews(const QStringList &views);
+    void                                setViewSize(qint64 minSize, qint64 maxSize);
+    void                                setCategoryCount(int count);
+    void                                setCategorySize(int size);
+    void                                setDocumentCount(int count);
+    void                                setSeed(quint32 seed);
+
+    bool                                generate(const QString &rootDir);
+
+    QString                             getProjectFile() const;
+    QStringList                         getLibraryNames() const;
+    qint64                              getFileCount() const;
+    qint64                              getByteCount() const;
+    QStringList                         getErrors() const;
+
+    static QString                      getLibraryName(int index);
+    static QString                      getCellName(int index);
+
+private:
+    quint32                             random();
+    qint64                              randomSize();
+
+    bool                                writeView(const QString &viewPath, const QString &cellName,
+                                                  const QString &viewName);
+    bool                                writeText(const QString &filePath, const QByteArray &head, qint64 size,
+                                                  const QByteArray &tail);
+
+private:
+    int                                 m_libraryCount;     /*!< Number of libraries. */
+    int                                 m_cellCount;        /*!< Number of cells per library. */
+    QStringList                         m_views;            /*!< View types created for every cell. */
+    qint64                              m_minSize;          /*!< Minimal size of a text view in bytes. */
+    qint64                              m_maxSize;          /*!< Maximal size of a text view in bytes. */
+    int                                 m_categoryCount;    /*!< Number of categories per library. */
+    int                                 m_categorySize;     /*!< Number of cells per category. */
+    int                                 m_documentCount;    /*!< Number of documents per library. */
+    quint32                             m_seed;             /*!< Seed of the pseudo random generator. */
+    quint32                             m_state;            /*!< State of the pseudo random generator. */
+
+    QString                             m_projFile;         /*!< Path to the generated project file. */
+    qint64                              m_fileCount;        /*!< Number of generated files. */
+    qint64                              m_byteCount;        /*!< Number of generated bytes. */
+    QStringList                         m_errorList;        /*!< Errors of the last generation. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Returns path to the generated project file.
+ **********************************************************************************************************************/
+inline QString ProjectGenerator::getProjectFile() const
+{
+    return m_projFile;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns number of generated files.
+ **********************************************************************************************************************/
+inline qint64 ProjectGenerator::getFileCount() const
+{
+    return m_fileCount;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns number of generated bytes.
+ **********************************************************************************************************************/
+inline qint64 ProjectGenerator::getByteCount() const
+{
+    return m_byteCount;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns errors of the last generation.
+ **********************************************************************************************************************/
+inline QStringList ProjectGenerator::getErrors() const
+{
+    return m_errorList;
+}
+
+#endif // PROJECTGENERATOR_H
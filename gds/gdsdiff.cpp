@@ -0,0 +1,373 @@
+#include <cstring>
+
+#include <QHash>
+#include <QFile>
+
+#include "gdsdiff.h"
+#include "gdsreader.h"
+#include "gdsscanner.h"
+#include "perfcounters.h"
+
+//*********************************************************************************************************************
+// GdsFile
+//
+// Keeps a stream mapped into memory, or read at once if it can not be mapped, as long as it exists.
+//*********************************************************************************************************************
+class GdsFile
+{
+public:
+    GdsFile() : m_data(0), m_size(0) {}
+    ~GdsFile();
+
+    bool                        open(const QString &fileName, QStringList *errorList);
+
+    const unsigned char*        getData() const { return m_data; }
+    qint64                      getSize() const { return m_size; }
+
+private:
+    QFile                       m_file;
+    QByteArray                  m_content;
+    const unsigned char         *m_data;
+    qint64                      m_size;
+};
+
+//*********************************************************************************************************************
+// GdsFile::~GdsFile
+//*********************************************************************************************************************
+GdsFile::~GdsFile()
+{
+    if(m_content.isEmpty() && m_data) {
+        m_file.unmap(const_cast<unsigned char*>(m_data));
+    }
+}
+
+//*********************************************************************************************************************
+// GdsFile::open
+//*********************************************************************************************************************
+bool GdsFile::open(const QString &fileName, QStringList *errorList)
+{
+    m_file.setFileName(fileName);
+    if(!m_file.open(QIODevice::ReadOnly)) {
+        *errorList<<QString("Can not read file '%1':\n%2.").arg(fileName).arg(m_file.errorString());
+        return false;
+    }
+
+    m_size = m_file.size();
+
+    PerfCounters::add(PerfCounters::FILES_READ);
+    PerfCounters::add(PerfCounters::BYTES_READ, m_size);
+
+    m_data = m_size > 0 ? m_file.map(0, m_size) : 0;
+    if(!m_data) {
+        m_content = m_file.readAll();
+        m_data = reinterpret_cast<const unsigned char*>(m_content.constData());
+        m_size = m_content.size();
+    }
+
+    return true;
+}
+
+//*********************************************************************************************************************
+// GdsDiff::GdsDiff
+//*********************************************************************************************************************
+GdsDiff::GdsDiff()
+    : m_identicalCount(0)
+{
+}
+
+//*********************************************************************************************************************
+// GdsDiff::diff
+//
+// Structures are matched by name. Their bodies exclude BGNSTR, so changed modification times do not count.
+//*********************************************************************************************************************
+bool GdsDiff::diff(const QString &oldFile, const QString &newFile)
+{
+    m_changes.clear();
+    m_identicalCount = 0;
+    m_errorList.clear();
+
+    GdsFile oldGds;
+    GdsFile newGds;
+
+    bool isOpen = oldGds.open(oldFile, &m_errorList);
+    isOpen = newGds.open(newFile, &m_errorList) && isOpen;
+
+    if(!isOpen) {
+        return false;
+    }
+
+    GdsScanner oldScanner;
+    GdsScanner newScanner;
+
+    bool isScanned = oldScanner.scan(oldGds.getData(), oldGds.getSize(), oldFile);
+    isScanned = newScanner.scan(newGds.getData(), newGds.getSize(), newFile) && isScanned;
+
+    if(!isScanned) {
+        m_errorList<<oldScanner.getErrors()<<newScanner.getErrors();
+        return false;
+    }
+
+    QList<GdsScanner::Structure> oldStructures = oldScanner.getStructures();
+    QList<GdsScanner::Structure> newStructures = newScanner.getStructures();
+
+    QHash<QString, int> oldIds;
+    for(int i = 0; i < oldStructures.count(); ++i) {
+        oldIds.insert(oldStructures[i].name, i);
+    }
+
+    QHash<QString, int> newIds;
+    for(int i = 0; i < newStructures.count(); ++i) {
+        newIds.insert(newStructures[i].name, i);
+    }
+
+    foreach(const GdsScanner::Structure &structure, oldStructures) {
+        if(!newIds.contains(structure.name)) {
+            addChange(structure.name, "removed", "", "");
+        }
+    }
+
+    foreach(const GdsScanner::Structure &structure, newStructures) {
+        QHash<QString, int>::const_iterator it = oldIds.constFind(structure.name);
+        if(it == oldIds.constEnd()) {
+            addChange(structure.name, "added", "", "");
+            continue;
+        }
+
+        const GdsScanner::Structure &oldStructure = oldStructures[it.value()];
+        const unsigned char *oldData = oldGds.getData() + oldStructure.offset;
+        const unsigned char *newData = newGds.getData() + structure.offset;
+
+        if(oldStructure.length == structure.length && std::memcmp(oldData, newData, structure.length) == 0) {
+            m_identicalCount++;
+            continue;
+        }
+
+        compare(structure.name, oldData, oldStructure.length, newData, structure.length);
+    }
+
+    return true;
+}
+
+//*********************************************************************************************************************
+// GdsDiff::getColumns
+//*********************************************************************************************************************
+QStringList GdsDiff::getColumns()
+{
+    return QStringList()<<"structure"<<"change"<<"element"<<"detail";
+}
+
+//*********************************************************************************************************************
+// GdsDiff::compare
+//
+// Elements are compared as multisets of their records, so moving an element within the structure is no change.
+//*********************************************************************************************************************
+void GdsDiff::compare(const QString &name, const unsigned char *oldData, qint64 oldSize,
+                      const unsigned char *newData, qint64 newSize)
+{
+    QList<QByteArray> oldElements = getElements(oldData, oldSize);
+    QList<QByteArray> newElements = getElements(newData, newSize);
+
+    QHash<QByteArray, int> oldCounts;
+    foreach(const QByteArray &element, oldElements) {
+        oldCounts[element]++;
+    }
+
+    QHash<QByteArray, int> newCounts;
+    foreach(const QByteArray &element, newElements) {
+        newCounts[element]++;
+    }
+
+    int count = m_changes.count();
+
+    foreach(const QByteArray &element, oldElements) {
+        int &found = newCounts[element];
+        if(found > 0) {
+            found--;
+        }
+        else {
+            addChange(name, "removed", getType(element), describe(element));
+        }
+    }
+
+    foreach(const QByteArray &element, newElements) {
+        int &found = oldCounts[element];
+        if(found > 0) {
+            found--;
+        }
+        else {
+            addChange(name, "added", getType(element), describe(element));
+        }
+    }
+
+    if(m_changes.count() == count) {
+        addChange(name, "changed", "", "element order or records outside of elements");
+    }
+}
+
+//*********************************************************************************************************************
+// GdsDiff::addChange
+//*********************************************************************************************************************
+void GdsDiff::addChange(const QString &structure, const QString &change, const QString &element,
+                        const QString &detail)
+{
+    m_changes<<(QStringList()<<structure<<change<<element<<detail);
+}
+
+//*********************************************************************************************************************
+// GdsDiff::getElements
+//
+// Returns the records of every element, from its type record up to ENDEL. The arrays share the data, which has to
+// exist as long as they are used.
+//*********************************************************************************************************************
+QList<QByteArray> GdsDiff::getElements(const unsigned char *data, qint64 size)
+{
+    QList<QByteArray> elements;
+
+    qint64 start = -1;
+    qint64 offset = 0;
+
+    while(offset + 4 <= size) {
+        const unsigned char *record = data + offset;
+
+        int length = (record[0] << 8) | record[1];
+        int type = (record[2] << 8) | record[3];
+
+        // GdsScanner has checked the records of the structure.
+        if(length < 4) {
+            break;
+        }
+
+        switch(type) {
+        case GDS_BOUNDARY:
+        case GDS_PATH:
+        case GDS_SREF:
+        case GDS_AREF:
+        case GDS_TEXT:
+        case GDS_NODE:
+        case GDS_BOX:
+            start = offset;
+            break;
+
+        case GDS_ENDEL:
+            if(start >= 0) {
+                elements<<QByteArray::fromRawData(reinterpret_cast<const char*>(data + start), offset + length - start);
+                start = -1;
+            }
+            break;
+
+        default:
+            break;
+        }
+
+        offset += length;
+    }
+
+    return elements;
+}
+
+//*********************************************************************************************************************
+// GdsDiff::getType
+//*********************************************************************************************************************
+QString GdsDiff::getType(const QByteArray &element)
+{
+    int type = (static_cast<unsigned char>(element[2]) << 8) | static_cast<unsigned char>(element[3]);
+
+    switch(type) {
+    case GDS_BOUNDARY:
+        return "BOUNDARY";
+    case GDS_PATH:
+        return "PATH";
+    case GDS_SREF:
+        return "SREF";
+    case GDS_AREF:
+        return "AREF";
+    case GDS_TEXT:
+        return "TEXT";
+    case GDS_NODE:
+        return "NODE";
+    case GDS_BOX:
+        return "BOX";
+    default:
+        return "";
+    }
+}
+
+//*********************************************************************************************************************
+// GdsDiff::describe
+//
+// Returns layer and type, referenced structure, text and the first point of the element in database units.
+//*********************************************************************************************************************
+QString GdsDiff::describe(const QByteArray &element)
+{
+    const unsigned char *data = reinterpret_cast<const unsigned char*>(element.constData());
+    qint64 size = element.size();
+    qint64 offset = 0;
+
+    int layer = -1;
+    int dataType = -1;
+    QStringList items;
+
+    while(offset + 4 <= size) {
+        const unsigned char *record = data + offset;
+        const unsigned char *values = record + 4;
+
+        int length = (record[0] << 8) | record[1];
+        int type = (record[2] << 8) | record[3];
+
+        if(length < 4) {
+            break;
+        }
+
+        int valueLength = length - 4;
+
+        switch(type) {
+        case GDS_LAYER:
+            if(valueLength >= 2) {
+                layer = static_cast<qint16>((values[0] << 8) | values[1]);
+            }
+            break;
+
+        case GDS_DATATYPE:
+        case GDS_TEXTTYPE:
+        case GDS_NODETYPE:
+        case GDS_BOXTYPE:
+            if(valueLength >= 2) {
+                dataType = static_cast<qint16>((values[0] << 8) | values[1]);
+            }
+            break;
+
+        case GDS_SNAME:
+        case GDS_STRING: {
+            int stringLength = valueLength;
+            while(stringLength > 0 && values[stringLength - 1] == 0) {
+                stringLength--;
+            }
+
+            items<<QString("'%1'").arg(QString::fromLatin1(reinterpret_cast<const char*>(values), stringLength));
+            break;
+        }
+
+        case GDS_XY:
+            if(valueLength >= 8) {
+                qint32 x = static_cast<qint32>((quint32(values[0]) << 24) | (values[1] << 16) | (values[2] << 8) |
+                                               values[3]);
+                qint32 y = static_cast<qint32>((quint32(values[4]) << 24) | (values[5] << 16) | (values[6] << 8) |
+                                               values[7]);
+
+                items<<QString("at %1,%2").arg(x).arg(y);
+            }
+            break;
+
+        default:
+            break;
+        }
+
+        offset += length;
+    }
+
+    if(layer >= 0) {
+        items.prepend(dataType >= 0 ? QString("%1/%2").arg(layer).arg(dataType) : QString::number(layer));
+    }
+
+    return items.join(" ");
+}
@@ -0,0 +1,69 @@
+#ifndef GDSDIFF_H
+#define GDSDIFF_H
+
+#include <QList>
+#include <QString>
+#include <QByteArray>
+#include <QStringList>
+
+//*********************************************************************************************************************
+// GdsDiff
+//
+// Compares two versions of a GDSII stream structure by structure. Both files are memory mapped and scanned by
+// GdsScanner; structures whose bodies are equal byte by byte are skipped, the others are split into elements which
+// are matched by their records, so only added and removed elements are reported.
+//*********************************************************************************************************************
+class GdsDiff
+{
+public:
+    GdsDiff();
+
+    bool                        diff(const QString &oldFile, const QString &newFile);
+
+    QList<QStringList>          getChanges() const;
+    int                         getIdenticalCount() const;
+    QStringList                 getErrors() const;
+
+    static QStringList          getColumns();
+
+private:
+    void                        compare(const QString &name, const unsigned char *oldData, qint64 oldSize,
+                                        const unsigned char *newData, qint64 newSize);
+    void                        addChange(const QString &structure, const QString &change, const QString &element,
+                                          const QString &detail);
+
+    static QList<QByteArray>    getElements(const unsigned char *data, qint64 size);
+    static QString              getType(const QByteArray &element);
+    static QString              describe(const QByteArray &element);
+
+private:
+    QList<QStringList>          m_changes;
+    int                         m_identicalCount;
+    QStringList                 m_errorList;
+};
+
+//*********************************************************************************************************************
+// GdsDiff::getChanges()
+//*********************************************************************************************************************
+inline QList<QStringList> GdsDiff::getChanges() const
+{
+    return m_changes;
+}
+
+//*********************************************************************************************************************
+// GdsDiff::getIdenticalCount()
+//*********************************************************************************************************************
+inline int GdsDiff::getIdenticalCount() const
+{
+    return m_identicalCount;
+}
+
+//*********************************************************************************************************************
+// GdsDiff::getErrors()
+//*********************************************************************************************************************
+inline QStringList GdsDiff::getErrors() const
+{
+    return m_errorList;
+}
+
+#endif // GDSDIFF_H
@@ -0,0 +1,500 @@
+#include <climits>
+#include <cstdio>
+
+#include "gdsgenerator.h"
+#include "gdswriter.h"
+
+//*********************************************************************************************************************
+// GdsGenerator::GdsGenerator
+//*********************************************************************************************************************
+GdsGenerator::GdsGenerator()
+    : m_seed(1),
+      m_state(1),
+      m_depth(3),
+      m_cellsPerLevel(16),
+      m_fanout(8),
+      m_arefRatio(0.25),
+      m_maxColumns(8),
+      m_maxRows(8),
+      m_polygonCount(1000),
+      m_minVertices(4),
+      m_maxVertices(32),
+      m_rectangleRatio(0.7),
+      m_pathRatio(0.1),
+      m_textCount(8),
+      m_layerWeight(0),
+      m_cellSize(10000),
+      m_targetSize(0),
+      m_bytesWritten(0),
+      m_shapeCount(0)
+{
+    std::vector<Layer> layers;
+
+    Layer defaultLayers[] = { { 1, 0, 4 }, { 2, 0, 2 }, { 3, 0, 2 }, { 10, 0, 1 }, { 11, 0, 1 } };
+    for(unsigned int i = 0; i < sizeof(defaultLayers) / sizeof(Layer); ++i) {
+        layers.push_back(defaultLayers[i]);
+    }
+
+    setLayers(layers);
+}
+
+//*********************************************************************************************************************
+// GdsGenerator::setSeed
+//*********************************************************************************************************************
+void GdsGenerator::setSeed(unsigned int seed)
+{
+    m_seed = seed ? seed : 1;
+}
+
+//*********************************************************************************************************************
+// GdsGenerator::setDepth
+//
+// Number of levels below the top cell, level 0 holds the leaf cells.
+//*********************************************************************************************************************
+void GdsGenerator::setDepth(int depth)
+{
+    m_depth = qMax(1, depth);
+}
+
+//*********************************************************************************************************************
+// GdsGenerator::setCellsPerLevel
+//*********************************************************************************************************************
+void GdsGenerator::setCellsPerLevel(int count)
+{
+    m_cellsPerLevel = qMax(1, count);
+}
+
+//*********************************************************************************************************************
+// GdsGenerator::setFanout
+//
+// Number of references placed in every cell above the leaf level.
+//*********************************************************************************************************************
+void GdsGenerator::setFanout(int fanout)
+{
+    m_fanout = qMax(1, fanout);
+}
+
+//*********************************************************************************************************************
+// GdsGenerator::setArefRatio
+//
+// Share of references written as AREF instead of SREF, between 0 and 1.
+//*********************************************************************************************************************
+void GdsGenerator::setArefRatio(double ratio)
+{
+    m_arefRatio = qBound(0.0, ratio, 1.0);
+}
+
+//*********************************************************************************************************************
+// GdsGenerator::setArraySize
+//*********************************************************************************************************************
+void GdsGenerator::setArraySize(int maxColumns, int maxRows)
+{
+    m_maxColumns = qBound(1, maxColumns, 32767);
+    m_maxRows = qBound(1, maxRows, 32767);
+}
+
+//*********************************************************************************************************************
+// GdsGenerator::setPolygonCount
+//
+// Number of shapes in every leaf cell. Ignored if a target size is set.
+//*********************************************************************************************************************
+void GdsGenerator::setPolygonCount(int count)
+{
+    m_polygonCount = qMax(0, count);
+}
+
+//*********************************************************************************************************************
+// GdsGenerator::setVertexRange
+//
+// Vertex count of non-rectangular polygons is uniform in the range. Polygons are rectilinear, so odd counts are
+// rounded up.
+//*********************************************************************************************************************
+void GdsGenerator::setVertexRange(int minCount, int maxCount)
+{
+    m_minVertices = qBound(4, qMin(minCount, maxCount), GdsWriter::MAX_POINTS - 2);
+    m_maxVertices = qBound(4, qMax(minCount, maxCount), GdsWriter::MAX_POINTS - 2);
+}
+
+//*********************************************************************************************************************
+// GdsGenerator::setRectangleRatio
+//*********************************************************************************************************************
+void GdsGenerator::setRectangleRatio(double ratio)
+{
+    m_rectangleRatio = qBound(0.0, ratio, 1.0);
+}
+
+//*********************************************************************************************************************
+// GdsGenerator::setPathRatio
+//*********************************************************************************************************************
+void GdsGenerator::setPathRatio(double ratio)
+{
+    m_pathRatio = qBound(0.0, ratio, 1.0);
+}
+
+//*********************************************************************************************************************
+// GdsGenerator::setTextCount
+//
+// Number of text labels in every leaf cell.
+//*********************************************************************************************************************
+void GdsGenerator::setTextCount(int count)
+{
+    m_textCount = qMax(0, count);
+}
+
+//*********************************************************************************************************************
+// GdsGenerator::setLayers
+//*********************************************************************************************************************
+void GdsGenerator::setLayers(const std::vector<Layer> &layers)
+{
+    m_layers.clear();
+    m_layerWeight = 0;
+
+    for(unsigned int i = 0; i < layers.size(); ++i) {
+        if(layers[i].weight > 0) {
+            m_layers.push_back(layers[i]);
+            m_layerWeight += layers[i].weight;
+        }
+    }
+
+    if(m_layers.empty()) {
+        Layer layer = { 1, 0, 1 };
+        m_layers.push_back(layer);
+        m_layerWeight = 1;
+    }
+}
+
+//*********************************************************************************************************************
+// GdsGenerator::setCellSize
+//
+// Size of leaf cells in database units.
+//*********************************************************************************************************************
+void GdsGenerator::setCellSize(int size)
+{
+    m_cellSize = qBound(100, size, 100000000);
+}
+
+//*********************************************************************************************************************
+// GdsGenerator::setTargetSize
+//
+// Approximate size of the stream in bytes. The number of shapes per leaf cell is derived from it, 0 to use the
+// polygon count.
+//*********************************************************************************************************************
+void GdsGenerator::setTargetSize(long long bytes)
+{
+    m_targetSize = qMax(0LL, bytes);
+}
+
+//*********************************************************************************************************************
+// GdsGenerator::parseLayers
+//
+// Parses layer mix like "1/0:4,2/0:2,10/0:1" (layer/datatype:weight, datatype and weight are optional).
+//*********************************************************************************************************************
+bool GdsGenerator::parseLayers(const QString &spec, std::vector<Layer> *layers)
+{
+    layers->clear();
+
+    foreach(const QString &item, spec.split(",")) {
+        Layer layer = { 0, 0, 1 };
+
+        QStringList weightParts = item.split(":");
+        QStringList layerParts = weightParts[0].split("/");
+
+        bool ok = true;
+        layer.layer = layerParts[0].toInt(&ok);
+        if(ok && layerParts.count() > 1) {
+            layer.dataType = layerParts[1].toInt(&ok);
+        }
+
+        if(ok && weightParts.count() > 1) {
+            layer.weight = weightParts[1].toInt(&ok);
+        }
+
+        if(!ok || layer.layer < 0 || layer.layer > 32767 || layer.dataType < 0 || layer.dataType > 32767) {
+            return false;
+        }
+
+        layers->push_back(layer);
+    }
+
+    return !layers->empty();
+}
+
+//*********************************************************************************************************************
+// GdsGenerator::generate
+//*********************************************************************************************************************
+bool GdsGenerator::generate(const QString &fileName)
+{
+    m_state = m_seed;
+    m_bytesWritten = 0;
+    m_shapeCount = 0;
+    m_errorList.clear();
+
+    GdsWriter writer;
+    if(!writer.open(fileName)) {
+        m_errorList<<writer.getErrors();
+        return false;
+    }
+
+    writer.beginLibrary("SYNTH");
+
+    int polygonCount = getLeafPolygonCount();
+    for(int i = 0; i < m_cellsPerLevel; ++i) {
+        writeLeaf(&writer, i, polygonCount);
+    }
+
+    for(int level = 1; level < m_depth; ++level) {
+        for(int i = 0; i < m_cellsPerLevel; ++i) {
+            writeParent(&writer, level, i, m_cellsPerLevel, m_fanout);
+        }
+    }
+
+    writeParent(&writer, m_depth, 0, m_cellsPerLevel, m_cellsPerLevel);
+
+    writer.endLibrary();
+    writer.close();
+
+    m_bytesWritten = writer.getBytesWritten();
+    m_errorList<<writer.getErrors();
+
+    return m_errorList.isEmpty();
+}
+
+//*********************************************************************************************************************
+// GdsGenerator::getLeafPolygonCount
+//
+// Estimates shapes per leaf cell from the target size: a boundary with n points takes 28 + 8 * (n + 1) bytes.
+//*********************************************************************************************************************
+int GdsGenerator::getLeafPolygonCount() const
+{
+    if(m_targetSize <= 0) {
+        return m_polygonCount;
+    }
+
+    double vertices = m_rectangleRatio * 4 + (1.0 - m_rectangleRatio) * (m_minVertices + m_maxVertices + 1) / 2.0;
+    double shapeBytes = 28.0 + 8.0 * (vertices + 1);
+
+    long long count = (long long)(m_targetSize / (shapeBytes * m_cellsPerLevel));
+
+    return int(qBound(1LL, count, (long long)INT_MAX));
+}
+
+//*********************************************************************************************************************
+// GdsGenerator::getCellName
+//*********************************************************************************************************************
+std::string GdsGenerator::getCellName(int level, int index) const
+{
+    if(level >= m_depth) {
+        return "TOP";
+    }
+
+    char name[32];
+    snprintf(name, sizeof(name), "L%d_C%05d", level, index);
+
+    return name;
+}
+
+//*********************************************************************************************************************
+// GdsGenerator::writeLeaf
+//*********************************************************************************************************************
+void GdsGenerator::writeLeaf(GdsWriter *writer, int index, int polygonCount)
+{
+    writer->beginStructure(getCellName(0, index));
+
+    for(int i = 0; i < polygonCount; ++i) {
+        if(randomRatio() < m_pathRatio) {
+            writePath(writer);
+            continue;
+        }
+
+        int vertexCount = 4;
+        if(randomRatio() >= m_rectangleRatio) {
+            vertexCount = random(m_minVertices, m_maxVertices);
+            vertexCount += vertexCount % 2;
+        }
+
+        writePolygon(writer, vertexCount);
+    }
+
+    for(int i = 0; i < m_textCount; ++i) {
+        const Layer &layer = randomLayer();
+
+        char label[32];
+        snprintf(label, sizeof(label), "NET%d", i);
+
+        writer->text(layer.layer, 0, random(0, m_cellSize), random(0, m_cellSize), label);
+    }
+
+    writer->endStructure();
+}
+
+//*********************************************************************************************************************
+// GdsGenerator::writeParent
+//*********************************************************************************************************************
+void GdsGenerator::writeParent(GdsWriter *writer, int level, int index, int childCount, int fanout)
+{
+    static const int angles[] = { 0, 90, 180, 270 };
+
+    // Parents are four times larger than their children, limited to keep coordinates in 32 bits.
+    long long childSize = m_cellSize;
+    for(int i = 1; i < level && childSize < 100000000; ++i) {
+        childSize *= 4;
+    }
+
+    int pitch = int(childSize);
+    int extent = int(qMin(childSize * 4, 400000000LL));
+
+    writer->beginStructure(getCellName(level, index));
+
+    for(int i = 0; i < fanout; ++i) {
+        std::string childName = getCellName(level - 1, fanout == childCount ? i : random(0, childCount - 1));
+        int x = random(0, extent);
+        int y = random(0, extent);
+
+        if(randomRatio() < m_arefRatio) {
+            int columns = random(1, m_maxColumns);
+            int rows = random(1, m_maxRows);
+            long long maxPitch = 1000000000LL / qMax(columns, rows);
+
+            writer->aref(childName, columns, rows, x, y, int(qMin((long long)pitch, maxPitch)),
+                         int(qMin((long long)pitch, maxPitch)));
+        }
+        else {
+            writer->sref(childName, x, y, angles[random() % 4], random() % 8 == 0);
+        }
+    }
+
+    writer->endStructure();
+}
+
+//*********************************************************************************************************************
+// GdsGenerator::writePolygon
+//
+// Writes rectilinear histogram polygon: (n - 2) / 2 bars of random width and height standing on a common base line.
+// Neighbouring bars have different heights, so there are no collinear points.
+//*********************************************************************************************************************
+void GdsGenerator::writePolygon(GdsWriter *writer, int vertexCount)
+{
+    const Layer &layer = randomLayer();
+
+    int bars = (vertexCount - 2) / 2;
+    int unit = qMax(1, m_cellSize / (bars * 4 + 4));
+
+    int x0 = random(0, m_cellSize / 2);
+    int y0 = random(0, m_cellSize / 2);
+
+    std::vector<int> &xy = m_points;
+    xy.clear();
+
+    std::vector<int> xs(bars + 1);
+    std::vector<int> heights(bars);
+
+    xs[0] = x0;
+    for(int i = 0; i < bars; ++i) {
+        xs[i + 1] = xs[i] + unit * random(1, 2);
+
+        heights[i] = unit * random(1, 8);
+        if(i && heights[i] == heights[i - 1]) {
+            heights[i] += unit;
+        }
+    }
+
+    xy.push_back(x0);
+    xy.push_back(y0);
+    xy.push_back(xs[bars]);
+    xy.push_back(y0);
+
+    for(int i = bars - 1; i >= 0; --i) {
+        xy.push_back(xs[i + 1]);
+        xy.push_back(y0 + heights[i]);
+        xy.push_back(xs[i]);
+        xy.push_back(y0 + heights[i]);
+    }
+
+    writer->boundary(layer.layer, layer.dataType, &xy[0], int(xy.size() / 2));
+
+    m_shapeCount++;
+}
+
+//*********************************************************************************************************************
+// GdsGenerator::writePath
+//*********************************************************************************************************************
+void GdsGenerator::writePath(GdsWriter *writer)
+{
+    const Layer &layer = randomLayer();
+
+    int pointCount = random(2, 8);
+    int width = 10 * random(1, 10);
+
+    std::vector<int> &xy = m_points;
+    xy.clear();
+
+    int x = random(0, m_cellSize);
+    int y = random(0, m_cellSize);
+
+    for(int i = 0; i < pointCount; ++i) {
+        xy.push_back(x);
+        xy.push_back(y);
+
+        if(i % 2) {
+            y = random(0, m_cellSize);
+        }
+        else {
+            x = random(0, m_cellSize);
+        }
+    }
+
+    writer->path(layer.layer, layer.dataType, width, &xy[0], pointCount);
+
+    m_shapeCount++;
+}
+
+//*********************************************************************************************************************
+// GdsGenerator::randomLayer
+//*********************************************************************************************************************
+const GdsGenerator::Layer& GdsGenerator::randomLayer()
+{
+    int value = random() % m_layerWeight;
+
+    for(unsigned int i = 0; i < m_layers.size(); ++i) {
+        value -= m_layers[i].weight;
+        if(value < 0) {
+            return m_layers[i];
+        }
+    }
+
+    return m_layers.back();
+}
+
+//*********************************************************************************************************************
+// GdsGenerator::random
+//
+// Returns the next value of the xorshift32 pseudo random generator.
+//*********************************************************************************************************************
+unsigned int GdsGenerator::random()
+{
+    m_state ^= m_state << 13;
+    m_state ^= m_state >> 17;
+    m_state ^= m_state << 5;
+
+    return m_state;
+}
+
+//*********************************************************************************************************************
+// GdsGenerator::random
+//*********************************************************************************************************************
+int GdsGenerator::random(int minValue, int maxValue)
+{
+    if(maxValue <= minValue) {
+        return minValue;
+    }
+
+    return minValue + int(random() % (unsigned int)(maxValue - minValue + 1));
+}
+
+//*********************************************************************************************************************
+// GdsGenerator::randomRatio
+//*********************************************************************************************************************
+double GdsGenerator::randomRatio()
+{
+    return random() / 4294967296.0;
+}
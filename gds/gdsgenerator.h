@@ -0,0 +1,120 @@
+#ifndef GDSGENERATOR_H
+#define GDSGENERATOR_H
+
+#include <string>
+#include <vector>
+
+#include <QStringList>
+
+class GdsWriter;
+
+//*********************************************************************************************************************
+// GdsGenerator
+//
+// Deterministic generator of synthetic GDSII streams for benchmarks. Level 0 holds leaf cells with polygons, paths
+// and texts; every cell of a higher level places 'fanout' cells of the level below as SREF or AREF; a single top
+// cell places the cells of the highest level. Equal settings and seed always give byte-identical streams.
+//*********************************************************************************************************************
+class GdsGenerator
+{
+public:
+    /*!
+     * \brief The Layer struct specifies a layer/datatype pair and its relative share of the shapes.
+     */
+    struct Layer {
+        int                     layer;
+        int                     dataType;
+        int                     weight;
+    };
+
+    GdsGenerator();
+
+    void                        setSeed(unsigned int seed);
+    void                        setDepth(int depth);
+    void                        setCellsPerLevel(int count);
+    void                        setFanout(int fanout);
+    void                        setArefRatio(double ratio);
+    void                        setArraySize(int maxColumns, int maxRows);
+    void                        setPolygonCount(int count);
+    void                        setVertexRange(int minCount, int maxCount);
+    void                        setRectangleRatio(double ratio);
+    void                        setPathRatio(double ratio);
+    void                        setTextCount(int count);
+    void                        setLayers(const std::vector<Layer> &layers);
+    void                        setCellSize(int size);
+    void                        setTargetSize(long long bytes);
+
+    bool                        generate(const QString &fileName);
+
+    long long                   getBytesWritten() const;
+    long long                   getShapeCount() const;
+    QStringList                 getErrors() const;
+
+    static bool                 parseLayers(const QString &spec, std::vector<Layer> *layers);
+
+private:
+    unsigned int                random();
+    int                         random(int minValue, int maxValue);
+    double                      randomRatio();
+
+    const Layer&                randomLayer();
+    std::string                 getCellName(int level, int index) const;
+
+    void                        writeLeaf(GdsWriter *writer, int index, int polygonCount);
+    void                        writeParent(GdsWriter *writer, int level, int index, int childCount, int fanout);
+    void                        writePolygon(GdsWriter *writer, int vertexCount);
+    void                        writePath(GdsWriter *writer);
+
+    int                         getLeafPolygonCount() const;
+
+private:
+    unsigned int                m_seed;
+    unsigned int                m_state;
+    int                         m_depth;
+    int                         m_cellsPerLevel;
+    int                         m_fanout;
+    double                      m_arefRatio;
+    int                         m_maxColumns;
+    int                         m_maxRows;
+    int                         m_polygonCount;
+    int                         m_minVertices;
+    int                         m_maxVertices;
+    double                      m_rectangleRatio;
+    double                      m_pathRatio;
+    int                         m_textCount;
+    std::vector<Layer>          m_layers;
+    int                         m_layerWeight;
+    int                         m_cellSize;
+    long long                   m_targetSize;
+
+    std::vector<int>            m_points;
+    long long                   m_bytesWritten;
+    long long                   m_shapeCount;
+    QStringList                 m_errorList;
+};
+
+//*********************************************************************************************************************
+// GdsGenerator::getBytesWritten()
+//*********************************************************************************************************************
+inline long long GdsGenerator::getBytesWritten() const
+{
+    return m_bytesWritten;
+}
+
+//*********************************************************************************************************************
+// GdsGenerator::getShapeCount()
+//*********************************************************************************************************************
+inline long long GdsGenerator::getShapeCount() const
+{
+    return m_shapeCount;
+}
+
+//*********************************************************************************************************************
+// GdsGenerator::getErrors()
+//*********************************************************************************************************************
+inline QStringList GdsGenerator::getErrors() const
+{
+    return m_errorList;
+}
+
+#endif // GDSGENERATOR_H
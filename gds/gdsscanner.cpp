@@ -0,0 +1,191 @@
+#include <QSet>
+#include <QFile>
+
+#include "gdsreader.h"
+#include "gdsscanner.h"
+#include "perfcounters.h"
+
+//*********************************************************************************************************************
+// GdsScanner::GdsScanner
+//*********************************************************************************************************************
+GdsScanner::GdsScanner()
+{
+}
+
+//*********************************************************************************************************************
+// GdsScanner::scan
+//
+// The file is mapped into memory, or read at once if it can not be mapped.
+//*********************************************************************************************************************
+bool GdsScanner::scan(const QString &fileName)
+{
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly)) {
+        m_libName.clear();
+        m_structures.clear();
+        m_errorList.clear();
+        m_errorList<<QString("Can not read file '%1':\n%2.").arg(fileName).arg(file.errorString());
+        return false;
+    }
+
+    qint64 size = file.size();
+
+    PerfCounters::add(PerfCounters::FILES_READ);
+    PerfCounters::add(PerfCounters::BYTES_READ, size);
+
+    uchar *data = size > 0 ? file.map(0, size) : 0;
+    if(data) {
+        bool isScanned = scan(data, size, fileName);
+        file.unmap(data);
+
+        return isScanned;
+    }
+
+    QByteArray content = file.readAll();
+
+    return scan(reinterpret_cast<const unsigned char*>(content.constData()), content.size(), fileName);
+}
+
+//*********************************************************************************************************************
+// GdsScanner::scan
+//
+// Scans the stream up to ENDLIB. Every record starts with its length and type in big endian byte order.
+//*********************************************************************************************************************
+bool GdsScanner::scan(const unsigned char *data, qint64 size, const QString &fileName)
+{
+    m_libName.clear();
+    m_structures.clear();
+    m_errorList.clear();
+
+    int current = -1;
+    int element = 0;
+    qint64 offset = 0;
+
+    while(offset + 4 <= size) {
+        const unsigned char *record = data + offset;
+
+        int length = (record[0] << 8) | record[1];
+        int type = (record[2] << 8) | record[3];
+
+        // Some writers pad the stream with zeros up to a block size.
+        if(length == 0 && type == 0) {
+            break;
+        }
+
+        if(length < 4 || length % 2 || offset + length > size) {
+            m_errorList<<QString("Incorrect record at offset %1 of '%2'.").arg(offset).arg(fileName);
+            return false;
+        }
+
+        const unsigned char *values = record + 4;
+        int valueLength = length - 4;
+
+        switch(type) {
+        case GDS_LIBNAME:
+            m_libName = getString(values, valueLength);
+            break;
+
+        case GDS_BGNSTR:
+            current = m_structures.count();
+            m_structures<<Structure();
+            m_structures[current].offset = offset + length;
+            m_structures[current].length = 0;
+            break;
+
+        case GDS_STRNAME:
+            if(current >= 0) {
+                m_structures[current].name = getString(values, valueLength);
+                m_structures[current].offset = offset + length;
+            }
+            break;
+
+        case GDS_ENDSTR:
+            if(current >= 0) {
+                m_structures[current].length = offset - m_structures[current].offset;
+            }
+            current = -1;
+            break;
+
+        case GDS_BOUNDARY:
+        case GDS_PATH:
+        case GDS_SREF:
+        case GDS_AREF:
+        case GDS_TEXT:
+        case GDS_NODE:
+        case GDS_BOX:
+            element = type;
+            break;
+
+        case GDS_ENDEL:
+            element = 0;
+            break;
+
+        case GDS_SNAME:
+            if(current >= 0 && (element == GDS_SREF || element == GDS_AREF)) {
+                m_structures[current].references[getString(values, valueLength)]++;
+            }
+            break;
+
+        case GDS_STRING:
+            if(current >= 0 && element == GDS_TEXT) {
+                m_structures[current].labels<<getString(values, valueLength);
+            }
+            break;
+
+        default:
+            break;
+        }
+
+        offset += length;
+
+        if(type == GDS_ENDLIB) {
+            break;
+        }
+    }
+
+    if(current >= 0) {
+        m_errorList<<QString("Structure '%1' of '%2' is not closed by ENDSTR.").arg(m_structures[current].name)
+                     .arg(fileName);
+    }
+
+    return m_errorList.isEmpty();
+}
+
+//*********************************************************************************************************************
+// GdsScanner::getTopStructures
+//
+// Returns structures which are not referenced by any other structure of the stream.
+//*********************************************************************************************************************
+QStringList GdsScanner::getTopStructures() const
+{
+    QSet<QString> referenced;
+    foreach(const Structure &structure, m_structures) {
+        QMap<QString, int>::const_iterator it;
+        for(it = structure.references.constBegin(); it != structure.references.constEnd(); ++it) {
+            referenced.insert(it.key());
+        }
+    }
+
+    QStringList tops;
+    foreach(const Structure &structure, m_structures) {
+        if(!referenced.contains(structure.name)) {
+            tops<<structure.name;
+        }
+    }
+
+    return tops;
+}
+
+//*********************************************************************************************************************
+// GdsScanner::getString
+//
+// Strings are padded with a zero byte to an even length.
+//*********************************************************************************************************************
+QString GdsScanner::getString(const unsigned char *data, int length)
+{
+    while(length > 0 && data[length - 1] == 0) {
+        length--;
+    }
+
+    return QString::fromLatin1(reinterpret_cast<const char*>(data), length);
+}
@@ -0,0 +1,73 @@
+#ifndef GDSSCANNER_H
+#define GDSSCANNER_H
+
+#include <QMap>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+//*********************************************************************************************************************
+// GdsScanner
+//
+// Reads structure names, references (SREF/AREF) and text labels of a GDSII stream. The file is memory mapped and
+// records are skipped by their length, so geometry is never decoded and large layouts are scanned at disk speed.
+// The byte range of every structure body, from the record after STRNAME up to ENDSTR, is kept for comparisons.
+//*********************************************************************************************************************
+class GdsScanner
+{
+public:
+    /*!
+     * \brief The Structure struct keeps what is scanned from a single structure (cell) of the stream.
+     */
+    struct Structure {
+        QString                 name;
+        QMap<QString, int>      references;
+        QStringList             labels;
+        qint64                  offset;
+        qint64                  length;
+    };
+
+    GdsScanner();
+
+    bool                        scan(const QString &fileName);
+    bool                        scan(const unsigned char *data, qint64 size, const QString &fileName);
+
+    QString                     getLibraryName() const;
+    QList<Structure>            getStructures() const;
+    QStringList                 getTopStructures() const;
+    QStringList                 getErrors() const;
+
+private:
+    static QString              getString(const unsigned char *data, int length);
+
+private:
+    QString                     m_libName;
+    QList<Structure>            m_structures;
+    QStringList                 m_errorList;
+};
+
+//*********************************************************************************************************************
+// GdsScanner::getLibraryName()
+//*********************************************************************************************************************
+inline QString GdsScanner::getLibraryName() const
+{
+    return m_libName;
+}
+
+//*********************************************************************************************************************
+// GdsScanner::getStructures()
+//*********************************************************************************************************************
+inline QList<GdsScanner::Structure> GdsScanner::getStructures() const
+{
+    return m_structures;
+}
+
+//*********************************************************************************************************************
+// GdsScanner::getErrors()
+//*********************************************************************************************************************
+inline QStringList GdsScanner::getErrors() const
+{
+    return m_errorList;
+}
+
+#endif // GDSSCANNER_H
@@ -0,0 +1,384 @@
+#include <cmath>
+#include <cstring>
+
+#include "gdsreader.h"
+#include "gdswriter.h"
+
+//*********************************************************************************************************************
+// GdsWriter::GdsWriter
+//*********************************************************************************************************************
+GdsWriter::GdsWriter()
+    : m_gdsFile(0),
+      m_bytesWritten(0)
+{
+    m_buffer.reserve(BUFFER_SIZE);
+}
+
+//*********************************************************************************************************************
+// GdsWriter::~GdsWriter
+//*********************************************************************************************************************
+GdsWriter::~GdsWriter()
+{
+    close();
+}
+
+//*********************************************************************************************************************
+// GdsWriter::open
+//*********************************************************************************************************************
+bool GdsWriter::open(const QString &fileName)
+{
+    close();
+
+    m_fileName = fileName;
+    m_bytesWritten = 0;
+    m_buffer.clear();
+    m_errorList.clear();
+
+    m_gdsFile = fopen(m_fileName.toStdString().c_str(), "wb");
+    if(!m_gdsFile) {
+        m_errorList<<QString("Can not write to file '%1'.").arg(m_fileName);
+        return false;
+    }
+
+    return true;
+}
+
+//*********************************************************************************************************************
+// GdsWriter::close
+//*********************************************************************************************************************
+bool GdsWriter::close()
+{
+    if(!m_gdsFile) {
+        return m_errorList.isEmpty();
+    }
+
+    flush();
+
+    if(fclose(m_gdsFile) != 0) {
+        m_errorList<<QString("Can not close file '%1'.").arg(m_fileName);
+    }
+
+    m_gdsFile = 0;
+
+    return m_errorList.isEmpty();
+}
+
+//*********************************************************************************************************************
+// GdsWriter::beginLibrary
+//
+// Modification and access times are written as zeros, so equal input gives byte-identical streams.
+//*********************************************************************************************************************
+void GdsWriter::beginLibrary(const std::string &libName, double userUnit, double dbUnit)
+{
+    int version = 600;
+    int times[12] = { 0 };
+
+    writeInt16(GDS_HEADER, &version, 1);
+    writeInt16(GDS_BGNLIB, times, 12);
+    writeString(GDS_LIBNAME, libName);
+
+    if(!writeHeader(GDS_UNITS, 16)) {
+        return;
+    }
+
+    unsigned char real[8];
+    toReal8(userUnit, real);
+    m_buffer.insert(m_buffer.end(), real, real + 8);
+    toReal8(dbUnit, real);
+    m_buffer.insert(m_buffer.end(), real, real + 8);
+}
+
+//*********************************************************************************************************************
+// GdsWriter::endLibrary
+//*********************************************************************************************************************
+void GdsWriter::endLibrary()
+{
+    writeRecord(GDS_ENDLIB);
+}
+
+//*********************************************************************************************************************
+// GdsWriter::beginStructure
+//*********************************************************************************************************************
+void GdsWriter::beginStructure(const std::string &name)
+{
+    int times[12] = { 0 };
+
+    writeInt16(GDS_BGNSTR, times, 12);
+    writeString(GDS_STRNAME, name);
+}
+
+//*********************************************************************************************************************
+// GdsWriter::endStructure
+//*********************************************************************************************************************
+void GdsWriter::endStructure()
+{
+    writeRecord(GDS_ENDSTR);
+}
+
+//*********************************************************************************************************************
+// GdsWriter::boundary
+//
+// Polygon is closed by repeating the first point, so at most MAX_POINTS - 1 points may be given.
+//*********************************************************************************************************************
+void GdsWriter::boundary(int layer, int dataType, const int *xy, int pointCount)
+{
+    if(pointCount < 3 || pointCount >= MAX_POINTS) {
+        m_errorList<<QString("Incorrect number of boundary points: %1").arg(pointCount);
+        return;
+    }
+
+    writeRecord(GDS_BOUNDARY);
+    writeInt16(GDS_LAYER, &layer, 1);
+    writeInt16(GDS_DATATYPE, &dataType, 1);
+
+    if(!writeHeader(GDS_XY, (pointCount + 1) * 8)) {
+        return;
+    }
+
+    for(int i = 0; i < pointCount * 2; ++i) {
+        put32(xy[i]);
+    }
+
+    put32(xy[0]);
+    put32(xy[1]);
+
+    writeRecord(GDS_ENDEL);
+}
+
+//*********************************************************************************************************************
+// GdsWriter::path
+//*********************************************************************************************************************
+void GdsWriter::path(int layer, int dataType, int width, const int *xy, int pointCount)
+{
+    if(pointCount < 2 || pointCount > MAX_POINTS) {
+        m_errorList<<QString("Incorrect number of path points: %1").arg(pointCount);
+        return;
+    }
+
+    writeRecord(GDS_PATH);
+    writeInt16(GDS_LAYER, &layer, 1);
+    writeInt16(GDS_DATATYPE, &dataType, 1);
+    writeInt32(GDS_WIDTH, &width, 1);
+    writeInt32(GDS_XY, xy, pointCount * 2);
+    writeRecord(GDS_ENDEL);
+}
+
+//*********************************************************************************************************************
+// GdsWriter::sref
+//*********************************************************************************************************************
+void GdsWriter::sref(const std::string &name, int x, int y, int angle, bool reflect)
+{
+    int xy[2] = { x, y };
+
+    writeRecord(GDS_SREF);
+    writeString(GDS_SNAME, name);
+    writeStrans(angle, reflect);
+    writeInt32(GDS_XY, xy, 2);
+    writeRecord(GDS_ENDEL);
+}
+
+//*********************************************************************************************************************
+// GdsWriter::aref
+//*********************************************************************************************************************
+void GdsWriter::aref(const std::string &name, int columns, int rows, int x, int y, int columnPitch, int rowPitch)
+{
+    int colRow[2] = { columns, rows };
+    int xy[6] = { x, y, x + columns * columnPitch, y, x, y + rows * rowPitch };
+
+    writeRecord(GDS_AREF);
+    writeString(GDS_SNAME, name);
+    writeInt16(GDS_COLROW, colRow, 2);
+    writeInt32(GDS_XY, xy, 6);
+    writeRecord(GDS_ENDEL);
+}
+
+//*********************************************************************************************************************
+// GdsWriter::text
+//*********************************************************************************************************************
+void GdsWriter::text(int layer, int textType, int x, int y, const std::string &label)
+{
+    int xy[2] = { x, y };
+
+    writeRecord(GDS_TEXT);
+    writeInt16(GDS_LAYER, &layer, 1);
+    writeInt16(GDS_TEXTTYPE, &textType, 1);
+    writeInt32(GDS_XY, xy, 2);
+    writeString(GDS_STRING, label);
+    writeRecord(GDS_ENDEL);
+}
+
+//*********************************************************************************************************************
+// GdsWriter::toReal8
+//
+// Converts value into GDSII 8-byte real: sign bit, 7-bit base-16 exponent in excess-64 and 56-bit mantissa.
+//*********************************************************************************************************************
+void GdsWriter::toReal8(double value, unsigned char *out)
+{
+    memset(out, 0, 8);
+
+    if(value == 0.0) {
+        return;
+    }
+
+    unsigned char sign = value < 0 ? 0x80 : 0x00;
+    double mantissa = fabs(value);
+    int exponent = 64;
+
+    while(mantissa >= 1.0) {
+        mantissa /= 16.0;
+        exponent++;
+    }
+
+    while(mantissa < 1.0 / 16.0) {
+        mantissa *= 16.0;
+        exponent--;
+    }
+
+    unsigned long long bits = (unsigned long long)(ldexp(mantissa, 56) + 0.5);
+    if(bits >> 56) {
+        bits >>= 4;
+        exponent++;
+    }
+
+    out[0] = sign | (exponent & 0x7f);
+    for(int i = 7; i >= 1; --i) {
+        out[i] = bits & 0xff;
+        bits >>= 8;
+    }
+}
+
+//*********************************************************************************************************************
+// GdsWriter::writeHeader
+//
+// A record too long for its 16-bit length is reported and not written at all, the caller must skip its data.
+//*********************************************************************************************************************
+bool GdsWriter::writeHeader(int record, int dataSize)
+{
+    if(dataSize + 4 > 0xffff) {
+        m_errorList<<QString("Record 0x%1 is too long: %2 bytes").arg(record, 4, 16, QChar('0')).arg(dataSize + 4);
+        return false;
+    }
+
+    if(m_buffer.size() >= BUFFER_SIZE) {
+        flush();
+    }
+
+    put16(dataSize + 4);
+    put16(record);
+
+    return true;
+}
+
+//*********************************************************************************************************************
+// GdsWriter::writeRecord
+//*********************************************************************************************************************
+void GdsWriter::writeRecord(int record)
+{
+    writeHeader(record, 0);
+}
+
+//*********************************************************************************************************************
+// GdsWriter::writeInt16
+//*********************************************************************************************************************
+void GdsWriter::writeInt16(int record, const int *values, int count)
+{
+    if(!writeHeader(record, count * 2)) {
+        return;
+    }
+
+    for(int i = 0; i < count; ++i) {
+        put16(values[i]);
+    }
+}
+
+//*********************************************************************************************************************
+// GdsWriter::writeInt32
+//*********************************************************************************************************************
+void GdsWriter::writeInt32(int record, const int *values, int count)
+{
+    if(!writeHeader(record, count * 4)) {
+        return;
+    }
+
+    for(int i = 0; i < count; ++i) {
+        put32(values[i]);
+    }
+}
+
+//*********************************************************************************************************************
+// GdsWriter::writeString
+//*********************************************************************************************************************
+void GdsWriter::writeString(int record, const std::string &value)
+{
+    int length = value.length() + value.length() % 2;
+
+    if(!writeHeader(record, length)) {
+        return;
+    }
+
+    m_buffer.insert(m_buffer.end(), value.begin(), value.end());
+    if(value.length() % 2) {
+        m_buffer.push_back(0);
+    }
+}
+
+//*********************************************************************************************************************
+// GdsWriter::writeStrans
+//*********************************************************************************************************************
+void GdsWriter::writeStrans(int angle, bool reflect)
+{
+    if(!angle && !reflect) {
+        return;
+    }
+
+    int strans = reflect ? 0x8000 : 0;
+    writeInt16(GDS_STRANS, &strans, 1);
+
+    if(angle) {
+        unsigned char real[8];
+        toReal8(angle, real);
+
+        if(!writeHeader(GDS_ANGLE, 8)) {
+            return;
+        }
+
+        m_buffer.insert(m_buffer.end(), real, real + 8);
+    }
+}
+
+//*********************************************************************************************************************
+// GdsWriter::put16
+//*********************************************************************************************************************
+void GdsWriter::put16(int value)
+{
+    m_buffer.push_back((value >> 8) & 0xff);
+    m_buffer.push_back(value & 0xff);
+}
+
+//*********************************************************************************************************************
+// GdsWriter::put32
+//*********************************************************************************************************************
+void GdsWriter::put32(int value)
+{
+    m_buffer.push_back((value >> 24) & 0xff);
+    m_buffer.push_back((value >> 16) & 0xff);
+    m_buffer.push_back((value >> 8) & 0xff);
+    m_buffer.push_back(value & 0xff);
+}
+
+//*********************************************************************************************************************
+// GdsWriter::flush
+//*********************************************************************************************************************
+void GdsWriter::flush()
+{
+    if(m_buffer.empty()) {
+        return;
+    }
+
+    if(m_gdsFile && fwrite(&m_buffer[0], 1, m_buffer.size(), m_gdsFile) != m_buffer.size()) {
+        m_errorList<<QString("Can not write to file '%1'.").arg(m_fileName);
+    }
+
+    m_bytesWritten += m_buffer.size();
+    m_buffer.clear();
+}
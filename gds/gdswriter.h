@@ -0,0 +1,84 @@
+#ifndef GDSWRITER_H
+#define GDSWRITER_H
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include <QStringList>
+
+//*********************************************************************************************************************
+// GdsWriter
+//
+// Buffered GDSII stream encoder. Records are encoded into a memory buffer which is written to the file in large
+// blocks, so streams of many GB are written with a few thousand system calls.
+//*********************************************************************************************************************
+class GdsWriter
+{
+public:
+    enum {
+        BUFFER_SIZE             = 4 * 1024 * 1024,
+        MAX_POINTS              = 8191
+    };
+
+    GdsWriter();
+    ~GdsWriter();
+
+    bool                        open(const QString &fileName);
+    bool                        close();
+
+    void                        beginLibrary(const std::string &libName, double userUnit = 1e-3,
+                                             double dbUnit = 1e-9);
+    void                        endLibrary();
+    void                        beginStructure(const std::string &name);
+    void                        endStructure();
+
+    void                        boundary(int layer, int dataType, const int *xy, int pointCount);
+    void                        path(int layer, int dataType, int width, const int *xy, int pointCount);
+    void                        sref(const std::string &name, int x, int y, int angle = 0, bool reflect = false);
+    void                        aref(const std::string &name, int columns, int rows, int x, int y,
+                                     int columnPitch, int rowPitch);
+    void                        text(int layer, int textType, int x, int y, const std::string &label);
+
+    long long                   getBytesWritten() const;
+    QStringList                 getErrors() const;
+
+    static void                 toReal8(double value, unsigned char *out);
+
+private:
+    bool                        writeHeader(int record, int dataSize);
+    void                        writeRecord(int record);
+    void                        writeInt16(int record, const int *values, int count);
+    void                        writeInt32(int record, const int *values, int count);
+    void                        writeString(int record, const std::string &value);
+    void                        writeStrans(int angle, bool reflect);
+
+    void                        put16(int value);
+    void                        put32(int value);
+    void                        flush();
+
+private:
+    FILE*                       m_gdsFile;
+    QString                     m_fileName;
+    std::vector<unsigned char>  m_buffer;
+    long long                   m_bytesWritten;
+    QStringList                 m_errorList;
+};
+
+//*********************************************************************************************************************
+// GdsWriter::getBytesWritten()
+//*********************************************************************************************************************
+inline long long GdsWriter::getBytesWritten() const
+{
+    return m_bytesWritten;
+}
+
+//*********************************************************************************************************************
+// GdsWriter::getErrors()
+//*********************************************************************************************************************
+inline QStringList GdsWriter::getErrors() const
+{
+    return m_errorList;
+}
+
+#endif // GDSWRITER_H
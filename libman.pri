@@ -0,0 +1,135 @@
+#-------------------------------------------------
+#
+# Sources shared by LibMan application and benchmarks
+#
+#-------------------------------------------------
+
+INCLUDEPATH += $$PWD $$PWD/src
+
+SOURCES += $$PWD/src/mainwindow.cpp \
+    $$PWD/extension/variantmanager.cpp \
+    $$PWD/extension/variantfactory.cpp \
+    $$PWD/extension/qlineeditd2.cpp \
+    $$PWD/extension/filepathmanager.cpp \
+    $$PWD/extension/fileeditfactory.cpp \
+    $$PWD/extension/fileedit.cpp \
+    $$PWD/QtPropertyBrowser/qtvariantproperty.cpp \
+    $$PWD/QtPropertyBrowser/qttreepropertybrowser.cpp \
+    $$PWD/QtPropertyBrowser/qtpropertymanager.cpp \
+    $$PWD/QtPropertyBrowser/qtpropertybrowserutils.cpp \
+    $$PWD/QtPropertyBrowser/qtpropertybrowser.cpp \
+    $$PWD/QtPropertyBrowser/qtgroupboxpropertybrowser.cpp \
+    $$PWD/QtPropertyBrowser/qteditorfactory.cpp \
+    $$PWD/QtPropertyBrowser/qtbuttonpropertybrowser.cpp \
+    $$PWD/gds/gdsreader.cpp \
+    $$PWD/gds/gdswriter.cpp \
+    $$PWD/gds/gdsgenerator.cpp \
+    $$PWD/gds/gdsscanner.cpp \
+    $$PWD/gds/gdsdiff.cpp \
+    $$PWD/src/projectmanager.cpp \
+    $$PWD/src/property.cpp \
+    $$PWD/src/toolmanager.cpp \
+    $$PWD/src/projectfile.cpp \
+    $$PWD/src/categories.cpp \
+    $$PWD/src/viewcontextmenu.cpp \
+    $$PWD/src/groupcontextmenu.cpp \
+    $$PWD/src/projectcontextmenu.cpp \
+    $$PWD/src/categorycontextmenu.cpp \
+    $$PWD/src/about.cpp \
+    $$PWD/src/newview.cpp \
+    $$PWD/src/catalog.cpp \
+    $$PWD/src/recordwriter.cpp \
+    $$PWD/src/batchmode.cpp \
+    $$PWD/src/catalogclient.cpp \
+    $$PWD/src/catalogserver.cpp \
+    $$PWD/src/batchscript.cpp \
+    $$PWD/src/catalogexport.cpp \
+    $$PWD/src/trace.cpp \
+    $$PWD/src/perfcounters.cpp \
+    $$PWD/src/perfpanel.cpp \
+    $$PWD/src/netlistparser.cpp \
+    $$PWD/src/netlistindex.cpp \
+    $$PWD/src/netlistgraph.cpp \
+    $$PWD/src/verilogscanner.cpp \
+    $$PWD/src/viewcheck.cpp \
+    $$PWD/src/netlistsplitter.cpp \
+    $$PWD/src/libertyindex.cpp \
+    $$PWD/src/lefscanner.cpp \
+    $$PWD/src/lefindex.cpp \
+    $$PWD/src/netlistdiff.cpp \
+    $$PWD/src/categoryindex.cpp \
+    $$PWD/src/cellfilter.cpp \
+    $$PWD/src/toolsessions.cpp \
+    $$PWD/src/toolstub.cpp \
+    $$PWD/src/viewprefetch.cpp \
+    $$PWD/src/launchpanel.cpp \
+    $$PWD/src/lineindex.cpp \
+    $$PWD/src/textview.cpp \
+    $$PWD/src/previewpanel.cpp \
+    $$PWD/src/backgroundjob.cpp
+
+HEADERS += $$PWD/src/mainwindow.h \
+    $$PWD/extension/variantmanager.h \
+    $$PWD/extension/variantfactory.h \
+    $$PWD/extension/qlineeditd2.h \
+    $$PWD/extension/filepathmanager.h \
+    $$PWD/extension/fileeditfactory.h \
+    $$PWD/extension/fileedit.h \
+    $$PWD/QtPropertyBrowser/qtvariantproperty.h \
+    $$PWD/QtPropertyBrowser/qttreepropertybrowser.h \
+    $$PWD/QtPropertyBrowser/qtpropertymanager.h \
+    $$PWD/QtPropertyBrowser/qtpropertybrowserutils_p.h \
+    $$PWD/QtPropertyBrowser/qtpropertybrowser.h \
+    $$PWD/QtPropertyBrowser/qtgroupboxpropertybrowser.h \
+    $$PWD/QtPropertyBrowser/qteditorfactory.h \
+    $$PWD/QtPropertyBrowser/qtbuttonpropertybrowser.h \
+    $$PWD/gds/gdsreader.h \
+    $$PWD/gds/gdswriter.h \
+    $$PWD/gds/gdsgenerator.h \
+    $$PWD/gds/gdsscanner.h \
+    $$PWD/gds/gdsdiff.h \
+    $$PWD/src/projectmanager.h \
+    $$PWD/src/property.h \
+    $$PWD/src/toolmanager.h \
+    $$PWD/src/about.h \
+    $$PWD/src/newview.h \
+    $$PWD/src/catalog.h \
+    $$PWD/src/recordwriter.h \
+    $$PWD/src/batchmode.h \
+    $$PWD/src/catalogclient.h \
+    $$PWD/src/catalogserver.h \
+    $$PWD/src/batchscript.h \
+    $$PWD/src/catalogexport.h \
+    $$PWD/src/trace.h \
+    $$PWD/src/perfcounters.h \
+    $$PWD/src/perfpanel.h \
+    $$PWD/src/netlistparser.h \
+    $$PWD/src/netlistindex.h \
+    $$PWD/src/netlistgraph.h \
+    $$PWD/src/verilogscanner.h \
+    $$PWD/src/viewcheck.h \
+    $$PWD/src/netlistsplitter.h \
+    $$PWD/src/libertyindex.h \
+    $$PWD/src/lefscanner.h \
+    $$PWD/src/lefindex.h \
+    $$PWD/src/netlistdiff.h \
+    $$PWD/src/categoryindex.h \
+    $$PWD/src/cellfilter.h \
+    $$PWD/src/toolsessions.h \
+    $$PWD/src/toolstub.h \
+    $$PWD/src/viewprefetch.h \
+    $$PWD/src/launchpanel.h \
+    $$PWD/src/lineindex.h \
+    $$PWD/src/textview.h \
+    $$PWD/src/previewpanel.h \
+    $$PWD/src/backgroundjob.h
+
+FORMS += $$PWD/src/mainwindow.ui \
+    $$PWD/src/projectmanager.ui \
+    $$PWD/src/toolmanager.ui \
+    $$PWD/src/about.ui \
+    $$PWD/src/newview.ui
+
+RESOURCES += \
+    $$PWD/icons.qrc
+
@@ -0,0 +1,249 @@
+#include <QDateTime>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QApplication>
+#include <QMutexLocker>
+
+#include "backgroundjob.h"
+#include "mainwindow.h"
+#include "catalog.h"
+#include "perfcounters.h"
+#include "netlistindex.h"
+#include "netlistgraph.h"
+
+/*!*********************************************************************************************************************
+ * \brief The BackgroundRunner class runs a job in the thread of its queue and hands it back for finishing.
+ **********************************************************************************************************************/
+class BackgroundRunner : public QRunnable
+{
+public:
+    BackgroundRunner(BackgroundQueue *queue, BackgroundJob *job) : m_queue(queue), m_job(job) {}
+
+    void run() { m_job->run(); m_queue->setDone(m_job); }
+
+private:
+    BackgroundQueue                     *m_queue;           /*!< Queue the job has been started in. */
+    BackgroundJob                       *m_job;             /*!< Job to run, owned by the queue. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Constructs a job of the window.
+ * \param window        Window starting the job, it shows the results.
+ **********************************************************************************************************************/
+BackgroundJob::BackgroundJob(MainWindow *window)
+    : m_window(window)
+{
+}
+
+/*!*********************************************************************************************************************
+ * \brief Destroys the job.
+ **********************************************************************************************************************/
+BackgroundJob::~BackgroundJob()
+{
+}
+
+/*!*********************************************************************************************************************
+ * \brief Prints the text and the errors collected by run() into the output window of MainWindow.
+ **********************************************************************************************************************/
+void BackgroundJob::finish()
+{
+    if(!m_info.isEmpty()) {
+        info(m_info);
+    }
+
+    foreach(const QString &explain, m_errorList) {
+        error(explain + "\n");
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns catalog of the window. Only functions which scan folders without touching the cached libraries, like
+ * Catalog::scanLibrary(), may be called from run().
+ **********************************************************************************************************************/
+const Catalog& BackgroundJob::getCatalog() const
+{
+    return *m_window->m_catalog;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns netlist index of the window, it is loaded on first use. Must be called from run() only.
+ **********************************************************************************************************************/
+NetlistIndex& BackgroundJob::getNetlistIndex()
+{
+    if(!m_window->m_netlistIndex) {
+        m_window->m_netlistIndex = new NetlistIndex;
+        if(!m_window->m_netlistIndex->load(NetlistIndex::getDefaultFile())) {
+            m_errorList<<m_window->m_netlistIndex->getErrors();
+        }
+    }
+
+    return *m_window->m_netlistIndex;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns netlist graph of the window. Must be called from run() only.
+ **********************************************************************************************************************/
+NetlistGraph& BackgroundJob::getNetlistGraph()
+{
+    return *m_window->m_netlistGraph;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Parses the views if they have changed and saves the netlist index. Must be called from run() only.
+ * \param viewPaths     Paths to SPICE, CDL and Verilog views.
+ **********************************************************************************************************************/
+void BackgroundJob::updateNetlistIndex(const QStringList &viewPaths)
+{
+    NetlistIndex &index = getNetlistIndex();
+    index.update(viewPaths);
+
+    if(index.isChanged() && !index.save(NetlistIndex::getDefaultFile())) {
+        m_errorList<<index.getErrors();
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns netlist views of the libraries. The list of a library is kept and only scanned again if one of its
+ * netlist view folders has been modified, i.e. a view has been added or removed. Must be called from run() only.
+ * \param libraries     Map of library names to library paths.
+ * \return              Rows of library, cell, view and view path in library and cell order.
+ **********************************************************************************************************************/
+QList<QStringList> BackgroundJob::getNetlistViews(const QMap<QString, QString> &libraries)
+{
+    QList<QStringList> views;
+
+    QMap<QString, QString>::const_iterator it;
+    for(it = libraries.constBegin(); it != libraries.constEnd(); ++it) {
+        QString stamp;
+        foreach(const QString &viewName, Catalog::getValidViewList()) {
+            if(NetlistParser::isNetlistView(viewName)) {
+                QFileInfo dirInfo(it.value() + "/" + viewName);
+                stamp += QString::number(dirInfo.exists() ? dirInfo.lastModified().toMSecsSinceEpoch() : -1) + " ";
+
+                PerfCounters::add(PerfCounters::STAT_CALLS);
+            }
+        }
+
+        if(!m_window->m_netlistViews.contains(it.value()) || m_window->m_netlistStamps.value(it.value()) != stamp) {
+            QMap<QString, QString> library;
+            library[it.key()] = it.value();
+
+            m_window->m_netlistViews[it.value()] = NetlistIndex::getNetlistViews(getCatalog(), library);
+            m_window->m_netlistStamps[it.value()] = stamp;
+        }
+
+        foreach(QStringList view, m_window->m_netlistViews.value(it.value())) {
+            view[0] = it.key();
+            views<<view;
+        }
+    }
+
+    return views;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Drops the cached content of the library after views have been written and lists its groups again if it is
+ * shown. Must be called from finish() only.
+ * \param libPath       Path to the library.
+ **********************************************************************************************************************/
+void BackgroundJob::reloadLibrary(const QString &libPath)
+{
+    m_window->m_catalog->invalidateLibrary(libPath);
+
+    if(m_window->m_cellFilter->getLibraryPath() == libPath) {
+        m_window->m_cellFilter->clear();
+    }
+
+    if(m_window->getCurrentLibraryPath() == libPath) {
+        m_window->loadGroups(libPath);
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Appends the message to the output window of MainWindow. Must be called from finish() only.
+ * \param msg           Message to print.
+ **********************************************************************************************************************/
+void BackgroundJob::info(const QString &msg)
+{
+    m_window->info(msg, false);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Appends the error to the output window of MainWindow. Must be called from finish() only.
+ * \param msg           Error to print.
+ **********************************************************************************************************************/
+void BackgroundJob::error(const QString &msg)
+{
+    m_window->error(msg, false);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Constructs an idle queue.
+ * \param parent        Parent object, by default is NULL.
+ **********************************************************************************************************************/
+BackgroundQueue::BackgroundQueue(QObject *parent)
+    : QObject(parent),
+      m_pendingCount(0)
+{
+    m_pool.setMaxThreadCount(1);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Waits for the running job. Jobs which have not been finished yet are dropped, their results are not shown.
+ **********************************************************************************************************************/
+BackgroundQueue::~BackgroundQueue()
+{
+    m_pool.waitForDone();
+
+    qDeleteAll(m_doneJobs);
+
+    if(m_pendingCount > 0) {
+        QApplication::restoreOverrideCursor();
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Queues the job behind the jobs started before. The queue takes ownership of the job.
+ * \param job           Job to run.
+ **********************************************************************************************************************/
+void BackgroundQueue::start(BackgroundJob *job)
+{
+    if(m_pendingCount++ == 0) {
+        QApplication::setOverrideCursor(Qt::BusyCursor);
+    }
+
+    m_pool.start(new BackgroundRunner(this, job));
+}
+
+/*!*********************************************************************************************************************
+ * \brief Finishes the jobs which have been run, called in the UI thread.
+ **********************************************************************************************************************/
+void BackgroundQueue::finishJobs()
+{
+    QMutexLocker locker(&m_mutex);
+    QList<BackgroundJob*> jobs = m_doneJobs;
+    m_doneJobs.clear();
+    locker.unlock();
+
+    foreach(BackgroundJob *job, jobs) {
+        job->finish();
+        delete job;
+
+        if(--m_pendingCount == 0) {
+            QApplication::restoreOverrideCursor();
+        }
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Hands the job over to the UI thread for finishing, called in the thread of the queue.
+ * \param job           Job which has been run.
+ **********************************************************************************************************************/
+void BackgroundQueue::setDone(BackgroundJob *job)
+{
+    QMutexLocker locker(&m_mutex);
+    m_doneJobs<<job;
+    locker.unlock();
+
+    QMetaObject::invokeMethod(this, "finishJobs", Qt::QueuedConnection);
+}
@@ -0,0 +1,88 @@
+#ifndef BACKGROUNDJOB_H
+#define BACKGROUNDJOB_H
+
+#include <QMap>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QStringList>
+#include <QThreadPool>
+
+class Catalog;
+class MainWindow;
+class NetlistIndex;
+class NetlistGraph;
+
+/*!*********************************************************************************************************************
+ * \brief The BackgroundJob class is a task of MainWindow which takes too long for the UI thread, e.g. parsing netlist
+ * views. run() is called in the thread of a BackgroundQueue and must not touch any widget; finish() is called in the
+ * UI thread afterwards and shows the results. The netlist index and graph of MainWindow are only accessed by jobs, as
+ * the queue runs them one after another.
+ **********************************************************************************************************************/
+class BackgroundJob
+{
+public:
+    explicit BackgroundJob(MainWindow *window);
+    virtual ~BackgroundJob();
+
+    virtual void                        run() = 0;
+    virtual void                        finish();
+
+protected:
+    const Catalog&                      getCatalog() const;
+    NetlistIndex&                       getNetlistIndex();
+    NetlistGraph&                       getNetlistGraph();
+    void                                updateNetlistIndex(const QStringList &viewPaths);
+    QList<QStringList>                  getNetlistViews(const QMap<QString, QString> &libraries);
+
+    void                                reloadLibrary(const QString &libPath);
+    void                                info(const QString &msg);
+    void                                error(const QString &msg);
+
+protected:
+    MainWindow                          *m_window;          /*!< Window the job has been started by. */
+    QString                             m_info;             /*!< Text printed into the output window by finish(). */
+    QStringList                         m_errorList;        /*!< Errors printed into the output window by finish(). */
+};
+
+/*!*********************************************************************************************************************
+ * \brief The BackgroundQueue class runs jobs of MainWindow one after another in a single thread and finishes them in
+ * the UI thread, in the order they have been started. A busy cursor is shown while jobs are pending; the window stays
+ * responsive.
+ **********************************************************************************************************************/
+class BackgroundQueue : public QObject
+{
+    Q_OBJECT
+
+    friend class BackgroundRunner;
+
+public:
+    explicit BackgroundQueue(QObject *parent = 0);
+    ~BackgroundQueue();
+
+    void                                start(BackgroundJob *job);
+
+    bool                                isBusy() const;
+
+private slots:
+    void                                finishJobs();
+
+private:
+    void                                setDone(BackgroundJob *job);
+
+private:
+    QThreadPool                         m_pool;             /*!< Single thread running the jobs. */
+    QMutex                              m_mutex;            /*!< Guards m_doneJobs. */
+    QList<BackgroundJob*>               m_doneJobs;         /*!< Jobs run but not yet finished. */
+    int                                 m_pendingCount;     /*!< Jobs started but not yet finished. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if jobs have been started and not yet finished.
+ **********************************************************************************************************************/
+inline bool BackgroundQueue::isBusy() const
+{
+    return m_pendingCount > 0;
+}
+
+#endif // BACKGROUNDJOB_H
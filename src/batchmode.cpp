@@ -0,0 +1,1152 @@
+#include <cstring>
+#include <iostream>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include "batchmode.h"
+#include "batchscript.h"
+#include "gds/gdsdiff.h"
+#include "lefindex.h"
+#include "libertyindex.h"
+#include "netlistdiff.h"
+#include "netlistgraph.h"
+#include "netlistindex.h"
+#include "netlistsplitter.h"
+#include "viewcheck.h"
+
+using std::cerr;
+using std::endl;
+
+/*!*********************************************************************************************************************
+ * \brief Constructs BatchMode object.
+ * \param arguments     Command line arguments including the program name.
+ **********************************************************************************************************************/
+BatchMode::BatchMode(const QStringList &arguments)
+    : m_arguments(arguments.mid(1)),
+      m_format(RecordWriter::TSV),
+      m_useDaemon(true),
+      m_dryRun(false),
+      m_withDependencies(false),
+      m_overwrite(false),
+      m_jobs(0),
+      m_out(stdout, QIODevice::WriteOnly)
+{
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if LibMan has been asked to run without GUI. Used before any Qt application object exists.
+ * \param argc     Number of command line arguments.
+ * \param argv     Command line arguments.
+ **********************************************************************************************************************/
+bool BatchMode::isRequested(int argc, char *argv[])
+{
+    for(int i = 1; i < argc; ++i) {
+        if(std::strcmp(argv[i], "--batch") == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Executes the requested query.
+ * \return      Exit code of the application: 0 on success, otherwise 1.
+ **********************************************************************************************************************/
+int BatchMode::exec()
+{
+    if(!parseArguments()) {
+        return 1;
+    }
+
+    if(m_command.isEmpty() || m_command == "help") {
+        printUsage();
+        return m_command.isEmpty() ? 1 : 0;
+    }
+
+    if(!loadProject()) {
+        return 1;
+    }
+
+    if(m_command == "libraries") {
+        return listLibraries();
+    }
+    else if(m_command == "groups") {
+        return listGroups();
+    }
+    else if(m_command == "cells") {
+        return listCells();
+    }
+    else if(m_command == "views") {
+        return listViews();
+    }
+    else if(m_command == "categories") {
+        return listCategories();
+    }
+    else if(m_command == "category") {
+        return listCategoryCells();
+    }
+    else if(m_command == "documents") {
+        return listDocuments();
+    }
+    else if(m_command == "search") {
+        return searchCells();
+    }
+    else if(m_command == "whereused") {
+        return listWhereUsed();
+    }
+    else if(m_command == "resolve") {
+        return resolveView();
+    }
+    else if(m_command == "run") {
+        return runScript();
+    }
+    else if(m_command == "export") {
+        return exportCatalog();
+    }
+    else if(m_command == "netlists") {
+        return indexNetlists();
+    }
+    else if(m_command == "usedby" || m_command == "hierarchy") {
+        return listNetlistRelatives();
+    }
+    else if(m_command == "checkviews") {
+        return checkViews();
+    }
+    else if(m_command == "split") {
+        return splitNetlist();
+    }
+    else if(m_command == "liberty") {
+        return indexLiberty();
+    }
+    else if(m_command == "lef") {
+        return indexLef();
+    }
+    else if(m_command == "diff") {
+        return diffViews();
+    }
+
+    error(QString("Unknown command '%1'.").arg(m_command));
+    printUsage();
+
+    return 1;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Parses command line arguments.
+ **********************************************************************************************************************/
+bool BatchMode::parseArguments()
+{
+    for(int i = 0; i < m_arguments.count(); ++i) {
+        QString key = m_arguments[i];
+
+        if(key == "--batch") {
+            continue;
+        }
+        else if(key == "--no-daemon") {
+            m_useDaemon = false;
+        }
+        else if(key == "--dry-run") {
+            m_dryRun = true;
+        }
+        else if(key == "--with-deps") {
+            m_withDependencies = true;
+        }
+        else if(key == "--overwrite") {
+            m_overwrite = true;
+        }
+        else if(key == "-h" || key == "--help") {
+            m_command = "help";
+            return true;
+        }
+        else if(key == "--format" || key == "--project" || key == "--jobs" || key == "--hash" || key == "--trace" ||
+                key == "--sort" || key == "--view") {
+            if(i + 1 >= m_arguments.count()) {
+                error(QString("Missing value of argument '%1'.").arg(key));
+                return false;
+            }
+
+            QString value = m_arguments[++i];
+            if(key == "--trace") {
+                // Tracing is started in main() before the batch mode is created.
+                continue;
+            }
+            else if(key == "--project") {
+                m_projFile = value;
+            }
+            else if(key == "--hash") {
+                m_hash = value;
+            }
+            else if(key == "--sort") {
+                m_sort = value;
+            }
+            else if(key == "--view") {
+                m_view = value;
+            }
+            else if(key == "--jobs") {
+                bool ok = false;
+                m_jobs = value.toInt(&ok);
+                if(!ok || m_jobs < 0) {
+                    error(QString("Incorrect number of jobs '%1'.").arg(value));
+                    return false;
+                }
+            }
+            else if(!RecordWriter::parseFormat(value, &m_format)) {
+                error(QString("Unknown output format '%1'.").arg(value));
+                return false;
+            }
+        }
+        else if(key.startsWith("--")) {
+            error(QString("Incorrect input argument '%1'.").arg(key));
+            return false;
+        }
+        else if(m_command.isEmpty()) {
+            m_command = key;
+        }
+        else {
+            m_commandArgs<<key;
+        }
+    }
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Loads the project file given by '--project' or the one found in the current folder.
+ **********************************************************************************************************************/
+bool BatchMode::loadProject()
+{
+    QString projFile = m_projFile;
+    if(projFile.isEmpty()) {
+        projFile = Catalog::getProjectFileFromDir(QDir(".").absolutePath());
+    }
+
+    if(projFile.isEmpty()) {
+        error("No project file found. Please use '--project <file>'.");
+        return false;
+    }
+
+    if(!m_catalog.loadProjectFile(projFile)) {
+        foreach(const QString &explain, m_catalog.getErrors()) {
+            error(explain);
+        }
+
+        return false;
+    }
+
+    if(m_useDaemon && m_client.connectToDaemon(projFile)) {
+        m_catalog.setClient(&m_client);
+    }
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Prints usage information to the standard output.
+ **********************************************************************************************************************/
+void BatchMode::printUsage() const
+{
+    QTextStream out(stdout, QIODevice::WriteOnly);
+
+    out<<"Usage: libman --batch [--project <file>] [--format json|tsv|csv] [--no-daemon] <command> [arguments]\n"
+       <<"       libman --batch [--project <file>] [--dry-run] [--jobs <n>] run <script>\n"
+       <<"       libman --batch [--project <file>] [--format json|tsv|csv] [--hash md5|sha1] [--jobs <n>] export [file]\n"
+       <<"       libman --batch [--project <file>] [--view cdl|spice] [--with-deps] [--overwrite] [--dry-run] [--jobs <n>]\n"
+       <<"                      split <netlist> <library> [subckt...]\n"
+       <<"\n"
+       <<"Commands:\n"
+       <<"  libraries                     List libraries of the project.\n"
+       <<"  groups                        List groups of libraries.\n"
+       <<"  cells <library>               List cells of the library.\n"
+       <<"  views <library> [cell]        List views of the cell or of all library cells.\n"
+       <<"  categories <library> [cell]   List categories of the library or the categories listing the cell.\n"
+       <<"  category <library> <name>     List cells of the category.\n"
+       <<"  documents <library>           List documents of the library.\n"
+       <<"  search <pattern>              List cells matching the wildcard pattern in all libraries.\n"
+       <<"  whereused <cell>              List libraries and categories using the cell.\n"
+       <<"  resolve <library> <cell> <view>  Print path of the view.\n"
+       <<"  run <script>                  Execute library operations of the script file.\n"
+       <<"  export [file]                 Write library, cell, view, size, mtime and hash of all views.\n"
+       <<"  netlists [library...]         Index netlist views, list their subcircuits, ports and devices.\n"
+       <<"  usedby <subckt>               List subcircuits instantiating the subcircuit on any level.\n"
+       <<"  hierarchy <subckt>            List subcircuits instantiated by the subcircuit on any level.\n"
+       <<"  checkviews [library...]       Compare layout and netlist views of all cells ('--sort <column>').\n"
+       <<"  split <netlist> <library> [subckt...]  Write every subcircuit of the netlist to its own cell view.\n"
+       <<"  liberty <file> [cell...]      List cells, areas and pins of a Liberty file or print the given cell groups.\n"
+       <<"  lef [library...]              List LEF macros with size, pins, obstructions and the views of their cells.\n"
+       <<"  diff <old> <new>              List structural changes between two versions of a netlist or GDSII view.\n"
+       <<"\n"
+       <<"If '--project' is not given, the project file is searched in the current folder.\n"
+       <<"Queries are sent to the catalog daemon ('libman --daemon') if it serves the project,\n"
+       <<"unless '--no-daemon' is given. '--trace <file>' writes a Chrome trace of the run.\n"
+       <<"\n"
+       <<"Script commands (one per line, '#' starts a comment):\n"
+       <<"  ADD_LIBRARY <library> <path>            REMOVE_LIBRARY <library>\n"
+       <<"  GROUP <group> <library> [library...]    UNGROUP <group>\n"
+       <<"  COPY_CELL <library> <cell> <target library> [target cell]\n"
+       <<"  COPY_VIEW <library> <cell> <view> <target library> [target cell]\n"
+       <<"  CREATE_VIEW <library> <cell> <view>     DELETE_VIEW <library> <cell> <view>\n"
+       <<"  DELETE_CELL <library> <cell>\n"
+       <<"With '--dry-run' the plan and the estimated I/O volume are printed, nothing is changed.\n"
+       <<"Independent steps run in parallel, '--jobs' limits their number (default: CPU cores).\n";
+}
+
+/*!*********************************************************************************************************************
+ * \brief Prints error message to the standard error output.
+ * \param msg       Message to print.
+ **********************************************************************************************************************/
+void BatchMode::error(const QString &msg) const
+{
+    cerr<<"[ERROR] "<<msg.toStdString()<<endl;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Checks number of the command arguments and reports an error if it is out of range.
+ * \param min       Minimal number of arguments.
+ * \param max       Maximal number of arguments.
+ **********************************************************************************************************************/
+bool BatchMode::checkArgumentCount(int min, int max) const
+{
+    if(m_commandArgs.count() < min || m_commandArgs.count() > max) {
+        error(QString("Incorrect number of arguments for command '%1'.").arg(m_command));
+        return false;
+    }
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns path of the library or reports an error if library is unknown.
+ * \param libName       Name of the library.
+ **********************************************************************************************************************/
+QString BatchMode::getLibraryPath(const QString &libName) const
+{
+    QString libPath = m_catalog.getLibraryPath(libName);
+    if(libPath.isEmpty()) {
+        error(QString("Unknown library '%1'.").arg(libName));
+    }
+
+    return libPath;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Prints libraries of the project.
+ **********************************************************************************************************************/
+int BatchMode::listLibraries()
+{
+    if(!checkArgumentCount(0, 0)) {
+        return 1;
+    }
+
+    RecordWriter writer(&m_out, m_format, QStringList()<<"library"<<"path");
+
+    QMap<QString, QString> libraries = m_catalog.getLibraries();
+    QMap<QString, QString>::const_iterator it;
+    for(it = libraries.constBegin(); it != libraries.constEnd(); ++it) {
+        writer.writeRow(QStringList()<<it.key()<<it.value());
+    }
+
+    return 0;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Prints groups of libraries, one row per group member.
+ **********************************************************************************************************************/
+int BatchMode::listGroups()
+{
+    if(!checkArgumentCount(0, 0)) {
+        return 1;
+    }
+
+    RecordWriter writer(&m_out, m_format, QStringList()<<"group"<<"library");
+
+    QMap<QString, QStringList> groups = m_catalog.getCombinedLibs();
+    QMap<QString, QStringList>::const_iterator it;
+    for(it = groups.constBegin(); it != groups.constEnd(); ++it) {
+        foreach(const QString &libName, it.value()) {
+            writer.writeRow(QStringList()<<it.key()<<libName);
+        }
+    }
+
+    return 0;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Prints cells of the library.
+ **********************************************************************************************************************/
+int BatchMode::listCells()
+{
+    if(!checkArgumentCount(1, 1)) {
+        return 1;
+    }
+
+    QString libName = m_commandArgs[0];
+    QString libPath = getLibraryPath(libName);
+    if(libPath.isEmpty()) {
+        return 1;
+    }
+
+    RecordWriter writer(&m_out, m_format, QStringList()<<"library"<<"cell");
+
+    foreach(const QString &cellName, m_catalog.getCells(libPath)) {
+        writer.writeRow(QStringList()<<libName<<cellName);
+    }
+
+    return 0;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Prints views of the cell or of all cells of the library.
+ **********************************************************************************************************************/
+int BatchMode::listViews()
+{
+    if(!checkArgumentCount(1, 2)) {
+        return 1;
+    }
+
+    QString libName = m_commandArgs[0];
+    QString libPath = getLibraryPath(libName);
+    if(libPath.isEmpty()) {
+        return 1;
+    }
+
+    QStringList cells;
+    if(m_commandArgs.count() > 1) {
+        cells<<m_commandArgs[1];
+    }
+    else {
+        cells = m_catalog.getCells(libPath);
+    }
+
+    RecordWriter writer(&m_out, m_format, QStringList()<<"library"<<"cell"<<"view"<<"path");
+
+    foreach(const QString &cellName, cells) {
+        foreach(const QString &viewName, m_catalog.getViews(libPath, cellName)) {
+            QString viewPath = Catalog::getViewPath(libPath, cellName, viewName);
+            writer.writeRow(QStringList()<<libName<<cellName<<viewName<<viewPath);
+        }
+    }
+
+    return 0;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Prints categories of the library, or the categories listing the cell if it is given.
+ **********************************************************************************************************************/
+int BatchMode::listCategories()
+{
+    if(!checkArgumentCount(1, 2)) {
+        return 1;
+    }
+
+    QString libName = m_commandArgs[0];
+    QString libPath = getLibraryPath(libName);
+    if(libPath.isEmpty()) {
+        return 1;
+    }
+
+    QStringList categories;
+    if(m_commandArgs.count() > 1) {
+        m_catalog.clearErrors();
+        categories = m_catalog.getCellCategories(libPath, m_commandArgs[1]);
+
+        foreach(const QString &explain, m_catalog.getErrors()) {
+            error(explain);
+        }
+    }
+    else {
+        categories = m_catalog.getCategories(libPath);
+    }
+
+    RecordWriter writer(&m_out, m_format, QStringList()<<"library"<<"category");
+
+    foreach(const QString &catName, categories) {
+        writer.writeRow(QStringList()<<libName<<catName);
+    }
+
+    return 0;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Prints cells of the category.
+ **********************************************************************************************************************/
+int BatchMode::listCategoryCells()
+{
+    if(!checkArgumentCount(2, 2)) {
+        return 1;
+    }
+
+    QString libName = m_commandArgs[0];
+    QString catName = m_commandArgs[1];
+    QString libPath = getLibraryPath(libName);
+    if(libPath.isEmpty()) {
+        return 1;
+    }
+
+    m_catalog.clearErrors();
+    QStringList cells = m_catalog.readCategory(libPath, catName);
+    if(m_catalog.getErrors().count()) {
+        foreach(const QString &explain, m_catalog.getErrors()) {
+            error(explain);
+        }
+
+        return 1;
+    }
+
+    RecordWriter writer(&m_out, m_format, QStringList()<<"library"<<"category"<<"cell");
+
+    foreach(const QString &cellName, cells) {
+        writer.writeRow(QStringList()<<libName<<catName<<cellName);
+    }
+
+    return 0;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Prints documents of the library.
+ **********************************************************************************************************************/
+int BatchMode::listDocuments()
+{
+    if(!checkArgumentCount(1, 1)) {
+        return 1;
+    }
+
+    QString libName = m_commandArgs[0];
+    QString libPath = getLibraryPath(libName);
+    if(libPath.isEmpty()) {
+        return 1;
+    }
+
+    RecordWriter writer(&m_out, m_format, QStringList()<<"library"<<"document"<<"path");
+
+    foreach(const QString &docName, m_catalog.getDocuments(libPath)) {
+        QString docPath = QDir::toNativeSeparators(libPath + "/doc/" + docName);
+        writer.writeRow(QStringList()<<libName<<docName<<docPath);
+    }
+
+    return 0;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Prints cells of all libraries matching the wildcard pattern.
+ **********************************************************************************************************************/
+int BatchMode::searchCells()
+{
+    if(!checkArgumentCount(1, 1)) {
+        return 1;
+    }
+
+    RecordWriter writer(&m_out, m_format, QStringList()<<"library"<<"cell");
+
+    foreach(const QStringList &row, m_catalog.search(m_commandArgs[0])) {
+        writer.writeRow(row);
+    }
+
+    return 0;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Prints libraries and categories using the cell.
+ **********************************************************************************************************************/
+int BatchMode::listWhereUsed()
+{
+    if(!checkArgumentCount(1, 1)) {
+        return 1;
+    }
+
+    RecordWriter writer(&m_out, m_format, QStringList()<<"library"<<"category");
+
+    foreach(const QStringList &row, m_catalog.whereUsed(m_commandArgs[0])) {
+        writer.writeRow(row);
+    }
+
+    m_catalog.clearErrors();
+
+    return 0;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Prints path of the view.
+ **********************************************************************************************************************/
+int BatchMode::resolveView()
+{
+    if(!checkArgumentCount(3, 3)) {
+        return 1;
+    }
+
+    if(getLibraryPath(m_commandArgs[0]).isEmpty()) {
+        return 1;
+    }
+
+    QString viewPath = m_catalog.resolveViewPath(m_commandArgs[0], m_commandArgs[1], m_commandArgs[2]);
+    if(viewPath.isEmpty()) {
+        error(QString("Can not find view '%1' of cell '%2'.").arg(m_commandArgs[2]).arg(m_commandArgs[1]));
+        return 1;
+    }
+
+    RecordWriter writer(&m_out, m_format, QStringList()<<"path");
+    writer.writeRow(QStringList()<<viewPath);
+
+    return 0;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Plans and executes library operations of the script file. Project file is saved if libraries or groups are
+ * changed. With '--dry-run' only the plan and the estimated I/O volume are printed.
+ **********************************************************************************************************************/
+int BatchMode::runScript()
+{
+    if(!checkArgumentCount(1, 1)) {
+        return 1;
+    }
+
+    // Script changes libraries, so answers of the daemon cache can not be used for planning.
+    m_catalog.setClient(0);
+
+    BatchScript script(&m_catalog);
+    if(!script.load(m_commandArgs[0])) {
+        foreach(const QString &explain, script.getErrors()) {
+            error(explain);
+        }
+
+        return 1;
+    }
+
+    if(m_dryRun) {
+        RecordWriter writer(&m_out, m_format, QStringList()<<"line"<<"wave"<<"operation"<<"arguments"
+                                                          <<"depends"<<"files"<<"read_bytes"<<"write_bytes"
+                                                          <<"delete_bytes");
+
+        qint64 readBytes = 0;
+        qint64 writeBytes = 0;
+        qint64 deleteBytes = 0;
+        int fileCount = 0;
+
+        foreach(const BatchScript::Step &step, script.getSteps()) {
+            QStringList depends;
+            foreach(int dependency, step.dependencies) {
+                depends<<QString::number(script.getSteps()[dependency].line);
+            }
+
+            writer.writeRow(QStringList()<<QString::number(step.line)
+                                         <<QString::number(step.wave + 1)
+                                         <<BatchScript::getOperationName(step.operation)
+                                         <<step.arguments.join(" ")
+                                         <<depends.join(",")
+                                         <<QString::number(step.targets.count())
+                                         <<QString::number(step.readBytes)
+                                         <<QString::number(step.writeBytes)
+                                         <<QString::number(step.deleteBytes));
+
+            readBytes += step.readBytes;
+            writeBytes += step.writeBytes;
+            deleteBytes += step.deleteBytes;
+            fileCount += step.targets.count();
+        }
+
+        writer.finish();
+        m_out.flush();
+
+        cerr<<"[INFO] "<<script.getSteps().count()<<" steps in "<<script.getWaveCount()<<" waves, "
+            <<fileCount<<" files, "<<readBytes<<" bytes to read, "<<writeBytes<<" bytes to write, "
+            <<deleteBytes<<" bytes to delete."<<endl;
+
+        return 0;
+    }
+
+    bool isDone = script.execute(m_jobs);
+
+    RecordWriter writer(&m_out, m_format, QStringList()<<"line"<<"operation"<<"arguments"<<"status"<<"message");
+
+    foreach(const BatchScript::Step &step, script.getSteps()) {
+        writer.writeRow(QStringList()<<QString::number(step.line)
+                                     <<BatchScript::getOperationName(step.operation)
+                                     <<step.arguments.join(" ")
+                                     <<BatchScript::getStatusName(step.status)
+                                     <<step.message);
+    }
+
+    writer.finish();
+    m_out.flush();
+
+    if(script.isProjectChanged() && !m_catalog.saveProjectFile(m_catalog.getProjectFile())) {
+        foreach(const QString &explain, m_catalog.getErrors()) {
+            error(explain);
+        }
+
+        return 1;
+    }
+
+    foreach(const QString &explain, script.getErrors()) {
+        error(explain);
+    }
+
+    return isDone ? 0 : 1;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Writes (library, cell, view, size, mtime, hash) rows of all project libraries into the file or to the
+ * standard output. Rows are streamed while libraries are scanned in parallel.
+ **********************************************************************************************************************/
+int BatchMode::exportCatalog()
+{
+    if(!checkArgumentCount(0, 1)) {
+        return 1;
+    }
+
+    CatalogExport::HASH hash = CatalogExport::NO_HASH;
+    if(!m_hash.isEmpty() && !CatalogExport::parseHash(m_hash, &hash)) {
+        error(QString("Unknown checksum '%1'.").arg(m_hash));
+        return 1;
+    }
+
+    QFile file;
+    QTextStream fileOut;
+    QTextStream *out = &m_out;
+
+    if(m_commandArgs.count()) {
+        file.setFileName(m_commandArgs[0]);
+        if(!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            error(QString("Can not write to file '%1': %2.").arg(m_commandArgs[0]).arg(file.errorString()));
+            return 1;
+        }
+
+        fileOut.setDevice(&file);
+        out = &fileOut;
+    }
+
+    CatalogExport catalogExport(m_catalog.getLibraries());
+    catalogExport.setHash(hash);
+    catalogExport.setJobs(m_jobs);
+
+    RecordWriter writer(out, m_format, CatalogExport::getColumns());
+    bool isExported = catalogExport.exportTo(&writer);
+    writer.finish();
+
+    foreach(const QString &explain, catalogExport.getErrors()) {
+        error(explain);
+    }
+
+    return isExported ? 0 : 1;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Indexes SPICE, CDL and Verilog views of the given or of all libraries and prints their subcircuits. Changed
+ * views are parsed in parallel ('--jobs'), the index is kept in the cache folder for the next run and for the GUI.
+ **********************************************************************************************************************/
+int BatchMode::indexNetlists()
+{
+    QMap<QString, QString> libraries;
+    if(m_commandArgs.isEmpty()) {
+        libraries = m_catalog.getLibraries();
+    }
+
+    foreach(const QString &libName, m_commandArgs) {
+        QString libPath = getLibraryPath(libName);
+        if(libPath.isEmpty()) {
+            return 1;
+        }
+
+        libraries[libName] = libPath;
+    }
+
+    QList<QStringList> views = NetlistIndex::getNetlistViews(m_catalog, libraries);
+
+    NetlistIndex index;
+    updateNetlistIndex(&index, views);
+
+    RecordWriter writer(&m_out, m_format, QStringList()<<"library"<<"cell"<<"view"<<"subckt"<<"ports"<<"devices"
+                                                       <<"instances");
+
+    bool isIndexed = true;
+
+    foreach(const QStringList &view, views) {
+        NetlistIndex::View data = index.getView(view[3]);
+
+        foreach(const NetlistParser::Subckt &subckt, data.subckts) {
+            writer.writeRow(QStringList()<<view[0]<<view[1]<<view[2]
+                                         <<subckt.name
+                                         <<subckt.ports.join(" ")
+                                         <<NetlistParser::formatCounts(subckt.devices)
+                                         <<NetlistParser::formatCounts(subckt.instances));
+        }
+
+        foreach(const QString &explain, data.errors) {
+            error(explain);
+            isIndexed = false;
+        }
+    }
+
+    return isIndexed ? 0 : 1;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Prints all subcircuits using ('usedby') or used by ('hierarchy') the subcircuit with their depth and the views
+ * defining them. Netlist views of all project libraries are taken into account.
+ **********************************************************************************************************************/
+int BatchMode::listNetlistRelatives()
+{
+    if(!checkArgumentCount(1, 1)) {
+        return 1;
+    }
+
+    QList<QStringList> views = NetlistIndex::getNetlistViews(m_catalog, m_catalog.getLibraries());
+
+    NetlistIndex index;
+    updateNetlistIndex(&index, views);
+
+    NetlistGraph graph;
+    graph.update(index, views);
+
+    QString name = m_commandArgs[0];
+    if(!graph.contains(name)) {
+        error(QString("Unknown subcircuit '%1'.").arg(name));
+        return 1;
+    }
+
+    QList<NetlistGraph::Relative> relatives = m_command == "usedby" ? graph.getUsers(name, true)
+                                                                     : graph.getChildren(name, true);
+
+    RecordWriter writer(&m_out, m_format, QStringList()<<"subckt"<<"depth"<<"instances"<<"library"<<"cell"<<"view");
+
+    foreach(const NetlistGraph::Relative &relative, relatives) {
+        QList<QStringList> definitions = graph.getDefinitions(relative.name);
+        if(definitions.isEmpty()) {
+            definitions<<(QStringList()<<""<<""<<"");
+        }
+
+        foreach(const QStringList &definition, definitions) {
+            writer.writeRow(QStringList()<<relative.name
+                                         <<QString::number(relative.depth)
+                                         <<QString::number(relative.instances)
+                                         <<definition);
+        }
+    }
+
+    return 0;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Compares layout and netlist views of all cells of the given or of all libraries and prints the findings,
+ * ordered by library and cell or by the column given by '--sort'. Cells are checked in parallel ('--jobs').
+ * \return              1 if a finding has severity 'error', otherwise 0.
+ **********************************************************************************************************************/
+int BatchMode::checkViews()
+{
+    if(!m_sort.isEmpty() && !ViewCheck::getColumns().contains(m_sort)) {
+        error(QString("Unknown sort column '%1', use one of: %2.").arg(m_sort)
+              .arg(ViewCheck::getColumns().join(", ")));
+        return 1;
+    }
+
+    QMap<QString, QString> libraries;
+    if(m_commandArgs.isEmpty()) {
+        libraries = m_catalog.getLibraries();
+    }
+
+    foreach(const QString &libName, m_commandArgs) {
+        QString libPath = getLibraryPath(libName);
+        if(libPath.isEmpty()) {
+            return 1;
+        }
+
+        libraries[libName] = libPath;
+    }
+
+    ViewCheck check;
+    check.scanLibraries(m_catalog, libraries);
+
+    NetlistIndex index;
+    updateNetlistIndex(&index, check.getNetlistViews());
+
+    check.run(index, m_jobs);
+
+    QList<ViewCheck::Issue> issues = check.getIssues();
+    if(!m_sort.isEmpty()) {
+        ViewCheck::sortIssues(&issues, m_sort);
+    }
+
+    RecordWriter writer(&m_out, m_format, ViewCheck::getColumns());
+
+    foreach(const ViewCheck::Issue &issue, issues) {
+        writer.writeRow(ViewCheck::toRow(issue));
+    }
+
+    writer.finish();
+
+    cerr<<"[INFO] Checked "<<check.getCellCount()<<" cells: "<<check.getErrorCount()<<" errors, "
+        <<issues.count() - check.getErrorCount()<<" warnings."<<endl;
+
+    return check.getErrorCount() ? 1 : 0;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Imports a netlist with many subcircuits into per-cell views of the library. The view is given by '--view' or
+ * derived from the file suffix; existing views are kept unless '--overwrite' is given, '--with-deps' copies the
+ * instantiated subcircuits into every view and '--dry-run' only lists the planned views. Files are written in parallel
+ * ('--jobs') and the catalog daemon is told once at the end to rescan the library.
+ **********************************************************************************************************************/
+int BatchMode::splitNetlist()
+{
+    if(m_commandArgs.count() < 2) {
+        error(QString("Incorrect number of arguments for command '%1'.").arg(m_command));
+        return 1;
+    }
+
+    QString fileName = m_commandArgs[0];
+    QString libPath = getLibraryPath(m_commandArgs[1]);
+    if(libPath.isEmpty()) {
+        return 1;
+    }
+
+    QString viewName = m_view.isEmpty() ? NetlistSplitter::getViewName(fileName) : m_view;
+    if(viewName != "cdl" && viewName != "spice") {
+        error(QString("Can not derive view of '%1', please use '--view cdl|spice'.").arg(fileName));
+        return 1;
+    }
+
+    NetlistSplitter splitter;
+    bool isRead = splitter.read(fileName);
+
+    foreach(const QString &explain, splitter.getErrors()) {
+        error(explain);
+    }
+
+    if(splitter.getSubcktNames().isEmpty()) {
+        error(QString("No subcircuits found in '%1'.").arg(fileName));
+        return 1;
+    }
+
+    int written = splitter.write(libPath, viewName, m_commandArgs.mid(2), m_withDependencies, m_overwrite, m_dryRun,
+                                 m_jobs);
+
+    if(written) {
+        m_catalog.invalidateLibrary(libPath);
+    }
+
+    RecordWriter writer(&m_out, m_format, NetlistSplitter::getColumns());
+
+    foreach(const QStringList &row, splitter.getReport()) {
+        writer.writeRow(row);
+    }
+
+    writer.finish();
+
+    foreach(const QString &explain, splitter.getErrors()) {
+        error(explain);
+    }
+
+    cerr<<"[INFO] Wrote "<<written<<" of "<<splitter.getReport().count()<<" '"<<viewName.toStdString()
+        <<"' views."<<endl;
+
+    return isRead && splitter.getErrors().isEmpty() ? 0 : 1;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Lists cells of a Liberty file with their area, pins and byte range, or prints the 'cell' groups of the given
+ * cells. The file is scanned once and its index kept in the cache folder, so later calls read only the cell groups.
+ **********************************************************************************************************************/
+int BatchMode::indexLiberty()
+{
+    if(m_commandArgs.isEmpty()) {
+        error(QString("Incorrect number of arguments for command '%1'.").arg(m_command));
+        return 1;
+    }
+
+    QString fileName = m_commandArgs[0];
+
+    LibertyIndex index;
+    bool isIndexed = index.update(fileName);
+
+    foreach(const QString &explain, index.getErrors()) {
+        error(explain);
+    }
+
+    if(!isIndexed) {
+        return 1;
+    }
+
+    QStringList cellNames = m_commandArgs.mid(1);
+    if(cellNames.isEmpty()) {
+        RecordWriter writer(&m_out, m_format, QStringList()<<"library"<<"cell"<<"area"<<"pins"<<"offset"<<"length");
+
+        foreach(const LibertyIndex::Cell &cell, index.getCells()) {
+            writer.writeRow(QStringList()<<index.getLibraryName()<<cell.name<<cell.area
+                                         <<LibertyIndex::formatPins(cell.pins)
+                                         <<QString::number(cell.offset)<<QString::number(cell.length));
+        }
+
+        writer.finish();
+
+        cerr<<"[INFO] Indexed "<<index.getCells().count()<<" cells of '"<<fileName.toStdString()<<"'."<<endl;
+
+        return 0;
+    }
+
+    bool isRead = true;
+
+    foreach(const QString &cellName, cellNames) {
+        QByteArray text = index.readCell(cellName);
+
+        foreach(const QString &explain, index.getErrors()) {
+            error(explain);
+            isRead = false;
+        }
+
+        if(!text.isEmpty()) {
+            m_out<<QString::fromLatin1(text)<<"\n";
+        }
+    }
+
+    m_out.flush();
+
+    return isRead ? 0 : 1;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Lists the macros of the LEF views of the given or of all libraries with the views of the library cell named
+ * like the macro. Netlist views of these cells are taken from the netlist index and their ports compared with the LEF
+ * pins. LEF views are scanned in parallel ('--jobs').
+ * \return              1 if a LEF view can not be scanned, otherwise 0.
+ **********************************************************************************************************************/
+int BatchMode::indexLef()
+{
+    QMap<QString, QString> libraries;
+    if(m_commandArgs.isEmpty()) {
+        libraries = m_catalog.getLibraries();
+    }
+
+    foreach(const QString &libName, m_commandArgs) {
+        QString libPath = getLibraryPath(libName);
+        if(libPath.isEmpty()) {
+            return 1;
+        }
+
+        libraries[libName] = libPath;
+    }
+
+    LefIndex lefIndex;
+    lefIndex.scanLibraries(m_catalog, libraries);
+    lefIndex.update(m_jobs);
+
+    NetlistIndex index;
+    updateNetlistIndex(&index, lefIndex.getNetlistViews());
+
+    lefIndex.link(index);
+
+    RecordWriter writer(&m_out, m_format, LefIndex::getColumns());
+
+    foreach(const LefIndex::Entry &entry, lefIndex.getEntries()) {
+        writer.writeRow(LefIndex::toRow(entry));
+    }
+
+    writer.finish();
+
+    foreach(const QString &explain, lefIndex.getErrors()) {
+        error(explain);
+    }
+
+    cerr<<"[INFO] Scanned "<<lefIndex.getViewCount()<<" LEF views: "<<lefIndex.getEntries().count()<<" macros."<<endl;
+
+    return lefIndex.getErrors().isEmpty() ? 0 : 1;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Lists the changes between two versions of a SPICE, CDL or GDSII view. The format is taken from the suffix of
+ * the new file. Subcircuits or structures which are equal in both versions are skipped by a hash or byte compare.
+ * \return              1 if a file can not be read, otherwise 0.
+ **********************************************************************************************************************/
+int BatchMode::diffViews()
+{
+    if(!checkArgumentCount(2, 2)) {
+        return 1;
+    }
+
+    QString oldFile = m_commandArgs[0];
+    QString newFile = m_commandArgs[1];
+    QString suffix = QFileInfo(newFile).suffix().toLower();
+
+    QStringList columns;
+    QList<QStringList> changes;
+    QStringList errors;
+    int identicalCount = 0;
+    bool isCompared = false;
+
+    if(suffix == "gds" || suffix == "gds2" || suffix == "gdsii") {
+        GdsDiff diff;
+        isCompared = diff.diff(oldFile, newFile);
+
+        columns = GdsDiff::getColumns();
+        changes = diff.getChanges();
+        errors = diff.getErrors();
+        identicalCount = diff.getIdenticalCount();
+    }
+    else if(suffix == "v" || suffix == "sv") {
+        error(QString("Verilog file '%1' can not be compared.").arg(newFile));
+        return 1;
+    }
+    else {
+        NetlistDiff diff;
+        isCompared = diff.diff(oldFile, newFile);
+
+        columns = NetlistDiff::getColumns();
+        changes = diff.getChanges();
+        errors = diff.getErrors();
+        identicalCount = diff.getIdenticalCount();
+    }
+
+    foreach(const QString &explain, errors) {
+        error(explain);
+    }
+
+    if(!isCompared) {
+        return 1;
+    }
+
+    RecordWriter writer(&m_out, m_format, columns);
+
+    foreach(const QStringList &change, changes) {
+        writer.writeRow(change);
+    }
+
+    writer.finish();
+
+    cerr<<"[INFO] "<<changes.count()<<" changes, "<<identicalCount<<" identical cells skipped."<<endl;
+
+    return errors.isEmpty() ? 0 : 1;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Loads the netlist index from the cache folder, parses changed views in parallel ('--jobs') and saves it.
+ * \param index         Index to update.
+ * \param views         Rows of library, cell, view and view path.
+ * \return              Number of parsed views.
+ **********************************************************************************************************************/
+int BatchMode::updateNetlistIndex(NetlistIndex *index, const QList<QStringList> &views)
+{
+    QString indexFile = NetlistIndex::getDefaultFile();
+    if(!index->load(indexFile)) {
+        foreach(const QString &explain, index->getErrors()) {
+            error(explain);
+        }
+    }
+
+    QStringList viewPaths;
+    foreach(const QStringList &view, views) {
+        viewPaths<<view[3];
+    }
+
+    int parsed = index->update(viewPaths, m_jobs);
+
+    if(index->isChanged() && !index->save(indexFile)) {
+        foreach(const QString &explain, index->getErrors()) {
+            error(explain);
+        }
+    }
+
+    cerr<<"[INFO] Indexed "<<viewPaths.count()<<" netlist views, "<<parsed<<" of them parsed."<<endl;
+
+    return parsed;
+}
@@ -0,0 +1,80 @@
+#ifndef BATCHMODE_H
+#define BATCHMODE_H
+
+#include <QStringList>
+#include <QTextStream>
+
+#include "catalog.h"
+#include "catalogclient.h"
+#include "catalogexport.h"
+#include "recordwriter.h"
+
+class NetlistIndex;
+
+/*!*********************************************************************************************************************
+ * \brief The BatchMode class runs LibMan without GUI. It answers catalog queries (libraries, cells, views, categories,
+ * documents) of a project file and prints the result as JSON or TSV to the standard output. If a catalog daemon
+ * serves the project, queries are sent to it instead of scanning libraries. Bulk library operations are executed from
+ * a script file by BatchScript.
+ **********************************************************************************************************************/
+class BatchMode
+{
+public:
+    explicit BatchMode(const QStringList &arguments);
+
+    int                                 exec();
+
+    static bool                         isRequested(int argc, char *argv[]);
+
+private:
+    bool                                parseArguments();
+    bool                                loadProject();
+    void                                printUsage() const;
+    void                                error(const QString &msg) const;
+
+    bool                                checkArgumentCount(int min, int max) const;
+    QString                             getLibraryPath(const QString &libName) const;
+
+    int                                 listLibraries();
+    int                                 listGroups();
+    int                                 listCells();
+    int                                 listViews();
+    int                                 listCategories();
+    int                                 listCategoryCells();
+    int                                 listDocuments();
+    int                                 searchCells();
+    int                                 listWhereUsed();
+    int                                 resolveView();
+    int                                 runScript();
+    int                                 exportCatalog();
+    int                                 indexNetlists();
+    int                                 listNetlistRelatives();
+    int                                 checkViews();
+    int                                 splitNetlist();
+    int                                 indexLiberty();
+    int                                 indexLef();
+    int                                 diffViews();
+
+    int                                 updateNetlistIndex(NetlistIndex *index, const QList<QStringList> &views);
+
+private:
+    QStringList                         m_arguments;        /*!< Command line arguments without program name. */
+    QString                             m_projFile;         /*!< Path to the project file to load. */
+    QString                             m_command;          /*!< Name of the query to execute. */
+    QStringList                         m_commandArgs;      /*!< Arguments of the query. */
+    RecordWriter::FORMAT                m_format;           /*!< Output format. */
+    bool                                m_useDaemon;        /*!< State if catalog daemon may be used. */
+    bool                                m_dryRun;           /*!< State if script is only planned, not executed. */
+    bool                                m_withDependencies; /*!< State if split views include their dependencies. */
+    bool                                m_overwrite;        /*!< State if split views replace existing ones. */
+    int                                 m_jobs;             /*!< Maximal number of parallel script steps or scans. */
+    QString                             m_hash;             /*!< Checksum of exported view files. */
+    QString                             m_sort;             /*!< Column the check report is sorted by. */
+    QString                             m_view;             /*!< View written by split, derived from file if empty. */
+
+    Catalog                             m_catalog;          /*!< Project and library data. */
+    CatalogClient                       m_client;           /*!< Connection to the catalog daemon. */
+    QTextStream                         m_out;              /*!< Standard output stream. */
+};
+
+#endif // BATCHMODE_H
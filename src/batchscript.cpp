@@ -0,0 +1,624 @@
+#include <QDir>
+#include <QFile>
+#include <QMutex>
+#include <QRunnable>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QThreadPool>
+
+#include "batchscript.h"
+#include "catalog.h"
+#include "perfcounters.h"
+#include "trace.h"
+#include "gds/gdsreader.h"
+
+/*!*********************************************************************************************************************
+ * \brief The BatchStepRunner class executes a single step of BatchScript in a thread of the pool.
+ **********************************************************************************************************************/
+class BatchStepRunner : public QRunnable
+{
+public:
+    BatchStepRunner(BatchScript *script, BatchScript::Step *step) : m_script(script), m_step(step) {}
+
+    void run() { m_script->executeStep(m_step); }
+
+private:
+    BatchScript                         *m_script;          /*!< Script owning the step. */
+    BatchScript::Step                   *m_step;            /*!< Step to execute. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Resource name used by steps changing libraries or groups of the project.
+ **********************************************************************************************************************/
+static const QString PROJECT_RESOURCE = "project:";
+
+/*!*********************************************************************************************************************
+ * \brief Constructs BatchScript object.
+ * \param catalog       Project to be changed by the script.
+ **********************************************************************************************************************/
+BatchScript::BatchScript(Catalog *catalog)
+    : m_catalog(catalog),
+      m_waveCount(0),
+      m_projectChanged(false)
+{
+}
+
+/*!*********************************************************************************************************************
+ * \brief Reads and plans the script file.
+ * \param fileName      Path to the script file.
+ * \return              True if all commands are valid, otherwise false and the reasons are added to the error list.
+ **********************************************************************************************************************/
+bool BatchScript::load(const QString &fileName)
+{
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        m_errorList<<QString("Can not read file '%1':\n%2.").arg(fileName).arg(file.errorString());
+        return false;
+    }
+
+    QStringList lines;
+
+    QTextStream in(&file);
+    while(!in.atEnd()) {
+        lines<<in.readLine();
+    }
+
+    file.close();
+
+    return plan(lines);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Plans script commands. Library names are resolved and each step gets its files, estimated I/O volume,
+ * dependencies and execution wave. Nothing is changed on disk.
+ * \param lines         Lines of the script.
+ * \return              True if all commands are valid, otherwise false and the reasons are added to the error list.
+ **********************************************************************************************************************/
+bool BatchScript::plan(const QStringList &lines)
+{
+    m_steps.clear();
+    m_waveCount = 0;
+    m_projectChanged = false;
+    m_errorList.clear();
+
+    m_plannedLibs = m_catalog->getLibraries();
+    m_plannedFiles.clear();
+    m_lastWriter.clear();
+    m_lastReaders.clear();
+
+    for(int i = 0; i < lines.count(); ++i) {
+        QString line = lines[i];
+
+        int commentPos = line.indexOf('#');
+        if(commentPos >= 0) {
+            line.truncate(commentPos);
+        }
+
+        line = line.simplified();
+        if(line.isEmpty()) {
+            continue;
+        }
+
+        planStep(i + 1, line.split(" "));
+    }
+
+    return m_errorList.isEmpty();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Plans a single script command and appends it to the steps.
+ * \param line          Line number in the script.
+ * \param fields        Command and its arguments.
+ * \return              True if command is valid, otherwise false and the reason is added to the error list.
+ **********************************************************************************************************************/
+bool BatchScript::planStep(int line, const QStringList &fields)
+{
+    static const int minArgs[] = { 2, 1, 2, 1, 3, 4, 3, 2, 3 };
+    static const int maxArgs[] = { 2, 1, -1, 1, 4, 5, 3, 2, 3 };
+
+    QString command = fields[0].toUpper();
+    QStringList args = fields.mid(1);
+
+    int index = -1;
+    for(int i = 0; i <= DELETE_VIEW; ++i) {
+        if(command == getOperationName(OPERATION(i))) {
+            index = i;
+            break;
+        }
+    }
+
+    if(index < 0) {
+        m_errorList<<QString("Line %1: unknown command '%2'.").arg(line).arg(fields[0]);
+        return false;
+    }
+
+    if(args.count() < minArgs[index] || (maxArgs[index] >= 0 && args.count() > maxArgs[index])) {
+        m_errorList<<QString("Line %1: incorrect number of arguments for command '%2'.").arg(line).arg(command);
+        return false;
+    }
+
+    Step step;
+    step.line = line;
+    step.operation = OPERATION(index);
+    step.arguments = args;
+    step.wave = 0;
+    step.readBytes = 0;
+    step.writeBytes = 0;
+    step.deleteBytes = 0;
+    step.status = PENDING;
+
+    QStringList validViews = Catalog::getValidViewList();
+
+    switch(step.operation) {
+    case ADD_LIBRARY: {
+        step.libPath = QDir::toNativeSeparators(QDir(args[1]).absolutePath());
+        step.modified<<PROJECT_RESOURCE<<step.libPath;
+        m_plannedLibs[args[0]] = step.libPath;
+        m_projectChanged = true;
+        break;
+    }
+    case REMOVE_LIBRARY: {
+        if(resolveLibrary(line, args[0]).isEmpty()) {
+            return false;
+        }
+
+        step.modified<<PROJECT_RESOURCE;
+        m_plannedLibs.remove(args[0]);
+        m_projectChanged = true;
+        break;
+    }
+    case GROUP: {
+        foreach(const QString &libName, args.mid(1)) {
+            if(resolveLibrary(line, libName).isEmpty()) {
+                return false;
+            }
+        }
+
+        step.modified<<PROJECT_RESOURCE;
+        m_projectChanged = true;
+        break;
+    }
+    case UNGROUP: {
+        step.modified<<PROJECT_RESOURCE;
+        m_projectChanged = true;
+        break;
+    }
+    case COPY_CELL:
+    case COPY_VIEW: {
+        bool isCell = step.operation == COPY_CELL;
+        QString tarLibName = isCell ? args[2] : args[3];
+        QString tarCellName = args.value(isCell ? 3 : 4, args[1]);
+
+        step.libPath = resolveLibrary(line, args[0]);
+        QString tarLibPath = resolveLibrary(line, tarLibName);
+        if(step.libPath.isEmpty() || tarLibPath.isEmpty()) {
+            return false;
+        }
+
+        QStringList views;
+        if(isCell) {
+            views = getPlannedViews(step.libPath, args[1]);
+            if(views.isEmpty()) {
+                m_errorList<<QString("Line %1: cell '%2' has no views in library '%3'.")
+                             .arg(line).arg(args[1]).arg(args[0]);
+                return false;
+            }
+        }
+        else {
+            views<<args[2];
+            if(getPlannedSize(Catalog::getViewPath(step.libPath, args[1], args[2])) < 0) {
+                m_errorList<<QString("Line %1: view '%2' of cell '%3' does not exist in library '%4'.")
+                             .arg(line).arg(args[2]).arg(args[1]).arg(args[0]);
+                return false;
+            }
+        }
+
+        foreach(const QString &viewName, views) {
+            QString src = Catalog::getViewPath(step.libPath, args[1], viewName);
+            QString tar = Catalog::getViewPath(tarLibPath, tarCellName, viewName);
+            if(src == tar) {
+                m_errorList<<QString("Line %1: source and target of '%2' are the same.").arg(line).arg(src);
+                return false;
+            }
+
+            qint64 size = getPlannedSize(src);
+
+            step.sources<<src;
+            step.targets<<tar;
+            step.readBytes += size;
+            step.writeBytes += size;
+            m_plannedFiles[tar] = size;
+        }
+
+        step.resources<<step.libPath<<tarLibPath<<step.sources;
+        step.modified<<step.targets;
+        break;
+    }
+    case CREATE_VIEW: {
+        if(!validViews.contains(args[2])) {
+            m_errorList<<QString("Line %1: unknown view '%2'.").arg(line).arg(args[2]);
+            return false;
+        }
+
+        step.libPath = resolveLibrary(line, args[0]);
+        if(step.libPath.isEmpty()) {
+            return false;
+        }
+
+        QString viewPath = Catalog::getViewPath(step.libPath, args[1], args[2]);
+        if(getPlannedSize(viewPath) >= 0) {
+            m_errorList<<QString("Line %1: view '%2' already exists.").arg(line).arg(viewPath);
+            return false;
+        }
+
+        step.targets<<viewPath;
+        step.resources<<step.libPath;
+        step.modified<<viewPath;
+        m_plannedFiles[viewPath] = 0;
+        break;
+    }
+    case DELETE_CELL:
+    case DELETE_VIEW: {
+        step.libPath = resolveLibrary(line, args[0]);
+        if(step.libPath.isEmpty()) {
+            return false;
+        }
+
+        QStringList views;
+        if(step.operation == DELETE_CELL) {
+            views = getPlannedViews(step.libPath, args[1]);
+        }
+        else if(getPlannedSize(Catalog::getViewPath(step.libPath, args[1], args[2])) >= 0) {
+            views<<args[2];
+        }
+
+        if(views.isEmpty()) {
+            m_errorList<<QString("Line %1: nothing to delete for cell '%2' in library '%3'.")
+                         .arg(line).arg(args[1]).arg(args[0]);
+            return false;
+        }
+
+        foreach(const QString &viewName, views) {
+            QString viewPath = Catalog::getViewPath(step.libPath, args[1], viewName);
+            step.targets<<viewPath;
+            step.deleteBytes += getPlannedSize(viewPath);
+            m_plannedFiles[viewPath] = -1;
+        }
+
+        step.resources<<step.libPath;
+        step.modified<<step.targets;
+        break;
+    }
+    }
+
+    addDependencies(&step);
+    m_steps<<step;
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Adds dependencies on earlier steps and assigns execution wave. A step depends on the last step modifying a
+ * resource it uses and on all steps reading a resource since it modifies it.
+ * \param step          Step to be appended to the steps.
+ **********************************************************************************************************************/
+void BatchScript::addDependencies(Step *step)
+{
+    int index = m_steps.count();
+
+    foreach(const QString &resource, step->resources + step->modified) {
+        if(m_lastWriter.contains(resource)) {
+            int writer = m_lastWriter[resource];
+            if(!step->dependencies.contains(writer)) {
+                step->dependencies<<writer;
+            }
+        }
+    }
+
+    foreach(const QString &resource, step->modified) {
+        foreach(int reader, m_lastReaders.value(resource)) {
+            if(reader != index && !step->dependencies.contains(reader)) {
+                step->dependencies<<reader;
+            }
+        }
+    }
+
+    foreach(const QString &resource, step->resources) {
+        m_lastReaders[resource]<<index;
+    }
+
+    foreach(const QString &resource, step->modified) {
+        m_lastWriter[resource] = index;
+        m_lastReaders.remove(resource);
+    }
+
+    foreach(int dependency, step->dependencies) {
+        step->wave = qMax(step->wave, m_steps[dependency].wave + 1);
+    }
+
+    m_waveCount = qMax(m_waveCount, step->wave + 1);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Executes planned steps wave by wave. Steps of a wave run in parallel, steps depending on a failed step are
+ * skipped.
+ * \param jobs          Maximal number of parallel steps, 0 to use number of CPU cores.
+ * \return              True if all steps are done, otherwise false and the reasons are added to the error list.
+ **********************************************************************************************************************/
+bool BatchScript::execute(int jobs)
+{
+    TRACE_SCOPE("file", "script");
+
+    QThreadPool pool;
+    if(jobs > 0) {
+        pool.setMaxThreadCount(jobs);
+    }
+
+    for(int wave = 0; wave < m_waveCount; ++wave) {
+        for(int i = 0; i < m_steps.count(); ++i) {
+            Step &step = m_steps[i];
+            if(step.wave != wave) {
+                continue;
+            }
+
+            foreach(int dependency, step.dependencies) {
+                if(m_steps[dependency].status != DONE) {
+                    step.status = SKIPPED;
+                    step.message = QString("Step of line %1 is not done.").arg(m_steps[dependency].line);
+                    break;
+                }
+            }
+
+            if(step.status == SKIPPED) {
+                continue;
+            }
+
+            // Project steps change the catalog, they depend on each other and never share a wave.
+            if(step.operation <= UNGROUP) {
+                executeStep(&step);
+            }
+            else {
+                pool.start(new BatchStepRunner(this, &step));
+            }
+        }
+
+        pool.waitForDone();
+    }
+
+    foreach(const Step &step, m_steps) {
+        if(step.status == DONE) {
+            PerfCounters::add(PerfCounters::JOBS_DONE);
+        }
+        else if(step.status == FAILED) {
+            PerfCounters::add(PerfCounters::JOBS_FAILED);
+            m_errorList<<QString("Line %1: %2").arg(step.line).arg(step.message);
+        }
+    }
+
+    return m_errorList.isEmpty();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Executes a single step. It is called from threads of the pool, so only the step itself is changed.
+ * \param step          Step to execute.
+ **********************************************************************************************************************/
+void BatchScript::executeStep(Step *step)
+{
+    TRACE_SCOPE_ARG("file", "step", getOperationName(step->operation) + " " + step->arguments.join(" "));
+    PerfTimer perfTimer(PerfCounters::JOB_DURATION);
+
+    const QStringList &args = step->arguments;
+
+    step->status = DONE;
+
+    switch(step->operation) {
+    case ADD_LIBRARY:
+        if(!QFileInfo(step->libPath).isDir() && !QDir().mkpath(step->libPath)) {
+            step->status = FAILED;
+            step->message = QString("Can not create folder '%1'.").arg(step->libPath);
+            return;
+        }
+
+        m_catalog->setLibrary(args[0], step->libPath);
+        break;
+    case REMOVE_LIBRARY:
+        m_catalog->removeLibrary(args[0]);
+        break;
+    case GROUP:
+        m_catalog->setCombinedLib(args[0], args.mid(1));
+        break;
+    case UNGROUP:
+        m_catalog->removeCombinedLib(args[0]);
+        break;
+    case COPY_CELL:
+    case COPY_VIEW:
+        for(int i = 0; i < step->sources.count() && step->status == DONE; ++i) {
+            copyFile(step, step->sources[i], step->targets[i]);
+        }
+        break;
+    case CREATE_VIEW:
+        createView(step, step->targets[0], args[1]);
+        break;
+    case DELETE_CELL:
+    case DELETE_VIEW:
+        foreach(const QString &filePath, step->targets) {
+            removeFile(step, filePath);
+        }
+        break;
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Copies view file, an existing target is replaced.
+ * \param step          Step to report failure to.
+ * \param src           Path to the source view.
+ * \param tar           Path to the target view.
+ **********************************************************************************************************************/
+void BatchScript::copyFile(Step *step, const QString &src, const QString &tar) const
+{
+    QString tarPath = QFileInfo(tar).absolutePath();
+    if(!QFileInfo(tarPath).isDir()) {
+        QDir().mkpath(tarPath);
+    }
+
+    if(QFileInfo(tar).exists()) {
+        QFile::remove(tar);
+    }
+
+    if(!Catalog::copyFile(src, tar)) {
+        step->status = FAILED;
+        step->message = QString("Can not copy '%1' to '%2'.").arg(src).arg(tar);
+        return;
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Creates new view. Layout views get an empty cell structure, other views an empty file.
+ * \param step          Step to report failure to.
+ * \param viewPath      Path to the view to be created.
+ * \param cellName      Name of the cell.
+ **********************************************************************************************************************/
+void BatchScript::createView(Step *step, const QString &viewPath, const QString &cellName) const
+{
+    QString groupPath = QFileInfo(viewPath).absolutePath();
+    if(!QFileInfo(groupPath).isDir() && !QDir().mkpath(groupPath)) {
+        step->status = FAILED;
+        step->message = QString("Failed to create a group '%1'").arg(groupPath);
+        return;
+    }
+
+    if(QFileInfo(viewPath).suffix() == "gds") {
+        // GdsReader keeps its time stamp in a static buffer.
+        static QMutex gdsMutex;
+        QMutexLocker locker(&gdsMutex);
+
+        GdsReader gdsReader(viewPath);
+        gdsReader.gdsCreate(cellName);
+
+        QStringList errors = gdsReader.getErrors();
+        if(errors.count()) {
+            step->status = FAILED;
+            step->message = errors.join(" ");
+            return;
+        }
+    }
+    else {
+        QFile file(viewPath);
+        if(!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            step->status = FAILED;
+            step->message = QString("Can not write to file '%1': %2.").arg(viewPath).arg(file.errorString());
+            return;
+        }
+
+        file.close();
+    }
+
+    QFileInfo viewInfo(viewPath);
+    if(!viewInfo.exists()) {
+        step->status = FAILED;
+        step->message = QString("Can not create view '%1'.").arg(viewPath);
+        return;
+    }
+
+    PerfCounters::add(PerfCounters::FILES_WRITTEN);
+    PerfCounters::add(PerfCounters::BYTES_WRITTEN, viewInfo.size());
+}
+
+/*!*********************************************************************************************************************
+ * \brief Removes view file.
+ * \param step          Step to report failure to.
+ * \param filePath      Path to the view.
+ **********************************************************************************************************************/
+void BatchScript::removeFile(Step *step, const QString &filePath) const
+{
+    if(QFileInfo(filePath).exists() && !QFile::remove(filePath)) {
+        step->status = FAILED;
+        step->message = QString("Can not remove '%1'.").arg(filePath);
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns path of the library as it is after the planned steps or reports an error if library is unknown.
+ * \param line          Line number in the script.
+ * \param libName       Name of the library.
+ **********************************************************************************************************************/
+QString BatchScript::resolveLibrary(int line, const QString &libName)
+{
+    QString libPath = m_plannedLibs.value(libName);
+    if(libPath.isEmpty()) {
+        m_errorList<<QString("Line %1: unknown library '%2'.").arg(line).arg(libName);
+    }
+
+    return libPath;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns views of the cell as they are after the planned steps.
+ * \param libPath       Path to the library.
+ * \param cellName      Name of the cell.
+ **********************************************************************************************************************/
+QStringList BatchScript::getPlannedViews(const QString &libPath, const QString &cellName) const
+{
+    QStringList views;
+
+    foreach(const QString &viewName, Catalog::getValidViewList()) {
+        if(getPlannedSize(Catalog::getViewPath(libPath, cellName, viewName)) >= 0) {
+            views<<viewName;
+        }
+    }
+
+    return views;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns size of the file as it is after the planned steps or -1 if file does not exist.
+ * \param filePath      Path to the file.
+ **********************************************************************************************************************/
+qint64 BatchScript::getPlannedSize(const QString &filePath) const
+{
+    QMap<QString, qint64>::const_iterator it = m_plannedFiles.constFind(filePath);
+    if(it != m_plannedFiles.constEnd()) {
+        return it.value();
+    }
+
+    QFileInfo fileInfo(filePath);
+
+    return fileInfo.isFile() ? fileInfo.size() : -1;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns script command name of the operation.
+ * \param operation     Operation of the step.
+ **********************************************************************************************************************/
+QString BatchScript::getOperationName(OPERATION operation)
+{
+    switch(operation) {
+    case ADD_LIBRARY:       return "ADD_LIBRARY";
+    case REMOVE_LIBRARY:    return "REMOVE_LIBRARY";
+    case GROUP:             return "GROUP";
+    case UNGROUP:           return "UNGROUP";
+    case COPY_CELL:         return "COPY_CELL";
+    case COPY_VIEW:         return "COPY_VIEW";
+    case CREATE_VIEW:       return "CREATE_VIEW";
+    case DELETE_CELL:       return "DELETE_CELL";
+    case DELETE_VIEW:       return "DELETE_VIEW";
+    }
+
+    return QString();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns name of the execution state.
+ * \param status        Execution state of the step.
+ **********************************************************************************************************************/
+QString BatchScript::getStatusName(STATUS status)
+{
+    switch(status) {
+    case PENDING:           return "pending";
+    case DONE:              return "done";
+    case FAILED:            return "failed";
+    case SKIPPED:           return "skipped";
+    }
+
+    return QString();
+}
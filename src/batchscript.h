@@ -0,0 +1,151 @@
+#ifndef BATCHSCRIPT_H
+#define BATCHSCRIPT_H
+
+#include <QMap>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+class Catalog;
+
+/*!*********************************************************************************************************************
+ * \brief The BatchScript class runs a command file with bulk library operations. The whole script is planned first:
+ * library names are resolved, files read and written by every step are collected and each step gets dependencies on
+ * the earlier steps touching the same files. Steps are then executed in waves, where all steps of a wave are
+ * independent of each other and run in parallel.
+ *
+ * Script syntax, one command per line, '#' starts a comment:
+ *
+ *     ADD_LIBRARY <library> <path>
+ *     REMOVE_LIBRARY <library>
+ *     GROUP <group> <library> [library...]
+ *     UNGROUP <group>
+ *     COPY_CELL <library> <cell> <target library> [target cell]
+ *     COPY_VIEW <library> <cell> <view> <target library> [target cell]
+ *     CREATE_VIEW <library> <cell> <view>
+ *     DELETE_CELL <library> <cell>
+ *     DELETE_VIEW <library> <cell> <view>
+ **********************************************************************************************************************/
+class BatchScript
+{
+public:
+    /*!
+     * \brief The OPERATION enum specifies supported script commands.
+     */
+    enum OPERATION {
+        ADD_LIBRARY                     = 0,
+        REMOVE_LIBRARY,
+        GROUP,
+        UNGROUP,
+        COPY_CELL,
+        COPY_VIEW,
+        CREATE_VIEW,
+        DELETE_CELL,
+        DELETE_VIEW
+    };
+
+    /*!
+     * \brief The STATUS enum specifies execution state of a step.
+     */
+    enum STATUS {
+        PENDING                         = 0,
+        DONE,
+        FAILED,
+        SKIPPED
+    };
+
+    /*!
+     * \brief The Step struct keeps a planned script command.
+     */
+    struct Step {
+        int                             line;               /*!< Line number in the script. */
+        OPERATION                       operation;          /*!< Command of the step. */
+        QStringList                     arguments;          /*!< Arguments of the command. */
+        QString                         libPath;            /*!< Resolved path of the (source) library. */
+        QStringList                     sources;            /*!< Files read by the step. */
+        QStringList                     targets;            /*!< Files created, replaced or removed by the step. */
+        QStringList                     resources;          /*!< Resources read by the step. */
+        QStringList                     modified;           /*!< Resources modified by the step. */
+        QList<int>                      dependencies;       /*!< Indexes of steps to be finished before this one. */
+        int                             wave;               /*!< Index of the wave the step is executed in. */
+        qint64                          readBytes;          /*!< Estimated number of bytes to read. */
+        qint64                          writeBytes;         /*!< Estimated number of bytes to write. */
+        qint64                          deleteBytes;        /*!< Estimated number of bytes to remove. */
+        STATUS                          status;             /*!< Execution state. */
+        QString                         message;            /*!< Error message of a failed step. */
+    };
+
+    explicit BatchScript(Catalog *catalog);
+
+    bool                                load(const QString &fileName);
+    bool                                plan(const QStringList &lines);
+    bool                                execute(int jobs);
+
+    void                                executeStep(Step *step);
+
+    const QList<Step>&                  getSteps() const;
+    int                                 getWaveCount() const;
+    bool                                isProjectChanged() const;
+    QStringList                         getErrors() const;
+
+    static QString                      getOperationName(OPERATION operation);
+    static QString                      getStatusName(STATUS status);
+
+private:
+    bool                                planStep(int line, const QStringList &fields);
+    void                                addDependencies(Step *step);
+
+    QString                             resolveLibrary(int line, const QString &libName);
+    QStringList                         getPlannedViews(const QString &libPath, const QString &cellName) const;
+    qint64                              getPlannedSize(const QString &filePath) const;
+
+    void                                copyFile(Step *step, const QString &src, const QString &tar) const;
+    void                                createView(Step *step, const QString &viewPath, const QString &cellName) const;
+    void                                removeFile(Step *step, const QString &filePath) const;
+
+private:
+    Catalog                             *m_catalog;         /*!< Project to be changed, not owned. */
+    QList<Step>                         m_steps;            /*!< Planned steps in script order. */
+    int                                 m_waveCount;        /*!< Number of execution waves. */
+    bool                                m_projectChanged;   /*!< State if script changes libraries or groups. */
+    QStringList                         m_errorList;        /*!< Errors of planning and execution. */
+
+    QMap<QString, QString>              m_plannedLibs;      /*!< Libraries of the project after planned steps. */
+    QMap<QString, qint64>               m_plannedFiles;     /*!< Sizes of files after planned steps, -1 if removed. */
+    QMap<QString, int>                  m_lastWriter;       /*!< Map of resources to the step modifying it last. */
+    QMap<QString, QList<int> >          m_lastReaders;      /*!< Map of resources to steps reading it since then. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Returns planned steps in script order.
+ **********************************************************************************************************************/
+inline const QList<BatchScript::Step>& BatchScript::getSteps() const
+{
+    return m_steps;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns number of execution waves.
+ **********************************************************************************************************************/
+inline int BatchScript::getWaveCount() const
+{
+    return m_waveCount;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if script changes libraries or groups of the project, so project file has to be saved.
+ **********************************************************************************************************************/
+inline bool BatchScript::isProjectChanged() const
+{
+    return m_projectChanged;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns errors of planning and execution.
+ **********************************************************************************************************************/
+inline QStringList BatchScript::getErrors() const
+{
+    return m_errorList;
+}
+
+#endif // BATCHSCRIPT_H
@@ -0,0 +1,717 @@
+#include <cstdio>
+
+#include <QDir>
+#include <QFile>
+#include <QRegExp>
+#include <QFileInfo>
+#include <QTextStream>
+
+#if QT_VERSION >= 0x050000
+#include <QStandardPaths>
+#endif
+
+#include "catalog.h"
+#include "catalogclient.h"
+#include "perfcounters.h"
+#include "trace.h"
+
+/*!*********************************************************************************************************************
+ * \brief Constructs an empty Catalog object.
+ **********************************************************************************************************************/
+Catalog::Catalog()
+    : m_client(0)
+{
+}
+
+/*!*********************************************************************************************************************
+ * \brief Splits a project or category file line into words.
+ * \param line     Line to be split.
+ **********************************************************************************************************************/
+QStringList Catalog::splitLine(const QString &line)
+{
+#if QT_VERSION >= 0x050000
+    return line.split(" ", Qt::SkipEmptyParts);
+#else
+    return line.split(" ", QString::SkipEmptyParts);
+#endif
+}
+
+/*!*********************************************************************************************************************
+ * \brief Copies a file like QFile::copy() and counts the bytes as they are copied, so the size is not stat'ed again.
+ * An existing target is not overwritten.
+ * \param src           Path to the source file.
+ * \param tar           Path to the target file.
+ * \return              True if the file has been copied.
+ **********************************************************************************************************************/
+bool Catalog::copyFile(const QString &src, const QString &tar)
+{
+    if(QFile::exists(tar)) {
+        return false;
+    }
+
+    QFile source(src);
+    if(!source.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QFile target(tar);
+    if(!target.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    qint64 size = 0;
+    qint64 length = 0;
+    char buffer[65536];
+
+    while((length = source.read(buffer, sizeof(buffer))) > 0) {
+        if(target.write(buffer, length) != length) {
+            break;
+        }
+
+        size += length;
+    }
+
+    if(length != 0) {
+        target.close();
+        target.remove();
+        return false;
+    }
+
+    target.setPermissions(source.permissions());
+
+    PerfCounters::add(PerfCounters::FILES_READ);
+    PerfCounters::add(PerfCounters::BYTES_READ, size);
+    PerfCounters::add(PerfCounters::FILES_WRITTEN);
+    PerfCounters::add(PerfCounters::BYTES_WRITTEN, size);
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Renames a file over the target. On Unix the target is replaced atomically, so a concurrent reader sees either
+ * the old or the new file; elsewhere the target is removed first and may be missing for a moment.
+ * \param src           Path to the file, usually a temporary file next to the target.
+ * \param tar           Path to the replaced file.
+ * \return              True if the file has been renamed.
+ **********************************************************************************************************************/
+bool Catalog::replaceFile(const QString &src, const QString &tar)
+{
+#if defined(Q_OS_UNIX)
+    return ::rename(QFile::encodeName(src).constData(), QFile::encodeName(tar).constData()) == 0;
+#else
+    QFile::remove(tar);
+    return QFile::rename(src, tar);
+#endif
+}
+
+/*!*********************************************************************************************************************
+ * \brief Loads project file contence. Libraries which folders do not exist are skipped.
+ * \param fileName     Path to the file to be loaded.
+ * \return             True if the file has been read, otherwise false and the reason is added to the error list.
+ **********************************************************************************************************************/
+bool Catalog::loadProjectFile(const QString &fileName)
+{
+    TRACE_SCOPE_ARG("catalog", "load_project", fileName);
+    PerfTimer perfTimer(PerfCounters::LOAD_DURATION);
+
+    QFile file(fileName);
+    if(!file.open(QFile::ReadOnly | QFile::Text)) {
+        m_errorList<<QString("Can not read file '%1':\n%2.").arg(fileName).arg(file.errorString());
+        return false;
+    }
+
+    PerfCounters::add(PerfCounters::FILES_READ);
+    PerfCounters::add(PerfCounters::BYTES_READ, file.size());
+
+    clear();
+
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        QString line = in.readLine().remove("^\\s+").remove("\\s+$");
+
+        if(line.startsWith("#")) {
+            continue;
+        }
+
+        if(line.contains("GROUP")) {
+            QStringList words = splitLine(line);
+            if(words.count() > 1) {
+                QString groupName = words[1];
+                QStringList groupItems;
+                for(int i = 2; i < words.count(); ++i) {
+                    groupItems<<words[i];
+                }
+
+                m_combinedLibs[groupName] = groupItems;
+            }
+        }
+        else if(line.contains("PROJECT")) {
+            QStringList words = splitLine(line);
+            if(words.count() == 3) {
+                QString libName = words[1];
+                QString libPath = words[2];
+
+                if(!libName.isEmpty() && QFileInfo(libPath).exists() && QFileInfo(libPath).isDir()) {
+                    m_libraries[libName] = libPath;
+                }
+            }
+        }
+    }
+
+    file.close();
+
+    m_projFile = fileName;
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Saves libraries and groups of libraries into the project file.
+ * \param fileName     Path to the file to be saved.
+ * \return             True if the file has been written, otherwise false and the reason is added to the error list.
+ **********************************************************************************************************************/
+bool Catalog::saveProjectFile(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        m_errorList<<QString("Can not write to file '%1':\n%2.").arg(fileName).arg(file.errorString());
+        return false;
+    }
+
+    QTextStream out(&file);
+
+    QMap<QString, QStringList>::const_iterator git;
+    for(git = m_combinedLibs.constBegin(); git != m_combinedLibs.constEnd(); ++git) {
+        if(git.value().count()) {
+            out<<"GROUP "<<git.key()<<" "<<git.value().join(" ")<<"\n";
+        }
+    }
+
+    if(m_combinedLibs.count()) {
+        out<<"\n";
+    }
+
+    QMap<QString, QString>::const_iterator it;
+    for(it = m_libraries.constBegin(); it != m_libraries.constEnd(); ++it) {
+        if(QFileInfo(it.value()).isDir()) {
+            out<<"PROJECT "<<it.key()<<" "<<it.value()<<"\n";
+        }
+    }
+
+    out.flush();
+
+    PerfCounters::add(PerfCounters::FILES_WRITTEN);
+    PerfCounters::add(PerfCounters::BYTES_WRITTEN, file.pos());
+
+    file.close();
+
+    m_projFile = fileName;
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Clears all libraries and groups of libraries.
+ **********************************************************************************************************************/
+void Catalog::clear()
+{
+    m_projFile.clear();
+    m_libraries.clear();
+    m_combinedLibs.clear();
+    m_categoryIndexes.clear();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Adds a new library or changes path of the existing one.
+ * \param libName     Name of the library.
+ * \param libPath     Path to the library folder.
+ **********************************************************************************************************************/
+void Catalog::setLibrary(const QString &libName, const QString &libPath)
+{
+    m_libraries[libName] = libPath;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Removes library and its membership in groups of libraries.
+ * \param libName     Name of the library.
+ **********************************************************************************************************************/
+void Catalog::removeLibrary(const QString &libName)
+{
+    m_libraries.remove(libName);
+
+    QMap<QString, QStringList>::iterator it;
+    for(it = m_combinedLibs.begin(); it != m_combinedLibs.end(); ++it) {
+        it.value().removeAll(libName);
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Unites libraries into a group. Existing group with the same name is replaced.
+ * \param groupName     Name of the group.
+ * \param libNames      Names of libraries to be united.
+ **********************************************************************************************************************/
+void Catalog::setCombinedLib(const QString &groupName, const QStringList &libNames)
+{
+    m_combinedLibs[groupName] = libNames;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Removes group of libraries. Libraries themselves are kept.
+ * \param groupName     Name of the group.
+ **********************************************************************************************************************/
+void Catalog::removeCombinedLib(const QString &groupName)
+{
+    m_combinedLibs.remove(groupName);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns sorted list of groups (cells) which have at least one valid view in the library.
+ * \param libPath      Path to the library, where group (cell) is located.
+ **********************************************************************************************************************/
+QStringList Catalog::getCells(const QString &libPath) const
+{
+    TRACE_SCOPE_ARG("catalog", "cells", libPath);
+
+    QStringList cells;
+
+    if(queryClient("CELLS", QStringList()<<libPath, &cells)) {
+        return cells;
+    }
+
+    cells = scanLibrary(libPath).keys();
+
+    return cells;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns list of valid views existing for the given group (cell).
+ * \param libPath      Path to the library, where group (cell) is located.
+ * \param cellName     Name of group (cell) to read for its view(s).
+ **********************************************************************************************************************/
+QStringList Catalog::getViews(const QString &libPath, const QString &cellName) const
+{
+    TRACE_SCOPE_ARG("catalog", "views", cellName);
+
+    QStringList cellViews;
+
+    if(queryClient("VIEWS", QStringList()<<libPath<<cellName, &cellViews)) {
+        return cellViews;
+    }
+
+    QStringList views = getValidViewList();
+    PerfCounters::add(PerfCounters::STAT_CALLS, views.count());
+
+    foreach(const QString &viewName, views) {
+        if(QFileInfo(getViewPath(libPath, cellName, viewName)).exists()) {
+            cellViews<<viewName;
+        }
+    }
+
+    return cellViews;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns sorted list of category names defined in the library. The category index of the library is brought
+ * up to date, only category files changed since the last call are read.
+ * \param libPath      Path to the library, where category is located.
+ **********************************************************************************************************************/
+QStringList Catalog::getCategories(const QString &libPath) const
+{
+    TRACE_SCOPE_ARG("catalog", "categories", libPath);
+
+    QStringList categories;
+
+    if(queryClient("CATEGORIES", QStringList()<<libPath, &categories)) {
+        return categories;
+    }
+
+    PerfCounters::add(PerfCounters::STAT_CALLS);
+    if(!QFileInfo(libPath).isDir()) {
+        return categories;
+    }
+
+    CategoryIndex &index = m_categoryIndexes[libPath];
+    index.update(libPath);
+
+    return index.getCategories();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns sorted list of document file names stored in the library 'doc' folder.
+ * \param libPath      Path to the library, where documentation is located.
+ **********************************************************************************************************************/
+QStringList Catalog::getDocuments(const QString &libPath) const
+{
+    TRACE_SCOPE_ARG("catalog", "documents", libPath);
+
+    QStringList documents;
+    if(queryClient("DOCS", QStringList()<<libPath, &documents)) {
+        return documents;
+    }
+
+    QString docPath = QDir::toNativeSeparators(libPath + "/doc");
+
+    PerfCounters::add(PerfCounters::STAT_CALLS);
+    if(!QFileInfo(docPath).isDir()) {
+        return QStringList();
+    }
+
+    PerfCounters::add(PerfCounters::READDIR_CALLS);
+
+    QDir docDir(docPath);
+    docDir.setNameFilters(getDocumentFormats());
+
+    return docDir.entryList(QDir::Files, QDir::Name);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Reads library category and returns it's cells.
+ * \param libPath     Path to the project library.
+ * \param catName     Name of the category.
+ * \return            Sorted list of cells taken from the category index, the file is only stat'ed unless it has
+ *                    changed since it was indexed. If category can not be read, the list is empty and the reason
+ *                    is added to the error list.
+ **********************************************************************************************************************/
+QStringList Catalog::readCategory(const QString &libPath, const QString &catName)
+{
+    TRACE_SCOPE_ARG("catalog", "read_category", catName);
+
+    QStringList cells;
+
+    if(queryClient("CATEGORY", QStringList()<<libPath<<catName, &cells)) {
+        return cells;
+    }
+
+    CategoryIndex &index = getCategoryIndex(libPath, catName, &m_errorList);
+    if(!index.contains(catName)) {
+        QString fileName = QDir::toNativeSeparators(libPath + "/" + catName + ".group");
+        m_errorList<<QString("Can not find category '%1'.").arg(fileName);
+        return cells;
+    }
+
+    return index.getCells(catName);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns categories of the library which list the group (cell). The daemon is never asked.
+ * \param libPath     Path to the project library.
+ * \param cellName    Name of the group (cell).
+ * \return            Sorted list of categories, read from the category index once the files of all categories
+ *                    have been stat'ed.
+ **********************************************************************************************************************/
+QStringList Catalog::getCellCategories(const QString &libPath, const QString &cellName)
+{
+    TRACE_SCOPE_ARG("catalog", "cell_categories", cellName);
+
+    // Any category may have been edited to list the cell, which does not touch the library folder, so all of them
+    // are validated; only changed files are read again.
+    CategoryIndex &index = m_categoryIndexes[libPath];
+    if(!index.update(libPath)) {
+        m_errorList<<index.getErrors();
+    }
+
+    return index.getCellCategories(cellName);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Scans the library and returns its groups (cells) with their views. Every view folder is listed only once,
+ * so the number of file system calls does not depend on the number of cells. The daemon is never asked.
+ * \param libPath      Path to the library.
+ * \return             Map of cell names to the list of their views.
+ **********************************************************************************************************************/
+QMap<QString, QStringList> Catalog::scanLibrary(const QString &libPath) const
+{
+    TRACE_SCOPE_ARG("catalog", "scan_library", libPath);
+    PerfTimer perfTimer(PerfCounters::SCAN_DURATION, libPath);
+
+    QMap<QString, QStringList> cells;
+
+    QStringList views = getValidViewList();
+    PerfCounters::add(PerfCounters::READDIR_CALLS, views.count());
+    foreach(const QString &viewName, views) {
+        QString suffix = QString(".") + viewName;
+
+        QDir viewDir(QDir::toNativeSeparators(libPath + "/" + viewName));
+        viewDir.setNameFilters(QStringList()<<"*" + suffix);
+
+        QStringList fileList = viewDir.entryList(QDir::Files);
+        foreach(QString cellName, fileList) {
+            cellName.chop(suffix.length());
+            cells[cellName]<<viewName;
+        }
+    }
+
+    return cells;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Searches for groups (cells) in all libraries of the project.
+ * \param pattern      Case insensitive wildcard pattern (for ex., *_esd*).
+ * \return             Rows of library and cell names.
+ **********************************************************************************************************************/
+QList<QStringList> Catalog::search(const QString &pattern) const
+{
+    TRACE_SCOPE_ARG("catalog", "search", pattern);
+
+    QList<QStringList> rows;
+
+    if(queryClient("SEARCH", QStringList()<<pattern, &rows)) {
+        return rows;
+    }
+
+    QRegExp regExp(pattern, Qt::CaseInsensitive, QRegExp::Wildcard);
+
+    QMap<QString, QString>::const_iterator it;
+    for(it = m_libraries.constBegin(); it != m_libraries.constEnd(); ++it) {
+        foreach(const QString &cellName, getCells(it.value())) {
+            if(regExp.exactMatch(cellName)) {
+                rows<<(QStringList()<<it.key()<<cellName);
+            }
+        }
+    }
+
+    return rows;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Finds libraries and categories of the project which use the group (cell).
+ * \param cellName     Name of the group (cell).
+ * \return             Rows of library and category names. Empty category means that the cell is defined in library.
+ **********************************************************************************************************************/
+QList<QStringList> Catalog::whereUsed(const QString &cellName)
+{
+    TRACE_SCOPE_ARG("catalog", "where_used", cellName);
+
+    QList<QStringList> rows;
+
+    if(queryClient("WHEREUSED", QStringList()<<cellName, &rows)) {
+        return rows;
+    }
+
+    QMap<QString, QString>::const_iterator it;
+    for(it = m_libraries.constBegin(); it != m_libraries.constEnd(); ++it) {
+        QString libPath = it.value();
+
+        if(getCells(libPath).contains(cellName)) {
+            rows<<(QStringList()<<it.key()<<"");
+        }
+
+        foreach(const QString &catName, getCellCategories(libPath, cellName)) {
+            rows<<(QStringList()<<it.key()<<catName);
+        }
+    }
+
+    return rows;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns path of an existing view or an empty string.
+ * \param libName      Name of the library.
+ * \param cellName     Name of the group (cell).
+ * \param viewName     Name of the view.
+ **********************************************************************************************************************/
+QString Catalog::resolveViewPath(const QString &libName, const QString &cellName, const QString &viewName) const
+{
+    QString libPath = getLibraryPath(libName);
+    if(libPath.isEmpty()) {
+        return QString();
+    }
+
+    QStringList paths;
+    if(queryClient("RESOLVE", QStringList()<<libPath<<cellName<<viewName, &paths)) {
+        return paths.value(0);
+    }
+
+    QString viewPath = getViewPath(libPath, cellName, viewName);
+    if(!QFileInfo(viewPath).exists()) {
+        return QString();
+    }
+
+    return viewPath;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Tells the catalog daemon, if it is used, to drop its data of the library after bulk changes, so the library
+ * is rescanned once instead of on every change of its folders.
+ * \param libPath      Path to the changed library.
+ **********************************************************************************************************************/
+void Catalog::invalidateLibrary(const QString &libPath) const
+{
+    m_categoryIndexes.remove(libPath);
+
+    QList<QStringList> rows;
+    queryClient("INVALIDATE", QStringList()<<libPath, &rows);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns the category index of the library. The index is built, or loaded from the cache folder and validated,
+ * on the first use in this session and whenever the file it is asked for has changed: the '.group' file of the
+ * category, or the library folder if no category is given, so added and removed categories are seen. Only that file
+ * is stat'ed if it has not changed.
+ * \param libPath      Path to the library.
+ * \param catName      Name of a category which has to be in the index and up to date, or empty.
+ * \param errors       List to add the errors of the update to, or NULL.
+ **********************************************************************************************************************/
+CategoryIndex& Catalog::getCategoryIndex(const QString &libPath, const QString &catName, QStringList *errors) const
+{
+    QMap<QString, CategoryIndex>::iterator it = m_categoryIndexes.find(libPath);
+    if(it != m_categoryIndexes.end() && it.value().isCurrent(catName)) {
+        return it.value();
+    }
+
+    CategoryIndex &index = m_categoryIndexes[libPath];
+    if(!index.update(libPath) && errors) {
+        *errors<<index.getErrors();
+    }
+
+    return index;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Sends query to the catalog daemon if it is used.
+ * \param command      Name of the command.
+ * \param args         Arguments of the command.
+ * \param rows         Rows of the response.
+ * \return             False if daemon is not used or failed to answer.
+ **********************************************************************************************************************/
+bool Catalog::queryClient(const QString &command, const QStringList &args, QList<QStringList> *rows) const
+{
+    if(!m_client || !m_client->isConnected()) {
+        return false;
+    }
+
+    TRACE_SCOPE_ARG("catalog", "daemon_query", command);
+
+    if(!m_client->query(command, args, rows)) {
+        PerfCounters::add(PerfCounters::CACHE_MISSES);
+        return false;
+    }
+
+    PerfCounters::add(PerfCounters::CACHE_HITS);
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Sends query to the catalog daemon and returns the first column of the response.
+ * \param command      Name of the command.
+ * \param args         Arguments of the command.
+ * \param column       First column of the response rows.
+ * \return             False if daemon is not used or failed to answer.
+ **********************************************************************************************************************/
+bool Catalog::queryClient(const QString &command, const QStringList &args, QStringList *column) const
+{
+    QList<QStringList> rows;
+    if(!queryClient(command, args, &rows)) {
+        return false;
+    }
+
+    column->clear();
+    foreach(const QStringList &row, rows) {
+        *column<<row.value(0);
+    }
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns list of valid view names.
+ **********************************************************************************************************************/
+QStringList Catalog::getValidViewList()
+{
+    QStringList views;
+    views<<"gds"<<"cdl"<<"spice"<<"verilog"<<"liberty"<<"lef";
+    return views;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns list of name filters for document files.
+ **********************************************************************************************************************/
+QStringList Catalog::getDocumentFormats()
+{
+    QStringList formats;
+    formats<<"*.txt"<<"*.pdf"<<"*.doc"<<"*.celllist";
+    return formats;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns absolute path of the view based on given project/group/view (library/cell/view) information.
+ * \param libPath       Path to the project (library).
+ * \param cellName      Name of the group (cell).
+ * \param viewName      Name of the view.
+ **********************************************************************************************************************/
+QString Catalog::getViewPath(const QString &libPath, const QString &cellName, const QString &viewName)
+{
+    return QDir::toNativeSeparators(libPath + "/" + viewName + "/" + cellName + "." + viewName);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns folder of index files which can be rebuilt from the libraries at any time. It is given by the
+ * LIBMAN_CACHE_DIR environment variable or is the 'libman' folder in the cache location of the user.
+ **********************************************************************************************************************/
+QString Catalog::getCacheDir()
+{
+    QString cacheDir = QString::fromLocal8Bit(qgetenv("LIBMAN_CACHE_DIR"));
+    if(!cacheDir.isEmpty()) {
+        return cacheDir;
+    }
+
+#if QT_VERSION >= 0x050000
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/libman";
+#else
+    return QDir::homePath() + "/.cache/libman";
+#endif
+}
+
+/*!*********************************************************************************************************************
+ * \brief Searches for *.projects-files in the specified directory and returns the first found one.
+ * \param dirName     Name of folder to search for project file.
+ **********************************************************************************************************************/
+QString Catalog::getProjectFileFromDir(const QString &dirName)
+{
+    QString projFile;
+
+    QDir projDir(dirName);
+    projDir.setNameFilters(QStringList()<<"*.projects");
+
+    QStringList fileList = projDir.entryList();
+    foreach(const QString &projName, fileList) {
+        QString projPath = QDir::toNativeSeparators(dirName + "/" + projName);
+        if(QFileInfo(projPath).isFile()) {
+            QFile file(projPath);
+            if(!file.open(QFile::ReadOnly | QFile::Text)) {
+                return projFile;
+            }
+
+            QTextStream in(&file);
+            while (!in.atEnd()) {
+                QString line = in.readLine().remove("^\\s+").remove("\\s+$");
+
+                if(line.startsWith("#")) {
+                    continue;
+                }
+
+                if(line.contains("PROJECT")) {
+                    if(splitLine(line).count() == 3) {
+                        projFile = projPath;
+                        break;
+                    }
+                }
+                else if(line.contains("GROUP")) {
+                    if(splitLine(line).count() > 1) {
+                        projFile = projPath;
+                        break;
+                    }
+                }
+            }
+
+            file.close();
+
+            if(!projFile.isEmpty()) {
+                return projFile;
+            }
+        }
+    }
+
+    return projFile;
+}
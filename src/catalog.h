@@ -0,0 +1,155 @@
+#ifndef CATALOG_H
+#define CATALOG_H
+
+#include <QMap>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "categoryindex.h"
+
+class CatalogClient;
+
+/*!*********************************************************************************************************************
+ * \brief The Catalog class reads and writes project files and scans project (library) folders for groups (cells),
+ * views, categories and documents. It does not depend on any GUI class, so it is shared by MainWindow and the batch
+ * mode of LibMan. If a catalog daemon client is set, library queries are answered by the daemon and local scanning
+ * is used only as a fallback. Categories are served from a CategoryIndex per library, which is validated whenever
+ * the categories of the library are listed.
+ **********************************************************************************************************************/
+class Catalog
+{
+public:
+    Catalog();
+
+    bool                                loadProjectFile(const QString &fileName);
+    bool                                saveProjectFile(const QString &fileName);
+
+    void                                clear();
+
+    void                                setClient(CatalogClient *client);
+    CatalogClient*                      getClient() const;
+
+    QString                             getProjectFile() const;
+    QStringList                         getErrors() const;
+    void                                clearErrors();
+
+    QMap<QString, QString>              getLibraries() const;
+    QMap<QString, QStringList>          getCombinedLibs() const;
+    QString                             getLibraryPath(const QString &libName) const;
+
+    void                                setLibrary(const QString &libName, const QString &libPath);
+    void                                removeLibrary(const QString &libName);
+    void                                setCombinedLib(const QString &groupName, const QStringList &libNames);
+    void                                removeCombinedLib(const QString &groupName);
+
+    QStringList                         getCells(const QString &libPath) const;
+    QStringList                         getViews(const QString &libPath, const QString &cellName) const;
+    QStringList                         getCategories(const QString &libPath) const;
+    QStringList                         getDocuments(const QString &libPath) const;
+    QStringList                         readCategory(const QString &libPath, const QString &catName);
+    QStringList                         getCellCategories(const QString &libPath, const QString &cellName);
+
+    QMap<QString, QStringList>          scanLibrary(const QString &libPath) const;
+    void                                invalidateLibrary(const QString &libPath) const;
+    QList<QStringList>                  search(const QString &pattern) const;
+    QList<QStringList>                  whereUsed(const QString &cellName);
+    QString                             resolveViewPath(const QString &libName, const QString &cellName,
+                                                        const QString &viewName) const;
+
+    static QStringList                  getValidViewList();
+    static QStringList                  getDocumentFormats();
+    static QString                      getProjectFileFromDir(const QString &dirName);
+    static QString                      getCacheDir();
+    static QString                      getViewPath(const QString &libPath, const QString &cellName,
+                                                    const QString &viewName);
+    static QStringList                  splitLine(const QString &line);
+    static bool                         copyFile(const QString &src, const QString &tar);
+    static bool                         replaceFile(const QString &src, const QString &tar);
+
+private:
+    CategoryIndex&                      getCategoryIndex(const QString &libPath, const QString &catName = QString(),
+                                                         QStringList *errors = 0) const;
+
+    bool                                queryClient(const QString &command, const QStringList &args,
+                                                    QList<QStringList> *rows) const;
+    bool                                queryClient(const QString &command, const QStringList &args,
+                                                    QStringList *column) const;
+
+private:
+    QString                             m_projFile;         /*!< Path to the last loaded or saved project file. */
+    QMap<QString, QString>              m_libraries;        /*!< Map of library names to library paths. */
+    QMap<QString, QStringList>          m_combinedLibs;     /*!< Map of group names to the libraries united by them. */
+    QStringList                         m_errorList;        /*!< Errors collected since the last clearErrors() call. */
+    CatalogClient                       *m_client;          /*!< Connection to the catalog daemon, not owned. */
+
+    mutable QMap<QString, CategoryIndex> m_categoryIndexes; /*!< Map of library paths to their categories. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Returns path to the last loaded or saved project file.
+ **********************************************************************************************************************/
+inline QString Catalog::getProjectFile() const
+{
+    return m_projFile;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Sets connection to the catalog daemon. Catalog does not take ownership of the client.
+ * \param client      Connected client or NULL to use local scanning only.
+ **********************************************************************************************************************/
+inline void Catalog::setClient(CatalogClient *client)
+{
+    m_client = client;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns connection to the catalog daemon or NULL if it is not used.
+ **********************************************************************************************************************/
+inline CatalogClient* Catalog::getClient() const
+{
+    return m_client;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns list of errors collected since the last clearErrors() call.
+ **********************************************************************************************************************/
+inline QStringList Catalog::getErrors() const
+{
+    return m_errorList;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Clears list of collected errors.
+ **********************************************************************************************************************/
+inline void Catalog::clearErrors()
+{
+    m_errorList.clear();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns map of library names to library paths.
+ **********************************************************************************************************************/
+inline QMap<QString, QString> Catalog::getLibraries() const
+{
+    return m_libraries;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns map of group names to the libraries united by them.
+ **********************************************************************************************************************/
+inline QMap<QString, QStringList> Catalog::getCombinedLibs() const
+{
+    return m_combinedLibs;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns path of the library or an empty string if library is unknown.
+ * \param libName     Name of the library.
+ **********************************************************************************************************************/
+inline QString Catalog::getLibraryPath(const QString &libName) const
+{
+    return m_libraries.value(libName);
+}
+
+#endif // CATALOG_H
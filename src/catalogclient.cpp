@@ -0,0 +1,256 @@
+#include <QFileInfo>
+#include <QLocalSocket>
+#include <QCryptographicHash>
+
+#include "catalogclient.h"
+
+/*!*********************************************************************************************************************
+ * \brief Constructs CatalogClient object. Connection is not established until connectToDaemon() is called.
+ **********************************************************************************************************************/
+CatalogClient::CatalogClient()
+    : m_socket(new QLocalSocket),
+      m_timeout(2000)
+{
+}
+
+/*!*********************************************************************************************************************
+ * \brief Destructs CatalogClient object and closes the connection.
+ **********************************************************************************************************************/
+CatalogClient::~CatalogClient()
+{
+    disconnectFromDaemon();
+    delete m_socket;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Connects to the daemon serving the given project file.
+ * \param projFile     Path to the project file.
+ * \param timeout      Time in milliseconds to wait for the connection.
+ * \return             True if the daemon is running and answers, otherwise false.
+ **********************************************************************************************************************/
+bool CatalogClient::connectToDaemon(const QString &projFile, int timeout)
+{
+    disconnectFromDaemon();
+
+    m_socket->connectToServer(getSocketName(projFile));
+    if(!m_socket->waitForConnected(timeout)) {
+        m_socket->abort();
+        return false;
+    }
+
+    QList<QStringList> rows;
+    if(!query("PING", QStringList(), &rows)) {
+        disconnectFromDaemon();
+        return false;
+    }
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Closes the connection to the daemon.
+ **********************************************************************************************************************/
+void CatalogClient::disconnectFromDaemon()
+{
+    if(m_socket->state() != QLocalSocket::UnconnectedState) {
+        m_socket->abort();
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if the connection to the daemon is established.
+ **********************************************************************************************************************/
+bool CatalogClient::isConnected() const
+{
+    return m_socket->state() == QLocalSocket::ConnectedState;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Sends a query to the daemon and waits for the answer. If the daemon does not answer in time, the
+ * connection is closed, so the caller can fall back to local scanning.
+ * \param command      Name of the command (CELLS, VIEWS, SEARCH etc.).
+ * \param args         Arguments of the command.
+ * \param rows         Rows of the response.
+ * \param errorMsg     Error message returned by the daemon, optional.
+ * \return             True if daemon answered with OK, otherwise false.
+ **********************************************************************************************************************/
+bool CatalogClient::query(const QString &command, const QStringList &args, QList<QStringList> *rows, QString *errorMsg)
+{
+    rows->clear();
+
+    if(!isConnected()) {
+        return false;
+    }
+
+    QStringList fields;
+    fields<<command<<args;
+
+    m_socket->write((joinFields(fields) + "\n").toUtf8());
+    if(!m_socket->waitForBytesWritten(m_timeout)) {
+        disconnectFromDaemon();
+        return false;
+    }
+
+    QString header;
+    if(!readLine(&header)) {
+        disconnectFromDaemon();
+        return false;
+    }
+
+    if(header.startsWith("ERR")) {
+        if(errorMsg) {
+            *errorMsg = header.mid(4);
+        }
+
+        return false;
+    }
+
+    if(!header.startsWith("OK ")) {
+        disconnectFromDaemon();
+        return false;
+    }
+
+    bool ok = false;
+    int count = header.mid(3).toInt(&ok);
+    if(!ok) {
+        disconnectFromDaemon();
+        return false;
+    }
+
+    for(int i = 0; i < count; ++i) {
+        QString line;
+        if(!readLine(&line)) {
+            disconnectFromDaemon();
+            rows->clear();
+            return false;
+        }
+
+        rows->append(splitFields(line));
+    }
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Reads one response line without the line break.
+ * \param line         Read line.
+ **********************************************************************************************************************/
+bool CatalogClient::readLine(QString *line)
+{
+    while(!m_socket->canReadLine()) {
+        if(!m_socket->waitForReadyRead(m_timeout)) {
+            return false;
+        }
+    }
+
+    QByteArray data = m_socket->readLine();
+    if(data.endsWith('\n')) {
+        data.chop(1);
+    }
+
+    *line = QString::fromUtf8(data);
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns name of the local socket used by the daemon of the given project file. The name can be overridden
+ * by LIBMAN_SOCKET environment variable.
+ * \param projFile     Path to the project file.
+ **********************************************************************************************************************/
+QString CatalogClient::getSocketName(const QString &projFile)
+{
+    QByteArray socketName = qgetenv("LIBMAN_SOCKET");
+    if(!socketName.isEmpty()) {
+        return QString::fromLocal8Bit(socketName);
+    }
+
+    QString projPath = QFileInfo(projFile).canonicalFilePath();
+    if(projPath.isEmpty()) {
+        projPath = QFileInfo(projFile).absoluteFilePath();
+    }
+
+    QByteArray hash = QCryptographicHash::hash(projPath.toUtf8(), QCryptographicHash::Md5).toHex();
+
+    return QString("libman-%1").arg(QString::fromLatin1(hash.left(16)));
+}
+
+/*!*********************************************************************************************************************
+ * \brief Escapes tabs, line breaks and backslashes of the field.
+ * \param field        Field to be escaped.
+ **********************************************************************************************************************/
+QString CatalogClient::escapeField(const QString &field)
+{
+    QString escaped = field;
+    escaped.replace("\\", "\\\\");
+    escaped.replace("\t", "\\t");
+    escaped.replace("\n", "\\n");
+    escaped.replace("\r", "\\r");
+    return escaped;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Reverts escaping done by escapeField().
+ * \param field        Field to be unescaped.
+ **********************************************************************************************************************/
+QString CatalogClient::unescapeField(const QString &field)
+{
+    if(!field.contains('\\')) {
+        return field;
+    }
+
+    QString unescaped;
+    unescaped.reserve(field.length());
+
+    for(int i = 0; i < field.length(); ++i) {
+        QChar c = field[i];
+        if(c == '\\' && i + 1 < field.length()) {
+            QChar next = field[++i];
+            if(next == 't') {
+                unescaped += '\t';
+            }
+            else if(next == 'n') {
+                unescaped += '\n';
+            }
+            else if(next == 'r') {
+                unescaped += '\r';
+            }
+            else {
+                unescaped += next;
+            }
+        }
+        else {
+            unescaped += c;
+        }
+    }
+
+    return unescaped;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Splits a protocol line into unescaped fields.
+ * \param line         Line without the line break.
+ **********************************************************************************************************************/
+QStringList CatalogClient::splitFields(const QString &line)
+{
+    QStringList fields;
+    foreach(const QString &field, line.split('\t')) {
+        fields<<unescapeField(field);
+    }
+
+    return fields;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Joins fields into a protocol line without the line break.
+ * \param fields       Fields to be joined.
+ **********************************************************************************************************************/
+QString CatalogClient::joinFields(const QStringList &fields)
+{
+    QStringList escaped;
+    foreach(const QString &field, fields) {
+        escaped<<escapeField(field);
+    }
+
+    return escaped.join("\t");
+}
@@ -0,0 +1,44 @@
+#ifndef CATALOGCLIENT_H
+#define CATALOGCLIENT_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+class QLocalSocket;
+
+/*!*********************************************************************************************************************
+ * \brief The CatalogClient class sends queries to a running LibMan catalog daemon over a local socket.
+ *
+ * Protocol is line based. A request is a command followed by its arguments, all separated by tabs. A response is
+ * either "OK <n>" followed by n tab separated rows or "ERR <message>". Tabs, line breaks and backslashes inside of
+ * fields are escaped with a backslash.
+ **********************************************************************************************************************/
+class CatalogClient
+{
+public:
+    CatalogClient();
+    ~CatalogClient();
+
+    bool                                connectToDaemon(const QString &projFile, int timeout = 100);
+    void                                disconnectFromDaemon();
+    bool                                isConnected() const;
+
+    bool                                query(const QString &command, const QStringList &args,
+                                              QList<QStringList> *rows, QString *errorMsg = 0);
+
+    static QString                      getSocketName(const QString &projFile);
+    static QString                      escapeField(const QString &field);
+    static QString                      unescapeField(const QString &field);
+    static QStringList                  splitFields(const QString &line);
+    static QString                      joinFields(const QStringList &fields);
+
+private:
+    bool                                readLine(QString *line);
+
+private:
+    QLocalSocket                        *m_socket;      /*!< Connection to the daemon. */
+    int                                 m_timeout;      /*!< Time in milliseconds to wait for a daemon response. */
+};
+
+#endif // CATALOGCLIENT_H
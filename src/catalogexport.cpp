@@ -0,0 +1,318 @@
+#include <QDir>
+#include <QFile>
+#include <QMutex>
+#include <QQueue>
+#include <QPair>
+#include <QThread>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <QCryptographicHash>
+
+#include <algorithm>
+
+#include "catalog.h"
+#include "catalogexport.h"
+#include "perfcounters.h"
+#include "recordwriter.h"
+#include "trace.h"
+
+/*!*********************************************************************************************************************
+ * \brief Number of rows handed over from a library job to the writer at once.
+ **********************************************************************************************************************/
+static const int EXPORT_CHUNK_SIZE = 1024;
+
+/*!*********************************************************************************************************************
+ * \brief Number of chunks a library job may keep before it waits for the writer.
+ **********************************************************************************************************************/
+static const int EXPORT_QUEUE_CAPACITY = 8;
+
+/*!*********************************************************************************************************************
+ * \brief Size of the block used to read files for checksums.
+ **********************************************************************************************************************/
+static const qint64 EXPORT_HASH_BLOCK = 1024 * 1024;
+
+/*!*********************************************************************************************************************
+ * \brief The ExportQueue class is a bounded queue of row chunks of a single library.
+ **********************************************************************************************************************/
+class ExportQueue
+{
+public:
+    ExportQueue() : m_finished(false) {}
+
+    /*!
+     * \brief Appends chunk, waits while the queue is full.
+     */
+    void push(const QList<QStringList> &chunk)
+    {
+        QMutexLocker locker(&m_mutex);
+        while(m_chunks.count() >= EXPORT_QUEUE_CAPACITY) {
+            m_notFull.wait(&m_mutex);
+        }
+
+        m_chunks.enqueue(chunk);
+        m_notEmpty.wakeAll();
+    }
+
+    /*!
+     * \brief Takes the next chunk, waits while the queue is empty. Returns false if the library is done.
+     */
+    bool pop(QList<QStringList> *chunk)
+    {
+        QMutexLocker locker(&m_mutex);
+        while(m_chunks.isEmpty() && !m_finished) {
+            m_notEmpty.wait(&m_mutex);
+        }
+
+        if(m_chunks.isEmpty()) {
+            return false;
+        }
+
+        *chunk = m_chunks.dequeue();
+        m_notFull.wakeAll();
+
+        return true;
+    }
+
+    /*!
+     * \brief Marks library as done and keeps errors found by the job.
+     */
+    void finish(const QStringList &errors)
+    {
+        QMutexLocker locker(&m_mutex);
+        m_errors = errors;
+        m_finished = true;
+        m_notEmpty.wakeAll();
+    }
+
+    /*!
+     * \brief Returns errors found by the job. Valid after pop() has returned false.
+     */
+    QStringList errors() const
+    {
+        return m_errors;
+    }
+
+private:
+    QMutex                              m_mutex;            /*!< Guard of the members below. */
+    QWaitCondition                      m_notFull;          /*!< Signalled when a chunk has been taken. */
+    QWaitCondition                      m_notEmpty;         /*!< Signalled when a chunk has been added. */
+    QQueue<QList<QStringList> >         m_chunks;           /*!< Chunks not written yet. */
+    QStringList                         m_errors;           /*!< Errors found by the job. */
+    bool                                m_finished;         /*!< State if the job is done. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief The ExportJob class scans a single library and pushes its rows to the queue.
+ **********************************************************************************************************************/
+class ExportJob : public QRunnable
+{
+public:
+    ExportJob(const QString &libName, const QString &libPath, CatalogExport::HASH hash, ExportQueue *queue)
+        : m_libName(libName), m_libPath(libPath), m_hash(hash), m_queue(queue) {}
+
+    void run();
+
+private:
+    QString                             getHash(const QString &filePath);
+
+private:
+    QString                             m_libName;          /*!< Name of the library. */
+    QString                             m_libPath;          /*!< Path to the library. */
+    CatalogExport::HASH                 m_hash;             /*!< Checksum written for view files. */
+    ExportQueue                         *m_queue;           /*!< Queue to hand rows over to the writer. */
+    QStringList                         m_errorList;        /*!< Errors found while scanning. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Lists view files of the library, sorts them by cell and view and pushes a row per file in chunks.
+ **********************************************************************************************************************/
+void ExportJob::run()
+{
+    TRACE_SCOPE_ARG("export", "library", m_libName);
+    PerfTimer perfTimer(PerfCounters::JOB_DURATION);
+
+    QStringList views = Catalog::getValidViewList();
+    PerfCounters::add(PerfCounters::READDIR_CALLS, views.count());
+
+    QList<QPair<QString, int> > entries;
+    for(int i = 0; i < views.count(); ++i) {
+        QString suffix = QString(".") + views[i];
+
+        QDir viewDir(QDir::toNativeSeparators(m_libPath + "/" + views[i]));
+        viewDir.setNameFilters(QStringList()<<"*" + suffix);
+
+        foreach(QString cellName, viewDir.entryList(QDir::Files, QDir::Unsorted)) {
+            cellName.chop(suffix.length());
+            entries<<qMakePair(cellName, i);
+        }
+    }
+
+    std::sort(entries.begin(), entries.end());
+
+    PerfCounters::add(PerfCounters::STAT_CALLS, entries.count());
+
+    QList<QStringList> chunk;
+    for(int i = 0; i < entries.count(); ++i) {
+        const QString &cellName = entries[i].first;
+        const QString &viewName = views[entries[i].second];
+
+        QString viewPath = Catalog::getViewPath(m_libPath, cellName, viewName);
+        QFileInfo viewInfo(viewPath);
+
+        chunk<<(QStringList()<<m_libName
+                             <<cellName
+                             <<viewName
+                             <<QString::number(viewInfo.size())
+                             <<viewInfo.lastModified().toUTC().toString(Qt::ISODate)
+                             <<getHash(viewPath));
+
+        if(chunk.count() >= EXPORT_CHUNK_SIZE) {
+            m_queue->push(chunk);
+            chunk.clear();
+        }
+    }
+
+    if(chunk.count()) {
+        m_queue->push(chunk);
+    }
+
+    PerfCounters::add(m_errorList.isEmpty() ? PerfCounters::JOBS_DONE : PerfCounters::JOBS_FAILED);
+
+    m_queue->finish(m_errorList);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns hex checksum of the file or an empty string if checksums are off or file can not be read.
+ * \param filePath      Path to the file.
+ **********************************************************************************************************************/
+QString ExportJob::getHash(const QString &filePath)
+{
+    if(m_hash == CatalogExport::NO_HASH) {
+        return QString();
+    }
+
+    QFile file(filePath);
+    if(!file.open(QIODevice::ReadOnly)) {
+        m_errorList<<QString("Can not read file '%1':\n%2.").arg(filePath).arg(file.errorString());
+        return QString();
+    }
+
+    QCryptographicHash hash(m_hash == CatalogExport::MD5 ? QCryptographicHash::Md5 : QCryptographicHash::Sha1);
+
+    while(!file.atEnd()) {
+        QByteArray block = file.read(EXPORT_HASH_BLOCK);
+        if(block.isEmpty()) {
+            break;
+        }
+
+        hash.addData(block);
+        PerfCounters::add(PerfCounters::BYTES_READ, block.size());
+    }
+
+    PerfCounters::add(PerfCounters::FILES_READ);
+
+    file.close();
+
+    return QString(hash.result().toHex());
+}
+
+/*!*********************************************************************************************************************
+ * \brief Constructs CatalogExport object.
+ * \param libraries     Map of library names to library paths to be exported.
+ **********************************************************************************************************************/
+CatalogExport::CatalogExport(const QMap<QString, QString> &libraries)
+    : m_libraries(libraries),
+      m_hash(NO_HASH),
+      m_jobs(0),
+      m_rowCount(0)
+{
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns names of the exported columns.
+ **********************************************************************************************************************/
+QStringList CatalogExport::getColumns()
+{
+    return QStringList()<<"library"<<"cell"<<"view"<<"size"<<"mtime"<<"hash";
+}
+
+/*!*********************************************************************************************************************
+ * \brief Converts checksum name into HASH value.
+ * \param name          Name of the checksum (none, md5, sha1).
+ * \param hash          Output value.
+ * \return              False if name is unknown.
+ **********************************************************************************************************************/
+bool CatalogExport::parseHash(const QString &name, HASH *hash)
+{
+    QString lower = name.toLower();
+
+    if(lower == "none") {
+        *hash = NO_HASH;
+    }
+    else if(lower == "md5") {
+        *hash = MD5;
+    }
+    else if(lower == "sha1") {
+        *hash = SHA1;
+    }
+    else {
+        return false;
+    }
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Scans all libraries and writes their rows. At most the configured number of libraries is scanned at a time;
+ * a library job is started as soon as the writer has finished an earlier library.
+ * \param writer        Writer of the rows, its columns have to be getColumns().
+ * \return              True if no errors were found, otherwise false and the reasons are added to the error list.
+ **********************************************************************************************************************/
+bool CatalogExport::exportTo(RecordWriter *writer)
+{
+    TRACE_SCOPE("export", "catalog");
+
+    m_rowCount = 0;
+    m_errorList.clear();
+
+    int window = m_jobs > 0 ? m_jobs : qMax(1, QThread::idealThreadCount());
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(window);
+
+    QStringList libNames = m_libraries.keys();
+
+    // Queues are kept until all jobs are done, a job may still be leaving finish() when its library is written.
+    QList<ExportQueue*> queues;
+    for(int i = 0; i < libNames.count(); ++i) {
+        queues<<new ExportQueue;
+    }
+
+    int started = 0;
+    for(int i = 0; i < libNames.count(); ++i) {
+        for(; started < libNames.count() && started < i + window; ++started) {
+            QString libName = libNames[started];
+            pool.start(new ExportJob(libName, m_libraries[libName], m_hash, queues[started]));
+        }
+
+        QList<QStringList> chunk;
+        while(queues[i]->pop(&chunk)) {
+            foreach(const QStringList &row, chunk) {
+                writer->writeRow(row);
+            }
+
+            m_rowCount += chunk.count();
+        }
+
+        m_errorList<<queues[i]->errors();
+    }
+
+    pool.waitForDone();
+
+    qDeleteAll(queues);
+
+    return m_errorList.isEmpty();
+}
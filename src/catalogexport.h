@@ -0,0 +1,83 @@
+#ifndef CATALOGEXPORT_H
+#define CATALOGEXPORT_H
+
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+class RecordWriter;
+
+/*!*********************************************************************************************************************
+ * \brief The CatalogExport class streams the (library, cell, view, size, mtime, hash) table of all project libraries
+ * into a RecordWriter. Libraries are scanned in parallel by a window of jobs, each job hands its rows over in chunks
+ * through a bounded queue, and rows are written in library, cell and view order. Each job sorts the cell and view
+ * names of its library in memory, so memory use grows with the largest library scanned at a time; rows with sizes,
+ * times and checksums are only held a chunk at a time.
+ **********************************************************************************************************************/
+class CatalogExport
+{
+public:
+    /*!
+     * \brief The HASH enum specifies checksum written for every view file.
+     */
+    enum HASH {
+        NO_HASH                         = 0,
+        MD5,
+        SHA1
+    };
+
+    explicit CatalogExport(const QMap<QString, QString> &libraries);
+
+    void                                setHash(HASH hash);
+    void                                setJobs(int jobs);
+
+    bool                                exportTo(RecordWriter *writer);
+    qint64                              getRowCount() const;
+    QStringList                         getErrors() const;
+
+    static QStringList                  getColumns();
+    static bool                         parseHash(const QString &name, HASH *hash);
+
+private:
+    QMap<QString, QString>              m_libraries;        /*!< Map of library names to library paths. */
+    HASH                                m_hash;             /*!< Checksum written for view files. */
+    int                                 m_jobs;             /*!< Number of libraries scanned in parallel. */
+    qint64                              m_rowCount;         /*!< Number of rows written by the last export. */
+    QStringList                         m_errorList;        /*!< Errors of the last export. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Sets checksum written for every view file. Checksums require reading all files, so they are off by default.
+ * \param hash          Checksum type.
+ **********************************************************************************************************************/
+inline void CatalogExport::setHash(HASH hash)
+{
+    m_hash = hash;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Sets number of libraries scanned in parallel, 0 to use number of CPU cores.
+ * \param jobs          Number of jobs.
+ **********************************************************************************************************************/
+inline void CatalogExport::setJobs(int jobs)
+{
+    m_jobs = jobs;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns number of rows written by the last export.
+ **********************************************************************************************************************/
+inline qint64 CatalogExport::getRowCount() const
+{
+    return m_rowCount;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns errors of the last export.
+ **********************************************************************************************************************/
+inline QStringList CatalogExport::getErrors() const
+{
+    return m_errorList;
+}
+
+#endif // CATALOGEXPORT_H
@@ -0,0 +1,512 @@
+#include <cstring>
+#include <iostream>
+
+#include <QDir>
+#include <QRegExp>
+#include <QFileInfo>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QCoreApplication>
+#include <QFileSystemWatcher>
+
+#include "catalogserver.h"
+#include "catalogclient.h"
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+/*!*********************************************************************************************************************
+ * \brief Constructs CatalogServer object. The server does not listen until start() is called.
+ * \param parent       Parent object, by default is NULL.
+ **********************************************************************************************************************/
+CatalogServer::CatalogServer(QObject *parent)
+    : QObject(parent),
+      m_server(new QLocalServer(this)),
+      m_watcher(new QFileSystemWatcher(this))
+{
+    connect(m_server, SIGNAL(newConnection()), this, SLOT(newConnection()));
+    connect(m_watcher, SIGNAL(directoryChanged(QString)), this, SLOT(directoryChanged(QString)));
+    connect(m_watcher, SIGNAL(fileChanged(QString)), this, SLOT(fileChanged(QString)));
+}
+
+/*!*********************************************************************************************************************
+ * \brief Destructs CatalogServer object and stops listening.
+ **********************************************************************************************************************/
+CatalogServer::~CatalogServer()
+{
+    m_server->close();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if LibMan has been asked to run as catalog daemon. Used before any Qt application object exists.
+ * \param argc     Number of command line arguments.
+ * \param argv     Command line arguments.
+ **********************************************************************************************************************/
+bool CatalogServer::isRequested(int argc, char *argv[])
+{
+    for(int i = 1; i < argc; ++i) {
+        if(std::strcmp(argv[i], "--daemon") == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Parses command line arguments, loads the project file and starts listening.
+ * \param arguments     Command line arguments including the program name.
+ * \return              False if the daemon can not be started.
+ **********************************************************************************************************************/
+bool CatalogServer::start(const QStringList &arguments)
+{
+    for(int i = 1; i < arguments.count(); ++i) {
+        QString key = arguments[i];
+
+        if(key == "--daemon") {
+            continue;
+        }
+        else if(key == "--project" && i + 1 < arguments.count()) {
+            m_projFile = arguments[++i];
+        }
+        else if(key == "--trace" && i + 1 < arguments.count()) {
+            ++i;
+        }
+        else {
+            cerr<<"[ERROR] Incorrect input argument '"<<key.toStdString()<<"'."<<endl;
+            return false;
+        }
+    }
+
+    if(m_projFile.isEmpty()) {
+        m_projFile = Catalog::getProjectFileFromDir(QDir(".").absolutePath());
+    }
+
+    if(m_projFile.isEmpty()) {
+        cerr<<"[ERROR] No project file found. Please use '--project <file>'."<<endl;
+        return false;
+    }
+
+    m_projFile = QFileInfo(m_projFile).absoluteFilePath();
+
+    if(!loadProject()) {
+        return false;
+    }
+
+    QString socketName = CatalogClient::getSocketName(m_projFile);
+
+    CatalogClient client;
+    if(client.connectToDaemon(m_projFile)) {
+        cerr<<"[ERROR] Catalog daemon is already running on '"<<socketName.toStdString()<<"'."<<endl;
+        return false;
+    }
+
+    QLocalServer::removeServer(socketName);
+
+#if QT_VERSION >= 0x050000
+    // Only the owner may query, the daemon lists and reads library files with the rights of its owner.
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+#endif
+
+    if(!m_server->listen(socketName)) {
+        cerr<<"[ERROR] Can not listen on '"<<socketName.toStdString()<<"': "
+            <<m_server->errorString().toStdString()<<endl;
+        return false;
+    }
+
+    m_watcher->addPath(m_projFile);
+
+    QMap<QString, QString> libraries = m_catalog.getLibraries();
+    QMap<QString, QString>::const_iterator it;
+    for(it = libraries.constBegin(); it != libraries.constEnd(); ++it) {
+        getLibrary(it.value());
+    }
+
+    log(QString("Serving '%1' on '%2'.").arg(m_projFile).arg(m_server->fullServerName()));
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Loads the served project file and drops all cached library data.
+ **********************************************************************************************************************/
+bool CatalogServer::loadProject()
+{
+    m_cache.clear();
+    m_catalog.clearErrors();
+
+    // Libraries removed from the project must not stay watched, they are added again when queried.
+    if(!m_watcher->directories().isEmpty()) {
+        m_watcher->removePaths(m_watcher->directories());
+    }
+
+    QStringList watchedFiles = m_watcher->files();
+    watchedFiles.removeAll(m_projFile);
+    if(!watchedFiles.isEmpty()) {
+        m_watcher->removePaths(watchedFiles);
+    }
+
+    if(!m_catalog.loadProjectFile(m_projFile)) {
+        foreach(const QString &explain, m_catalog.getErrors()) {
+            cerr<<"[ERROR] "<<explain.toStdString()<<endl;
+        }
+
+        m_catalog.clearErrors();
+        return false;
+    }
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Prints message to the standard output.
+ * \param msg       Message to print.
+ **********************************************************************************************************************/
+void CatalogServer::log(const QString &msg) const
+{
+    cout<<"[INFO] "<<msg.toStdString()<<endl;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns cached data of the library. Library is scanned and watched if it is not cached yet.
+ * \param libPath       Path to the library.
+ **********************************************************************************************************************/
+const CatalogServer::LibraryCache& CatalogServer::getLibrary(const QString &libPath)
+{
+    QMap<QString, LibraryCache>::const_iterator it = m_cache.constFind(libPath);
+    if(it != m_cache.constEnd()) {
+        return it.value();
+    }
+
+    LibraryCache &library = m_cache[libPath];
+
+    library.cells = m_catalog.scanLibrary(libPath);
+    library.documents = m_catalog.getDocuments(libPath);
+
+    foreach(const QString &catName, m_catalog.getCategories(libPath)) {
+        library.categories[catName] = m_catalog.readCategory(libPath, catName);
+    }
+
+    m_catalog.clearErrors();
+
+    watchLibrary(libPath);
+
+    return library;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if the path is the path of a library of the served project. Other paths are never scanned, so
+ * clients can not list arbitrary folders and the cache only holds libraries of the project.
+ * \param libPath       Path to the library.
+ **********************************************************************************************************************/
+bool CatalogServer::isServedLibrary(const QString &libPath) const
+{
+    return m_catalog.getLibraries().values().contains(libPath);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if the path is a served library or lies inside one.
+ * \param path          Path to check.
+ **********************************************************************************************************************/
+bool CatalogServer::isInServedLibrary(const QString &path) const
+{
+    foreach(const QString &libPath, m_catalog.getLibraries().values()) {
+        if(path == libPath || path.startsWith(libPath + "/")) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Adds library folder, its view and document folders and category files to the watcher.
+ * \param libPath       Path to the library.
+ **********************************************************************************************************************/
+void CatalogServer::watchLibrary(const QString &libPath)
+{
+    if(!QFileInfo(libPath).isDir()) {
+        return;
+    }
+
+    QStringList dirs;
+    dirs<<libPath<<QDir::toNativeSeparators(libPath + "/doc");
+    foreach(const QString &viewName, Catalog::getValidViewList()) {
+        dirs<<QDir::toNativeSeparators(libPath + "/" + viewName);
+    }
+
+    QStringList watchedDirs = m_watcher->directories();
+    foreach(const QString &dir, dirs) {
+        if(QFileInfo(dir).isDir() && !watchedDirs.contains(dir)) {
+            m_watcher->addPath(dir);
+        }
+    }
+
+    QStringList watchedFiles = m_watcher->files();
+    foreach(const QString &catName, m_catalog.getCategories(libPath)) {
+        QString catPath = QDir::toNativeSeparators(libPath + "/" + catName + ".group");
+        if(!watchedFiles.contains(catPath)) {
+            m_watcher->addPath(catPath);
+        }
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Drops cached data of all libraries containing the path. Libraries are rescanned on the next query.
+ * \param path          Changed path.
+ **********************************************************************************************************************/
+void CatalogServer::invalidateLibrary(const QString &path)
+{
+    QStringList libPaths = m_cache.keys();
+    foreach(const QString &libPath, libPaths) {
+        if(path == libPath || path.startsWith(libPath + "/")) {
+            m_cache.remove(libPath);
+            log(QString("Library '%1' changed.").arg(libPath));
+        }
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Slot is triggered when a new client connects.
+ **********************************************************************************************************************/
+void CatalogServer::newConnection()
+{
+    while(m_server->hasPendingConnections()) {
+        QLocalSocket *socket = m_server->nextPendingConnection();
+        connect(socket, SIGNAL(readyRead()), this, SLOT(readRequest()));
+        connect(socket, SIGNAL(disconnected()), this, SLOT(clientDisconnected()));
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Slot is triggered when a client sends data. Every complete request line is answered.
+ **********************************************************************************************************************/
+void CatalogServer::readRequest()
+{
+    QLocalSocket *socket = qobject_cast<QLocalSocket *>(sender());
+    if(!socket) {
+        return;
+    }
+
+    while(socket->canReadLine()) {
+        QByteArray data = socket->readLine();
+        if(data.endsWith('\n')) {
+            data.chop(1);
+        }
+
+        socket->write(handleRequest(QString::fromUtf8(data)));
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Slot is triggered when a client disconnects.
+ **********************************************************************************************************************/
+void CatalogServer::clientDisconnected()
+{
+    QLocalSocket *socket = qobject_cast<QLocalSocket *>(sender());
+    if(socket) {
+        socket->deleteLater();
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Slot is triggered when a watched folder is changed.
+ * \param path          Changed folder.
+ **********************************************************************************************************************/
+void CatalogServer::directoryChanged(const QString &path)
+{
+    invalidateLibrary(path);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Slot is triggered when a watched file is changed. Project file changes reload the whole project.
+ * \param path          Changed file.
+ **********************************************************************************************************************/
+void CatalogServer::fileChanged(const QString &path)
+{
+    if(path == m_projFile) {
+        log(QString("Project '%1' changed.").arg(m_projFile));
+        loadProject();
+
+        if(!m_watcher->files().contains(m_projFile) && QFileInfo(m_projFile).exists()) {
+            m_watcher->addPath(m_projFile);
+        }
+
+        return;
+    }
+
+    invalidateLibrary(path);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Executes a single request and returns the encoded response.
+ * \param line          Request line without the line break.
+ **********************************************************************************************************************/
+QByteArray CatalogServer::handleRequest(const QString &line)
+{
+    QStringList fields = CatalogClient::splitFields(line);
+    QString command = fields.value(0).toUpper();
+    QStringList args = fields.mid(1);
+
+    QList<QStringList> rows;
+
+    static const QStringList libraryCommands = QStringList()<<"CELLS"<<"VIEWS"<<"CATEGORIES"<<"CATEGORY"<<"DOCS"
+                                                            <<"RESOLVE";
+
+    if(libraryCommands.contains(command) && !args.isEmpty() && !isServedLibrary(args[0])) {
+        return replyError(QString("Library '%1' is not part of the project.").arg(args[0]));
+    }
+
+    if(command == "INVALIDATE" && !args.isEmpty() && !isInServedLibrary(args[0])) {
+        return replyError(QString("Path '%1' is not part of the project.").arg(args[0]));
+    }
+
+    if(command == "PING") {
+        return reply(rows);
+    }
+    else if(command == "RELOAD") {
+        if(!loadProject()) {
+            return replyError(QString("Can not reload '%1'.").arg(m_projFile));
+        }
+
+        return reply(rows);
+    }
+    else if(command == "LIBS") {
+        QMap<QString, QString> libraries = m_catalog.getLibraries();
+        QMap<QString, QString>::const_iterator it;
+        for(it = libraries.constBegin(); it != libraries.constEnd(); ++it) {
+            rows<<(QStringList()<<it.key()<<it.value());
+        }
+
+        return reply(rows);
+    }
+    else if(command == "GROUPS") {
+        QMap<QString, QStringList> groups = m_catalog.getCombinedLibs();
+        QMap<QString, QStringList>::const_iterator it;
+        for(it = groups.constBegin(); it != groups.constEnd(); ++it) {
+            foreach(const QString &libName, it.value()) {
+                rows<<(QStringList()<<it.key()<<libName);
+            }
+        }
+
+        return reply(rows);
+    }
+    else if(command == "CELLS" && args.count() == 1) {
+        foreach(const QString &cellName, getLibrary(args[0]).cells.keys()) {
+            rows<<(QStringList()<<cellName);
+        }
+
+        return reply(rows);
+    }
+    else if(command == "VIEWS" && args.count() == 2) {
+        foreach(const QString &viewName, getLibrary(args[0]).cells.value(args[1])) {
+            rows<<(QStringList()<<viewName);
+        }
+
+        return reply(rows);
+    }
+    else if(command == "CATEGORIES" && args.count() == 1) {
+        foreach(const QString &catName, getLibrary(args[0]).categories.keys()) {
+            rows<<(QStringList()<<catName);
+        }
+
+        return reply(rows);
+    }
+    else if(command == "CATEGORY" && args.count() == 2) {
+        const LibraryCache &library = getLibrary(args[0]);
+        if(!library.categories.contains(args[1])) {
+            return replyError(QString("Can not find category '%1'.").arg(args[1]));
+        }
+
+        foreach(const QString &cellName, library.categories.value(args[1])) {
+            rows<<(QStringList()<<cellName);
+        }
+
+        return reply(rows);
+    }
+    else if(command == "DOCS" && args.count() == 1) {
+        foreach(const QString &docName, getLibrary(args[0]).documents) {
+            rows<<(QStringList()<<docName);
+        }
+
+        return reply(rows);
+    }
+    else if(command == "SEARCH" && args.count() == 1) {
+        QRegExp regExp(args[0], Qt::CaseInsensitive, QRegExp::Wildcard);
+
+        QMap<QString, QString> libraries = m_catalog.getLibraries();
+        QMap<QString, QString>::const_iterator it;
+        for(it = libraries.constBegin(); it != libraries.constEnd(); ++it) {
+            foreach(const QString &cellName, getLibrary(it.value()).cells.keys()) {
+                if(regExp.exactMatch(cellName)) {
+                    rows<<(QStringList()<<it.key()<<cellName);
+                }
+            }
+        }
+
+        return reply(rows);
+    }
+    else if(command == "WHEREUSED" && args.count() == 1) {
+        QMap<QString, QString> libraries = m_catalog.getLibraries();
+        QMap<QString, QString>::const_iterator it;
+        for(it = libraries.constBegin(); it != libraries.constEnd(); ++it) {
+            const LibraryCache &library = getLibrary(it.value());
+
+            if(library.cells.contains(args[0])) {
+                rows<<(QStringList()<<it.key()<<"");
+            }
+
+            QMap<QString, QStringList>::const_iterator cit;
+            for(cit = library.categories.constBegin(); cit != library.categories.constEnd(); ++cit) {
+                if(cit.value().contains(args[0])) {
+                    rows<<(QStringList()<<it.key()<<cit.key());
+                }
+            }
+        }
+
+        return reply(rows);
+    }
+    else if(command == "RESOLVE" && args.count() == 3) {
+        if(!getLibrary(args[0]).cells.value(args[1]).contains(args[2])) {
+            return replyError(QString("Can not find view '%1' of cell '%2'.").arg(args[2]).arg(args[1]));
+        }
+
+        rows<<(QStringList()<<Catalog::getViewPath(args[0], args[1], args[2]));
+
+        return reply(rows);
+    }
+    else if(command == "INVALIDATE" && args.count() == 1) {
+        invalidateLibrary(args[0]);
+
+        return reply(rows);
+    }
+
+    return replyError(QString("Incorrect request '%1'.").arg(command));
+}
+
+/*!*********************************************************************************************************************
+ * \brief Encodes successful response.
+ * \param rows          Rows of the response.
+ **********************************************************************************************************************/
+QByteArray CatalogServer::reply(const QList<QStringList> &rows) const
+{
+    QString response = QString("OK %1\n").arg(rows.count());
+    foreach(const QStringList &row, rows) {
+        response += CatalogClient::joinFields(row) + "\n";
+    }
+
+    return response.toUtf8();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Encodes error response.
+ * \param msg           Error message.
+ **********************************************************************************************************************/
+QByteArray CatalogServer::replyError(const QString &msg) const
+{
+    QString response = msg;
+    response.replace("\n", " ");
+
+    return QString("ERR %1\n").arg(response).toUtf8();
+}
@@ -0,0 +1,71 @@
+#ifndef CATALOGSERVER_H
+#define CATALOGSERVER_H
+
+#include <QMap>
+#include <QObject>
+#include <QStringList>
+
+#include "catalog.h"
+
+class QLocalServer;
+class QLocalSocket;
+class QFileSystemWatcher;
+
+/*!*********************************************************************************************************************
+ * \brief The CatalogServer class implements LibMan catalog daemon. It keeps catalogs of project libraries in memory,
+ * watches library folders for changes and answers queries of CatalogClient objects over a local socket.
+ **********************************************************************************************************************/
+class CatalogServer : public QObject
+{
+    Q_OBJECT
+
+    /*!
+     * \brief The LibraryCache struct keeps scanned data of a single library.
+     */
+    struct LibraryCache {
+        QMap<QString, QStringList>      cells;              /*!< Map of cell names to their views. */
+        QMap<QString, QStringList>      categories;         /*!< Map of category names to their cells. */
+        QStringList                     documents;          /*!< Names of library documents. */
+    };
+
+public:
+    explicit CatalogServer(QObject *parent = 0);
+    ~CatalogServer();
+
+    bool                                start(const QStringList &arguments);
+
+    static bool                         isRequested(int argc, char *argv[]);
+
+private slots:
+    void                                newConnection();
+    void                                readRequest();
+    void                                clientDisconnected();
+    void                                directoryChanged(const QString &path);
+    void                                fileChanged(const QString &path);
+
+private:
+    bool                                loadProject();
+    void                                log(const QString &msg) const;
+
+    bool                                isServedLibrary(const QString &libPath) const;
+    bool                                isInServedLibrary(const QString &path) const;
+
+    const LibraryCache&                 getLibrary(const QString &libPath);
+    void                                watchLibrary(const QString &libPath);
+    void                                invalidateLibrary(const QString &path);
+
+    QByteArray                          handleRequest(const QString &line);
+    QByteArray                          reply(const QList<QStringList> &rows) const;
+    QByteArray                          replyError(const QString &msg) const;
+
+private:
+    QLocalServer                        *m_server;          /*!< Local socket server. */
+    QFileSystemWatcher                  *m_watcher;         /*!< Watcher of the project file and library folders. */
+
+    QString                             m_projFile;         /*!< Path to the served project file. */
+    Catalog                             m_catalog;          /*!< Project data and local scanning logic. */
+
+    QMap<QString, LibraryCache>         m_cache;            /*!< Map of library paths to scanned library data. */
+};
+
+#endif // CATALOGSERVER_H
@@ -14,6 +14,7 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 
+#include "catalog.h"
 #include "property.h"
 #include "toolmanager.h"
 #include "projectmanager.h"
@@ -25,42 +26,17 @@
  **********************************************************************************************************************/
 QStringList MainWindow::readLibraryCategories(const QString &libPath, const QString &catName)
 {
-    QStringList categories;
-
-    QString fileName = QDir::toNativeSeparators(libPath + "/" + catName + ".group");
-    if(!QFileInfo(fileName).exists()) {
-        QMessageBox::critical(this, tr("LibManager"),
-                              tr("Can not find category '%1'.").arg(fileName));
-        error("Can not find category '" + fileName + "'.");
-        return categories;
-    }
+    m_catalog->clearErrors();
 
+    QStringList categories = m_catalog->readCategory(libPath, catName);
 
-    QFile file(fileName);
-    if(!file.open(QFile::ReadOnly | QFile::Text)) {
-        QMessageBox::critical(this, tr("LibManager"),
-                              tr("Can not read category '%1':\n%2.")
-                              .arg(fileName)
-                              .arg(file.errorString()));
-        error("Can not read category '" + fileName + "'.");
-        return categories;
-    }
+    QStringList errors = m_catalog->getErrors();
+    if(errors.count()) {
+        m_catalog->clearErrors();
 
-    QTextStream in(&file);
-    while (!in.atEnd()) {
-        QString line = in.readLine().remove("^\\s+").remove("\\s+$");
-        #if QT_VERSION >= 0x050000
-            QStringList words = line.split(" ", Qt::SkipEmptyParts);
-        #else
-            QStringList words = line.split(" ", QString::SkipEmptyParts);
-        #endif
-        foreach(const QString catName, words) {
-            categories<<catName;
-        }
+        QMessageBox::critical(this, tr("LibManager"), errors.join("\n"));
+        error(errors.join("\n"));
     }
 
-    categories.removeDuplicates();
-    categories.sort();
-
     return categories;
 }
@@ -0,0 +1,403 @@
+#include <QDir>
+#include <QMap>
+#include <QFile>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QDataStream>
+#include <QTextStream>
+#include <QCoreApplication>
+#include <QCryptographicHash>
+
+#include "catalog.h"
+#include "categoryindex.h"
+#include "perfcounters.h"
+#include "trace.h"
+
+/*!*********************************************************************************************************************
+ * \brief Magic number and version of the index files. The version is increased whenever the stored data changes, older
+ * files are then dropped and the category files read again.
+ **********************************************************************************************************************/
+static const quint32 CATEGORY_INDEX_MAGIC = 0x4c4d4349;
+static const quint32 CATEGORY_INDEX_VERSION = 1;
+
+/*!*********************************************************************************************************************
+ * \brief Writes category into the index file.
+ **********************************************************************************************************************/
+QDataStream& operator<<(QDataStream &out, const CategoryIndex::Category &category)
+{
+    return out<<category.name<<category.size<<category.modified<<category.cells;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Reads category from the index file.
+ **********************************************************************************************************************/
+QDataStream& operator>>(QDataStream &in, CategoryIndex::Category &category)
+{
+    return in>>category.name>>category.size>>category.modified>>category.cells;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Constructs an empty index.
+ **********************************************************************************************************************/
+CategoryIndex::CategoryIndex()
+    : m_modified(-1)
+{
+}
+
+/*!*********************************************************************************************************************
+ * \brief Brings the index of the library up to date. The index is loaded from the cache folder if it does not hold
+ * the library yet; then the library folder is listed once and only category files whose size or modification time
+ * differ from the index are read. The index is saved if anything has changed.
+ * \param libPath       Path to the library.
+ * \return              True if all category files have been read, otherwise false and the reasons are in the error
+ *                      list. Unreadable categories are empty and read again by the next call.
+ **********************************************************************************************************************/
+bool CategoryIndex::update(const QString &libPath)
+{
+    TRACE_SCOPE_ARG("catalog", "update_categories", libPath);
+
+    QString indexFile = getIndexFile(libPath);
+
+    if(m_libPath != libPath) {
+        load(indexFile);
+
+        if(m_libPath != libPath) {
+            m_libPath = libPath;
+            m_categories.clear();
+            m_cellNames.clear();
+            updateLookups();
+        }
+    }
+
+    m_errorList.clear();
+
+    PerfCounters::add(PerfCounters::STAT_CALLS);
+    m_modified = QFileInfo(libPath).lastModified().toMSecsSinceEpoch();
+
+    PerfCounters::add(PerfCounters::READDIR_CALLS);
+
+    QDir catDir(libPath);
+    catDir.setNameFilters(QStringList()<<"*.group");
+
+    // Categories are kept in the order of QStringList::sort(), which may differ from the order of QDir.
+    QMap<QString, QFileInfo> files;
+    foreach(const QFileInfo &fileInfo, catDir.entryInfoList(QDir::Files)) {
+        files.insert(fileInfo.completeBaseName(), fileInfo);
+    }
+
+    PerfCounters::add(PerfCounters::STAT_CALLS, files.count());
+
+    QList<Category> categories;
+    QList<QStringList> cellLists;
+    bool isChanged = files.count() != m_categories.count();
+    bool isRead = true;
+
+    QMap<QString, QFileInfo>::const_iterator it;
+    for(it = files.constBegin(); it != files.constEnd(); ++it) {
+        Category category;
+        category.name = it.key();
+        category.size = it.value().size();
+        category.modified = it.value().lastModified().toMSecsSinceEpoch();
+
+        QStringList cells;
+
+        int id = m_categoryIds.value(category.name, -1);
+        if(id >= 0 && m_categories[id].size == category.size && m_categories[id].modified == category.modified) {
+            PerfCounters::add(PerfCounters::CACHE_HITS);
+            cells = getCells(m_categories[id]);
+        }
+        else {
+            PerfCounters::add(PerfCounters::CACHE_MISSES);
+            isChanged = true;
+
+            if(!readCells(it.value().filePath(), &cells)) {
+                category.modified = -1;
+                isRead = false;
+            }
+        }
+
+        categories<<category;
+        cellLists<<cells;
+    }
+
+    if(!isChanged) {
+        return isRead;
+    }
+
+    QStringList cellNames;
+    foreach(const QStringList &cells, cellLists) {
+        cellNames<<cells;
+    }
+
+    cellNames.removeDuplicates();
+    cellNames.sort();
+
+    QHash<QString, int> cellIds;
+    for(int i = 0; i < cellNames.count(); ++i) {
+        cellIds.insert(cellNames[i], i);
+    }
+
+    for(int i = 0; i < categories.count(); ++i) {
+        categories[i].cells.resize(cellNames.count());
+
+        foreach(const QString &cellName, cellLists[i]) {
+            categories[i].cells.setBit(cellIds.value(cellName));
+        }
+    }
+
+    m_categories = categories;
+    m_cellNames = cellNames;
+    updateLookups();
+
+    // The index is still valid if it can not be saved, the changed files are only read again next time.
+    save(indexFile);
+
+    return isRead;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Loads the index of a library. A missing file or one of another version gives an empty index.
+ * \param indexFile     Path to the index file.
+ * \return              False if the file exists but can not be read.
+ **********************************************************************************************************************/
+bool CategoryIndex::load(const QString &indexFile)
+{
+    m_libPath.clear();
+    m_modified = -1;
+    m_categories.clear();
+    m_cellNames.clear();
+    m_errorList.clear();
+    updateLookups();
+
+    QFile file(indexFile);
+    if(!file.exists()) {
+        return true;
+    }
+
+    if(!file.open(QIODevice::ReadOnly)) {
+        m_errorList<<QString("Can not read file '%1':\n%2.").arg(indexFile).arg(file.errorString());
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_4_6);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    in>>magic>>version;
+
+    if(magic != CATEGORY_INDEX_MAGIC || version != CATEGORY_INDEX_VERSION) {
+        return true;
+    }
+
+    in>>m_libPath>>m_cellNames>>m_categories;
+
+    if(in.status() != QDataStream::Ok) {
+        m_libPath.clear();
+        m_categories.clear();
+        m_cellNames.clear();
+        m_errorList<<QString("Category index '%1' is damaged and will be rebuilt.").arg(indexFile);
+        return false;
+    }
+
+    updateLookups();
+
+    PerfCounters::add(PerfCounters::FILES_READ);
+    PerfCounters::add(PerfCounters::BYTES_READ, file.size());
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Saves the index. It is written to a temporary file first, which replaces the index atomically on Unix, so
+ * readers never see a partial index.
+ * \param indexFile     Path to the index file.
+ **********************************************************************************************************************/
+bool CategoryIndex::save(const QString &indexFile)
+{
+    QDir().mkpath(QFileInfo(indexFile).absolutePath());
+
+    QString tempName = indexFile + QString(".%1.tmp").arg(QCoreApplication::applicationPid());
+
+    QFile file(tempName);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        m_errorList<<QString("Can not write to file '%1':\n%2.").arg(tempName).arg(file.errorString());
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_4_6);
+    out<<CATEGORY_INDEX_MAGIC<<CATEGORY_INDEX_VERSION<<m_libPath<<m_cellNames<<m_categories;
+
+    qint64 size = file.size();
+    file.close();
+
+    if(out.status() != QDataStream::Ok || file.error() != QFile::NoError) {
+        m_errorList<<QString("Can not write to file '%1':\n%2.").arg(tempName).arg(file.errorString());
+        QFile::remove(tempName);
+        return false;
+    }
+
+    if(!Catalog::replaceFile(tempName, indexFile)) {
+        m_errorList<<QString("Can not replace file '%1'.").arg(indexFile);
+        QFile::remove(tempName);
+        return false;
+    }
+
+    PerfCounters::add(PerfCounters::FILES_WRITTEN);
+    PerfCounters::add(PerfCounters::BYTES_WRITTEN, size);
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns names of the categories in sorted order.
+ **********************************************************************************************************************/
+QStringList CategoryIndex::getCategories() const
+{
+    QStringList categories;
+    foreach(const Category &category, m_categories) {
+        categories<<category.name;
+    }
+
+    return categories;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if the category file has the size and modification time it was indexed with. Without a category
+ * the library folder is checked instead, its modification time changes when a category file is added or removed.
+ * Either way a single file is stat'ed.
+ * \param catName       Name of the category, or empty.
+ **********************************************************************************************************************/
+bool CategoryIndex::isCurrent(const QString &catName) const
+{
+    PerfCounters::add(PerfCounters::STAT_CALLS);
+
+    if(catName.isEmpty()) {
+        return m_modified >= 0 && QFileInfo(m_libPath).lastModified().toMSecsSinceEpoch() == m_modified;
+    }
+
+    int id = m_categoryIds.value(catName, -1);
+    if(id < 0) {
+        return false;
+    }
+
+    QFileInfo fileInfo(QDir::toNativeSeparators(m_libPath + "/" + catName + ".group"));
+
+    return fileInfo.isFile() && fileInfo.size() == m_categories[id].size
+                             && fileInfo.lastModified().toMSecsSinceEpoch() == m_categories[id].modified;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns sorted cells of the category, empty if the library has no such category.
+ * \param catName       Name of the category.
+ **********************************************************************************************************************/
+QStringList CategoryIndex::getCells(const QString &catName) const
+{
+    int id = m_categoryIds.value(catName, -1);
+    if(id < 0) {
+        return QStringList();
+    }
+
+    return getCells(m_categories[id]);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns sorted categories listing the cell.
+ * \param cellName      Name of the cell.
+ **********************************************************************************************************************/
+QStringList CategoryIndex::getCellCategories(const QString &cellName) const
+{
+    QStringList categories;
+
+    int id = m_cellIds.value(cellName, -1);
+    if(id < 0) {
+        return categories;
+    }
+
+    foreach(int catId, m_cellCategories[id]) {
+        categories<<m_categories[catId].name;
+    }
+
+    return categories;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns path of the index file of the library in the cache folder.
+ * \param libPath       Path to the library.
+ **********************************************************************************************************************/
+QString CategoryIndex::getIndexFile(const QString &libPath)
+{
+    QByteArray key = QCryptographicHash::hash(QFileInfo(libPath).absoluteFilePath().toUtf8(),
+                                              QCryptographicHash::Md5).toHex();
+
+    return QDir::toNativeSeparators(Catalog::getCacheDir() + "/categories/" + QString::fromLatin1(key) + ".index");
+}
+
+/*!*********************************************************************************************************************
+ * \brief Reads the cells of a category file, they are separated by blanks and line breaks.
+ * \param fileName      Path to the '.group' file.
+ * \param cells         List to add the cells to.
+ **********************************************************************************************************************/
+bool CategoryIndex::readCells(const QString &fileName, QStringList *cells)
+{
+    QFile file(fileName);
+    if(!file.open(QFile::ReadOnly | QFile::Text)) {
+        m_errorList<<QString("Can not read category '%1':\n%2.").arg(fileName).arg(file.errorString());
+        return false;
+    }
+
+    PerfCounters::add(PerfCounters::FILES_READ);
+    PerfCounters::add(PerfCounters::BYTES_READ, file.size());
+
+    QTextStream in(&file);
+    while(!in.atEnd()) {
+        *cells<<Catalog::splitLine(in.readLine());
+    }
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns cells whose bits are set in the category, they are sorted as the bits follow the cell order.
+ * \param category      Category of this index.
+ **********************************************************************************************************************/
+QStringList CategoryIndex::getCells(const Category &category) const
+{
+    QStringList cells;
+
+    int count = qMin(category.cells.size(), m_cellNames.count());
+    for(int i = 0; i < count; ++i) {
+        if(category.cells.testBit(i)) {
+            cells<<m_cellNames[i];
+        }
+    }
+
+    return cells;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Builds the maps of names to positions and the reverse lookup of the categories of every cell.
+ **********************************************************************************************************************/
+void CategoryIndex::updateLookups()
+{
+    m_categoryIds.clear();
+    m_cellIds.clear();
+    m_cellCategories.clear();
+    m_cellCategories.resize(m_cellNames.count());
+
+    for(int i = 0; i < m_cellNames.count(); ++i) {
+        m_cellIds.insert(m_cellNames[i], i);
+    }
+
+    for(int i = 0; i < m_categories.count(); ++i) {
+        m_categoryIds.insert(m_categories[i].name, i);
+
+        int count = qMin(m_categories[i].cells.size(), m_cellNames.count());
+        for(int j = 0; j < count; ++j) {
+            if(m_categories[i].cells.testBit(j)) {
+                m_cellCategories[j]<<i;
+            }
+        }
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef CATEGORYINDEX_H
+#define CATEGORYINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include <QString>
+#include <QBitArray>
+#include <QStringList>
+
+/*!*********************************************************************************************************************
+ * \brief The CategoryIndex class keeps the categories ('.group' files) of a library as bit sets over the sorted cells
+ * of all its categories, together with the reverse lookup from a cell to its categories. Category files are read only
+ * if their size or modification time has changed; the index is kept in the cache folder, so it survives restarts.
+ * Lookups of a category validate only its file with isCurrent(), a single stat; reverse lookups need update().
+ **********************************************************************************************************************/
+class CategoryIndex
+{
+public:
+    /*!
+     * \brief The Category struct keeps the cells of a category file and the state of the file they were read from.
+     */
+    struct Category {
+        QString                         name;               /*!< Name of the category. */
+        qint64                          size;               /*!< Size of the '.group' file. */
+        qint64                          modified;           /*!< Modification time of the file in ms since epoch. */
+        QBitArray                       cells;              /*!< Bit of every cell of the index in the category. */
+    };
+
+    CategoryIndex();
+
+    bool                                update(const QString &libPath);
+    bool                                load(const QString &indexFile);
+    bool                                save(const QString &indexFile);
+
+    QString                             getLibraryPath() const;
+    QStringList                         getCategories() const;
+    bool                                contains(const QString &catName) const;
+    bool                                isCurrent(const QString &catName = QString()) const;
+    QStringList                         getCells(const QString &catName) const;
+    QStringList                         getCellCategories(const QString &cellName) const;
+    QStringList                         getErrors() const;
+
+    static QString                      getIndexFile(const QString &libPath);
+
+private:
+    bool                                readCells(const QString &fileName, QStringList *cells);
+    QStringList                         getCells(const Category &category) const;
+    void                                updateLookups();
+
+private:
+    QString                             m_libPath;          /*!< Path to the indexed library. */
+    QList<Category>                     m_categories;       /*!< Categories in name order. */
+    QStringList                         m_cellNames;        /*!< Cells of all categories in name order. */
+    QHash<QString, int>                 m_categoryIds;      /*!< Map of category names to their position. */
+    QVector<QList<int> >                m_cellCategories;   /*!< Positions of the categories of every cell. */
+    QHash<QString, int>                 m_cellIds;          /*!< Map of cell names to their bit. */
+    qint64                              m_modified;         /*!< Modification time of the library folder at update(). */
+    QStringList                         m_errorList;        /*!< Errors of the last update(), load() or save(). */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Returns path to the indexed library.
+ **********************************************************************************************************************/
+inline QString CategoryIndex::getLibraryPath() const
+{
+    return m_libPath;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if the library has the category.
+ * \param catName       Name of the category.
+ **********************************************************************************************************************/
+inline bool CategoryIndex::contains(const QString &catName) const
+{
+    return m_categoryIds.contains(catName);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns errors of the last update(), load() or save() call.
+ **********************************************************************************************************************/
+inline QStringList CategoryIndex::getErrors() const
+{
+    return m_errorList;
+}
+
+#endif // CATEGORYINDEX_H
@@ -0,0 +1,141 @@
+#include <QRegExp>
+
+#include "cellfilter.h"
+#include "trace.h"
+
+/*!*********************************************************************************************************************
+ * \brief Constructs an empty filter.
+ **********************************************************************************************************************/
+CellFilter::CellFilter()
+{
+}
+
+/*!*********************************************************************************************************************
+ * \brief Numbers the cells and builds the bit sets of their views and categories. Cells of a category which are not
+ * cells of the library are ignored.
+ * \param libPath       Path to the library.
+ * \param cells         Map of cell names to their views, as returned by Catalog::scanLibrary().
+ * \param categories    Map of category names to their cells.
+ **********************************************************************************************************************/
+void CellFilter::build(const QString &libPath, const QMap<QString, QStringList> &cells,
+                       const QMap<QString, QStringList> &categories)
+{
+    TRACE_SCOPE_ARG("gui", "build_cell_filter", libPath);
+
+    clear();
+
+    m_libPath = libPath;
+    m_cellNames = cells.keys();
+
+    int count = m_cellNames.count();
+    for(int i = 0; i < count; ++i) {
+        m_cellIds.insert(m_cellNames[i], i);
+    }
+
+    int id = 0;
+    QMap<QString, QStringList>::const_iterator it;
+    for(it = cells.constBegin(); it != cells.constEnd(); ++it, ++id) {
+        foreach(const QString &viewName, it.value()) {
+            QBitArray &bits = m_viewBits[viewName];
+            if(bits.size() != count) {
+                bits.resize(count);
+            }
+
+            bits.setBit(id);
+        }
+    }
+
+    for(it = categories.constBegin(); it != categories.constEnd(); ++it) {
+        QBitArray &bits = m_categoryBits[it.key()];
+        bits.resize(count);
+
+        foreach(const QString &cellName, it.value()) {
+            int cellId = m_cellIds.value(cellName, -1);
+            if(cellId >= 0) {
+                bits.setBit(cellId);
+            }
+        }
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Drops all cells and bit sets.
+ **********************************************************************************************************************/
+void CellFilter::clear()
+{
+    m_libPath.clear();
+    m_cellNames.clear();
+    m_cellIds.clear();
+    m_viewBits.clear();
+    m_categoryBits.clear();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns the cells matching all given conditions. The bit sets are intersected a byte at a time, which the
+ * compiler vectorizes; the name pattern is matched only against the cells left.
+ * \param catName       Name of the category, empty for all cells.
+ * \param viewNames     Views every cell has to have.
+ * \param pattern       Matched case insensitive: wildcard pattern matched against the whole name if it contains '*'
+ *                      or '?', otherwise text the name has to contain. Empty for all names.
+ * \return              Bit of every matching cell id.
+ **********************************************************************************************************************/
+QBitArray CellFilter::filter(const QString &catName, const QStringList &viewNames, const QString &pattern) const
+{
+    int count = m_cellNames.count();
+
+    QBitArray cells(count, true);
+
+    if(!catName.isEmpty()) {
+        cells &= m_categoryBits.value(catName, QBitArray(count));
+    }
+
+    foreach(const QString &viewName, viewNames) {
+        cells &= m_viewBits.value(viewName, QBitArray(count));
+    }
+
+    if(pattern.isEmpty()) {
+        return cells;
+    }
+
+    bool isPattern = isWildcard(pattern);
+    QRegExp regExp(pattern, Qt::CaseInsensitive, QRegExp::Wildcard);
+
+    for(int i = 0; i < count; ++i) {
+        if(!cells.testBit(i)) {
+            continue;
+        }
+
+        if(isPattern ? !regExp.exactMatch(m_cellNames[i]) : !m_cellNames[i].contains(pattern, Qt::CaseInsensitive)) {
+            cells.clearBit(i);
+        }
+    }
+
+    return cells;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns names of the cells whose bits are set, in name order.
+ * \param cells         Bit set returned by filter().
+ **********************************************************************************************************************/
+QStringList CellFilter::getCells(const QBitArray &cells) const
+{
+    QStringList names;
+
+    int count = qMin(cells.size(), m_cellNames.count());
+    for(int i = 0; i < count; ++i) {
+        if(cells.testBit(i)) {
+            names<<m_cellNames[i];
+        }
+    }
+
+    return names;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if the pattern contains wildcards.
+ * \param pattern       Name pattern.
+ **********************************************************************************************************************/
+bool CellFilter::isWildcard(const QString &pattern)
+{
+    return pattern.contains('*') || pattern.contains('?');
+}
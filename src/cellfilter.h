@@ -0,0 +1,88 @@
+#ifndef CELLFILTER_H
+#define CELLFILTER_H
+
+#include <QMap>
+#include <QHash>
+#include <QString>
+#include <QBitArray>
+#include <QStringList>
+
+/*!*********************************************************************************************************************
+ * \brief The CellFilter class numbers the cells of a library densely in name order and keeps a bit set of cells per
+ * view type and per category. A filter combining a category, view types and a name pattern intersects the bit sets
+ * first and matches the pattern only against the remaining cells, so it does not depend on the number of categories
+ * or views and touches each cell name at most once.
+ **********************************************************************************************************************/
+class CellFilter
+{
+public:
+    CellFilter();
+
+    void                                build(const QString &libPath, const QMap<QString, QStringList> &cells,
+                                              const QMap<QString, QStringList> &categories);
+    void                                clear();
+
+    QString                             getLibraryPath() const;
+    bool                                hasCategory(const QString &catName) const;
+    bool                                hasView(const QString &viewName) const;
+    int                                 getCellId(const QString &cellName) const;
+    int                                 getCellCount() const;
+
+    QBitArray                           filter(const QString &catName, const QStringList &viewNames,
+                                               const QString &pattern) const;
+    QStringList                         getCells(const QBitArray &cells) const;
+
+    static bool                         isWildcard(const QString &pattern);
+
+private:
+    QString                             m_libPath;          /*!< Path to the library, empty if nothing is built. */
+    QStringList                         m_cellNames;        /*!< Cells of the library, the position is the cell id. */
+    QHash<QString, int>                 m_cellIds;          /*!< Map of cell names to their id. */
+    QHash<QString, QBitArray>           m_viewBits;         /*!< Map of view names to the cells having the view. */
+    QHash<QString, QBitArray>           m_categoryBits;     /*!< Map of category names to their cells. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Returns path to the library of the last build() call, empty if the filter is cleared.
+ **********************************************************************************************************************/
+inline QString CellFilter::getLibraryPath() const
+{
+    return m_libPath;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if the library has the category.
+ * \param catName       Name of the category.
+ **********************************************************************************************************************/
+inline bool CellFilter::hasCategory(const QString &catName) const
+{
+    return m_categoryBits.contains(catName);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if any cell of the library has the view.
+ * \param viewName      Name of the view.
+ **********************************************************************************************************************/
+inline bool CellFilter::hasView(const QString &viewName) const
+{
+    return m_viewBits.contains(viewName);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns id of the cell, -1 if it is not a cell of the library.
+ * \param cellName      Name of the cell.
+ **********************************************************************************************************************/
+inline int CellFilter::getCellId(const QString &cellName) const
+{
+    return m_cellIds.value(cellName, -1);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns number of cells, every bit set returned by filter() has this size.
+ **********************************************************************************************************************/
+inline int CellFilter::getCellCount() const
+{
+    return m_cellNames.count();
+}
+
+#endif // CELLFILTER_H
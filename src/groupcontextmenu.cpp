@@ -12,7 +12,71 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 
+#include "catalog.h"
 #include "property.h"
+#include "netlistgraph.h"
+#include "netlistindex.h"
+#include "backgroundjob.h"
+#include "trace.h"
+
+/*!*********************************************************************************************************************
+ * \brief The GroupUsageJob class brings the netlist graph up to date and finds the subcircuits instantiating a cell.
+ **********************************************************************************************************************/
+class GroupUsageJob : public BackgroundJob
+{
+public:
+    GroupUsageJob(MainWindow *window, const QString &groupName, const QMap<QString, QString> &libraries)
+        : BackgroundJob(window), m_groupName(groupName), m_libraries(libraries) {}
+
+    void run();
+
+private:
+    QString                             m_groupName;        /*!< Name of the group (cell). */
+    QMap<QString, QString>              m_libraries;        /*!< Map of library names to paths of the graph. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Updates changed views in the index and the graph, and formats the users of the cell.
+ **********************************************************************************************************************/
+void GroupUsageJob::run()
+{
+    QList<QStringList> views = getNetlistViews(m_libraries);
+
+    QStringList viewPaths;
+    foreach(const QStringList &view, views) {
+        viewPaths<<view[3];
+    }
+
+    updateNetlistIndex(viewPaths);
+
+    NetlistGraph &graph = getNetlistGraph();
+    graph.update(getNetlistIndex(), views);
+
+    QList<NetlistGraph::Relative> users = graph.getUsers(m_groupName, true);
+    if(users.isEmpty()) {
+        m_info = QString("Cell '%1' is not instantiated in any netlist view.\n").arg(m_groupName);
+        return;
+    }
+
+    m_info = QString("Cell '%1' is used by %2 subcircuits:\n").arg(m_groupName).arg(users.count());
+    foreach(const NetlistGraph::Relative &user, users) {
+        QStringList locations;
+        foreach(const QStringList &definition, graph.getDefinitions(user.name)) {
+            locations<<definition.join("/");
+        }
+
+        m_info += QString("\tLevel %1: %2").arg(user.depth).arg(user.name);
+        if(user.depth == 1) {
+            m_info += QString(" (%1 instances)").arg(user.instances);
+        }
+
+        if(!locations.isEmpty()) {
+            m_info += " in " + locations.join(", ");
+        }
+
+        m_info += "\n";
+    }
+}
 
 /*!*********************************************************************************************************************
  * \brief Displays menu for group (cell) widget.
@@ -58,8 +122,12 @@ void MainWindow::showGroupMenu(const QPoint &pos)
 
     QList<QListWidgetItem *> items = m_ui->listGroups->selectedItems();
     if(items.count()) {
+        // Copy, paste, info and usage work on a single cell, only delete takes all selected cells.
+        bool isSingle = items.count() == 1;
+
         QAction *copyGroup = new QAction(tr("&Copy"), this);
         copyGroup->setStatusTip(tr("Copy view."));
+        copyGroup->setEnabled(isSingle);
         connect(copyGroup, SIGNAL(triggered()), this, SLOT(copySelectedGroup()));
         menu->addAction(copyGroup);
 
@@ -70,8 +138,15 @@ void MainWindow::showGroupMenu(const QPoint &pos)
 
         QAction *groupInfo = new QAction(tr("&Info"), this);
         groupInfo->setStatusTip(tr("Detele Project."));
+        groupInfo->setEnabled(isSingle);
         connect(groupInfo, SIGNAL(triggered()), this, SLOT(showGroupInfo()));
         menu->addAction(groupInfo);
+
+        QAction *groupUsage = new QAction(tr("Where &Used"), this);
+        groupUsage->setStatusTip(tr("Show subcircuits of all libraries instantiating the cell."));
+        groupUsage->setEnabled(isSingle);
+        connect(groupUsage, SIGNAL(triggered()), this, SLOT(showGroupUsage()));
+        menu->addAction(groupUsage);
     }
 
     menu->popup(QCursor::pos());
@@ -90,17 +165,16 @@ void MainWindow::addNewGroup()
     groupId->setFlags(groupId->flags() | Qt::ItemIsEditable);
     m_ui->listGroups->addItem(groupId);
     m_ui->listGroups->sortItems();
+
+    m_cellFilter->clear();
 }
 
 /*!*********************************************************************************************************************
- * \brief Removes selected group (cell).
+ * \brief Removes all selected groups (cells), each with its own views if they are deleted permanently.
  **********************************************************************************************************************/
 void MainWindow::removeSelectedGroup()
 {
-    QString groupName = getCurrentGroupName();
-    if(groupName.isEmpty()) {
-        return;
-    }
+    TRACE_SCOPE("file", "remove_cell");
 
     QString libPath = getCurrentLibraryPath();
     if(!QFileInfo(libPath).isDir()) {
@@ -116,13 +190,17 @@ void MainWindow::removeSelectedGroup()
 
     for(int i = 0; i < items.count(); ++i) {
         QString refText = items[i]->text();
+        if(refText.isEmpty()) {
+            continue;
+        }
+
         for(int j = 0; j < m_ui->listGroups->count(); ++j) {
             QListWidgetItem *item = m_ui->listGroups->item(j);
             if(refText == item->text()) {
                 if(deleteGroup) {
                     QStringList views = getValidViewList();
                     foreach(const QString viewName, views) {
-                        QString viewPath = getViewPath(libPath, groupName, viewName);
+                        QString viewPath = getViewPath(libPath, refText, viewName);
                         if(QFileInfo(viewPath).exists()) {
                             info(QString("Removing view '%1'").arg(viewPath), false);
                             QFile::remove(viewPath);
@@ -131,6 +209,7 @@ void MainWindow::removeSelectedGroup()
                 }
 
                 m_ui->listGroups->takeItem(j);
+                m_cellFilter->clear();
                 break;
             }
         }
@@ -158,6 +237,30 @@ void MainWindow::showGroupInfo()
         QString groupPath = QDir::toNativeSeparators(libPath + "/" + viewName + "/" + groupName + "." + viewName);
         showFolderInfo("Cell", groupName, groupPath, false);
     }
+
+    QStringList categories = m_catalog->getCellCategories(libPath, groupName);
+    if(!categories.isEmpty()) {
+        info("Categories: " + categories.join(" ") + "\n", false);
+    }
+
+    showNetlistInfo(libPath, groupName, views);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Prints subcircuits of all loaded libraries which instantiate the group (cell) directly or on any level above,
+ * so the impact of changing a shared cell is known before it is edited. The query runs in the background on the
+ * netlist graph kept since the last query, which is only patched with the views changed since.
+ **********************************************************************************************************************/
+void MainWindow::showGroupUsage()
+{
+    TRACE_SCOPE("gui", "group_usage");
+
+    QString groupName = getCurrentGroupName();
+    if(groupName.isEmpty()) {
+        return;
+    }
+
+    m_backgroundQueue->start(new GroupUsageJob(this, groupName, getCurrentLibraries()));
 }
 
 /*!*********************************************************************************************************************
@@ -170,6 +273,11 @@ void MainWindow::copySelectedGroup()
         return;
     }
 
+    // Paste takes a single cell, so nothing is copied if several cells are selected.
+    if(m_ui->listGroups->selectedItems().count() != 1) {
+        return;
+    }
+
     QString guiGroupName = getCurrentGroupName();
     if(guiGroupName.isEmpty()) {
         return;
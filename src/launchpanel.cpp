@@ -0,0 +1,154 @@
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+#include <QClipboard>
+#include <QPushButton>
+#include <QTreeWidget>
+#include <QApplication>
+
+#include "launchpanel.h"
+#include "toolsessions.h"
+
+/*!*********************************************************************************************************************
+ * \brief Constructs the panel, it is hidden until the user shows it.
+ * \param sessions      Tool sessions recording the launches.
+ * \param parent        Parent widget, by default is NULL.
+ **********************************************************************************************************************/
+LaunchPanel::LaunchPanel(ToolSessions *sessions, QWidget *parent) :
+    QDockWidget(tr("Tool Launches"), parent),
+    m_sessions(sessions),
+    m_tree(new QTreeWidget)
+{
+    setObjectName("dockLaunches");
+
+    m_tree->setColumnCount(10);
+    m_tree->setHeaderLabels(QStringList()<<tr("Time")<<tr("Tool")<<tr("Mode")<<tr("Files")<<tr("Resolve")
+                                         <<tr("Spawn")<<tr("Ready")<<tr("PID")<<tr("State")<<tr("Peak RSS"));
+    m_tree->setRootIsDecorated(false);
+    m_tree->setAlternatingRowColors(true);
+
+    QPushButton *btnCopy = new QPushButton(tr("Copy"));
+    btnCopy->setStatusTip(tr("Copy launches to the clipboard."));
+    connect(btnCopy, SIGNAL(clicked()), this, SLOT(copyToClipboard()));
+
+    QHBoxLayout *buttons = new QHBoxLayout;
+    buttons->addStretch();
+    buttons->addWidget(btnCopy);
+
+    QVBoxLayout *layout = new QVBoxLayout;
+    layout->setContentsMargins(2, 2, 2, 2);
+    layout->addWidget(m_tree);
+    layout->addLayout(buttons);
+
+    QWidget *widget = new QWidget;
+    widget->setLayout(layout);
+    setWidget(widget);
+
+    connect(m_sessions, SIGNAL(launchesChanged()), this, SLOT(refresh()));
+}
+
+/*!*********************************************************************************************************************
+ * \brief Updates the table with the current launches. Existing rows are reused, so the scroll position is kept.
+ **********************************************************************************************************************/
+void LaunchPanel::refresh()
+{
+    if(!isVisible()) {
+        return;
+    }
+
+    QList<QStringList> rows = getRows();
+
+    while(m_tree->topLevelItemCount() > rows.count()) {
+        delete m_tree->takeTopLevelItem(m_tree->topLevelItemCount() - 1);
+    }
+
+    for(int i = 0; i < rows.count(); ++i) {
+        QTreeWidgetItem *item = m_tree->topLevelItem(i);
+        if(!item) {
+            item = new QTreeWidgetItem;
+            m_tree->addTopLevelItem(item);
+        }
+
+        for(int j = 0; j < rows[i].count(); ++j) {
+            item->setText(j, rows[i][j]);
+        }
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Copies header and launches to the clipboard as tab separated lines.
+ **********************************************************************************************************************/
+void LaunchPanel::copyToClipboard()
+{
+    QStringList header;
+    for(int i = 0; i < m_tree->columnCount(); ++i) {
+        header<<m_tree->headerItem()->text(i);
+    }
+
+    QStringList lines;
+    lines<<header.join("\t");
+
+    foreach(const QStringList &row, getRows()) {
+        lines<<row.join("\t");
+    }
+
+    QApplication::clipboard()->setText(lines.join("\n") + "\n");
+}
+
+/*!*********************************************************************************************************************
+ * \brief Refreshes the table when the panel is shown, launches are recorded while it is hidden.
+ * \param event         Show event.
+ **********************************************************************************************************************/
+void LaunchPanel::showEvent(QShowEvent *event)
+{
+    QDockWidget::showEvent(event);
+
+    refresh();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns one row per launch, the latest first. There is no exit status column, tools are started detached and
+ * are not children of LibMan.
+ **********************************************************************************************************************/
+QList<QStringList> LaunchPanel::getRows() const
+{
+    QList<QStringList> rows;
+
+    foreach(const ToolSessions::Launch &launch, m_sessions->getLaunches()) {
+        QStringList row;
+        row<<launch.time.toString("hh:mm:ss")
+           <<launch.tool
+           <<launch.mode
+           <<QString::number(launch.files)
+           <<formatDuration(launch.resolveNsecs)
+           <<formatDuration(launch.spawnNsecs)
+           <<formatDuration(launch.readyNsecs)
+           <<(launch.pid > 0 ? QString::number(launch.pid) : QString("-"))
+           <<launch.state
+           <<(launch.peakRss >= 0 ? QString("%1 MB").arg(launch.peakRss / 1024.0, 0, 'f', 1) : QString("-"));
+
+        rows.prepend(row);
+    }
+
+    return rows;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns duration in a readable unit, '-' if it is unknown.
+ * \param nsecs         Duration in nanoseconds, negative if unknown.
+ **********************************************************************************************************************/
+QString LaunchPanel::formatDuration(qint64 nsecs)
+{
+    if(nsecs < 0) {
+        return "-";
+    }
+
+    if(nsecs < 1000000) {
+        return QString("%1 us").arg(nsecs / 1000);
+    }
+
+    if(nsecs < 1000000000) {
+        return QString("%1 ms").arg(nsecs / 1000000.0, 0, 'f', 1);
+    }
+
+    return QString("%1 s").arg(nsecs / 1000000000.0, 0, 'f', 2);
+}
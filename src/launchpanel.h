@@ -0,0 +1,38 @@
+#ifndef LAUNCHPANEL_H
+#define LAUNCHPANEL_H
+
+#include <QDockWidget>
+
+class QTreeWidget;
+class ToolSessions;
+
+/*!*********************************************************************************************************************
+ * \brief The LaunchPanel class shows the history of tool launches in a dockable panel: resolve, spawn and ready
+ * times, process id, state and peak memory. It is refreshed whenever a launch changes while the panel is visible; the
+ * history can be copied to the clipboard as tab separated text.
+ **********************************************************************************************************************/
+class LaunchPanel : public QDockWidget
+{
+    Q_OBJECT
+
+public:
+    explicit LaunchPanel(ToolSessions *sessions, QWidget *parent = 0);
+
+public slots:
+    void                                refresh();
+    void                                copyToClipboard();
+
+protected:
+    void                                showEvent(QShowEvent *event);
+
+private:
+    QList<QStringList>                  getRows() const;
+
+    static QString                      formatDuration(qint64 nsecs);
+
+private:
+    ToolSessions                        *m_sessions;        /*!< Tool sessions recording the launches. */
+    QTreeWidget                         *m_tree;            /*!< Table of launches, the latest first. */
+};
+
+#endif // LAUNCHPANEL_H
@@ -0,0 +1,270 @@
+#include <QSet>
+#include <QThread>
+#include <QVector>
+#include <QRunnable>
+#include <QThreadPool>
+
+#include "catalog.h"
+#include "lefindex.h"
+#include "netlistindex.h"
+#include "perfcounters.h"
+#include "trace.h"
+
+/*!*********************************************************************************************************************
+ * \brief The LefResult struct keeps the scan result of a single LEF view.
+ **********************************************************************************************************************/
+struct LefResult {
+    QList<LefScanner::Macro>            macros;             /*!< Macros of the view. */
+    QStringList                         errors;             /*!< Errors found while scanning. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Returns the pin name in upper case with bus brackets '<>' replaced by '[]', so LEF pins and netlist ports of
+ * both styles compare equal.
+ * \param name          Name of a pin or port.
+ **********************************************************************************************************************/
+static QString getPinKey(const QString &name)
+{
+    QString key = name.toUpper();
+    key.replace('<', '[');
+    key.replace('>', ']');
+
+    return key;
+}
+
+/*!*********************************************************************************************************************
+ * \brief The LefJob class scans a single view into its slot of the results, so jobs do not share any data.
+ **********************************************************************************************************************/
+class LefJob : public QRunnable
+{
+public:
+    LefJob(const QString &viewPath, LefResult *result)
+        : m_viewPath(viewPath), m_result(result) {}
+
+    void run();
+
+private:
+    QString                             m_viewPath;         /*!< Path to the view file. */
+    LefResult                           *m_result;          /*!< Result slot, owned by LefIndex::update(). */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Scans the view for macros.
+ **********************************************************************************************************************/
+void LefJob::run()
+{
+    PerfTimer perfTimer(PerfCounters::JOB_DURATION);
+
+    LefScanner scanner;
+    bool isScanned = scanner.scan(m_viewPath);
+
+    m_result->macros = scanner.getMacros();
+    m_result->errors = scanner.getErrors();
+
+    PerfCounters::add(isScanned ? PerfCounters::JOBS_DONE : PerfCounters::JOBS_FAILED);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Constructs an empty index.
+ **********************************************************************************************************************/
+LefIndex::LefIndex()
+{
+}
+
+/*!*********************************************************************************************************************
+ * \brief Collects the cells of the libraries and their LEF views. Every library is looked up once, the result is used
+ * to find the LEF views as well as the views of the macros.
+ * \param catalog       Catalog used to scan the libraries.
+ * \param libraries     Map of library names to library paths.
+ * \param cellName      Name of the only cell whose LEF view is scanned, all cells if empty.
+ **********************************************************************************************************************/
+void LefIndex::scanLibraries(const Catalog &catalog, const QMap<QString, QString> &libraries, const QString &cellName)
+{
+    TRACE_SCOPE("lef", "scan_libraries");
+
+    m_libraries.clear();
+    m_lefViews.clear();
+    m_entries.clear();
+
+    QMap<QString, QString>::const_iterator it;
+    for(it = libraries.constBegin(); it != libraries.constEnd(); ++it) {
+        Library library;
+        library.name = it.key();
+        library.path = it.value();
+        library.cells = catalog.scanLibrary(it.value());
+
+        QMap<QString, QStringList>::const_iterator cit;
+        for(cit = library.cells.constBegin(); cit != library.cells.constEnd(); ++cit) {
+            if(cit.value().contains("lef") && (cellName.isEmpty() || cit.key() == cellName)) {
+                View view;
+                view.library = m_libraries.count();
+                view.cell = cit.key();
+                view.path = Catalog::getViewPath(library.path, cit.key(), "lef");
+
+                m_lefViews<<view;
+            }
+        }
+
+        m_libraries<<library;
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Scans the LEF views in parallel and adds the views of the library cell named like each macro.
+ * \param jobs          Maximal number of views scanned at a time, 0 to use number of CPU cores.
+ * \return              Number of macros.
+ **********************************************************************************************************************/
+int LefIndex::update(int jobs)
+{
+    TRACE_SCOPE("lef", "update_index");
+
+    m_entries.clear();
+    m_errorList.clear();
+
+    QVector<LefResult> results(m_lefViews.count());
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(jobs > 0 ? jobs : qMax(1, QThread::idealThreadCount()));
+
+    for(int i = 0; i < m_lefViews.count(); ++i) {
+        pool.start(new LefJob(m_lefViews[i].path, &results[i]));
+    }
+
+    pool.waitForDone();
+
+    for(int i = 0; i < m_lefViews.count(); ++i) {
+        const Library &library = m_libraries[m_lefViews[i].library];
+
+        foreach(const LefScanner::Macro &macro, results[i].macros) {
+            Entry entry;
+            entry.library = library.name;
+            entry.cell = m_lefViews[i].cell;
+            entry.macro = macro;
+            entry.views = library.cells.value(macro.name);
+
+            m_entries<<entry;
+        }
+
+        m_errorList<<results[i].errors;
+    }
+
+    return m_entries.count();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns netlist views of the cells named like the macros, they have to be indexed before link() is called.
+ * \return              Rows of library, cell, view and view path.
+ **********************************************************************************************************************/
+QList<QStringList> LefIndex::getNetlistViews() const
+{
+    QMap<QString, QString> libPaths;
+    foreach(const Library &library, m_libraries) {
+        libPaths[library.name] = library.path;
+    }
+
+    QList<QStringList> views;
+    QSet<QString> viewPaths;
+
+    foreach(const Entry &entry, m_entries) {
+        foreach(const QString &viewName, entry.views) {
+            if(!NetlistParser::isNetlistView(viewName)) {
+                continue;
+            }
+
+            QString viewPath = Catalog::getViewPath(libPaths.value(entry.library), entry.macro.name, viewName);
+            if(!viewPaths.contains(viewPath)) {
+                viewPaths.insert(viewPath);
+                views<<(QStringList()<<entry.library<<entry.macro.name<<viewName<<viewPath);
+            }
+        }
+    }
+
+    return views;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Links every macro to the subcircuits of the same name in the netlist views of its cell and compares the LEF
+ * pins with the subcircuit ports, case insensitive.
+ * \param index         Index holding the views returned by getNetlistViews().
+ **********************************************************************************************************************/
+void LefIndex::link(const NetlistIndex &index)
+{
+    TRACE_SCOPE("lef", "link_netlists");
+
+    QMap<QString, QString> libPaths;
+    foreach(const Library &library, m_libraries) {
+        libPaths[library.name] = library.path;
+    }
+
+    for(int i = 0; i < m_entries.count(); ++i) {
+        Entry &entry = m_entries[i];
+        entry.netlists.clear();
+        entry.unmatchedPins.clear();
+
+        QSet<QString> pins;
+        foreach(const LefScanner::Pin &pin, entry.macro.pins) {
+            pins.insert(getPinKey(pin.name));
+        }
+
+        foreach(const QString &viewName, entry.views) {
+            if(!NetlistParser::isNetlistView(viewName)) {
+                continue;
+            }
+
+            NetlistIndex::View view = index.getView(Catalog::getViewPath(libPaths.value(entry.library),
+                                                                         entry.macro.name, viewName));
+
+            foreach(const NetlistParser::Subckt &subckt, view.subckts) {
+                if(subckt.name.compare(entry.macro.name, Qt::CaseInsensitive) != 0) {
+                    continue;
+                }
+
+                entry.netlists<<viewName;
+
+                QSet<QString> ports;
+                foreach(const QString &port, subckt.ports) {
+                    ports.insert(getPinKey(port));
+
+                    if(!pins.contains(getPinKey(port))) {
+                        entry.unmatchedPins<<QString("%1(%2)").arg(port).arg(viewName);
+                    }
+                }
+
+                foreach(const LefScanner::Pin &pin, entry.macro.pins) {
+                    if(!ports.contains(getPinKey(pin.name))) {
+                        entry.unmatchedPins<<QString("%1(lef)").arg(pin.name);
+                    }
+                }
+
+                break;
+            }
+        }
+
+        entry.unmatchedPins.removeDuplicates();
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns names of the report columns.
+ **********************************************************************************************************************/
+QStringList LefIndex::getColumns()
+{
+    return QStringList()<<"library"<<"cell"<<"macro"<<"class"<<"size"<<"pins"<<"obs"<<"views"<<"netlists"
+                        <<"unmatched_pins";
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns the macro as a row of the report.
+ * \param entry         Macro with the views of its cell.
+ **********************************************************************************************************************/
+QStringList LefIndex::toRow(const Entry &entry)
+{
+    QString size;
+    if(!entry.macro.width.isEmpty()) {
+        size = entry.macro.width + "x" + entry.macro.height;
+    }
+
+    return QStringList()<<entry.library<<entry.cell<<entry.macro.name<<entry.macro.className<<size
+                        <<LefScanner::formatPins(entry.macro.pins)<<entry.macro.obsLayers.join(" ")
+                        <<entry.views.join(" ")<<entry.netlists.join(" ")<<entry.unmatchedPins.join(" ");
+}
@@ -0,0 +1,98 @@
+#ifndef LEFINDEX_H
+#define LEFINDEX_H
+
+#include <QMap>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "lefscanner.h"
+
+class Catalog;
+class NetlistIndex;
+
+/*!*********************************************************************************************************************
+ * \brief The LefIndex class collects the macros of 'lef' views and links every macro to the library cell of the same
+ * name: its views are taken from the single catalog lookup which also finds the LEF views, its netlist subcircuit and
+ * ports from the NetlistIndex. LEF views are scanned by a pool of jobs, one view per job.
+ **********************************************************************************************************************/
+class LefIndex
+{
+public:
+    /*!
+     * \brief The Entry struct keeps a macro with the views of its cell.
+     */
+    struct Entry {
+        QString                         library;            /*!< Name of the library. */
+        QString                         cell;               /*!< Name of the cell holding the LEF view. */
+        LefScanner::Macro               macro;              /*!< Scanned macro. */
+        QStringList                     views;              /*!< Views of the library cell named like the macro. */
+        QStringList                     netlists;           /*!< Netlist views defining a subcircuit of the macro. */
+        QStringList                     unmatchedPins;      /*!< Pins missing in the LEF or a netlist, 'pin(view)'. */
+    };
+
+    LefIndex();
+
+    void                                scanLibraries(const Catalog &catalog, const QMap<QString, QString> &libraries,
+                                                      const QString &cellName = QString());
+    int                                 update(int jobs = 0);
+    QList<QStringList>                  getNetlistViews() const;
+    void                                link(const NetlistIndex &index);
+
+    QList<Entry>                        getEntries() const;
+    int                                 getViewCount() const;
+    QStringList                         getErrors() const;
+
+    static QStringList                  getColumns();
+    static QStringList                  toRow(const Entry &entry);
+
+private:
+    /*!
+     * \brief The Library struct keeps the cells of a library found by the catalog lookup.
+     */
+    struct Library {
+        QString                         name;               /*!< Name of the library. */
+        QString                         path;               /*!< Path to the library. */
+        QMap<QString, QStringList>      cells;              /*!< Map of cell names to their views. */
+    };
+
+    /*!
+     * \brief The View struct keeps a LEF view to scan.
+     */
+    struct View {
+        int                             library;            /*!< Position of the library in m_libraries. */
+        QString                         cell;               /*!< Name of the cell. */
+        QString                         path;               /*!< Path to the view file. */
+    };
+
+    QList<Library>                      m_libraries;        /*!< Libraries in name order. */
+    QList<View>                         m_lefViews;         /*!< LEF views in library and cell order. */
+    QList<Entry>                        m_entries;          /*!< Macros in library, cell and definition order. */
+    QStringList                         m_errorList;        /*!< Errors of scanning the LEF views. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Returns macros in library, cell and definition order.
+ **********************************************************************************************************************/
+inline QList<LefIndex::Entry> LefIndex::getEntries() const
+{
+    return m_entries;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns number of LEF views found by scanLibraries().
+ **********************************************************************************************************************/
+inline int LefIndex::getViewCount() const
+{
+    return m_lefViews.count();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns errors of the last update() call.
+ **********************************************************************************************************************/
+inline QStringList LefIndex::getErrors() const
+{
+    return m_errorList;
+}
+
+#endif // LEFINDEX_H
@@ -0,0 +1,482 @@
+#include <cstring>
+
+#include <QFile>
+#include <QByteArray>
+
+#include "lefscanner.h"
+#include "perfcounters.h"
+#include "trace.h"
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if the character separates tokens.
+ * \param c             Character to check.
+ **********************************************************************************************************************/
+static inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns position after the closing quote of a string or the end. Quotes escaped by an odd number of
+ * backslashes are skipped, so a string ending with an escaped backslash is closed.
+ * \param position      First character inside the string.
+ * \param end           End of the text.
+ **********************************************************************************************************************/
+static const char* skipString(const char *position, const char *end)
+{
+    const char *start = position;
+
+    while(position < end) {
+        const char *found = static_cast<const char*>(std::memchr(position, '"', end - position));
+        if(!found) {
+            return end;
+        }
+
+        // A quote is escaped by an odd number of backslashes.
+        const char *backslash = found;
+        while(backslash > start && backslash[-1] == '\\') {
+            --backslash;
+        }
+
+        if((found - backslash) % 2 == 0) {
+            return found + 1;
+        }
+
+        position = found + 1;
+    }
+
+    return end;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns position after the end of the line or the end.
+ * \param position      Position to search from.
+ * \param end           End of the text.
+ **********************************************************************************************************************/
+static const char* skipLine(const char *position, const char *end)
+{
+    const char *found = static_cast<const char*>(std::memchr(position, '\n', end - position));
+
+    return found ? found + 1 : end;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Constructs an empty scanner.
+ **********************************************************************************************************************/
+LefScanner::LefScanner()
+    : m_data(0),
+      m_position(0),
+      m_end(0),
+      m_hasPushedBack(false)
+{
+}
+
+/*!*********************************************************************************************************************
+ * \brief Scans the LEF file. The file is mapped into memory, or read if it can not be mapped.
+ * \param fileName      Path to the LEF file.
+ * \return              True if no errors were found, otherwise false and the reasons are in the error list.
+ **********************************************************************************************************************/
+bool LefScanner::scan(const QString &fileName)
+{
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly)) {
+        m_macros.clear();
+        m_layers.clear();
+        m_errorList.clear();
+        m_errorList<<QString("Can not read file '%1':\n%2.").arg(fileName).arg(file.errorString());
+        return false;
+    }
+
+    qint64 size = file.size();
+
+    PerfCounters::add(PerfCounters::FILES_READ);
+    PerfCounters::add(PerfCounters::BYTES_READ, size);
+
+    uchar *data = size > 0 ? file.map(0, size) : 0;
+    if(data) {
+        bool isScanned = scan(reinterpret_cast<const char*>(data), size, fileName);
+        file.unmap(data);
+
+        return isScanned;
+    }
+
+    QByteArray content = file.readAll();
+
+    return scan(content.constData(), content.size(), fileName);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Scans LEF text for macros and layers. Scanning stops at the first unclosed section.
+ * \param data          Text to scan, it does not need to be terminated.
+ * \param size          Size of the text in bytes.
+ * \param fileName      Name of the file used in error messages.
+ * \return              True if no errors were found, otherwise false and the reasons are in the error list.
+ **********************************************************************************************************************/
+bool LefScanner::scan(const char *data, qint64 size, const QString &fileName)
+{
+    TRACE_SCOPE_ARG("lef", "scan_lef", fileName);
+
+    m_data = data;
+    m_position = data;
+    m_end = data + size;
+    m_hasPushedBack = false;
+
+    m_fileName = fileName;
+    m_macros.clear();
+    m_layers.clear();
+    m_errorList.clear();
+
+    for(;;) {
+        Token token = next();
+        if(!token.length) {
+            break;
+        }
+
+        bool isScanned = true;
+
+        if(isKeyword(token, "MACRO")) {
+            isScanned = scanMacro(next());
+        }
+        else if(isKeyword(token, "LAYER")) {
+            Token name = next();
+            m_layers<<getText(name);
+            isScanned = skipBlock(name);
+        }
+        else if(isKeyword(token, "VIA") || isKeyword(token, "VIARULE") || isKeyword(token, "SITE") ||
+                isKeyword(token, "NONDEFAULTRULE") || isKeyword(token, "ARRAY")) {
+            isScanned = skipBlock(next());
+        }
+        else if(isKeyword(token, "PROPERTYDEFINITIONS") || isKeyword(token, "UNITS") ||
+                isKeyword(token, "SPACING")) {
+            isScanned = skipBlock(token);
+        }
+        else if(isKeyword(token, "BEGINEXT")) {
+            do {
+                token = next();
+            } while(token.length && !isKeyword(token, "ENDEXT"));
+        }
+        else if(isKeyword(token, "END")) {
+            if(isKeyword(next(), "LIBRARY")) {
+                break;
+            }
+        }
+
+        if(!isScanned) {
+            break;
+        }
+    }
+
+    m_data = 0;
+    m_position = 0;
+    m_end = 0;
+
+    return m_errorList.isEmpty();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns pins as space separated 'name:direction' pairs.
+ * \param pins          Pins to format.
+ **********************************************************************************************************************/
+QString LefScanner::formatPins(const QList<Pin> &pins)
+{
+    QStringList items;
+    foreach(const Pin &pin, pins) {
+        items<<(pin.direction.isEmpty() ? pin.name : pin.name + ":" + pin.direction.toLower().replace(' ', '_'));
+    }
+
+    return items.join(" ");
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns the next token. Comments are skipped, ';' is a token of its own and strings are single tokens.
+ **********************************************************************************************************************/
+LefScanner::Token LefScanner::next()
+{
+    if(m_hasPushedBack) {
+        m_hasPushedBack = false;
+        return m_pushedBack;
+    }
+
+    while(m_position < m_end) {
+        if(isSpace(*m_position)) {
+            ++m_position;
+        }
+        else if(*m_position == '#') {
+            m_position = skipLine(m_position + 1, m_end);
+        }
+        else {
+            break;
+        }
+    }
+
+    Token token;
+    token.start = m_position;
+
+    if(m_position >= m_end) {
+        token.length = 0;
+        return token;
+    }
+
+    if(*m_position == ';') {
+        ++m_position;
+    }
+    else if(*m_position == '"') {
+        m_position = skipString(m_position + 1, m_end);
+    }
+    else {
+        while(m_position < m_end && !isSpace(*m_position) && *m_position != ';') {
+            ++m_position;
+        }
+    }
+
+    token.length = m_position - token.start;
+
+    return token;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns the token by the next call of next().
+ * \param token         Token to return again.
+ **********************************************************************************************************************/
+void LefScanner::pushBack(const Token &token)
+{
+    m_pushedBack = token;
+    m_hasPushedBack = true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Reads the tokens up to the next ';', which ends the current statement.
+ * \return              Tokens without ';' joined by spaces.
+ **********************************************************************************************************************/
+QString LefScanner::readStatement()
+{
+    QStringList tokens;
+
+    for(;;) {
+        Token token = next();
+        if(!token.length || (token.length == 1 && *token.start == ';')) {
+            break;
+        }
+
+        tokens<<getText(token);
+    }
+
+    return tokens.join(" ");
+}
+
+/*!*********************************************************************************************************************
+ * \brief Skips a section up to 'END <name>'.
+ * \param name          Name of the section.
+ **********************************************************************************************************************/
+bool LefScanner::skipBlock(const Token &name)
+{
+    for(;;) {
+        Token token = next();
+        if(!token.length) {
+            addError(QString("Missing 'END %1'").arg(getText(name)), name.start);
+            return false;
+        }
+
+        if(isKeyword(token, "END")) {
+            token = next();
+            if(isEqual(token, name)) {
+                return true;
+            }
+
+            pushBack(token);
+        }
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Scans a MACRO section up to 'END <name>' for its class, size, pins and obstructions.
+ * \param name          Name of the macro.
+ **********************************************************************************************************************/
+bool LefScanner::scanMacro(const Token &name)
+{
+    Macro macro;
+    macro.name = getText(name);
+
+    for(;;) {
+        Token token = next();
+        if(!token.length) {
+            addError(QString("Missing 'END %1'").arg(macro.name), name.start);
+            return false;
+        }
+
+        if(isKeyword(token, "END")) {
+            token = next();
+            if(isEqual(token, name)) {
+                m_macros<<macro;
+                return true;
+            }
+
+            // 'END' of a DENSITY section.
+            pushBack(token);
+        }
+        else if(isKeyword(token, "CLASS")) {
+            macro.className = readStatement();
+        }
+        else if(isKeyword(token, "SIZE")) {
+            QStringList size = readStatement().split(' ');
+            if(size.count() == 3 && size[1].toUpper() == "BY") {
+                macro.width = size[0];
+                macro.height = size[2];
+            }
+        }
+        else if(isKeyword(token, "PIN")) {
+            if(!scanPin(&macro, next())) {
+                return false;
+            }
+        }
+        else if(isKeyword(token, "OBS")) {
+            if(!scanObs(&macro)) {
+                return false;
+            }
+        }
+        else {
+            readStatement();
+        }
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Scans a PIN section up to 'END <name>' for its direction and use, PORT geometries are skipped.
+ * \param macro         Macro to add the pin to.
+ * \param name          Name of the pin.
+ **********************************************************************************************************************/
+bool LefScanner::scanPin(Macro *macro, const Token &name)
+{
+    Pin pin;
+    pin.name = getText(name);
+
+    for(;;) {
+        Token token = next();
+        if(!token.length) {
+            addError(QString("Missing 'END %1'").arg(pin.name), name.start);
+            return false;
+        }
+
+        if(isKeyword(token, "END")) {
+            token = next();
+            if(isEqual(token, name)) {
+                macro->pins<<pin;
+                return true;
+            }
+
+            pushBack(token);
+        }
+        else if(isKeyword(token, "DIRECTION")) {
+            pin.direction = readStatement();
+        }
+        else if(isKeyword(token, "USE")) {
+            pin.use = readStatement();
+        }
+        else if(isKeyword(token, "PORT")) {
+            Token port = token;
+
+            for(;;) {
+                token = next();
+                if(!token.length) {
+                    addError("Missing 'END' of PORT", port.start);
+                    return false;
+                }
+
+                if(isKeyword(token, "END")) {
+                    break;
+                }
+
+                readStatement();
+            }
+        }
+        else {
+            readStatement();
+        }
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Scans an OBS section up to 'END' for its layers.
+ * \param macro         Macro to add the layers to.
+ **********************************************************************************************************************/
+bool LefScanner::scanObs(Macro *macro)
+{
+    const char *start = m_position;
+
+    for(;;) {
+        Token token = next();
+        if(!token.length) {
+            addError("Missing 'END' of OBS", start);
+            return false;
+        }
+
+        if(isKeyword(token, "END")) {
+            return true;
+        }
+
+        if(isKeyword(token, "LAYER")) {
+            QString layer = getText(next());
+            if(!macro->obsLayers.contains(layer)) {
+                macro->obsLayers<<layer;
+            }
+        }
+
+        readStatement();
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Adds an error with the line of the position. Lines are counted only here, the scan itself does not need them.
+ * \param msg           Description of the error without full stop.
+ * \param position      Position of the error in the scanned text.
+ **********************************************************************************************************************/
+void LefScanner::addError(const QString &msg, const char *position)
+{
+    int line = 1;
+
+    const char *current = m_data;
+    while(current < position) {
+        current = static_cast<const char*>(std::memchr(current, '\n', position - current));
+        if(!current) {
+            break;
+        }
+
+        ++line;
+        ++current;
+    }
+
+    m_errorList<<QString("%1 at line %2 of '%3'.").arg(msg).arg(line).arg(m_fileName);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if the token is the keyword, case insensitive as in LEF before version 5.6.
+ * \param token         Token to check.
+ * \param keyword       Upper case keyword.
+ **********************************************************************************************************************/
+bool LefScanner::isKeyword(const Token &token, const char *keyword)
+{
+    return token.length && qstrnicmp(token.start, keyword, token.length) == 0 && keyword[token.length] == '\0';
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if the tokens have the same text.
+ * \param first         First token.
+ * \param second        Second token.
+ **********************************************************************************************************************/
+bool LefScanner::isEqual(const Token &first, const Token &second)
+{
+    return first.length == second.length && std::memcmp(first.start, second.start, first.length) == 0;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns text of the token without quotes.
+ * \param token         Token to convert.
+ **********************************************************************************************************************/
+QString LefScanner::getText(const Token &token)
+{
+    if(token.length >= 2 && token.start[0] == '"' && token.start[token.length - 1] == '"') {
+        return QString::fromLatin1(token.start + 1, token.length - 2);
+    }
+
+    return QString::fromLatin1(token.start, token.length);
+}
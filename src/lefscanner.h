@@ -0,0 +1,109 @@
+#ifndef LEFSCANNER_H
+#define LEFSCANNER_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+/*!*********************************************************************************************************************
+ * \brief The LefScanner class reads MACRO names, classes, sizes, pins and OBS layers of LEF files in a single pass. Tech
+ * sections of combined tech and cell LEFs (LAYER, VIA, VIARULE, SITE, NONDEFAULTRULE, PROPERTYDEFINITIONS) are
+ * skipped token by token, only layer names are kept. The file is memory mapped.
+ **********************************************************************************************************************/
+class LefScanner
+{
+public:
+    /*!
+     * \brief The Pin struct keeps a PIN of a macro.
+     */
+    struct Pin {
+        QString                         name;               /*!< Name of the pin. */
+        QString                         direction;          /*!< Value of DIRECTION, e.g. 'INPUT' or 'OUTPUT TRISTATE'. */
+        QString                         use;                /*!< Value of USE, e.g. 'SIGNAL' or 'POWER'. */
+    };
+
+    /*!
+     * \brief The Macro struct keeps a MACRO of the file.
+     */
+    struct Macro {
+        QString                         name;               /*!< Name of the macro. */
+        QString                         className;          /*!< Value of CLASS, e.g. 'CORE' or 'BLOCK'. */
+        QString                         width;              /*!< Width of SIZE as written in the file. */
+        QString                         height;             /*!< Height of SIZE as written in the file. */
+        QList<Pin>                      pins;               /*!< Pins in the order of their definition. */
+        QStringList                     obsLayers;          /*!< Layers of OBS, each once. */
+    };
+
+    LefScanner();
+
+    bool                                scan(const QString &fileName);
+    bool                                scan(const char *data, qint64 size, const QString &fileName);
+
+    QList<Macro>                        getMacros() const;
+    QStringList                         getLayers() const;
+    QStringList                         getErrors() const;
+
+    static QString                      formatPins(const QList<Pin> &pins);
+
+private:
+    /*!
+     * \brief The Token struct points into the scanned text, a token of length 0 is the end of the file.
+     */
+    struct Token {
+        const char                      *start;             /*!< First character. */
+        int                             length;             /*!< Number of characters. */
+    };
+
+    Token                               next();
+    void                                pushBack(const Token &token);
+    QString                             readStatement();
+    bool                                skipBlock(const Token &name);
+
+    bool                                scanMacro(const Token &name);
+    bool                                scanPin(Macro *macro, const Token &name);
+    bool                                scanObs(Macro *macro);
+
+    void                                addError(const QString &msg, const char *position);
+
+    static bool                         isKeyword(const Token &token, const char *keyword);
+    static bool                         isEqual(const Token &first, const Token &second);
+    static QString                      getText(const Token &token);
+
+private:
+    const char                          *m_data;            /*!< Start of the scanned text. */
+    const char                          *m_position;        /*!< Next character to scan. */
+    const char                          *m_end;             /*!< End of the scanned text. */
+    Token                               m_pushedBack;       /*!< Token returned again by next(). */
+    bool                                m_hasPushedBack;    /*!< State if m_pushedBack is valid. */
+
+    QString                             m_fileName;         /*!< Path of the scanned file, used in error messages. */
+    QList<Macro>                        m_macros;           /*!< Macros in the order of their definition. */
+    QStringList                         m_layers;           /*!< Names of LAYER definitions of the tech section. */
+    QStringList                         m_errorList;        /*!< Errors found in the file. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Returns macros in the order of their definition.
+ **********************************************************************************************************************/
+inline QList<LefScanner::Macro> LefScanner::getMacros() const
+{
+    return m_macros;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns names of the layers defined by the tech section, empty for cell LEFs.
+ **********************************************************************************************************************/
+inline QStringList LefScanner::getLayers() const
+{
+    return m_layers;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns errors found by the last scan() call.
+ **********************************************************************************************************************/
+inline QStringList LefScanner::getErrors() const
+{
+    return m_errorList;
+}
+
+#endif // LEFSCANNER_H
@@ -0,0 +1,873 @@
+#include <cstring>
+
+#include <QDir>
+#include <QFile>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QDataStream>
+#include <QCoreApplication>
+#include <QCryptographicHash>
+
+#include "catalog.h"
+#include "libertyindex.h"
+#include "perfcounters.h"
+#include "trace.h"
+
+/*!*********************************************************************************************************************
+ * \brief Magic number and version of the index files. The version is increased whenever the stored data changes, older
+ * files are then dropped and the Liberty files scanned again.
+ **********************************************************************************************************************/
+static const quint32 LIBERTY_INDEX_MAGIC = 0x4c4d4c49;
+static const quint32 LIBERTY_INDEX_VERSION = 2;
+
+/*!*********************************************************************************************************************
+ * \brief Writes pin into the index file.
+ **********************************************************************************************************************/
+QDataStream& operator<<(QDataStream &out, const LibertyIndex::Pin &pin)
+{
+    return out<<pin.name<<pin.group<<pin.direction;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Reads pin from the index file.
+ **********************************************************************************************************************/
+QDataStream& operator>>(QDataStream &in, LibertyIndex::Pin &pin)
+{
+    return in>>pin.name>>pin.group>>pin.direction;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Writes cell into the index file.
+ **********************************************************************************************************************/
+QDataStream& operator<<(QDataStream &out, const LibertyIndex::Cell &cell)
+{
+    return out<<cell.name<<cell.area<<cell.offset<<cell.length<<cell.pins;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Reads cell from the index file.
+ **********************************************************************************************************************/
+QDataStream& operator>>(QDataStream &in, LibertyIndex::Cell &cell)
+{
+    return in>>cell.name>>cell.area>>cell.offset>>cell.length>>cell.pins;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if the character separates tokens.
+ * \param c             Character to check.
+ **********************************************************************************************************************/
+static inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if the character ends the name of an attribute or group.
+ * \param c             Character to check.
+ **********************************************************************************************************************/
+static inline bool isNameEnd(char c)
+{
+    return isSpace(c) || c == ':' || c == '(' || c == ')' || c == '{' || c == '}' || c == ';' || c == '"';
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns position after the closing quote of a string or the end. Quotes escaped by an odd number of
+ * backslashes are skipped, so a string ending with an escaped backslash is closed.
+ * \param position      First character inside the string.
+ * \param end           End of the text.
+ **********************************************************************************************************************/
+static const char* skipString(const char *position, const char *end)
+{
+    const char *start = position;
+
+    while(position < end) {
+        const char *found = static_cast<const char*>(std::memchr(position, '"', end - position));
+        if(!found) {
+            return end;
+        }
+
+        // A quote is escaped by an odd number of backslashes.
+        const char *backslash = found;
+        while(backslash > start && backslash[-1] == '\\') {
+            --backslash;
+        }
+
+        if((found - backslash) % 2 == 0) {
+            return found + 1;
+        }
+
+        position = found + 1;
+    }
+
+    return end;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns position after the end of a '/ *' comment or the end.
+ * \param position      First character inside the comment.
+ * \param end           End of the text.
+ **********************************************************************************************************************/
+static const char* skipComment(const char *position, const char *end)
+{
+    while(position < end) {
+        const char *found = static_cast<const char*>(std::memchr(position, '*', end - position));
+        if(!found || found + 1 >= end) {
+            return end;
+        }
+
+        if(found[1] == '/') {
+            return found + 2;
+        }
+
+        position = found + 1;
+    }
+
+    return end;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns position after the end of the line or the end.
+ * \param position      Position to search from.
+ * \param end           End of the text.
+ **********************************************************************************************************************/
+static const char* skipLine(const char *position, const char *end)
+{
+    const char *found = static_cast<const char*>(std::memchr(position, '\n', end - position));
+
+    return found ? found + 1 : end;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns the text without surrounding white space and quotes.
+ * \param start         First character of the text.
+ * \param length        Number of characters.
+ **********************************************************************************************************************/
+static QString toText(const char *start, int length)
+{
+    QString text = QString::fromLatin1(start, length).trimmed();
+    if(text.length() >= 2 && text.startsWith('"') && text.endsWith('"')) {
+        text = text.mid(1, text.length() - 2).trimmed();
+    }
+
+    return text;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Constructs an empty index.
+ **********************************************************************************************************************/
+LibertyIndex::LibertyIndex()
+    : m_data(0),
+      m_position(0),
+      m_end(0),
+      m_size(0),
+      m_modified(0)
+{
+}
+
+/*!*********************************************************************************************************************
+ * \brief Brings the index of the Liberty file up to date. The index is loaded from the cache folder if the file has
+ * not changed since it was scanned, otherwise the file is scanned and the index saved.
+ * \param fileName      Path to the Liberty file.
+ * \return              True if the index is valid, otherwise false and the reasons are in the error list.
+ **********************************************************************************************************************/
+bool LibertyIndex::update(const QString &fileName)
+{
+    TRACE_SCOPE_ARG("liberty", "update_index", fileName);
+
+    QFileInfo fileInfo(fileName);
+    PerfCounters::add(PerfCounters::STAT_CALLS);
+
+    QString indexFile = getIndexFile(fileName);
+    if(load(indexFile) && !m_fileName.isEmpty() && m_size == fileInfo.size() &&
+       m_modified == fileInfo.lastModified().toMSecsSinceEpoch()) {
+        PerfCounters::add(PerfCounters::CACHE_HITS);
+
+        m_fileName = fileName;
+        return true;
+    }
+
+    PerfCounters::add(PerfCounters::CACHE_MISSES);
+
+    if(!scan(fileName)) {
+        return false;
+    }
+
+    // The index is still valid if it can not be saved, it is only scanned again next time.
+    save(indexFile);
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Scans the Liberty file. The file is mapped into memory, or read if it can not be mapped.
+ * \param fileName      Path to the Liberty file.
+ * \return              True if no errors were found, otherwise false and the reasons are in the error list.
+ **********************************************************************************************************************/
+bool LibertyIndex::scan(const QString &fileName)
+{
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly)) {
+        m_fileName = fileName;
+        m_libraryName.clear();
+        m_cells.clear();
+        m_cellIds.clear();
+        m_errorList.clear();
+        m_errorList<<QString("Can not read file '%1':\n%2.").arg(fileName).arg(file.errorString());
+        return false;
+    }
+
+    qint64 size = file.size();
+    qint64 modified = QFileInfo(file).lastModified().toMSecsSinceEpoch();
+
+    PerfCounters::add(PerfCounters::FILES_READ);
+    PerfCounters::add(PerfCounters::BYTES_READ, size);
+
+    bool isScanned;
+
+    uchar *data = size > 0 ? file.map(0, size) : 0;
+    if(data) {
+        isScanned = scan(reinterpret_cast<const char*>(data), size, fileName);
+        file.unmap(data);
+    }
+    else {
+        QByteArray content = file.readAll();
+        isScanned = scan(content.constData(), content.size(), fileName);
+    }
+
+    m_modified = modified;
+
+    return isScanned;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Scans Liberty text for 'library' and 'cell' groups. Scanning stops at the first syntax error.
+ * \param data          Text to scan, it does not need to be terminated.
+ * \param size          Size of the text in bytes.
+ * \param fileName      Name of the file used in error messages and by readCell().
+ * \return              True if no errors were found, otherwise false and the reasons are in the error list.
+ **********************************************************************************************************************/
+bool LibertyIndex::scan(const char *data, qint64 size, const QString &fileName)
+{
+    TRACE_SCOPE_ARG("liberty", "scan_liberty", fileName);
+
+    m_data = data;
+    m_position = data;
+    m_end = data + size;
+
+    m_fileName = fileName;
+    m_size = size;
+    m_modified = 0;
+    m_libraryName.clear();
+    m_cells.clear();
+    m_cellIds.clear();
+    m_errorList.clear();
+
+    Statement statement;
+    while(next(&statement) && statement.type != END_OF_FILE) {
+        bool isScanned = true;
+
+        if(statement.type == GROUP_BEGIN) {
+            if(isName(statement, "library")) {
+                m_libraryName = getArguments(statement).value(0);
+                isScanned = scanLibrary(statement);
+            }
+            else if(isName(statement, "cell")) {
+                isScanned = scanCell(statement);
+            }
+            else {
+                isScanned = skipGroup(statement);
+            }
+        }
+        else if(statement.type == GROUP_END) {
+            addError("Unexpected '}'", statement.start);
+            isScanned = false;
+        }
+
+        if(!isScanned) {
+            break;
+        }
+    }
+
+    if(m_errorList.isEmpty() && m_libraryName.isEmpty() && m_cells.isEmpty()) {
+        m_errorList<<QString("No 'library' or 'cell' group found in '%1'.").arg(fileName);
+    }
+
+    m_data = 0;
+    m_position = 0;
+    m_end = 0;
+
+    return m_errorList.isEmpty();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Loads the index of a Liberty file. A missing file or one of another version gives an empty index.
+ * \param indexFile     Path to the index file.
+ * \return              False if the file exists but can not be read.
+ **********************************************************************************************************************/
+bool LibertyIndex::load(const QString &indexFile)
+{
+    m_fileName.clear();
+    m_size = 0;
+    m_modified = 0;
+    m_libraryName.clear();
+    m_cells.clear();
+    m_cellIds.clear();
+    m_errorList.clear();
+
+    QFile file(indexFile);
+    if(!file.exists()) {
+        return true;
+    }
+
+    if(!file.open(QIODevice::ReadOnly)) {
+        m_errorList<<QString("Can not read file '%1':\n%2.").arg(indexFile).arg(file.errorString());
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_4_6);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    in>>magic>>version;
+
+    if(magic != LIBERTY_INDEX_MAGIC || version != LIBERTY_INDEX_VERSION) {
+        return true;
+    }
+
+    in>>m_fileName>>m_size>>m_modified>>m_libraryName>>m_cells;
+
+    if(in.status() != QDataStream::Ok) {
+        m_fileName.clear();
+        m_cells.clear();
+        m_errorList<<QString("Liberty index '%1' is damaged and will be rebuilt.").arg(indexFile);
+        return false;
+    }
+
+    for(int i = 0; i < m_cells.count(); ++i) {
+        m_cellIds.insert(m_cells[i].name, i);
+    }
+
+    PerfCounters::add(PerfCounters::FILES_READ);
+    PerfCounters::add(PerfCounters::BYTES_READ, file.size());
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Saves the index. It is written to a temporary file first, which replaces the index atomically on Unix, so
+ * readers never see a partial index.
+ * \param indexFile     Path to the index file.
+ **********************************************************************************************************************/
+bool LibertyIndex::save(const QString &indexFile)
+{
+    QDir().mkpath(QFileInfo(indexFile).absolutePath());
+
+    QString tempName = indexFile + QString(".%1.tmp").arg(QCoreApplication::applicationPid());
+
+    QFile file(tempName);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        m_errorList<<QString("Can not write to file '%1':\n%2.").arg(tempName).arg(file.errorString());
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_4_6);
+    out<<LIBERTY_INDEX_MAGIC<<LIBERTY_INDEX_VERSION<<m_fileName<<m_size<<m_modified<<m_libraryName<<m_cells;
+
+    qint64 size = file.size();
+    file.close();
+
+    if(out.status() != QDataStream::Ok || file.error() != QFile::NoError) {
+        m_errorList<<QString("Can not write to file '%1':\n%2.").arg(tempName).arg(file.errorString());
+        QFile::remove(tempName);
+        return false;
+    }
+
+    if(!Catalog::replaceFile(tempName, indexFile)) {
+        m_errorList<<QString("Can not replace file '%1'.").arg(indexFile);
+        QFile::remove(tempName);
+        return false;
+    }
+
+    PerfCounters::add(PerfCounters::FILES_WRITTEN);
+    PerfCounters::add(PerfCounters::BYTES_WRITTEN, size);
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns indexed data of the cell or an empty cell if the file does not define it.
+ * \param cellName      Name of the cell.
+ **********************************************************************************************************************/
+LibertyIndex::Cell LibertyIndex::getCell(const QString &cellName) const
+{
+    QHash<QString, int>::const_iterator it = m_cellIds.constFind(cellName);
+    if(it == m_cellIds.constEnd()) {
+        Cell cell;
+        cell.offset = 0;
+        cell.length = 0;
+        return cell;
+    }
+
+    return m_cells.at(it.value());
+}
+
+/*!*********************************************************************************************************************
+ * \brief Reads the 'cell' group of the cell from the indexed file, only its bytes are read. The file must have the size
+ * and modification time it was indexed with, otherwise the offset may point anywhere.
+ * \param cellName      Name of the cell.
+ * \return              Text from the group name to the closing brace, empty on errors.
+ **********************************************************************************************************************/
+QByteArray LibertyIndex::readCell(const QString &cellName)
+{
+    TRACE_SCOPE_ARG("liberty", "read_cell", cellName);
+
+    m_errorList.clear();
+
+    if(!m_cellIds.contains(cellName)) {
+        m_errorList<<QString("Cell '%1' is not defined in '%2'.").arg(cellName).arg(m_fileName);
+        return QByteArray();
+    }
+
+    const Cell &cell = m_cells.at(m_cellIds.value(cellName));
+
+    QFile file(m_fileName);
+    if(!file.open(QIODevice::ReadOnly)) {
+        m_errorList<<QString("Can not read file '%1':\n%2.").arg(m_fileName).arg(file.errorString());
+        return QByteArray();
+    }
+
+    // Text scanned from memory has no modification time, only its size is compared then.
+    PerfCounters::add(PerfCounters::STAT_CALLS);
+    if(file.size() != m_size || (m_modified != 0 &&
+                                 QFileInfo(file).lastModified().toMSecsSinceEpoch() != m_modified)) {
+        m_errorList<<QString("File '%1' has changed since it was indexed.").arg(m_fileName);
+        return QByteArray();
+    }
+
+    QByteArray text;
+    if(file.seek(cell.offset)) {
+        text = file.read(cell.length);
+    }
+
+    if(text.size() != cell.length) {
+        m_errorList<<QString("Can not read file '%1':\n%2.").arg(m_fileName).arg(file.errorString());
+        return QByteArray();
+    }
+
+    PerfCounters::add(PerfCounters::FILES_READ);
+    PerfCounters::add(PerfCounters::BYTES_READ, text.size());
+
+    return text;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns path of the index file of the Liberty file in the cache folder.
+ * \param fileName      Path to the Liberty file.
+ **********************************************************************************************************************/
+QString LibertyIndex::getIndexFile(const QString &fileName)
+{
+    QByteArray key = QCryptographicHash::hash(QFileInfo(fileName).absoluteFilePath().toUtf8(),
+                                              QCryptographicHash::Md5).toHex();
+
+    return QDir::toNativeSeparators(Catalog::getCacheDir() + "/liberty/" + QString::fromLatin1(key) + ".index");
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns pins as space separated 'name:direction' pairs.
+ * \param pins          Pins to format.
+ **********************************************************************************************************************/
+QString LibertyIndex::formatPins(const QList<Pin> &pins)
+{
+    QStringList items;
+    foreach(const Pin &pin, pins) {
+        items<<(pin.direction.isEmpty() ? pin.name : pin.name + ":" + pin.direction);
+    }
+
+    return items.join(" ");
+}
+
+/*!*********************************************************************************************************************
+ * \brief Reads the next statement: a simple attribute 'name : value ;', a complex attribute 'name ( arguments ) ;', the
+ * head of a group 'name ( arguments ) {' or the closing brace of a group.
+ * \param statement     Statement to fill.
+ * \return              False on syntax errors, which are added to the error list.
+ **********************************************************************************************************************/
+bool LibertyIndex::next(Statement *statement)
+{
+    skipSpace();
+
+    while(m_position < m_end && *m_position == ';') {
+        ++m_position;
+        skipSpace();
+    }
+
+    statement->start = m_position;
+    statement->name = m_position;
+    statement->nameLength = 0;
+    statement->value = m_position;
+    statement->valueLength = 0;
+
+    if(m_position >= m_end) {
+        statement->type = END_OF_FILE;
+        return true;
+    }
+
+    if(*m_position == '}') {
+        ++m_position;
+        statement->type = GROUP_END;
+        return true;
+    }
+
+    while(m_position < m_end && !isNameEnd(*m_position)) {
+        ++m_position;
+    }
+
+    statement->nameLength = m_position - statement->name;
+    if(statement->nameLength == 0) {
+        addError("Incorrect statement", statement->start);
+        return false;
+    }
+
+    skipSpace();
+
+    if(m_position < m_end && *m_position == ':') {
+        ++m_position;
+        while(m_position < m_end && (*m_position == ' ' || *m_position == '\t')) {
+            ++m_position;
+        }
+
+        statement->value = m_position;
+
+        while(m_position < m_end) {
+            char c = *m_position;
+            if(c == '"') {
+                m_position = skipString(m_position + 1, m_end);
+            }
+            else if(c == ';' || c == '\n' || c == '}') {
+                break;
+            }
+            else {
+                ++m_position;
+            }
+        }
+
+        statement->valueLength = m_position - statement->value;
+        statement->type = SIMPLE_ATTRIBUTE;
+
+        if(m_position < m_end && *m_position == ';') {
+            ++m_position;
+        }
+
+        return true;
+    }
+
+    if(m_position >= m_end || *m_position != '(') {
+        addError(QString("Incorrect statement '%1'").arg(QString::fromLatin1(statement->name, statement->nameLength)),
+                 statement->start);
+        return false;
+    }
+
+    statement->value = ++m_position;
+
+    while(m_position < m_end && *m_position != ')') {
+        if(*m_position == '"') {
+            m_position = skipString(m_position + 1, m_end);
+        }
+        else {
+            ++m_position;
+        }
+    }
+
+    if(m_position >= m_end) {
+        addError("Unclosed parenthesis", statement->start);
+        return false;
+    }
+
+    statement->valueLength = m_position - statement->value;
+    ++m_position;
+
+    skipSpace();
+
+    if(m_position < m_end && *m_position == '{') {
+        ++m_position;
+        statement->type = GROUP_BEGIN;
+    }
+    else {
+        if(m_position < m_end && *m_position == ';') {
+            ++m_position;
+        }
+
+        statement->type = COMPLEX_ATTRIBUTE;
+    }
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Skips the body of a group by matching braces; strings and comments are skipped by memchr(). Most of the bytes
+ * of a Liberty file are timing and power tables, which are passed here without being tokenized.
+ * \param header        Head of the group, used in error messages.
+ **********************************************************************************************************************/
+bool LibertyIndex::skipGroup(const Statement &header)
+{
+    const char *position = m_position;
+    int depth = 1;
+
+    while(position < m_end) {
+        char c = *position;
+
+        if(c == '"') {
+            position = skipString(position + 1, m_end);
+        }
+        else if(c == '/' && position + 1 < m_end && position[1] == '*') {
+            position = skipComment(position + 2, m_end);
+        }
+        else if(c == '/' && position + 1 < m_end && position[1] == '/') {
+            position = skipLine(position + 2, m_end);
+        }
+        else if(c == '{') {
+            ++depth;
+            ++position;
+        }
+        else if(c == '}') {
+            ++position;
+            if(--depth == 0) {
+                m_position = position;
+                return true;
+            }
+        }
+        else {
+            ++position;
+        }
+    }
+
+    m_position = m_end;
+    addUnclosedError(header);
+
+    return false;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Scans the body of a 'library' group for cells, other groups are skipped.
+ * \param header        Head of the group.
+ **********************************************************************************************************************/
+bool LibertyIndex::scanLibrary(const Statement &header)
+{
+    Statement statement;
+    while(next(&statement)) {
+        if(statement.type == END_OF_FILE) {
+            addUnclosedError(header);
+            return false;
+        }
+
+        if(statement.type == GROUP_END) {
+            return true;
+        }
+
+        if(statement.type == GROUP_BEGIN) {
+            bool isScanned = isName(statement, "cell") ? scanCell(statement) : skipGroup(statement);
+            if(!isScanned) {
+                return false;
+            }
+        }
+    }
+
+    return false;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Scans the body of a 'cell' group for its area and pins and adds the cell to the index.
+ * \param header        Head of the group.
+ **********************************************************************************************************************/
+bool LibertyIndex::scanCell(const Statement &header)
+{
+    Cell cell;
+    cell.name = getArguments(header).value(0);
+    cell.offset = header.start - m_data;
+    cell.length = 0;
+
+    Statement statement;
+    while(next(&statement)) {
+        if(statement.type == END_OF_FILE) {
+            addUnclosedError(header);
+            return false;
+        }
+
+        if(statement.type == GROUP_END) {
+            cell.length = m_position - header.start;
+
+            if(m_cellIds.contains(cell.name)) {
+                addError(QString("Cell '%1' is defined more than once").arg(cell.name), header.start);
+            }
+            else {
+                m_cellIds.insert(cell.name, m_cells.count());
+                m_cells<<cell;
+            }
+
+            return true;
+        }
+
+        if(statement.type == SIMPLE_ATTRIBUTE && isName(statement, "area")) {
+            cell.area = toText(statement.value, statement.valueLength);
+        }
+        else if(statement.type == GROUP_BEGIN) {
+            bool isScanned;
+
+            if(isName(statement, "pin") || isName(statement, "bus") || isName(statement, "bundle") ||
+               isName(statement, "pg_pin")) {
+                isScanned = scanPin(&cell, statement);
+            }
+            else {
+                isScanned = skipGroup(statement);
+            }
+
+            if(!isScanned) {
+                return false;
+            }
+        }
+    }
+
+    return false;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Scans the body of a pin group for its direction and adds the pins it defines to the cell. Timing, power and
+ * member pin groups are skipped.
+ * \param cell          Cell to add the pins to.
+ * \param header        Head of the group.
+ **********************************************************************************************************************/
+bool LibertyIndex::scanPin(Cell *cell, const Statement &header)
+{
+    QString direction;
+    QString pgType;
+
+    Statement statement;
+    while(next(&statement)) {
+        if(statement.type == END_OF_FILE) {
+            addUnclosedError(header);
+            return false;
+        }
+
+        if(statement.type == GROUP_END) {
+            Pin pin;
+            pin.group = QString::fromLatin1(header.name, header.nameLength);
+            pin.direction = direction.isEmpty() ? pgType : direction;
+
+            foreach(const QString &name, getArguments(header)) {
+                pin.name = name;
+                cell->pins<<pin;
+            }
+
+            return true;
+        }
+
+        if(statement.type == SIMPLE_ATTRIBUTE) {
+            if(isName(statement, "direction")) {
+                direction = toText(statement.value, statement.valueLength);
+            }
+            else if(isName(statement, "pg_type")) {
+                pgType = toText(statement.value, statement.valueLength);
+            }
+        }
+        else if(statement.type == GROUP_BEGIN && !skipGroup(statement)) {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Skips white space, line continuations and comments.
+ **********************************************************************************************************************/
+void LibertyIndex::skipSpace()
+{
+    while(m_position < m_end) {
+        char c = *m_position;
+
+        if(isSpace(c) || (c == '\\' && (m_position + 1 >= m_end || isSpace(m_position[1])))) {
+            ++m_position;
+        }
+        else if(c == '/' && m_position + 1 < m_end && m_position[1] == '*') {
+            m_position = skipComment(m_position + 2, m_end);
+        }
+        else if(c == '/' && m_position + 1 < m_end && m_position[1] == '/') {
+            m_position = skipLine(m_position + 2, m_end);
+        }
+        else {
+            break;
+        }
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Adds an error with the line of the position. Lines are counted only here, the scan itself does not need them.
+ * \param msg           Description of the error without full stop.
+ * \param position      Position of the error in the scanned text.
+ **********************************************************************************************************************/
+void LibertyIndex::addError(const QString &msg, const char *position)
+{
+    int line = 1;
+
+    const char *current = m_data;
+    while(current < position) {
+        current = static_cast<const char*>(std::memchr(current, '\n', position - current));
+        if(!current) {
+            break;
+        }
+
+        ++line;
+        ++current;
+    }
+
+    m_errorList<<QString("%1 at line %2 of '%3'.").arg(msg).arg(line).arg(m_fileName);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Adds an error for a group which is not closed before the end of the file.
+ * \param header        Head of the group.
+ **********************************************************************************************************************/
+void LibertyIndex::addUnclosedError(const Statement &header)
+{
+    addError(QString("Unclosed group '%1'").arg(QString::fromLatin1(header.name, header.nameLength)), header.start);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if the statement has the given name.
+ * \param statement     Statement to check.
+ * \param name          Name to compare with.
+ **********************************************************************************************************************/
+bool LibertyIndex::isName(const Statement &statement, const char *name)
+{
+    return std::strncmp(statement.name, name, statement.nameLength) == 0 && name[statement.nameLength] == '\0';
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns comma separated arguments of a group or complex attribute without quotes, e.g. the names of 'pin(A, B)'.
+ * \param statement     Statement to read the arguments from.
+ **********************************************************************************************************************/
+QStringList LibertyIndex::getArguments(const Statement &statement)
+{
+    QStringList arguments;
+
+    const char *start = statement.value;
+    const char *end = statement.value + statement.valueLength;
+
+    while(start < end) {
+        const char *comma = static_cast<const char*>(std::memchr(start, ',', end - start));
+        if(!comma) {
+            comma = end;
+        }
+
+        QString argument = toText(start, comma - start);
+        if(!argument.isEmpty()) {
+            arguments<<argument;
+        }
+
+        start = comma + 1;
+    }
+
+    return arguments;
+}
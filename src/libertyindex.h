@@ -0,0 +1,143 @@
+#ifndef LIBERTYINDEX_H
+#define LIBERTYINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QByteArray>
+#include <QStringList>
+
+/*!*********************************************************************************************************************
+ * \brief The LibertyIndex class indexes 'cell' groups of Liberty timing libraries by byte offset, together with their
+ * area and pins, so the section of a single cell can be shown or extracted without loading a file of several GB. The
+ * file is memory mapped and scanned once; groups below pins (timing tables, power tables) are skipped by matching
+ * braces only. The index of every file is kept in the cache folder and used again while the file size and
+ * modification time are unchanged.
+ **********************************************************************************************************************/
+class LibertyIndex
+{
+public:
+    /*!
+     * \brief The Pin struct keeps a 'pin', 'bus', 'bundle' or 'pg_pin' group of a cell.
+     */
+    struct Pin {
+        QString                         name;               /*!< Name of the pin. */
+        QString                         group;              /*!< Name of the group, e.g. 'pin' or 'bus'. */
+        QString                         direction;          /*!< Value of 'direction', or 'pg_type' of power pins. */
+    };
+
+    /*!
+     * \brief The Cell struct keeps the position and the summary of a 'cell' group.
+     */
+    struct Cell {
+        QString                         name;               /*!< Name of the cell. */
+        QString                         area;               /*!< Value of 'area' as written in the file. */
+        qint64                          offset;             /*!< Offset of the group name in the file. */
+        qint64                          length;             /*!< Bytes from the group name to the closing brace. */
+        QList<Pin>                      pins;               /*!< Pins in the order of their definition. */
+    };
+
+    LibertyIndex();
+
+    bool                                update(const QString &fileName);
+    bool                                scan(const QString &fileName);
+    bool                                scan(const char *data, qint64 size, const QString &fileName);
+
+    bool                                load(const QString &indexFile);
+    bool                                save(const QString &indexFile);
+
+    QString                             getLibraryName() const;
+    QList<Cell>                         getCells() const;
+    bool                                contains(const QString &cellName) const;
+    Cell                                getCell(const QString &cellName) const;
+    QByteArray                          readCell(const QString &cellName);
+    QStringList                         getErrors() const;
+
+    static QString                      getIndexFile(const QString &fileName);
+    static QString                      formatPins(const QList<Pin> &pins);
+
+private:
+    /*!
+     * \brief The STATEMENT enum specifies statement types.
+     */
+    enum STATEMENT {
+        END_OF_FILE                     = 0,
+        SIMPLE_ATTRIBUTE,
+        COMPLEX_ATTRIBUTE,
+        GROUP_BEGIN,
+        GROUP_END
+    };
+
+    /*!
+     * \brief The Statement struct points into the scanned text.
+     */
+    struct Statement {
+        STATEMENT                       type;               /*!< Type of the statement. */
+        const char                      *start;             /*!< First character of the statement. */
+        const char                      *name;              /*!< Name of the attribute or group. */
+        int                             nameLength;         /*!< Number of characters of the name. */
+        const char                      *value;             /*!< Value or arguments without parentheses. */
+        int                             valueLength;        /*!< Number of characters of the value. */
+    };
+
+    bool                                next(Statement *statement);
+    bool                                skipGroup(const Statement &header);
+    bool                                scanLibrary(const Statement &header);
+    bool                                scanCell(const Statement &header);
+    bool                                scanPin(Cell *cell, const Statement &header);
+
+    void                                skipSpace();
+    void                                addError(const QString &msg, const char *position);
+    void                                addUnclosedError(const Statement &header);
+
+    static bool                         isName(const Statement &statement, const char *name);
+    static QStringList                  getArguments(const Statement &statement);
+
+private:
+    const char                          *m_data;            /*!< Start of the scanned text. */
+    const char                          *m_position;        /*!< Next character to scan. */
+    const char                          *m_end;             /*!< End of the scanned text. */
+
+    QString                             m_fileName;         /*!< Path of the indexed file. */
+    qint64                              m_size;             /*!< Size of the file when it was indexed. */
+    qint64                              m_modified;         /*!< Modification time in ms since epoch when indexed. */
+    QString                             m_libraryName;      /*!< Name of the 'library' group. */
+    QList<Cell>                         m_cells;            /*!< Cells in the order of their definition. */
+    QHash<QString, int>                 m_cellIds;          /*!< Map of cell names to positions in m_cells. */
+    QStringList                         m_errorList;        /*!< Errors of scanning, loading and reading. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Returns name of the 'library' group, empty if the file holds cell groups only.
+ **********************************************************************************************************************/
+inline QString LibertyIndex::getLibraryName() const
+{
+    return m_libraryName;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns cells in the order of their definition.
+ **********************************************************************************************************************/
+inline QList<LibertyIndex::Cell> LibertyIndex::getCells() const
+{
+    return m_cells;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if the file defines the cell.
+ * \param cellName      Name of the cell.
+ **********************************************************************************************************************/
+inline bool LibertyIndex::contains(const QString &cellName) const
+{
+    return m_cellIds.contains(cellName);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns errors of the last update(), scan(), load(), save() or readCell() call.
+ **********************************************************************************************************************/
+inline QStringList LibertyIndex::getErrors() const
+{
+    return m_errorList;
+}
+
+#endif // LIBERTYINDEX_H
@@ -0,0 +1,212 @@
+#include <cstring>
+
+#include <QRunnable>
+#include <QMutexLocker>
+
+#include "lineindex.h"
+#include "trace.h"
+
+/*!*********************************************************************************************************************
+ * \brief Size of the blocks the text is scanned in. Lines and checkpoints are published after each block, a stopped
+ * build ends after the current block.
+ **********************************************************************************************************************/
+static const qint64 LINE_INDEX_BLOCK_SIZE = 4 * 1024 * 1024;
+
+/*!*********************************************************************************************************************
+ * \brief The LineIndexJob class builds the index of a LineIndex object in its thread pool.
+ **********************************************************************************************************************/
+class LineIndexJob : public QRunnable
+{
+public:
+    explicit LineIndexJob(LineIndex *index) : m_index(index) {}
+
+    void run() { m_index->build(); }
+
+private:
+    LineIndex                           *m_index;           /*!< Index to build, owns the pool running the job. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Constructs an empty LineIndex object.
+ **********************************************************************************************************************/
+LineIndex::LineIndex()
+    : m_isCancelled(0),
+      m_data(0),
+      m_size(0),
+      m_lineCount(0),
+      m_indexedBytes(0),
+      m_isDone(true)
+{
+    m_pool.setMaxThreadCount(1);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Stops the build and waits for its current block.
+ **********************************************************************************************************************/
+LineIndex::~LineIndex()
+{
+    stop();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Stops a running build and starts indexing the given text in the background. The text must stay valid until
+ * stop() is called or the object is destroyed.
+ * \param data          Text to index.
+ * \param size          Size of the text in bytes.
+ **********************************************************************************************************************/
+void LineIndex::start(const char *data, qint64 size)
+{
+    stop();
+
+    QMutexLocker locker(&m_mutex);
+
+    m_data = data;
+    m_size = data ? size : 0;
+    m_checkpoints<<0;
+    m_isDone = false;
+
+    m_isCancelled.fetchAndStoreOrdered(0);
+
+    m_pool.start(new LineIndexJob(this));
+}
+
+/*!*********************************************************************************************************************
+ * \brief Stops a running build, waits for it and clears the index. The text is not accessed afterwards.
+ **********************************************************************************************************************/
+void LineIndex::stop()
+{
+    m_isCancelled.fetchAndStoreOrdered(1);
+    m_pool.waitForDone();
+
+    QMutexLocker locker(&m_mutex);
+
+    m_data = 0;
+    m_size = 0;
+    m_checkpoints.clear();
+    m_lineCount = 0;
+    m_indexedBytes = 0;
+    m_isDone = true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if the whole text has been indexed.
+ **********************************************************************************************************************/
+bool LineIndex::isDone() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_isDone;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns the number of lines indexed so far, the number of lines of the text once the build is done.
+ **********************************************************************************************************************/
+qint64 LineIndex::getLineCount() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_lineCount;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns the number of bytes scanned so far.
+ **********************************************************************************************************************/
+qint64 LineIndex::getIndexedBytes() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_indexedBytes;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns offset of the first character of the line, found from the nearest checkpoint.
+ * \param line          Number of the line starting with 0.
+ * \return              Offset in bytes, -1 if the line has not been indexed (yet).
+ **********************************************************************************************************************/
+qint64 LineIndex::getLineStart(qint64 line) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    if(line < 0 || line >= m_lineCount) {
+        return -1;
+    }
+
+    qint64 offset = m_checkpoints[int(line / LINE_STEP)];
+
+    locker.unlock();
+
+    for(qint64 i = line % LINE_STEP; i > 0; --i) {
+        const char *next = static_cast<const char*>(std::memchr(m_data + offset, '\n', size_t(m_size - offset)));
+        offset = next - m_data + 1;
+    }
+
+    return offset;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns offset behind the last character of the line, line breaks ('\n' or '\r\n') are not included.
+ * \param start         Offset of the first character of the line.
+ **********************************************************************************************************************/
+qint64 LineIndex::getLineEnd(qint64 start) const
+{
+    const char *next = static_cast<const char*>(std::memchr(m_data + start, '\n', size_t(m_size - start)));
+    qint64 end = next ? next - m_data : m_size;
+
+    if(end > start && m_data[end - 1] == '\r') {
+        --end;
+    }
+
+    return end;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Scans the text for line breaks block by block. memchr() is used for the scan as the C library provides it
+ * vectorized, so the build runs at memory bandwidth.
+ **********************************************************************************************************************/
+void LineIndex::build()
+{
+    TRACE_SCOPE("preview", "index_lines");
+
+    const char *end = m_data + m_size;
+    const char *block = m_data;
+    qint64 line = 0;
+
+    QVector<qint64> checkpoints;
+
+    while(block < end) {
+        if(m_isCancelled.fetchAndAddOrdered(0)) {
+            return;
+        }
+
+        const char *blockEnd = block + qMin(LINE_INDEX_BLOCK_SIZE, qint64(end - block));
+        const char *next = block;
+
+        while((next = static_cast<const char*>(std::memchr(next, '\n', size_t(blockEnd - next)))) != 0) {
+            ++next;
+            ++line;
+
+            if(line % LINE_STEP == 0) {
+                checkpoints<<(next - m_data);
+            }
+        }
+
+        block = blockEnd;
+
+        QMutexLocker locker(&m_mutex);
+
+        m_checkpoints += checkpoints;
+        m_lineCount = line;
+        m_indexedBytes = block - m_data;
+
+        checkpoints.clear();
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    // The last line is counted even without a line break at the end of the text.
+    if(m_size > 0 && m_data[m_size - 1] != '\n') {
+        ++m_lineCount;
+    }
+
+    m_isDone = true;
+}
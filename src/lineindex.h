@@ -0,0 +1,52 @@
+#ifndef LINEINDEX_H
+#define LINEINDEX_H
+
+#include <QMutex>
+#include <QVector>
+#include <QAtomicInt>
+#include <QThreadPool>
+
+/*!*********************************************************************************************************************
+ * \brief The LineIndex class finds the lines of a text in memory, typically a memory mapped file, in a background
+ * thread. Only the offset of every LINE_STEP-th line is kept, so the index of a multi-GB netlist stays a few MB; the
+ * remaining lines are found by scanning forward from the nearest checkpoint. Lines indexed so far can be used while
+ * the index is still being built.
+ **********************************************************************************************************************/
+class LineIndex
+{
+public:
+    LineIndex();
+    ~LineIndex();
+
+    void                                start(const char *data, qint64 size);
+    void                                stop();
+
+    bool                                isDone() const;
+    qint64                              getLineCount() const;
+    qint64                              getIndexedBytes() const;
+
+    qint64                              getLineStart(qint64 line) const;
+    qint64                              getLineEnd(qint64 start) const;
+
+    static const int                    LINE_STEP = 64;
+
+private:
+    friend class LineIndexJob;
+
+    void                                build();
+
+private:
+    mutable QMutex                      m_mutex;            /*!< Guards checkpoints and counts against the build job. */
+    QThreadPool                         m_pool;             /*!< Single thread building the index. */
+    QAtomicInt                          m_isCancelled;      /*!< Set to stop the build job. */
+
+    const char                          *m_data;            /*!< Text being indexed, not owned. */
+    qint64                              m_size;             /*!< Size of the text in bytes. */
+
+    QVector<qint64>                     m_checkpoints;      /*!< Offsets of lines 0, LINE_STEP, 2 * LINE_STEP, ... */
+    qint64                              m_lineCount;        /*!< Number of lines indexed so far. */
+    qint64                              m_indexedBytes;     /*!< Number of bytes scanned so far. */
+    bool                                m_isDone;           /*!< State if the whole text has been indexed. */
+};
+
+#endif // LINEINDEX_H
@@ -11,23 +11,113 @@
  * limitations under the License.
  *********************************************************************************************************************/
 
+#include <cstring>
 #include <iostream>
 
+#include <QtGlobal>
+
+#if defined(Q_OS_UNIX)
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <QSocketNotifier>
+#endif
+
 #include <QDir>
 #include <QDebug>
 #include <QFileInfo>
 #include <QApplication>
+#include <QCoreApplication>
 
 #include "mainwindow.h"
+#include "batchmode.h"
+#include "catalogserver.h"
+#include "toolstub.h"
+#include "trace.h"
 
 using std::cerr;
 using std::endl;
 
+#if defined(Q_OS_UNIX)
+static int s_signalFds[2] = {-1, -1};
+
+//*********************************************************************************************************************
+// handleSignal
+//*********************************************************************************************************************
+static void handleSignal(int)
+{
+    char signal = 1;
+    if(::write(s_signalFds[0], &signal, 1) < 0) {
+        return;
+    }
+}
+#endif
+
+//*********************************************************************************************************************
+// quitOnSignals
+//*********************************************************************************************************************
+static void quitOnSignals(QCoreApplication *app)
+{
+#if defined(Q_OS_UNIX)
+    // The handler only writes into a socket pair, the application quits from its event loop, so main() returns and
+    // the trace is completed.
+    if(::socketpair(AF_UNIX, SOCK_STREAM, 0, s_signalFds) != 0) {
+        return;
+    }
+
+    QSocketNotifier *notifier = new QSocketNotifier(s_signalFds[1], QSocketNotifier::Read, app);
+    QObject::connect(notifier, SIGNAL(activated(int)), app, SLOT(quit()));
+
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = handleSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+
+    sigaction(SIGTERM, &action, 0);
+    sigaction(SIGINT, &action, 0);
+    sigaction(SIGHUP, &action, 0);
+#else
+    Q_UNUSED(app);
+#endif
+}
+
 //*********************************************************************************************************************
 // main
 //*********************************************************************************************************************
 int main(int argc, char *argv[])
 {
+    TraceSession trace(Trace::getRequestedFile(argc, argv));
+
+    if(BatchMode::isRequested(argc, argv)) {
+        QCoreApplication a(argc, argv);
+        return BatchMode(a.arguments()).exec();
+    }
+
+    if(CatalogServer::isRequested(argc, argv)) {
+        QCoreApplication a(argc, argv);
+        CatalogServer server;
+        if(!server.start(a.arguments())) {
+            return 1;
+        }
+
+        quitOnSignals(&a);
+
+        return a.exec();
+    }
+
+    if(ToolStub::isRequested(argc, argv)) {
+        QCoreApplication a(argc, argv);
+        ToolStub stub;
+        if(!stub.start(a.arguments())) {
+            return 1;
+        }
+
+        quitOnSignals(&a);
+
+        return a.exec();
+    }
+
     QApplication a(argc, argv);
     QDir dir(".");
     QString runDir = dir.absolutePath();
@@ -36,7 +126,10 @@ int main(int argc, char *argv[])
     for(int i = 1; i < argc; ++i) {
         QString key = argv[i];
 
-        if(QFileInfo(key).exists()) {
+        if(key == "--trace" && i + 1 < argc) {
+            ++i;
+        }
+        else if(QFileInfo(key).exists()) {
             projFile = key;
         }
         else {
@@ -47,6 +140,10 @@ int main(int argc, char *argv[])
 
     MainWindow w(projFile, runDir);
     w.show();
+
+    if(Trace::isEnabled()) {
+        quitOnSignals(&a);
+    }
     
     return a.exec();
 }
@@ -1,7 +1,7 @@
 #include <QMenu>
 #include <QFile>
+#include <QBitArray>
 #include <QDebug>
-#include <QProcess>
 #include <QVariant>
 #include <QFileInfo>
 #include <QSettings>
@@ -19,10 +19,69 @@
 #include "ui_mainwindow.h"
 
 #include "about.h"
+#include "backgroundjob.h"
+#include "catalog.h"
+#include "catalogclient.h"
+#include "cellfilter.h"
 #include "newview.h"
+#include "netlistgraph.h"
+#include "netlistindex.h"
 #include "property.h"
 #include "toolmanager.h"
+#include "toolsessions.h"
+#include "perfpanel.h"
+#include "launchpanel.h"
+#include "previewpanel.h"
+#include "perfcounters.h"
 #include "projectmanager.h"
+#include "trace.h"
+#include "viewprefetch.h"
+
+/*!*********************************************************************************************************************
+ * \brief The PreviewSubcktsJob class looks up the subcircuits of a previewed file in the netlist index, which is loaded
+ * in the background on first use, and lists them in the preview panel.
+ **********************************************************************************************************************/
+class PreviewSubcktsJob : public BackgroundJob
+{
+public:
+    PreviewSubcktsJob(MainWindow *window, const QString &path) : BackgroundJob(window), m_path(path) {}
+
+    void run();
+    void finish();
+
+private:
+    QString                             m_path;             /*!< Path to the previewed file. */
+    QList<NetlistParser::Subckt>        m_subckts;          /*!< Subcircuits of the file if it is indexed. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Takes the subcircuits of the file if it is in the netlist index and has not changed since. The file is not
+ * parsed here, as that takes as long as loading it into an editor.
+ **********************************************************************************************************************/
+void PreviewSubcktsJob::run()
+{
+    NetlistIndex &index = getNetlistIndex();
+    if(!index.contains(m_path)) {
+        return;
+    }
+
+    NetlistIndex::View view = index.getView(m_path);
+    QFileInfo fileInfo(m_path);
+
+    if(view.size == fileInfo.size() && view.modified == fileInfo.lastModified().toMSecsSinceEpoch()) {
+        m_subckts = view.subckts;
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Lists the subcircuits in the preview panel, unless another file is previewed meanwhile.
+ **********************************************************************************************************************/
+void PreviewSubcktsJob::finish()
+{
+    BackgroundJob::finish();
+
+    m_window->m_previewPanel->setSubckts(m_path, m_subckts);
+}
 
 /*!*******************************************************************************************************************
  * \brief Constructs a LibMan MainWindow object with the given arguments.
@@ -34,6 +93,17 @@ MainWindow::MainWindow(const QString &projFile, const QString &runDir, QWidget *
     QMainWindow(parent),    
     m_ui(new Ui::MainWindow),
     m_properties(new Properties),
+    m_catalog(new Catalog),
+    m_client(new CatalogClient),
+    m_perfPanel(0),
+    m_launchPanel(0),
+    m_previewPanel(0),
+    m_netlistIndex(0),
+    m_netlistGraph(new NetlistGraph),
+    m_cellFilter(new CellFilter),
+    m_toolSessions(new ToolSessions(this)),
+    m_viewPrefetch(new ViewPrefetch),
+    m_backgroundQueue(new BackgroundQueue),
     m_isStateChanged(false),
     m_itemText(""),
     m_runDirectory(runDir),
@@ -54,6 +124,26 @@ MainWindow::MainWindow(const QString &projFile, const QString &runDir, QWidget *
     m_ui->actionUnion->setEnabled(false);
     m_ui->actionCategory->setEnabled(false);
 
+    m_perfPanel = new PerfPanel(this);
+    addDockWidget(Qt::BottomDockWidgetArea, m_perfPanel);
+    m_perfPanel->hide();
+
+    QAction *actionPerformance = m_perfPanel->toggleViewAction();
+    actionPerformance->setStatusTip(tr("Show counters of file system access, scans, filtering and jobs."));
+    m_ui->toolBar->addAction(actionPerformance);
+
+    m_launchPanel = new LaunchPanel(m_toolSessions, this);
+    addDockWidget(Qt::BottomDockWidgetArea, m_launchPanel);
+    m_launchPanel->hide();
+
+    QAction *actionLaunches = m_launchPanel->toggleViewAction();
+    actionLaunches->setStatusTip(tr("Show resolve, spawn and ready times and peak memory of tool launches."));
+    m_ui->toolBar->addAction(actionLaunches);
+
+    m_previewPanel = new PreviewPanel(this);
+    addDockWidget(Qt::RightDockWidgetArea, m_previewPanel);
+    m_previewPanel->hide();
+
     initRecentProjectMenu();
 
     loadSettings();
@@ -68,6 +158,7 @@ MainWindow::MainWindow(const QString &projFile, const QString &runDir, QWidget *
     connect(m_ui->listViews, SIGNAL(customContextMenuRequested(QPoint)), this, SLOT(showViewMenu(const QPoint &)));
     connect(m_ui->listGroups, SIGNAL(customContextMenuRequested(QPoint)), this, SLOT(showGroupMenu(const QPoint &)));
     connect(m_ui->listCategories, SIGNAL(customContextMenuRequested(QPoint)), this, SLOT(showCategoryMenu(const QPoint &)));
+    connect(m_toolSessions, SIGNAL(message(QString,bool)), this, SLOT(showToolMessage(QString,bool)));
 
     setWindowTitle(getLibManTitle());
 
@@ -87,8 +178,15 @@ MainWindow::MainWindow(const QString &projFile, const QString &runDir, QWidget *
  *********************************************************************************************************************/
 MainWindow::~MainWindow()
 {
+    delete m_backgroundQueue;
     delete m_ui;
     delete m_properties;
+    delete m_catalog;
+    delete m_client;
+    delete m_netlistIndex;
+    delete m_netlistGraph;
+    delete m_cellFilter;
+    delete m_viewPrefetch;
 }
 
 /*!*******************************************************************************************************************
@@ -134,6 +232,22 @@ void MainWindow::closeEvent(QCloseEvent *event)
     settings.setValue("Layout", layout);
     settings.setValue("Editor", editor);
     settings.setValue("PdfReader", pdfReader);
+
+    foreach(const QString &toolKey, QStringList()<<"Schematic"<<"Layout"<<"Editor"<<"PdfReader") {
+        QString fileArguments = "%f";
+        if(m_properties->exists(toolKey + "FileArguments")) {
+            fileArguments = m_properties->get<QString>(toolKey + "FileArguments");
+        }
+
+        int filesPerLaunch = 0;
+        if(m_properties->exists(toolKey + "FilesPerLaunch")) {
+            filesPerLaunch = m_properties->get<int>(toolKey + "FilesPerLaunch");
+        }
+
+        settings.setValue(toolKey + "FileArguments", fileArguments);
+        settings.setValue(toolKey + "FilesPerLaunch", filesPerLaunch);
+    }
+
     settings.endGroup();
 
     checkAndSaveProjectData(event);
@@ -227,6 +341,11 @@ void MainWindow::loadSettings()
     }
     m_properties->set("PdfReader", pdfReader);
 
+    foreach(const QString &toolKey, QStringList()<<"Schematic"<<"Layout"<<"Editor"<<"PdfReader") {
+        m_properties->set(toolKey + "FileArguments", settings.value(toolKey + "FileArguments", "%f").toString());
+        m_properties->set(toolKey + "FilesPerLaunch", settings.value(toolKey + "FilesPerLaunch", 0).toInt());
+    }
+
     settings.endGroup();
 }
 
@@ -425,6 +544,21 @@ void MainWindow::info(const QString &msg, bool clear)
     m_ui->textMessages->setTextColor(Qt::black);
 }
 
+/*!*******************************************************************************************************************
+ * \brief Slot to display messages of tool sessions, which may arrive after the request has been made.
+ * \param msg         Message to output.
+ * \param isError     Flag to display the message as error.
+ **********************************************************************************************************************/
+void MainWindow::showToolMessage(const QString &msg, bool isError)
+{
+    if(isError) {
+        error(msg + "\n", false);
+    }
+    else {
+        info(msg, false);
+    }
+}
+
 /*!*******************************************************************************************************************
  * \brief Displays error message in the output text widget of LibMan.
  * \param msg         Message to output.
@@ -446,9 +580,7 @@ void MainWindow::error(const QString &msg, bool clear)
  **********************************************************************************************************************/
 QStringList MainWindow::getValidViewList() const
 {
-    QStringList views;
-    views<<"gds"<<"cdl"<<"spice"<<"verilog";
-    return views;
+    return Catalog::getValidViewList();
 }
 
 /*!*******************************************************************************************************************
@@ -457,19 +589,23 @@ QStringList MainWindow::getValidViewList() const
  **********************************************************************************************************************/
 QString MainWindow::getToolByView(const QString &viewName) const
 {
-    QString tool;
+    return m_properties->get<QString>(getToolKeyByView(viewName));
+}
 
+/*!*******************************************************************************************************************
+ * \brief Returns settings key of the tool for displaying views based on view name.
+ * \param viewName     Name of the view to return an appropriate tool.
+ **********************************************************************************************************************/
+QString MainWindow::getToolKeyByView(const QString &viewName) const
+{
     if(viewName.toLower() == "gds") {
-        tool = m_properties->get<QString> ("Layout");
+        return "Layout";
     }
     else if(viewName.toLower() == "cdl") {
-        tool = m_properties->get<QString> ("Schematic");
-    }
-    else {
-        tool = m_properties->get<QString> ("Editor");
+        return "Schematic";
     }
 
-    return tool;
+    return "Editor";
 }
 
 /*!*******************************************************************************************************************
@@ -478,16 +614,20 @@ QString MainWindow::getToolByView(const QString &viewName) const
  **********************************************************************************************************************/
 QString MainWindow::getDocumentTool(const QString &documentName) const
 {
-    QString tool;
+    return m_properties->get<QString>(getDocumentToolKey(documentName));
+}
 
+/*!*******************************************************************************************************************
+ * \brief Returns settings key of the tool for viewing documents based on doument name.
+ * \param documentName     Name of the document to return an appropriate tool.
+ **********************************************************************************************************************/
+QString MainWindow::getDocumentToolKey(const QString &documentName) const
+{
     if(QFileInfo(documentName).completeSuffix().toLower() == "pdf") {
-        tool = m_properties->get<QString> ("PdfReader");
-    }
-    else {
-        tool = m_properties->get<QString> ("Editor");
+        return "PdfReader";
     }
 
-    return tool;
+    return "Editor";
 }
 
 /*!*******************************************************************************************************************
@@ -498,8 +638,7 @@ QString MainWindow::getDocumentTool(const QString &documentName) const
  **********************************************************************************************************************/
 QString MainWindow::getViewPath(const QString &libName, const QString &groupName, const QString &viewName) const
 {
-    QString viewPath = QDir::toNativeSeparators(libName + "/" + viewName + "/" + groupName + "." + viewName);
-    return(viewPath);
+    return Catalog::getViewPath(libName, groupName, viewName);
 }
 
 /*!*******************************************************************************************************************
@@ -654,6 +793,23 @@ QString MainWindow::getCurrentGroupName() const
     return groupName;
 }
 
+/*!*******************************************************************************************************************
+ * \brief Returns names of all selected groups (cells) in list order.
+ **********************************************************************************************************************/
+QStringList MainWindow::getSelectedGroupNames() const
+{
+    QStringList groupNames;
+
+    for(int i = 0; i < m_ui->listGroups->count(); ++i) {
+        QListWidgetItem *groupId = m_ui->listGroups->item(i);
+        if(groupId && groupId->isSelected() && !groupId->isHidden() && !groupId->text().isEmpty()) {
+            groupNames<<groupId->text();
+        }
+    }
+
+    return groupNames;
+}
+
 /*!*******************************************************************************************************************
  * \brief Returns currently selected view name.
  **********************************************************************************************************************/
@@ -788,19 +944,7 @@ QStringList MainWindow::getCurrentGroups(const QString &libPath) const
  **********************************************************************************************************************/
 QStringList MainWindow::getCurrentViews(const QString &libPath, const QString &groupName) const
 {
-    QStringList groupViews;
-
-    QStringList views = getValidViewList();
-    foreach(const QString viewName, views) {
-        QString viewPath = QDir::toNativeSeparators(libPath + "/" + viewName + "/" + groupName + "." + viewName);
-        if(QFileInfo(viewPath).exists()) {
-            groupViews<<viewName;
-        }
-    }
-
-    groupViews.removeDuplicates();
-
-    return(groupViews);
+    return m_catalog->getViews(libPath, groupName);
 }
 
 /*!*******************************************************************************************************************
@@ -809,20 +953,11 @@ QStringList MainWindow::getCurrentViews(const QString &libPath, const QString &g
  **********************************************************************************************************************/
 void MainWindow::loadDocuments(const QString &libPath)
 {
-    m_ui->listDocumentation->clear();
+    TRACE_SCOPE_ARG("gui", "populate_documents", libPath);
 
-    QString docPath = QDir::toNativeSeparators(libPath + "/doc");
-    if(!QFileInfo(docPath).isDir()) {
-        return;
-    }
-
-    QStringList formats;
-    formats<<"*.txt"<<"*.pdf"<<"*.doc"<<"*.celllist";
-
-    QDir docDir(docPath);
-    docDir.setNameFilters(formats);
+    m_ui->listDocumentation->clear();
 
-    QStringList fileList = docDir.entryList();
+    QStringList fileList = m_catalog->getDocuments(libPath);
     foreach(QString docName, fileList) {
         QTreeWidgetItem *docItem = new QTreeWidgetItem;
         docItem->setText(0, docName);
@@ -846,22 +981,15 @@ void MainWindow::loadDocuments(const QString &libPath)
  **********************************************************************************************************************/
 void MainWindow::loadCategories(const QString &libPath)
 {
-    m_ui->listCategories->clear();
-
-    if(!QFileInfo(libPath).isDir()) {
-        return;
-    }
+    TRACE_SCOPE_ARG("gui", "populate_categories", libPath);
 
-    QStringList formats;
-    formats<<"*.group";
-
-    QDir catDir(libPath);
-    catDir.setNameFilters(formats);
+    m_ui->listCategories->clear();
+    m_cellFilter->clear();
 
-    QStringList fileList = catDir.entryList();
-    foreach(QString catName, fileList) {
+    QStringList catList = m_catalog->getCategories(libPath);
+    foreach(const QString &catName, catList) {
         QTreeWidgetItem *catItem = new QTreeWidgetItem;
-        catItem->setText(0, QFileInfo(catName).completeBaseName());
+        catItem->setText(0, catName);
         m_ui->listCategories->addTopLevelItem(catItem);
     }
 
@@ -880,26 +1008,13 @@ void MainWindow::loadCategories(const QString &libPath)
  **********************************************************************************************************************/
 void MainWindow::loadGroups(const QString &libPath)
 {
+    TRACE_SCOPE_ARG("gui", "populate_cells", libPath);
+
     m_ui->listGroups->clear();
     m_ui->listViews->clear();
+    m_cellFilter->clear();
 
-    QStringList groups;
-
-    QStringList views = getValidViewList();
-    foreach(const QString viewName, views) {
-        QString groupPath = QDir::toNativeSeparators(libPath + "/" + viewName);
-
-        QDir groupDir(groupPath);
-        groupDir.setNameFilters(QStringList()<<"*." + viewName);
-
-        QStringList fileList = groupDir.entryList();
-        foreach(QString groupName, fileList) {
-            groupName.remove(QString(".") + viewName);
-            groups<<groupName;
-        }
-    }
-
-    groups.removeDuplicates();
+    QStringList groups = m_catalog->getCells(libPath);
 
     foreach(const QString &groupName, groups) {
         QListWidgetItem *groupItem = new QListWidgetItem;
@@ -918,19 +1033,11 @@ void MainWindow::loadGroups(const QString &libPath)
  **********************************************************************************************************************/
 void MainWindow::loadViews(const QString &libPath, const QString &groupName)
 {
-    m_ui->listViews->clear();
-
-    QStringList groupViews;
+    TRACE_SCOPE_ARG("gui", "populate_views", groupName);
 
-    QStringList views = getValidViewList();
-    foreach(const QString viewName, views) {
-        QString viewPath = QDir::toNativeSeparators(libPath + "/" + viewName + "/" + groupName + "." + viewName);
-        if(QFileInfo(viewPath).exists()) {
-            groupViews<<viewName;
-        }
-    }
+    m_ui->listViews->clear();
 
-    groupViews.removeDuplicates();
+    QStringList groupViews = m_catalog->getViews(libPath, groupName);
 
     foreach(const QString &viewName, groupViews) {
         QListWidgetItem *viewItem = new QListWidgetItem;
@@ -941,11 +1048,38 @@ void MainWindow::loadViews(const QString &libPath, const QString &groupName)
     m_ui->listViews->sortItems();
 }
 
+/*!*******************************************************************************************************************
+ * \brief Warms the page cache with the listed views of the group (cell) in the background, the layout first, so they
+ * are read quickly when a tool opens them. A prefetch still running for the previous selection is cancelled.
+ * \param libPath       Path to the library.
+ * \param groupName     Name of the group (cell).
+ **********************************************************************************************************************/
+void MainWindow::prefetchViews(const QString &libPath, const QString &groupName)
+{
+    QStringList viewPaths;
+
+    for(int i = 0; i < m_ui->listViews->count(); ++i) {
+        QString viewName = m_ui->listViews->item(i)->text();
+        QString viewPath = getViewPath(libPath, groupName, viewName);
+
+        if(viewName == "gds") {
+            viewPaths.prepend(viewPath);
+        }
+        else {
+            viewPaths<<viewPath;
+        }
+    }
+
+    m_viewPrefetch->prefetch(viewPaths);
+}
+
 /*!*******************************************************************************************************************
  * \brief Adds project (libraries) into the project tree widget from the LibMan settings.
  **********************************************************************************************************************/
 void MainWindow::loadLibraries()
 {
+    TRACE_SCOPE("gui", "populate_libraries");
+
     m_ui->treeLibs->clear();
 
     QMap<QString, QString> libraries = getCurrentLibraries();
@@ -976,6 +1110,8 @@ void MainWindow::loadLibraries()
  **********************************************************************************************************************/
 void MainWindow::loadCombinedLibs(const QMap<QString, QStringList> &combinedLibs)
 {
+    TRACE_SCOPE("gui", "populate_groups");
+
     QMap<QString, QStringList>::const_iterator it;
     for(it = combinedLibs.constBegin(); it != combinedLibs.constEnd(); it++) {
         QString groupName = it.key();
@@ -1015,6 +1151,8 @@ void MainWindow::loadCombinedLibs(const QMap<QString, QStringList> &combinedLibs
  **********************************************************************************************************************/
 void MainWindow::on_treeLibs_itemClicked(QTreeWidgetItem *item, int)
 {
+    TRACE_SCOPE("gui", "library_clicked");
+
     m_itemText = "";
 
     if(!item) {
@@ -1034,6 +1172,8 @@ void MainWindow::on_treeLibs_itemClicked(QTreeWidgetItem *item, int)
 
     m_ui->txtLibSearch->setText(item->text(0));
 
+    m_viewPrefetch->cancel();
+
     QString key = getLibraryKeyPrefix() + item->text(0);
     QString libPath = m_properties->get<QString>(key);
 
@@ -1054,6 +1194,8 @@ void MainWindow::on_treeLibs_itemClicked(QTreeWidgetItem *item, int)
  **********************************************************************************************************************/
 void MainWindow::on_listGroups_itemClicked(QListWidgetItem *item)
 {
+    TRACE_SCOPE("gui", "cell_clicked");
+
     if(!item) {
         return;
     }
@@ -1081,6 +1223,7 @@ void MainWindow::on_listGroups_itemClicked(QListWidgetItem *item)
 
     if(QFileInfo(libPath).exists()) {
         loadViews(libPath, item->text());
+        prefetchViews(libPath, item->text());
     }
 
     m_ui->actionUnion->setEnabled(true);
@@ -1097,16 +1240,12 @@ void MainWindow::on_listCategories_itemDoubleClicked(QTreeWidgetItem *item, int
         return;
     }
 
+    m_toolSessions->beginRequest();
+
     m_itemText = item->text(column);
 
     m_ui->txtCatSearch->setText(m_itemText);
 
-    QString tool = m_properties->get<QString>("Editor");
-    if(tool.isEmpty()) {
-        error(QString("Please specify tool first."));
-        return;
-    }
-
     QString libPath = getCurrentLibraryPath();
     if(!QFileInfo(libPath).exists()) {
         return;
@@ -1117,15 +1256,12 @@ void MainWindow::on_listCategories_itemDoubleClicked(QTreeWidgetItem *item, int
         return;
     }
 
-    QProcess proc;
-    QStringList args;
-    args<<catFile;
-
-    proc.startDetached(tool, args);
+    openFiles("Editor", QStringList()<<catFile);
 }
 
 /*!*******************************************************************************************************************
- * \brief Slot to execute a tool based on the selected item (schematic, layout, cdl, spice, etc.).
+ * \brief Slot to execute a tool based on the selected item (schematic, layout, cdl, spice, etc.). If several cells or
+ * views are selected, the selected views of all selected cells are opened.
  * \param item       Pointer to list item view.
  **********************************************************************************************************************/
 void MainWindow::on_listViews_itemDoubleClicked(QListWidgetItem *item)
@@ -1143,24 +1279,121 @@ void MainWindow::on_listViews_itemDoubleClicked(QListWidgetItem *item)
         return;
     }
 
-    QString viewPath = getCurrentViewFilePath(viewName);
-    if(!QFileInfo(viewPath).exists()) {
-        error(QString("Failed to find view '%1'").arg(viewPath));
+    QStringList viewNames;
+    if(item->isSelected()) {
+        foreach(QListWidgetItem *viewItem, m_ui->listViews->selectedItems()) {
+            viewNames<<viewItem->text();
+        }
+    }
+    else {
+        viewNames<<viewName;
+    }
+
+    openViews(viewNames);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Opens the views with the given names of all selected groups (cells). Views using the same tool are passed
+ * to it at once, following the file arguments of the tool set in the tool manager. A netlist above the preview size
+ * is shown in the preview panel instead.
+ * \param viewNames     Names of the views.
+ **********************************************************************************************************************/
+void MainWindow::openViews(const QStringList &viewNames)
+{
+    TRACE_SCOPE("gui", "open_views");
+
+    m_toolSessions->beginRequest();
+
+    QString libPath = getCurrentLibraryPath();
+    if(!QFileInfo(libPath).exists()) {
+        return;
+    }
+
+    QStringList groupNames = getSelectedGroupNames();
+    if(groupNames.isEmpty()) {
         return;
     }
 
+    QMap<QString, QStringList> toolPaths;
+    QStringList missingPaths;
+    QStringList previewPaths;
 
-    QString tool = getToolByView(viewName);
+    qint64 previewSize = PreviewPanel::getThreshold();
+
+    foreach(const QString &viewName, viewNames) {
+        foreach(const QString &groupName, groupNames) {
+            QString viewPath = getViewPath(libPath, groupName, viewName);
+
+            QFileInfo viewInfo(viewPath);
+            if(!viewInfo.exists()) {
+                missingPaths<<viewPath;
+            }
+            else if(NetlistParser::isNetlistView(viewName) && previewSize >= 0 && viewInfo.size() >= previewSize) {
+                previewPaths<<viewPath;
+            }
+            else {
+                toolPaths[getToolKeyByView(viewName)]<<viewPath;
+            }
+        }
+    }
+
+    if(!missingPaths.isEmpty()) {
+        error(QString("Failed to find view '%1'\n").arg(missingPaths.join("', '")));
+    }
+
+    if(!previewPaths.isEmpty()) {
+        previewFile(previewPaths.takeFirst());
+    }
+
+    if(!previewPaths.isEmpty()) {
+        info(QString("Only one netlist is previewed at a time, skipped '%1'.").arg(previewPaths.join("', '")), false);
+    }
+
+    QMap<QString, QStringList>::const_iterator it;
+    for(it = toolPaths.constBegin(); it != toolPaths.constEnd(); ++it) {
+        openFiles(it.key(), it.value());
+    }
+}
+
+/*!*******************************************************************************************************************
+ * \brief Opens files with the tool of the given settings key, using the file arguments and the number of files per
+ * launch set for the tool in the tool manager.
+ * \param toolKey       Settings key of the tool, e.g. 'Layout'.
+ * \param paths         Files to open.
+ **********************************************************************************************************************/
+void MainWindow::openFiles(const QString &toolKey, const QStringList &paths)
+{
+    QString tool = m_properties->get<QString>(toolKey);
     if(tool.isEmpty()) {
-        error(QString("Please specify tool first."));
+        error(QString("Please specify tool first.\n"), false);
+        return;
+    }
+
+    m_toolSessions->open(tool, paths, m_properties->get<QString>(toolKey + "FileArguments"),
+                         m_properties->get<int>(toolKey + "FilesPerLaunch"));
+}
+
+/*!*******************************************************************************************************************
+ * \brief Shows the file in the preview panel at once. Subcircuits are listed by a background job if the file is in
+ * the netlist index and has not changed since.
+ * \param path          Path to the netlist or cell list.
+ **********************************************************************************************************************/
+void MainWindow::previewFile(const QString &path)
+{
+    TRACE_SCOPE_ARG("gui", "preview_file", path);
+
+    if(!m_previewPanel->open(path)) {
+        foreach(const QString &explain, m_previewPanel->getErrors()) {
+            error(explain + "\n", false);
+        }
+
         return;
     }
 
-    QProcess proc;
-    QStringList args;
-    args<<viewPath;
+    m_previewPanel->show();
+    m_previewPanel->raise();
 
-    proc.startDetached(tool, args);
+    m_backgroundQueue->start(new PreviewSubcktsJob(this, path));
 }
 
 /*!*******************************************************************************************************************
@@ -1218,6 +1451,8 @@ void MainWindow::on_listDocumentation_itemDoubleClicked(QTreeWidgetItem *item)
         return;
     }
 
+    m_toolSessions->beginRequest();
+
     m_itemText = item->text(0);
 
     QString docName = item->text(0);
@@ -1231,18 +1466,13 @@ void MainWindow::on_listDocumentation_itemDoubleClicked(QTreeWidgetItem *item)
         return;
     }
 
-
-    QString tool = getDocumentTool(docName);
-    if(tool.isEmpty()) {
-        error(QString("Please specify tool first."));
+    qint64 previewSize = PreviewPanel::getThreshold();
+    if(docPath.endsWith(".celllist") && previewSize >= 0 && QFileInfo(docPath).size() >= previewSize) {
+        previewFile(docPath);
         return;
     }
 
-    QProcess proc;
-    QStringList args;
-    args<<docPath;
-
-    proc.startDetached(tool, args);
+    openFiles(getDocumentToolKey(docName), QStringList()<<docPath);
 }
 
 /*!*******************************************************************************************************************
@@ -1441,64 +1671,7 @@ QTreeWidgetItem* MainWindow::getTreeItemByName(const QString &name)
  **********************************************************************************************************************/
 QString MainWindow::getProjectFileFromDir(const QString &dirName) const
 {
-    QString projFile;
-
-    QStringList formats;
-    formats<<"*.projects";
-
-    QDir projDir(dirName);
-    projDir.setNameFilters(formats);
-
-    QStringList fileList = projDir.entryList();
-    foreach(QString projName, fileList) {
-        QString projPath = QDir::toNativeSeparators(dirName + "/" + projName);
-        if(QFileInfo(projPath).isFile()) {
-            QFile file(projPath);
-            if(!file.open(QFile::ReadOnly | QFile::Text)) {
-                return projFile;
-            }
-
-            QTextStream in(&file);
-            while (!in.atEnd()) {
-                QString line = in.readLine().remove("^\\s+").remove("\\s+$");
-
-                if(line.startsWith("#")) {
-                    continue;
-                }
-
-                if(line.contains("PROJECT")) {
-                    #if QT_VERSION >= 0x050000
-                        QStringList words = line.split(" ", Qt::SkipEmptyParts);
-                    #else
-                        QStringList words = line.split(" ", QString::SkipEmptyParts);
-                    #endif
-                    if(words.count() == 3) {
-                        projFile = projPath;
-                        break;
-                    }
-                }
-                else if(line.contains("GROUP")) {
-                    #if QT_VERSION >= 0x050000
-                        QStringList words = line.split(" ", Qt::SkipEmptyParts);
-                    #else
-                        QStringList words = line.split(" ", QString::SkipEmptyParts);
-                    #endif
-                    if(words.count() > 1) {
-                        projFile = projPath;
-                        break;
-                    }
-                }
-            }
-
-            file.close();
-
-            if(!projFile.isEmpty()) {
-                return projFile;
-            }
-        }
-    }
-
-    return projFile;
+    return Catalog::getProjectFileFromDir(dirName);
 }
 
 /*!*******************************************************************************************************************
@@ -1508,6 +1681,9 @@ QString MainWindow::getProjectFileFromDir(const QString &dirName) const
  **********************************************************************************************************************/
 void MainWindow::hideTreeItem(QTreeWidget *tree, const QString &filter)
 {
+    TRACE_SCOPE_ARG("gui", "filter", filter);
+    PerfTimer perfTimer(PerfCounters::FILTER_LATENCY);
+
     if(!tree) {
         return;
     }
@@ -1531,9 +1707,13 @@ void MainWindow::hideTreeItem(QTreeWidget *tree, const QString &filter)
  * \brief Hides list item during filtering.
  * \param list       List pointer used for filtering.
  * \param filter     Text string used to filter list items.
+ * \param cs         Case sensitivity of the comparison.
  **********************************************************************************************************************/
-void MainWindow::hideListItem(QListWidget *list, const QString &filter)
+void MainWindow::hideListItem(QListWidget *list, const QString &filter, Qt::CaseSensitivity cs)
 {
+    TRACE_SCOPE_ARG("gui", "filter", filter);
+    PerfTimer perfTimer(PerfCounters::FILTER_LATENCY);
+
     if(!list) {
         return;
     }
@@ -1549,7 +1729,75 @@ void MainWindow::hideListItem(QListWidget *list, const QString &filter)
             continue;
         }
 
-        item->setHidden(item->text().contains(filter) ? false : true);
+        item->setHidden(item->text().contains(filter, cs) ? false : true);
+    }
+}
+
+/*!*******************************************************************************************************************
+ * \brief Filters groups (cells) of the selected library by all search boxes: the category named in the category box,
+ * every view named in the view box and the cell box as case insensitive name pattern ('*' and '?' are wildcards,
+ * otherwise the name has to contain the text). The conditions are evaluated by CellFilter on bit sets, which are
+ * built on first use for the library and again when a listed cell has no id; without category, views and wildcards
+ * only the names of the listed cells are compared.
+ **********************************************************************************************************************/
+void MainWindow::filterGroups()
+{
+    QString pattern = m_ui->txtCellSearch->text();
+    QString catName = m_ui->txtCatSearch->text().trimmed();
+
+    QStringList viewNames;
+    QStringList validViews = getValidViewList();
+    foreach(const QString &word, Catalog::splitLine(m_ui->txtViewSearch->text())) {
+        if(validViews.contains(word)) {
+            viewNames<<word;
+        }
+    }
+
+    QString libPath = getCurrentLibraryPath();
+    if(!QFileInfo(libPath).isDir() || (catName.isEmpty() && viewNames.isEmpty() && !CellFilter::isWildcard(pattern))) {
+        hideListItem(m_ui->listGroups, pattern, Qt::CaseInsensitive);
+        return;
+    }
+
+    TRACE_SCOPE_ARG("gui", "filter_cells", pattern);
+    PerfTimer perfTimer(PerfCounters::FILTER_LATENCY);
+
+    // Cells added or renamed since the bit sets were built have no id, number them again.
+    if(m_cellFilter->getLibraryPath() == libPath) {
+        for(int i = 0; i < m_ui->listGroups->count(); ++i) {
+            QListWidgetItem *item = m_ui->listGroups->item(i);
+            if(item && m_cellFilter->getCellId(item->text()) < 0) {
+                m_cellFilter->clear();
+                break;
+            }
+        }
+    }
+
+    if(m_cellFilter->getLibraryPath() != libPath) {
+        QMap<QString, QStringList> categories;
+        foreach(const QString &name, m_catalog->getCategories(libPath)) {
+            categories[name] = m_catalog->readCategory(libPath, name);
+        }
+
+        m_catalog->clearErrors();
+        m_cellFilter->build(libPath, m_catalog->scanLibrary(libPath), categories);
+    }
+
+    // Text which does not name a category yet only filters the category list.
+    if(!m_cellFilter->hasCategory(catName)) {
+        catName.clear();
+    }
+
+    QBitArray cells = m_cellFilter->filter(catName, viewNames, pattern);
+
+    for(int i = 0; i < m_ui->listGroups->count(); ++i) {
+        QListWidgetItem *item = m_ui->listGroups->item(i);
+        if(!item) {
+            continue;
+        }
+
+        int id = m_cellFilter->getCellId(item->text());
+        item->setHidden(id < 0 || !cells.testBit(id));
     }
 }
 
@@ -1563,30 +1811,32 @@ void MainWindow::on_txtLibSearch_textEdited(const QString &filter)
 }
 
 /*!*******************************************************************************************************************
- * \brief Filters categories based on user input.
+ * \brief Filters categories based on user input. Text naming a category also limits the groups (cells).
  * \param filter     Text string used to filter categories.
  **********************************************************************************************************************/
 void MainWindow::on_txtCatSearch_textEdited(const QString &filter)
 {
     hideTreeItem(m_ui->listCategories, filter);
+    filterGroups();
 }
 
 /*!*******************************************************************************************************************
- * \brief Filters groups (cells) based on user input.
- * \param filter     Text string used to filter groups (cells).
+ * \brief Filters groups (cells) based on user input, the text is read by filterGroups() together with the other boxes.
  **********************************************************************************************************************/
-void MainWindow::on_txtCellSearch_textEdited(const QString &filter)
+void MainWindow::on_txtCellSearch_textEdited(const QString &)
 {
-    hideListItem(m_ui->listGroups, filter);
+    filterGroups();
 }
 
 /*!*******************************************************************************************************************
- * \brief Filters views based on user input.
+ * \brief Filters views based on user input. View names also limit the groups (cells) to those having all of them.
  * \param filter     Text string used to filter views.
  **********************************************************************************************************************/
 void MainWindow::on_txtViewSearch_textEdited(const QString &filter)
 {
-    hideListItem(m_ui->listViews, filter);
+    // Several view names are conditions for the cells, the views of the cell stay visible.
+    hideListItem(m_ui->listViews, Catalog::splitLine(filter).count() > 1 ? QString() : filter);
+    filterGroups();
 }
 
 /*!*******************************************************************************************************************
@@ -1653,6 +1903,7 @@ void MainWindow::on_actionSession_triggered()
    m_ui->treeLibs->clear();
    m_ui->listViews->clear();
    m_ui->listGroups->clear();
+   m_cellFilter->clear();
    m_ui->listCategories->clear();
    m_ui->listDocumentation->clear();
 
@@ -1664,6 +1915,10 @@ void MainWindow::on_actionSession_triggered()
 
    m_properties = new Properties;
 
+   m_catalog->setClient(0);
+   m_client->disconnectFromDaemon();
+   m_catalog->clear();
+
    loadSettings();
 
    setWindowTitle(getLibManTitle());
@@ -1,9 +1,21 @@
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 
+#include <QMap>
 #include <QMainWindow>
 
+class Catalog;
+class CatalogClient;
 class Properties;
+class PerfPanel;
+class LaunchPanel;
+class PreviewPanel;
+class NetlistIndex;
+class NetlistGraph;
+class CellFilter;
+class ToolSessions;
+class ViewPrefetch;
+class BackgroundQueue;
 class QTreeWidget;
 class QListWidget;
 class QListWidgetItem;
@@ -21,6 +33,9 @@ class MainWindow : public QMainWindow
     Q_OBJECT
 
     friend class NewView;
+    friend class BackgroundJob;
+    friend class PreviewSubcktsJob;
+    friend class LibManBench;
     friend class ProjectManager;
 
     /*!
@@ -50,6 +65,7 @@ private slots:
     void                                showGroupMenu(const QPoint &pos);
     void                                showLibraryMenu(const QPoint &pos);
     void                                showCategoryMenu(const QPoint &pos);
+    void                                showToolMessage(const QString &msg, bool isError);
 
     void                                addNewGroup();
     void                                addNewProject();
@@ -63,11 +79,20 @@ private slots:
     void                                removeSelectedCategory();
     void                                showViewInfo();
     void                                showGroupInfo();
+    void                                showGroupUsage();
     void                                showProjectInfo();
+    void                                checkProjectViews();
+    void                                importNetlist();
     void                                showCategoryInfo();
     void                                removeFromGroup();
     void                                removeGroupUnion();
     void                                showFolderInfo(const QString &, const QString &, const QString &, bool clear = true);
+    void                                showNetlistInfo(const QString &, const QString &, const QStringList &);
+    void                                showLibertyInfo(const QString &, const QString &);
+    void                                showLefInfo(const QString &, const QString &);
+    void                                compareView();
+    void                                openSelectedViews();
+    void                                previewSelectedView();
     void                                mergeProjectIntoGroup();
 
     void                                pasteSelectedData();
@@ -122,6 +147,11 @@ private:
     void                                info(const QString &msg, bool clear = true);
     void                                error(const QString &msg, bool clear = true);
 
+    void                                openViews(const QStringList &viewNames);
+    void                                openFiles(const QString &toolKey, const QStringList &paths);
+    void                                previewFile(const QString &path);
+    void                                prefetchViews(const QString &libPath, const QString &groupName);
+
     void                                initRecentProjectMenu();
 
     bool                                createNewFile(const QString &);
@@ -142,7 +172,9 @@ private:
     void                                loadViews(const QString &libPath, const QString &groupName);
 
     void                                hideTreeItem(QTreeWidget *, const QString &filter);
-    void                                hideListItem(QListWidget *, const QString &filter);
+    void                                hideListItem(QListWidget *, const QString &filter,
+                                                     Qt::CaseSensitivity cs = Qt::CaseSensitive);
+    void                                filterGroups();
 
     bool                                isViewCopied() const;
     bool                                isGroupCopied() const;
@@ -165,6 +197,7 @@ private:
 
     QString                             getCurrentViewName() const;
     QString                             getCurrentGroupName() const;
+    QStringList                         getSelectedGroupNames() const;
     QString                             getCurrentUnionName() const;
     QString                             getCurrentWorkingDir() const;    
     QString                             getCurrentLibraryName() const;
@@ -177,7 +210,9 @@ private:
 
     QString                             getSettingsHeaderName() const;
     QString                             getToolByView(const QString &) const;
+    QString                             getToolKeyByView(const QString &) const;
     QString                             getDocumentTool(const QString &) const;
+    QString                             getDocumentToolKey(const QString &) const;
 
     QString                             getLibManTitle() const;
 
@@ -193,6 +228,17 @@ private:
 private:
     Ui::MainWindow                      *m_ui;                  /*!< A pointer to acess ProjectManager graphic items. */
     Properties                          *m_properties;          /*!< A pointer to acess Properties collection with all settings. */
+    Catalog                             *m_catalog;             /*!< A pointer to acess project file and library scanning logic. */
+    CatalogClient                       *m_client;              /*!< A pointer to acess catalog daemon if it serves the project. */
+    PerfPanel                           *m_perfPanel;           /*!< A pointer to acess performance counters panel. */
+    LaunchPanel                         *m_launchPanel;         /*!< A pointer to acess history of tool launches panel. */
+    PreviewPanel                        *m_previewPanel;        /*!< A pointer to acess read-only preview of large netlists and cell lists. */
+    NetlistIndex                        *m_netlistIndex;        /*!< A pointer to acess subcircuits of netlist views, loaded on first use by a background job. */
+    NetlistGraph                        *m_netlistGraph;        /*!< A pointer to acess instantiations between subcircuits of all libraries. */
+    CellFilter                          *m_cellFilter;          /*!< A pointer to acess bit sets of the selected library used by the search boxes. */
+    ToolSessions                        *m_toolSessions;        /*!< A pointer to acess running tool sessions opening views and documents. */
+    ViewPrefetch                        *m_viewPrefetch;        /*!< A pointer to acess background page cache warm-up of the views of the selected cell. */
+    BackgroundQueue                     *m_backgroundQueue;     /*!< A pointer to acess jobs running netlist, Liberty and LEF scans outside of the UI thread. */
 
     bool                                m_isStateChanged;       /*!< State to keep if LibMan was changed or not. */
 
@@ -202,6 +248,9 @@ private:
 
     QList<QAction*>                     m_recentProjects;       /*!< List of existing recent project files. */
 
+    QMap<QString, QList<QStringList> >  m_netlistViews;         /*!< Netlist views per library path, listed by background jobs for where-used queries. */
+    QMap<QString, QString>              m_netlistStamps;        /*!< Modification times of the netlist view folders per library path when they were listed. */
+
     QStringList                         m_copyData;             /*!< A list used as a buffer for coping data (library/cell/view). */
     COPY_STATE                          m_currentCopyState;     /*!< State to specify what user would like to copy (library/cell/view). */
 };
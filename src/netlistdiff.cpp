@@ -0,0 +1,525 @@
+#include <QMap>
+#include <QHash>
+#include <QFile>
+#include <QBuffer>
+#include <QIODevice>
+#include <QCryptographicHash>
+
+#include "netlistdiff.h"
+#include "netlistparser.h"
+#include "perfcounters.h"
+#include "trace.h"
+
+/*!*********************************************************************************************************************
+ * \brief The StatementReader class reads statements of a netlist with their continuation lines joined and their tokens
+ * separated by single blanks. Comments are dropped except '*.PININFO' and the byte range of every statement is kept.
+ **********************************************************************************************************************/
+class StatementReader
+{
+public:
+    explicit StatementReader(QIODevice *device)
+        : m_device(device), m_position(0), m_start(0), m_end(0), m_pendingStart(0), m_pendingEnd(0),
+          m_isPendingPinInfo(false) {}
+
+    bool                                next(QByteArray *statement);
+
+    qint64                              getStart() const { return m_start; }
+    qint64                              getEnd() const { return m_end; }
+    qint64                              getBytes() const { return m_position; }
+
+private:
+    QIODevice                           *m_device;          /*!< Device to read from. */
+    qint64                              m_position;         /*!< Number of bytes read from the device. */
+    qint64                              m_start;            /*!< Offset of the first line of the last statement. */
+    qint64                              m_end;              /*!< Offset after the last line of the last statement. */
+    QByteArray                          m_pending;          /*!< Line read ahead, it starts the next statement. */
+    qint64                              m_pendingStart;     /*!< Offset of the line read ahead. */
+    qint64                              m_pendingEnd;       /*!< Offset after the line read ahead. */
+    bool                                m_isPendingPinInfo; /*!< State if the line read ahead is '*.PININFO'. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Reads the next statement. A statement ends with the next line which is neither a comment nor a continuation.
+ * \param statement     Statement to fill.
+ * \return              False at the end of the device.
+ **********************************************************************************************************************/
+bool StatementReader::next(QByteArray *statement)
+{
+    QByteArray text = m_pending;
+    bool isPinInfo = m_isPendingPinInfo;
+    m_start = m_pendingStart;
+    m_end = m_pendingEnd;
+    m_pending.clear();
+
+    while(!m_device->atEnd()) {
+        qint64 lineStart = m_position;
+
+        QByteArray line = m_device->readLine();
+        if(line.isEmpty()) {
+            break;
+        }
+
+        m_position += line.size();
+
+        NetlistParser::stripComment(line);
+        line = line.trimmed();
+        if(line.isEmpty()) {
+            continue;
+        }
+
+        bool isContinuation = line[0] == '+' || (isPinInfo && line.size() > 1 && line[0] == '*' && line[1] == '+');
+        bool isNewPinInfo = line.size() >= 9 && qstrnicmp(line.constData(), "*.PININFO", 9) == 0;
+
+        if(isContinuation) {
+            if(!text.isEmpty()) {
+                text += ' ';
+                text += line.mid(line[0] == '+' ? 1 : 2);
+                m_end = m_position;
+            }
+
+            continue;
+        }
+
+        if(line[0] == '*' && !isNewPinInfo) {
+            continue;
+        }
+
+        if(!text.isEmpty()) {
+            m_pending = line;
+            m_pendingStart = lineStart;
+            m_pendingEnd = m_position;
+            m_isPendingPinInfo = isNewPinInfo;
+            break;
+        }
+
+        text = line;
+        isPinInfo = isNewPinInfo;
+        m_start = lineStart;
+        m_end = m_position;
+    }
+
+    if(text.isEmpty()) {
+        return false;
+    }
+
+    QList<QByteArray> tokens = NetlistParser::splitTokens(text);
+
+    statement->clear();
+    for(int i = 0; i < tokens.count(); ++i) {
+        if(i > 0) {
+            *statement += ' ';
+        }
+
+        *statement += tokens[i];
+    }
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns tokens joined by blanks.
+ * \param tokens        Tokens to join.
+ **********************************************************************************************************************/
+static QString joinTokens(const QList<QByteArray> &tokens)
+{
+    QStringList items;
+    foreach(const QByteArray &token, tokens) {
+        items<<QString::fromLocal8Bit(token);
+    }
+
+    return items.join(" ");
+}
+
+/*!*********************************************************************************************************************
+ * \brief Splits tokens of a statement into connections and parameters. Parameters are 'name=value', 'name = value'
+ * or 'name =value'; a 'PARAMS:' keyword is dropped.
+ * \param tokens        Tokens of the statement.
+ * \param first         Index of the first token after the name.
+ * \param connections   Nodes, models and instance types in the order of the statement.
+ * \param parameters    Map of lower case parameter names to values.
+ **********************************************************************************************************************/
+static void splitStatement(const QList<QByteArray> &tokens, int first, QList<QByteArray> *connections,
+                           QMap<QByteArray, QByteArray> *parameters)
+{
+    for(int i = first; i < tokens.count(); ++i) {
+        QByteArray upper = tokens[i].toUpper();
+        if(upper == "PARAM:" || upper == "PARAMS:") {
+            continue;
+        }
+
+        if(!NetlistParser::isParameter(tokens, i)) {
+            *connections<<tokens[i];
+            continue;
+        }
+
+        QByteArray name = tokens[i];
+        QByteArray value;
+
+        int equal = name.indexOf('=');
+        if(equal >= 0) {
+            value = name.mid(equal + 1);
+            name = name.left(equal);
+
+            if(value.isEmpty() && i + 1 < tokens.count()) {
+                value = tokens[++i];
+            }
+        }
+        else if(tokens[i + 1] == "=") {
+            value = tokens.value(i + 2);
+            i += 2;
+        }
+        else {
+            value = tokens[i + 1].mid(1);
+            i += 1;
+        }
+
+        (*parameters)[name.toLower()] = value;
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Describes the differences of two statements of the same name.
+ * \param oldTokens     Tokens of the old statement.
+ * \param newTokens     Tokens of the new statement.
+ * \param first         Index of the first token after the name.
+ * \param label         Word used for the connections, e.g. 'ports' or 'connections'.
+ * \return              Differences separated by '; ', empty if the statements are equal.
+ **********************************************************************************************************************/
+static QString describeChange(const QList<QByteArray> &oldTokens, const QList<QByteArray> &newTokens, int first,
+                              const QString &label)
+{
+    QList<QByteArray> oldConnections;
+    QList<QByteArray> newConnections;
+    QMap<QByteArray, QByteArray> oldParameters;
+    QMap<QByteArray, QByteArray> newParameters;
+
+    splitStatement(oldTokens, first, &oldConnections, &oldParameters);
+    splitStatement(newTokens, first, &newConnections, &newParameters);
+
+    QStringList parts;
+
+    if(oldConnections != newConnections) {
+        parts<<QString("%1: %2 -> %3").arg(label).arg(joinTokens(oldConnections))
+               .arg(joinTokens(newConnections));
+    }
+
+    QMap<QByteArray, QByteArray>::const_iterator it;
+    for(it = oldParameters.constBegin(); it != oldParameters.constEnd(); ++it) {
+        if(!newParameters.contains(it.key())) {
+            parts<<QString("-%1=%2").arg(QString::fromLocal8Bit(it.key())).arg(QString::fromLocal8Bit(it.value()));
+        }
+        else if(newParameters.value(it.key()) != it.value()) {
+            parts<<QString("%1: %2 -> %3").arg(QString::fromLocal8Bit(it.key()))
+                   .arg(QString::fromLocal8Bit(it.value()))
+                   .arg(QString::fromLocal8Bit(newParameters.value(it.key())));
+        }
+    }
+
+    for(it = newParameters.constBegin(); it != newParameters.constEnd(); ++it) {
+        if(!oldParameters.contains(it.key())) {
+            parts<<QString("+%1=%2").arg(QString::fromLocal8Bit(it.key())).arg(QString::fromLocal8Bit(it.value()));
+        }
+    }
+
+    return parts.join("; ");
+}
+
+/*!*********************************************************************************************************************
+ * \brief The Body struct keeps the statements of a subcircuit by their role.
+ **********************************************************************************************************************/
+struct Body {
+    QList<QByteArray>                   header;             /*!< Tokens of the '.SUBCKT' statement. */
+    QList<QByteArray>                   pinInfo;            /*!< Tokens of '*.PININFO' statements. */
+    QList<QByteArray>                   order;              /*!< Keys of the elements in the order of definition. */
+    QHash<QByteArray, QList<QByteArray> > elements;         /*!< Map of upper case element names to their tokens. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Sorts statements of a subcircuit into header, pin directions and elements. Statements of nested subcircuits
+ * are skipped, other control statements are keyed by their whole text.
+ * \param statements    Statements from '.SUBCKT' to '.ENDS', or statements outside of subcircuits.
+ **********************************************************************************************************************/
+static Body getBody(const QList<QByteArray> &statements)
+{
+    Body body;
+    int depth = 0;
+
+    foreach(const QByteArray &statement, statements) {
+        QList<QByteArray> tokens = NetlistParser::splitTokens(statement);
+        if(tokens.isEmpty()) {
+            continue;
+        }
+
+        QByteArray keyword = tokens[0].toLower();
+
+        if(keyword == ".subckt") {
+            if(++depth == 1) {
+                body.header = tokens;
+            }
+
+            continue;
+        }
+
+        if(keyword == ".ends") {
+            depth--;
+            continue;
+        }
+
+        if(depth > 1) {
+            continue;
+        }
+
+        if(keyword == "*.pininfo") {
+            body.pinInfo<<tokens.mid(1);
+            continue;
+        }
+
+        QByteArray key = keyword.startsWith('.') ? statement : tokens[0].toUpper();
+        if(!body.elements.contains(key)) {
+            body.order<<key;
+        }
+
+        body.elements[key] = tokens;
+    }
+
+    return body;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Constructs an empty diff.
+ **********************************************************************************************************************/
+NetlistDiff::NetlistDiff()
+    : m_identicalCount(0)
+{
+}
+
+/*!*********************************************************************************************************************
+ * \brief Compares two versions of a netlist. Subcircuits are matched by name, case insensitive.
+ * \param oldFile       Path to the old version.
+ * \param newFile       Path to the new version.
+ * \return              True if both files have been read, otherwise false and the reasons are in the error list.
+ **********************************************************************************************************************/
+bool NetlistDiff::diff(const QString &oldFile, const QString &newFile)
+{
+    TRACE_SCOPE_ARG("netlist", "diff", newFile);
+
+    m_changes.clear();
+    m_identicalCount = 0;
+    m_errorList.clear();
+
+    Version oldVersion;
+    Version newVersion;
+
+    bool isScanned = scan(oldFile, &oldVersion);
+    isScanned = scan(newFile, &newVersion) && isScanned;
+
+    if(!isScanned) {
+        return false;
+    }
+
+    QHash<QString, int> oldIds;
+    for(int i = 0; i < oldVersion.subckts.count(); ++i) {
+        oldIds.insert(oldVersion.subckts[i].name.toUpper(), i);
+    }
+
+    QHash<QString, int> newIds;
+    for(int i = 0; i < newVersion.subckts.count(); ++i) {
+        newIds.insert(newVersion.subckts[i].name.toUpper(), i);
+    }
+
+    if(oldVersion.topStatements != newVersion.topStatements) {
+        compare("", oldVersion.topStatements, newVersion.topStatements);
+    }
+
+    foreach(const Subckt &subckt, oldVersion.subckts) {
+        if(!newIds.contains(subckt.name.toUpper())) {
+            addChange(subckt.name, "removed", "", "");
+        }
+    }
+
+    foreach(const Subckt &subckt, newVersion.subckts) {
+        QHash<QString, int>::const_iterator it = oldIds.constFind(subckt.name.toUpper());
+        if(it == oldIds.constEnd()) {
+            addChange(subckt.name, "added", "", "");
+            continue;
+        }
+
+        const Subckt &oldSubckt = oldVersion.subckts[it.value()];
+        if(oldSubckt.hash == subckt.hash) {
+            m_identicalCount++;
+            continue;
+        }
+
+        compare(subckt.name, readStatements(oldVersion, oldSubckt), readStatements(newVersion, subckt));
+    }
+
+    return m_errorList.isEmpty();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns names of the report columns.
+ **********************************************************************************************************************/
+QStringList NetlistDiff::getColumns()
+{
+    return QStringList()<<"subckt"<<"change"<<"item"<<"detail";
+}
+
+/*!*********************************************************************************************************************
+ * \brief Streams the file once and hashes the statements of every top level subcircuit. Statements outside of
+ * subcircuits are kept as they are.
+ * \param fileName      Path to the SPICE or CDL file.
+ * \param version       Version to fill.
+ **********************************************************************************************************************/
+bool NetlistDiff::scan(const QString &fileName, Version *version)
+{
+    version->fileName = fileName;
+
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly)) {
+        m_errorList<<QString("Can not read file '%1':\n%2.").arg(fileName).arg(file.errorString());
+        return false;
+    }
+
+    StatementReader reader(&file);
+    QCryptographicHash hash(QCryptographicHash::Md5);
+
+    Subckt subckt;
+    QByteArray statement;
+    int depth = 0;
+
+    while(reader.next(&statement)) {
+        int space = statement.indexOf(' ');
+        QByteArray keyword = (space < 0 ? statement : statement.left(space)).toLower();
+
+        if(depth > 0) {
+            hash.addData(statement);
+            hash.addData("\n", 1);
+        }
+
+        if(keyword == ".subckt") {
+            if(depth == 0) {
+                subckt.name = QString::fromLocal8Bit(NetlistParser::splitTokens(statement).value(1));
+                subckt.offset = reader.getStart();
+
+                hash.reset();
+                hash.addData(statement);
+                hash.addData("\n", 1);
+            }
+
+            depth++;
+        }
+        else if(keyword == ".ends") {
+            if(depth == 0) {
+                m_errorList<<QString("'.ENDS' without '.SUBCKT' at offset %1 of '%2'.").arg(reader.getStart())
+                             .arg(fileName);
+                continue;
+            }
+
+            if(--depth == 0) {
+                subckt.length = reader.getEnd() - subckt.offset;
+                subckt.hash = hash.result();
+                version->subckts<<subckt;
+            }
+        }
+        else if(depth == 0 && keyword != ".end") {
+            version->topStatements<<statement;
+        }
+    }
+
+    if(depth > 0) {
+        m_errorList<<QString("Subcircuit '%1' of '%2' is not closed by '.ENDS'.").arg(subckt.name).arg(fileName);
+    }
+
+    PerfCounters::add(PerfCounters::FILES_READ);
+    PerfCounters::add(PerfCounters::BYTES_READ, reader.getBytes());
+
+    return depth == 0;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Reads the statements of a subcircuit again, only its byte range of the file is read.
+ * \param version       Version holding the subcircuit.
+ * \param subckt        Subcircuit to read.
+ **********************************************************************************************************************/
+QList<QByteArray> NetlistDiff::readStatements(const Version &version, const Subckt &subckt)
+{
+    QList<QByteArray> statements;
+
+    QFile file(version.fileName);
+    if(!file.open(QIODevice::ReadOnly) || !file.seek(subckt.offset)) {
+        m_errorList<<QString("Can not read file '%1':\n%2.").arg(version.fileName).arg(file.errorString());
+        return statements;
+    }
+
+    QByteArray text = file.read(subckt.length);
+
+    PerfCounters::add(PerfCounters::FILES_READ);
+    PerfCounters::add(PerfCounters::BYTES_READ, text.size());
+
+    QBuffer buffer(&text);
+    buffer.open(QIODevice::ReadOnly);
+
+    StatementReader reader(&buffer);
+
+    QByteArray statement;
+    while(reader.next(&statement)) {
+        statements<<statement;
+    }
+
+    return statements;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Compares two versions of a subcircuit: ports, parameters and pin directions of the header, then the elements
+ * matched by name.
+ * \param name          Name of the subcircuit, empty for statements outside of subcircuits.
+ * \param oldStatements Statements of the old version.
+ * \param newStatements Statements of the new version.
+ **********************************************************************************************************************/
+void NetlistDiff::compare(const QString &name, const QList<QByteArray> &oldStatements,
+                          const QList<QByteArray> &newStatements)
+{
+    Body oldBody = getBody(oldStatements);
+    Body newBody = getBody(newStatements);
+
+    if(oldBody.header != newBody.header) {
+        addChange(name, "changed", ".subckt", describeChange(oldBody.header, newBody.header, 2, "ports"));
+    }
+
+    if(oldBody.pinInfo != newBody.pinInfo) {
+        addChange(name, "changed", "*.pininfo", QString("%1 -> %2").arg(joinTokens(oldBody.pinInfo))
+                                                                   .arg(joinTokens(newBody.pinInfo)));
+    }
+
+    foreach(const QByteArray &key, oldBody.order) {
+        QHash<QByteArray, QList<QByteArray> >::const_iterator it = newBody.elements.constFind(key);
+        const QList<QByteArray> &oldTokens = oldBody.elements[key];
+
+        if(it == newBody.elements.constEnd()) {
+            addChange(name, "removed", QString::fromLocal8Bit(oldTokens[0]), joinTokens(oldTokens.mid(1)));
+        }
+        else if(it.value() != oldTokens) {
+            addChange(name, "changed", QString::fromLocal8Bit(oldTokens[0]),
+                      describeChange(oldTokens, it.value(), 1, "connections"));
+        }
+    }
+
+    foreach(const QByteArray &key, newBody.order) {
+        if(!oldBody.elements.contains(key)) {
+            const QList<QByteArray> &newTokens = newBody.elements[key];
+            addChange(name, "added", QString::fromLocal8Bit(newTokens[0]), joinTokens(newTokens.mid(1)));
+        }
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Adds a row to the report.
+ * \param subckt        Name of the subcircuit.
+ * \param change        'added', 'removed' or 'changed'.
+ * \param item          Element, '.subckt' or '*.pininfo', empty for the whole subcircuit.
+ * \param detail        Description of the change.
+ **********************************************************************************************************************/
+void NetlistDiff::addChange(const QString &subckt, const QString &change, const QString &item, const QString &detail)
+{
+    m_changes<<(QStringList()<<subckt<<change<<item<<detail);
+}
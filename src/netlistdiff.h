@@ -0,0 +1,85 @@
+#ifndef NETLISTDIFF_H
+#define NETLISTDIFF_H
+
+#include <QList>
+#include <QString>
+#include <QByteArray>
+#include <QStringList>
+
+/*!*********************************************************************************************************************
+ * \brief The NetlistDiff class compares two versions of a SPICE or CDL netlist structurally: added and removed
+ * subcircuits, changed ports and pin directions, added, removed and changed instances with their connections and
+ * parameters. Both files are streamed once and every top level subcircuit is hashed on its statements, so white space
+ * and comments do not count; only subcircuits whose hashes differ are read again and compared statement by statement.
+ **********************************************************************************************************************/
+class NetlistDiff
+{
+public:
+    NetlistDiff();
+
+    bool                                diff(const QString &oldFile, const QString &newFile);
+
+    QList<QStringList>                  getChanges() const;
+    int                                 getIdenticalCount() const;
+    QStringList                         getErrors() const;
+
+    static QStringList                  getColumns();
+
+private:
+    /*!
+     * \brief The Subckt struct keeps the hash and the position of a top level subcircuit.
+     */
+    struct Subckt {
+        QString                         name;               /*!< Name of the subcircuit. */
+        QByteArray                      hash;               /*!< Hash of the statements. */
+        qint64                          offset;             /*!< Offset of the '.SUBCKT' line. */
+        qint64                          length;             /*!< Bytes up to the end of the '.ENDS' line. */
+    };
+
+    /*!
+     * \brief The Version struct keeps the scanned subcircuits of a file.
+     */
+    struct Version {
+        QString                         fileName;           /*!< Path of the file. */
+        QList<Subckt>                   subckts;            /*!< Subcircuits in the order of their definition. */
+        QList<QByteArray>               topStatements;      /*!< Statements outside of subcircuits. */
+    };
+
+    bool                                scan(const QString &fileName, Version *version);
+    QList<QByteArray>                   readStatements(const Version &version, const Subckt &subckt);
+    void                                compare(const QString &name, const QList<QByteArray> &oldStatements,
+                                                const QList<QByteArray> &newStatements);
+    void                                addChange(const QString &subckt, const QString &change, const QString &item,
+                                                  const QString &detail);
+
+private:
+    QList<QStringList>                  m_changes;          /*!< Rows of subcircuit, change, item and detail. */
+    int                                 m_identicalCount;   /*!< Number of subcircuits skipped by their hash. */
+    QStringList                         m_errorList;        /*!< Errors of reading the files. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Returns rows of subcircuit, change ('added', 'removed' or 'changed'), item and detail of the last diff() call.
+ **********************************************************************************************************************/
+inline QList<QStringList> NetlistDiff::getChanges() const
+{
+    return m_changes;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns number of subcircuits found identical by their hash.
+ **********************************************************************************************************************/
+inline int NetlistDiff::getIdenticalCount() const
+{
+    return m_identicalCount;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns errors of the last diff() call.
+ **********************************************************************************************************************/
+inline QStringList NetlistDiff::getErrors() const
+{
+    return m_errorList;
+}
+
+#endif // NETLISTDIFF_H
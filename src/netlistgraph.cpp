@@ -0,0 +1,296 @@
+#include <QSet>
+
+#include "netlistgraph.h"
+#include "netlistindex.h"
+#include "trace.h"
+
+/*!*********************************************************************************************************************
+ * \brief Constructs an empty graph.
+ **********************************************************************************************************************/
+NetlistGraph::NetlistGraph()
+    : m_edgeCount(0)
+{
+}
+
+/*!*********************************************************************************************************************
+ * \brief Brings the graph up to date with the index. Edges of views which have changed since the last update are
+ * replaced in the adjacency maps, views missing in the list are taken out and unchanged views are not touched.
+ * \param index         Index the views have been brought up to date in.
+ * \param views         Rows of library, cell, view and view path of all netlist views of the graph.
+ * \return              True if the graph has changed.
+ **********************************************************************************************************************/
+bool NetlistGraph::update(const NetlistIndex &index, const QList<QStringList> &views)
+{
+    TRACE_SCOPE("netlist", "graph_update");
+
+    bool isChanged = false;
+    QSet<QString> viewPaths;
+
+    foreach(const QStringList &view, views) {
+        QString viewPath = view.value(3);
+        if(!index.contains(viewPath)) {
+            continue;
+        }
+
+        viewPaths.insert(viewPath);
+
+        NetlistIndex::View data = index.getView(viewPath);
+        QStringList location = view.mid(0, 3);
+        bool isVerilog = viewPath.endsWith(".verilog");
+
+        QMap<QString, ViewEdges>::const_iterator it = m_views.constFind(viewPath);
+        if(it != m_views.constEnd() && it->size == data.size && it->modified == data.modified
+                                    && it->location == location) {
+            continue;
+        }
+
+        if(it != m_views.constEnd()) {
+            addView(it.value(), -1);
+        }
+
+        ViewEdges viewEdges;
+        viewEdges.size = data.size;
+        viewEdges.modified = data.modified;
+        viewEdges.location = location;
+
+        foreach(const NetlistParser::Subckt &subckt, data.subckts) {
+            int parent = getNode(subckt.name, isVerilog);
+            viewEdges.defined<<parent;
+
+            QMap<QString, int>::const_iterator iit;
+            for(iit = subckt.instances.constBegin(); iit != subckt.instances.constEnd(); ++iit) {
+                Edge edge = { parent, getNode(iit.key(), isVerilog), iit.value() };
+                viewEdges.edges<<edge;
+            }
+        }
+
+        addView(viewEdges, 1);
+        m_views[viewPath] = viewEdges;
+        isChanged = true;
+    }
+
+    foreach(const QString &viewPath, m_views.keys()) {
+        if(!viewPaths.contains(viewPath)) {
+            addView(m_views.take(viewPath), -1);
+            isChanged = true;
+        }
+    }
+
+    return isChanged;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Removes all subcircuits and views.
+ **********************************************************************************************************************/
+void NetlistGraph::clear()
+{
+    m_nodeIds.clear();
+    m_nodeNames.clear();
+    m_views.clear();
+
+    m_children.clear();
+    m_parents.clear();
+    m_definitions.clear();
+    m_depths.clear();
+    m_edgeCount = 0;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if the subcircuit is defined or instantiated in any view.
+ * \param name          Name of the subcircuit.
+ **********************************************************************************************************************/
+bool NetlistGraph::contains(const QString &name) const
+{
+    int node = findNode(name);
+
+    return node >= 0 && (!m_definitions[node].isEmpty() || !m_children[node].isEmpty() || !m_parents[node].isEmpty());
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns subcircuits instantiating the subcircuit, ordered by depth.
+ * \param name          Name of the subcircuit.
+ * \param transitive    Returns all subcircuits above it in the hierarchy if true, otherwise only the direct users.
+ **********************************************************************************************************************/
+QList<NetlistGraph::Relative> NetlistGraph::getUsers(const QString &name, bool transitive)
+{
+    TRACE_SCOPE_ARG("netlist", "graph_users", name);
+
+    int node = findNode(name);
+    if(node < 0) {
+        return QList<Relative>();
+    }
+
+    return traverse(node, transitive, m_parents);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns subcircuits instantiated by the subcircuit, ordered by depth.
+ * \param name          Name of the subcircuit.
+ * \param transitive    Returns all subcircuits below it in the hierarchy if true, otherwise only the direct children.
+ **********************************************************************************************************************/
+QList<NetlistGraph::Relative> NetlistGraph::getChildren(const QString &name, bool transitive)
+{
+    TRACE_SCOPE_ARG("netlist", "graph_children", name);
+
+    int node = findNode(name);
+    if(node < 0) {
+        return QList<Relative>();
+    }
+
+    return traverse(node, transitive, m_children);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns rows of library, cell and view of all views defining the subcircuit. Subcircuits which are only
+ * instantiated, e.g. devices of the PDK, have no definitions.
+ * \param name          Name of the subcircuit.
+ **********************************************************************************************************************/
+QList<QStringList> NetlistGraph::getDefinitions(const QString &name) const
+{
+    int node = findNode(name);
+    if(node < 0) {
+        return QList<QStringList>();
+    }
+
+    return m_definitions[node];
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns number of known subcircuits.
+ **********************************************************************************************************************/
+int NetlistGraph::getNodeCount() const
+{
+    return m_nodeNames.count();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns number of distinct parent and child pairs.
+ **********************************************************************************************************************/
+int NetlistGraph::getEdgeCount() const
+{
+    return m_edgeCount;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns node of the subcircuit, a Verilog module of exactly this name first, -1 if the name is unknown.
+ * \param name          Name of the subcircuit.
+ **********************************************************************************************************************/
+int NetlistGraph::findNode(const QString &name) const
+{
+    QHash<QString, int>::const_iterator it = m_nodeIds.constFind(name);
+    if(it != m_nodeIds.constEnd()) {
+        return it.value();
+    }
+
+    return m_nodeIds.value(name.toUpper(), -1);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns node of the subcircuit, a new node is added for an unknown name.
+ * \param name              Name of the subcircuit.
+ * \param isCaseSensitive   True for modules of Verilog views, which differ in case only.
+ **********************************************************************************************************************/
+int NetlistGraph::getNode(const QString &name, bool isCaseSensitive)
+{
+    QString key = isCaseSensitive ? name : name.toUpper();
+
+    QHash<QString, int>::const_iterator it = m_nodeIds.constFind(key);
+    if(it != m_nodeIds.constEnd()) {
+        return it.value();
+    }
+
+    int node = m_nodeNames.count();
+    m_nodeIds.insert(key, node);
+    m_nodeNames<<name;
+
+    m_children.resize(node + 1);
+    m_parents.resize(node + 1);
+    m_definitions.resize(node + 1);
+    m_depths.resize(node + 1);
+    m_depths[node] = -1;
+
+    return node;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Adds the definitions and edges of a view to the adjacency maps or takes them out. Instance numbers of the same
+ * parent and child found in several views are summed up; a pair is removed once its number drops to zero.
+ * \param view          Part of the graph of the view.
+ * \param sign          1 to add the view, -1 to take it out.
+ **********************************************************************************************************************/
+void NetlistGraph::addView(const ViewEdges &view, int sign)
+{
+    foreach(int node, view.defined) {
+        if(sign > 0) {
+            m_definitions[node]<<view.location;
+        }
+        else {
+            m_definitions[node].removeOne(view.location);
+        }
+    }
+
+    foreach(const Edge &edge, view.edges) {
+        QMap<int, int> &children = m_children[edge.parent];
+        QMap<int, int> &parents = m_parents[edge.child];
+
+        int count = children.value(edge.child) + sign * edge.count;
+
+        if(count > 0) {
+            if(!children.contains(edge.child)) {
+                ++m_edgeCount;
+            }
+
+            children[edge.child] = count;
+            parents[edge.parent] = count;
+        }
+        else if(children.remove(edge.child)) {
+            parents.remove(edge.parent);
+            --m_edgeCount;
+        }
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Walks the graph breadth first from the node, so every subcircuit is reported once with its shortest depth.
+ * \param node          Node to start from.
+ * \param transitive    Walks all levels if true, otherwise only the first one.
+ * \param edges         Instance numbers of the adjacent nodes of every node in the walked direction.
+ **********************************************************************************************************************/
+QList<NetlistGraph::Relative> NetlistGraph::traverse(int node, bool transitive, const QVector<QMap<int, int> > &edges)
+{
+    QList<Relative> relatives;
+
+    QVector<int> queue;
+    queue<<node;
+    m_depths[node] = 0;
+
+    for(int head = 0; head < queue.count(); ++head) {
+        int current = queue[head];
+        int depth = m_depths[current];
+
+        if(!transitive && depth > 0) {
+            break;
+        }
+
+        QMap<int, int>::const_iterator it;
+        for(it = edges[current].constBegin(); it != edges[current].constEnd(); ++it) {
+            int target = it.key();
+            if(m_depths[target] >= 0) {
+                continue;
+            }
+
+            m_depths[target] = depth + 1;
+            queue<<target;
+
+            Relative relative = { m_nodeNames[target], depth + 1, it.value() };
+            relatives<<relative;
+        }
+    }
+
+    // Only reached nodes are reset, so a query does not depend on the size of the graph.
+    foreach(int reached, queue) {
+        m_depths[reached] = -1;
+    }
+
+    return relatives;
+}
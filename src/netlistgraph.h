@@ -0,0 +1,83 @@
+#ifndef NETLISTGRAPH_H
+#define NETLISTGRAPH_H
+
+#include <QMap>
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include <QString>
+#include <QStringList>
+
+class NetlistIndex;
+
+/*!*********************************************************************************************************************
+ * \brief The NetlistGraph class links subcircuits of all indexed netlist views by their instances, across library
+ * boundaries. Subcircuits are matched by name, case insensitive as in SPICE; modules of Verilog views are matched case
+ * sensitive, so only an upper case module name meets SPICE subcircuits. Edges are kept per view; when a view
+ * changes, only its old edges are taken out of the adjacency maps of both directions and its new edges are added, so
+ * the graph is never rebuilt and queries are answered right after an update.
+ **********************************************************************************************************************/
+class NetlistGraph
+{
+public:
+    /*!
+     * \brief The Relative struct is a subcircuit reached by a query.
+     */
+    struct Relative {
+        QString                         name;               /*!< Name of the subcircuit. */
+        int                             depth;              /*!< Number of hierarchy levels to the queried one. */
+        int                             instances;          /*!< Number of instances on the level closest to it. */
+    };
+
+    NetlistGraph();
+
+    bool                                update(const NetlistIndex &index, const QList<QStringList> &views);
+    void                                clear();
+
+    bool                                contains(const QString &name) const;
+    QList<Relative>                     getUsers(const QString &name, bool transitive);
+    QList<Relative>                     getChildren(const QString &name, bool transitive);
+    QList<QStringList>                  getDefinitions(const QString &name) const;
+
+    int                                 getNodeCount() const;
+    int                                 getEdgeCount() const;
+
+private:
+    /*!
+     * \brief The Edge struct is an instantiation of a subcircuit by another one.
+     */
+    struct Edge {
+        int                             parent;             /*!< Node of the instantiating subcircuit. */
+        int                             child;              /*!< Node of the instantiated subcircuit. */
+        int                             count;              /*!< Number of instances. */
+    };
+
+    /*!
+     * \brief The ViewEdges struct keeps what a single view adds to the graph.
+     */
+    struct ViewEdges {
+        qint64                          size;               /*!< Size of the view when it was added. */
+        qint64                          modified;           /*!< Modification time of the view when it was added. */
+        QStringList                     location;           /*!< Library, cell and view names. */
+        QList<int>                      defined;            /*!< Nodes of subcircuits defined by the view. */
+        QList<Edge>                     edges;              /*!< Instantiations within the view. */
+    };
+
+    int                                 findNode(const QString &name) const;
+    int                                 getNode(const QString &name, bool isCaseSensitive);
+    void                                addView(const ViewEdges &view, int sign);
+    QList<Relative>                     traverse(int node, bool transitive, const QVector<QMap<int, int> > &edges);
+
+private:
+    QHash<QString, int>                 m_nodeIds;          /*!< Map of names, upper case for SPICE, to nodes. */
+    QStringList                         m_nodeNames;        /*!< Names of nodes as first seen. */
+    QMap<QString, ViewEdges>            m_views;            /*!< Map of view paths to their part of the graph. */
+
+    QVector<QMap<int, int> >            m_children;         /*!< Instance numbers of instantiated nodes per node. */
+    QVector<QMap<int, int> >            m_parents;          /*!< Instance numbers of instantiating nodes per node. */
+    QVector<QList<QStringList> >        m_definitions;      /*!< Library, cell and view of every definition per node. */
+    QVector<int>                        m_depths;           /*!< Depth per node during a query, -1 if not reached. */
+    int                                 m_edgeCount;        /*!< Number of distinct parent and child pairs. */
+};
+
+#endif // NETLISTGRAPH_H
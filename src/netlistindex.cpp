@@ -0,0 +1,362 @@
+#include <QDir>
+#include <QFile>
+#include <QThread>
+#include <QVector>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QDataStream>
+#include <QThreadPool>
+#include <QCoreApplication>
+
+#if QT_VERSION >= 0x050100
+#include <QLockFile>
+#endif
+
+#include "catalog.h"
+#include "netlistindex.h"
+#include "verilogscanner.h"
+#include "perfcounters.h"
+#include "trace.h"
+
+/*!*********************************************************************************************************************
+ * \brief Magic number and version of the index file. The version is increased whenever the stored data changes, older
+ * files are then dropped and rebuilt.
+ **********************************************************************************************************************/
+static const quint32 NETLIST_INDEX_MAGIC = 0x4c4d4e49;
+static const quint32 NETLIST_INDEX_VERSION = 1;
+
+/*!*********************************************************************************************************************
+ * \brief Time in milliseconds to wait for another LibMan saving the index file.
+ **********************************************************************************************************************/
+static const int NETLIST_INDEX_LOCK_TIMEOUT = 10000;
+
+/*!*********************************************************************************************************************
+ * \brief Writes subcircuit into the index file.
+ **********************************************************************************************************************/
+QDataStream& operator<<(QDataStream &out, const NetlistParser::Subckt &subckt)
+{
+    return out<<subckt.name<<subckt.ports<<subckt.pinInfo<<subckt.instances<<subckt.devices<<qint32(subckt.line);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Reads subcircuit from the index file.
+ **********************************************************************************************************************/
+QDataStream& operator>>(QDataStream &in, NetlistParser::Subckt &subckt)
+{
+    qint32 line = 0;
+    in>>subckt.name>>subckt.ports>>subckt.pinInfo>>subckt.instances>>subckt.devices>>line;
+    subckt.line = line;
+
+    return in;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Writes indexed view into the index file.
+ **********************************************************************************************************************/
+QDataStream& operator<<(QDataStream &out, const NetlistIndex::View &view)
+{
+    return out<<view.size<<view.modified<<view.subckts<<view.includes<<view.errors;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Reads indexed view from the index file.
+ **********************************************************************************************************************/
+QDataStream& operator>>(QDataStream &in, NetlistIndex::View &view)
+{
+    return in>>view.size>>view.modified>>view.subckts>>view.includes>>view.errors;
+}
+
+/*!*********************************************************************************************************************
+ * \brief The NetlistJob class parses a single view into its slot of the results, so jobs do not share any data.
+ **********************************************************************************************************************/
+class NetlistJob : public QRunnable
+{
+public:
+    NetlistJob(const QString &viewPath, NetlistIndex::View *view)
+        : m_viewPath(viewPath), m_view(view) {}
+
+    void run();
+
+private:
+    QString                             m_viewPath;         /*!< Path to the view file. */
+    NetlistIndex::View                  *m_view;            /*!< Result slot, owned by NetlistIndex::update(). */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Parses the view and stores its subcircuits, includes and errors. Verilog views are scanned for modules.
+ **********************************************************************************************************************/
+void NetlistJob::run()
+{
+    PerfTimer perfTimer(PerfCounters::JOB_DURATION);
+
+    bool isParsed;
+
+    if(m_viewPath.endsWith(".verilog")) {
+        VerilogScanner scanner;
+        isParsed = scanner.scan(m_viewPath);
+
+        m_view->subckts = scanner.getSubckts();
+        m_view->includes = scanner.getIncludes();
+        m_view->errors = scanner.getErrors();
+    }
+    else {
+        NetlistParser parser;
+        isParsed = parser.parse(m_viewPath);
+
+        m_view->subckts = parser.getSubckts();
+        m_view->includes = parser.getIncludes();
+        m_view->errors = parser.getErrors();
+    }
+
+    PerfCounters::add(isParsed ? PerfCounters::JOBS_DONE : PerfCounters::JOBS_FAILED);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Constructs an empty index.
+ **********************************************************************************************************************/
+NetlistIndex::NetlistIndex()
+    : m_isChanged(false)
+{
+}
+
+/*!*********************************************************************************************************************
+ * \brief Loads index file. A missing file or one of another version gives an empty index, views are then parsed again.
+ * \param fileName      Path to the index file.
+ * \return              False if the file exists but can not be read.
+ **********************************************************************************************************************/
+bool NetlistIndex::load(const QString &fileName)
+{
+    TRACE_SCOPE_ARG("netlist", "load_index", fileName);
+
+    m_views.clear();
+    m_changedPaths.clear();
+    m_errorList.clear();
+    m_isChanged = false;
+
+    return readFile(fileName, &m_views);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Writes index file. Other LibMan sessions and batch runs share the file, so it is locked and the views they
+ * have indexed since this index was loaded are merged in: views parsed or removed here replace theirs, all others are
+ * taken from the file. It is written into a temporary file first, which replaces the index atomically on Unix, so a
+ * concurrent LibMan never reads a partial index.
+ * \param fileName      Path to the index file.
+ **********************************************************************************************************************/
+bool NetlistIndex::save(const QString &fileName)
+{
+    TRACE_SCOPE_ARG("netlist", "save_index", fileName);
+
+    m_errorList.clear();
+
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+
+#if QT_VERSION >= 0x050100
+    QLockFile lockFile(fileName + ".lock");
+    if(!lockFile.tryLock(NETLIST_INDEX_LOCK_TIMEOUT)) {
+        m_errorList<<QString("Can not lock file '%1'.").arg(fileName);
+        return false;
+    }
+#endif
+
+    QMap<QString, View> views;
+    if(readFile(fileName, &views)) {
+        foreach(const QString &viewPath, m_changedPaths) {
+            QMap<QString, View>::const_iterator it = m_views.constFind(viewPath);
+            if(it != m_views.constEnd()) {
+                views[viewPath] = it.value();
+            }
+            else {
+                views.remove(viewPath);
+            }
+        }
+
+        m_views = views;
+    }
+
+    // A damaged file is replaced by this index.
+    m_errorList.clear();
+
+    QString tempName = fileName + QString(".%1.tmp").arg(QCoreApplication::applicationPid());
+
+    QFile file(tempName);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        m_errorList<<QString("Can not write to file '%1':\n%2.").arg(tempName).arg(file.errorString());
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_4_6);
+    out<<NETLIST_INDEX_MAGIC<<NETLIST_INDEX_VERSION<<m_views;
+
+    qint64 size = file.size();
+    file.close();
+
+    if(out.status() != QDataStream::Ok || file.error() != QFile::NoError) {
+        m_errorList<<QString("Can not write to file '%1':\n%2.").arg(tempName).arg(file.errorString());
+        QFile::remove(tempName);
+        return false;
+    }
+
+    if(!Catalog::replaceFile(tempName, fileName)) {
+        m_errorList<<QString("Can not replace file '%1'.").arg(fileName);
+        QFile::remove(tempName);
+        return false;
+    }
+
+    PerfCounters::add(PerfCounters::FILES_WRITTEN);
+    PerfCounters::add(PerfCounters::BYTES_WRITTEN, size);
+
+    m_changedPaths.clear();
+    m_isChanged = false;
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Brings views up to date. New and changed views are parsed in parallel, views which do not exist any more are
+ * removed from the index.
+ * \param viewPaths     Paths to SPICE, CDL or Verilog view files.
+ * \param jobs          Maximal number of views parsed at a time, 0 to use number of CPU cores.
+ * \return              Number of parsed views.
+ **********************************************************************************************************************/
+int NetlistIndex::update(const QStringList &viewPaths, int jobs)
+{
+    TRACE_SCOPE("netlist", "update_index");
+
+    QStringList stalePaths;
+    QVector<View> results;
+
+    PerfCounters::add(PerfCounters::STAT_CALLS, viewPaths.count());
+
+    foreach(const QString &viewPath, viewPaths) {
+        QFileInfo viewInfo(viewPath);
+        if(!viewInfo.isFile()) {
+            if(m_views.remove(viewPath)) {
+                m_changedPaths.insert(viewPath);
+                m_isChanged = true;
+            }
+
+            continue;
+        }
+
+        View view;
+        view.size = viewInfo.size();
+        view.modified = viewInfo.lastModified().toMSecsSinceEpoch();
+
+        QMap<QString, View>::const_iterator it = m_views.constFind(viewPath);
+        if(it != m_views.constEnd() && it->size == view.size && it->modified == view.modified) {
+            PerfCounters::add(PerfCounters::CACHE_HITS);
+            continue;
+        }
+
+        PerfCounters::add(PerfCounters::CACHE_MISSES);
+
+        stalePaths<<viewPath;
+        results<<view;
+    }
+
+    if(stalePaths.isEmpty()) {
+        return 0;
+    }
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(jobs > 0 ? jobs : qMax(1, QThread::idealThreadCount()));
+
+    for(int i = 0; i < stalePaths.count(); ++i) {
+        pool.start(new NetlistJob(stalePaths[i], &results[i]));
+    }
+
+    pool.waitForDone();
+
+    for(int i = 0; i < stalePaths.count(); ++i) {
+        m_views[stalePaths[i]] = results[i];
+        m_changedPaths.insert(stalePaths[i]);
+    }
+
+    m_isChanged = true;
+
+    return stalePaths.count();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns path of the index file shared by all projects.
+ **********************************************************************************************************************/
+QString NetlistIndex::getDefaultFile()
+{
+    return QDir::toNativeSeparators(Catalog::getCacheDir() + "/netlist.index");
+}
+
+/*!*********************************************************************************************************************
+ * \brief Lists SPICE, CDL and Verilog views of the libraries.
+ * \param catalog       Catalog used to scan the libraries.
+ * \param libraries     Map of library names to library paths.
+ * \return              Rows of library, cell, view and view path in library and cell order.
+ **********************************************************************************************************************/
+QList<QStringList> NetlistIndex::getNetlistViews(const Catalog &catalog, const QMap<QString, QString> &libraries)
+{
+    QList<QStringList> views;
+
+    QMap<QString, QString>::const_iterator it;
+    for(it = libraries.constBegin(); it != libraries.constEnd(); ++it) {
+        QMap<QString, QStringList> cells = catalog.scanLibrary(it.value());
+
+        QMap<QString, QStringList>::const_iterator cit;
+        for(cit = cells.constBegin(); cit != cells.constEnd(); ++cit) {
+            foreach(const QString &viewName, cit.value()) {
+                if(NetlistParser::isNetlistView(viewName)) {
+                    views<<(QStringList()<<it.key()<<cit.key()<<viewName
+                                         <<Catalog::getViewPath(it.value(), cit.key(), viewName));
+                }
+            }
+        }
+    }
+
+    return views;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Reads views of the index file. A missing file or one of another version gives no views.
+ * \param fileName      Path to the index file.
+ * \param views         Map to read the views into, it is cleared first.
+ * \return              False if the file exists but can not be read, the reasons are in the error list.
+ **********************************************************************************************************************/
+bool NetlistIndex::readFile(const QString &fileName, QMap<QString, View> *views)
+{
+    views->clear();
+
+    QFile file(fileName);
+    if(!file.exists()) {
+        return true;
+    }
+
+    if(!file.open(QIODevice::ReadOnly)) {
+        m_errorList<<QString("Can not read file '%1':\n%2.").arg(fileName).arg(file.errorString());
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_4_6);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    in>>magic>>version;
+
+    if(magic != NETLIST_INDEX_MAGIC || version != NETLIST_INDEX_VERSION) {
+        return true;
+    }
+
+    in>>*views;
+
+    if(in.status() != QDataStream::Ok) {
+        views->clear();
+        m_errorList<<QString("Netlist index '%1' is damaged and will be rebuilt.").arg(fileName);
+        return false;
+    }
+
+    PerfCounters::add(PerfCounters::FILES_READ);
+    PerfCounters::add(PerfCounters::BYTES_READ, file.size());
+
+    return true;
+}
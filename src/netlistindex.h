@@ -0,0 +1,104 @@
+#ifndef NETLISTINDEX_H
+#define NETLISTINDEX_H
+
+#include <QMap>
+#include <QSet>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "netlistparser.h"
+
+class Catalog;
+
+/*!*********************************************************************************************************************
+ * \brief The NetlistIndex class keeps subcircuits, ports and instance counts of SPICE, CDL and Verilog views by view
+ * path. Views are parsed in parallel by a pool of jobs and only if their size or modification time has changed since
+ * they were indexed. The index is persisted in a binary file, so netlists are parsed once and not on every start of
+ * LibMan; the file is shared by all sessions and batch runs, saving merges their views under a lock.
+ **********************************************************************************************************************/
+class NetlistIndex
+{
+public:
+    /*!
+     * \brief The View struct keeps the indexed data of a netlist view.
+     */
+    struct View {
+        View() : size(0), modified(0) {}
+
+        qint64                          size;               /*!< Size of the file when it was indexed. */
+        qint64                          modified;           /*!< Modification time in ms since epoch when it was indexed. */
+        QList<NetlistParser::Subckt>    subckts;            /*!< Subcircuits defined by the view. */
+        QStringList                     includes;           /*!< Files referenced by '.INCLUDE', '.LIB' or '`include'. */
+        QStringList                     errors;             /*!< Errors found while parsing. */
+    };
+
+    NetlistIndex();
+
+    bool                                load(const QString &fileName);
+    bool                                save(const QString &fileName);
+
+    int                                 update(const QStringList &viewPaths, int jobs = 0);
+
+    bool                                contains(const QString &viewPath) const;
+    View                                getView(const QString &viewPath) const;
+    QStringList                         getViewPaths() const;
+    bool                                isChanged() const;
+    QStringList                         getErrors() const;
+
+    static QString                      getDefaultFile();
+    static QList<QStringList>           getNetlistViews(const Catalog &catalog, const QMap<QString, QString> &libraries);
+
+private:
+    bool                                readFile(const QString &fileName, QMap<QString, View> *views);
+
+private:
+    QMap<QString, View>                 m_views;            /*!< Map of view paths to indexed data. */
+    QSet<QString>                       m_changedPaths;     /*!< Views parsed or removed since loading or saving. */
+    bool                                m_isChanged;        /*!< State if the index differs from the loaded file. */
+    QStringList                         m_errorList;        /*!< Errors of loading and saving. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if the view has been indexed.
+ * \param viewPath      Path to the view file.
+ **********************************************************************************************************************/
+inline bool NetlistIndex::contains(const QString &viewPath) const
+{
+    return m_views.contains(viewPath);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns indexed data of the view or an empty view if it is not indexed.
+ * \param viewPath      Path to the view file.
+ **********************************************************************************************************************/
+inline NetlistIndex::View NetlistIndex::getView(const QString &viewPath) const
+{
+    return m_views.value(viewPath);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns paths of all indexed views.
+ **********************************************************************************************************************/
+inline QStringList NetlistIndex::getViewPaths() const
+{
+    return m_views.keys();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if views have been indexed or removed since the index was loaded or saved.
+ **********************************************************************************************************************/
+inline bool NetlistIndex::isChanged() const
+{
+    return m_isChanged;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns errors of loading and saving.
+ **********************************************************************************************************************/
+inline QStringList NetlistIndex::getErrors() const
+{
+    return m_errorList;
+}
+
+#endif // NETLISTINDEX_H
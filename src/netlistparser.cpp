@@ -0,0 +1,367 @@
+#include <QFile>
+#include <QIODevice>
+
+#include "netlistparser.h"
+#include "perfcounters.h"
+#include "trace.h"
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if the character separates tokens of a statement.
+ * \param c             Character to check.
+ **********************************************************************************************************************/
+static inline bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+/*!*********************************************************************************************************************
+ * \brief Removes quotes around a file name.
+ * \param token         Token of the statement.
+ **********************************************************************************************************************/
+static QString unquote(const QByteArray &token)
+{
+    QByteArray value = token;
+    if(value.size() >= 2 && (value.at(0) == '"' || value.at(0) == '\'') && value.at(value.size() - 1) == value.at(0)) {
+        value = value.mid(1, value.size() - 2);
+    }
+
+    return QString::fromLocal8Bit(value);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Constructs an empty parser.
+ **********************************************************************************************************************/
+NetlistParser::NetlistParser()
+    : m_lineCount(0)
+{
+}
+
+/*!*********************************************************************************************************************
+ * \brief Parses the netlist file.
+ * \param fileName      Path to the SPICE or CDL file.
+ * \return              True if no errors were found, otherwise false and the reasons are in the error list.
+ **********************************************************************************************************************/
+bool NetlistParser::parse(const QString &fileName)
+{
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly)) {
+        m_subckts.clear();
+        m_includes.clear();
+        m_errorList.clear();
+        m_errorList<<QString("Can not read file '%1':\n%2.").arg(fileName).arg(file.errorString());
+        return false;
+    }
+
+    return parse(&file, fileName);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Parses the netlist read from the device. Comment and empty lines may stand between continuation lines.
+ * \param device        Opened device to read from.
+ * \param fileName      Name of the netlist used in error messages.
+ * \return              True if no errors were found, otherwise false and the reasons are in the error list.
+ **********************************************************************************************************************/
+bool NetlistParser::parse(QIODevice *device, const QString &fileName)
+{
+    TRACE_SCOPE_ARG("netlist", "parse", fileName);
+
+    m_fileName = fileName;
+    m_subckts.clear();
+    m_openSubckts.clear();
+    m_includes.clear();
+    m_errorList.clear();
+    m_lineCount = 0;
+
+    QByteArray statement;
+    int statementLine = 0;
+    bool isPinInfo = false;
+    qint64 bytes = 0;
+
+    while(!device->atEnd()) {
+        QByteArray line = device->readLine();
+        if(line.isEmpty()) {
+            break;
+        }
+
+        bytes += line.size();
+        m_lineCount++;
+
+        stripComment(line);
+        line = line.trimmed();
+        if(line.isEmpty()) {
+            continue;
+        }
+
+        if(line[0] == '*') {
+            // CDL keeps port directions in comments, long ones are continued by '*+'.
+            if(isPinInfo && line.size() > 1 && line[1] == '+') {
+                statement += ' ';
+                statement += line.mid(2);
+            }
+            else if(line.size() >= 9 && qstrnicmp(line.constData(), "*.PININFO", 9) == 0) {
+                parseStatement(statement, statementLine);
+                statement = line;
+                statementLine = m_lineCount;
+                isPinInfo = true;
+            }
+
+            continue;
+        }
+
+        if(line[0] == '+') {
+            statement += ' ';
+            statement += line.mid(1);
+            continue;
+        }
+
+        parseStatement(statement, statementLine);
+        statement = line;
+        statementLine = m_lineCount;
+        isPinInfo = false;
+    }
+
+    parseStatement(statement, statementLine);
+
+    foreach(int index, m_openSubckts) {
+        m_errorList<<QString("Subcircuit '%1' in line %2 of '%3' is not closed by '.ENDS'.")
+                     .arg(m_subckts[index].name).arg(m_subckts[index].line).arg(m_fileName);
+    }
+
+    m_openSubckts.clear();
+
+    PerfCounters::add(PerfCounters::FILES_READ);
+    PerfCounters::add(PerfCounters::BYTES_READ, bytes);
+
+    return m_errorList.isEmpty();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Parses a statement with all its continuation lines joined.
+ * \param statement     Statement to parse.
+ * \param line          Line of the statement, used in error messages.
+ **********************************************************************************************************************/
+void NetlistParser::parseStatement(const QByteArray &statement, int line)
+{
+    if(statement.isEmpty()) {
+        return;
+    }
+
+    QList<QByteArray> tokens = splitTokens(statement);
+    if(tokens.isEmpty()) {
+        return;
+    }
+
+    QByteArray keyword = tokens[0].toLower();
+
+    if(keyword == "*.pininfo") {
+        if(m_openSubckts.isEmpty()) {
+            return;
+        }
+
+        Subckt &subckt = m_subckts[m_openSubckts.last()];
+        for(int i = 1; i < tokens.count(); ++i) {
+            subckt.pinInfo<<QString::fromLocal8Bit(tokens[i]);
+        }
+    }
+    else if(keyword == ".subckt") {
+        if(tokens.count() < 2) {
+            m_errorList<<QString("Subcircuit without name in line %1 of '%2'.").arg(line).arg(m_fileName);
+            return;
+        }
+
+        Subckt subckt;
+        subckt.name = QString::fromLocal8Bit(tokens[1]);
+        subckt.line = line;
+
+        for(int i = 2; i < tokens.count(); ++i) {
+            QByteArray upper = tokens[i].toUpper();
+            if(upper == "PARAM:" || upper == "PARAMS:" || isParameter(tokens, i)) {
+                break;
+            }
+
+            subckt.ports<<QString::fromLocal8Bit(tokens[i]);
+        }
+
+        m_openSubckts<<m_subckts.count();
+        m_subckts<<subckt;
+    }
+    else if(keyword == ".ends") {
+        if(m_openSubckts.isEmpty()) {
+            m_errorList<<QString("'.ENDS' without '.SUBCKT' in line %1 of '%2'.").arg(line).arg(m_fileName);
+            return;
+        }
+
+        m_openSubckts.removeLast();
+    }
+    else if(keyword == ".include" || keyword == ".inc" || keyword == ".incl") {
+        if(tokens.count() >= 2) {
+            m_includes<<unquote(tokens[1]);
+        }
+    }
+    else if(keyword == ".lib") {
+        // '.LIB <file> <section>' references a library, '.LIB <section>' starts a section of this file.
+        if(tokens.count() >= 3) {
+            m_includes<<QString("%1 [%2]").arg(unquote(tokens[1])).arg(QString::fromLocal8Bit(tokens[2]));
+        }
+    }
+    else if(keyword.at(0) != '.' && !m_openSubckts.isEmpty()) {
+        parseElement(tokens);
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Counts element of the open subcircuit.
+ * \param tokens        Tokens of the element statement.
+ **********************************************************************************************************************/
+void NetlistParser::parseElement(const QList<QByteArray> &tokens)
+{
+    Subckt &subckt = m_subckts[m_openSubckts.last()];
+
+    char letter = tokens[0].at(0);
+    if(letter >= 'a' && letter <= 'z') {
+        letter -= 'a' - 'A';
+    }
+
+    if(letter < 'A' || letter > 'Z') {
+        return;
+    }
+
+    if(letter != 'X') {
+        subckt.devices[QString(QChar(letter))]++;
+        return;
+    }
+
+    QByteArray name = getInstanceType(tokens);
+    if(!name.isEmpty()) {
+        subckt.instances[QString::fromLocal8Bit(name)]++;
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Splits statement at blanks. Quoted and braced expressions are kept in a single token.
+ * \param statement     Statement to split.
+ **********************************************************************************************************************/
+QList<QByteArray> NetlistParser::splitTokens(const QByteArray &statement)
+{
+    QList<QByteArray> tokens;
+
+    const char *data = statement.constData();
+    int count = statement.size();
+    int start = -1;
+    char quote = 0;
+
+    for(int i = 0; i < count; ++i) {
+        char c = data[i];
+
+        if(quote) {
+            if(c == quote) {
+                quote = 0;
+            }
+
+            continue;
+        }
+
+        if(isBlank(c)) {
+            if(start >= 0) {
+                tokens<<QByteArray(data + start, i - start);
+                start = -1;
+            }
+
+            continue;
+        }
+
+        if(start < 0) {
+            start = i;
+        }
+
+        if(c == '\'' || c == '"') {
+            quote = c;
+        }
+        else if(c == '{') {
+            quote = '}';
+        }
+    }
+
+    if(start >= 0) {
+        tokens<<QByteArray(data + start, count - start);
+    }
+
+    return tokens;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns the subcircuit instantiated by an 'X' element: the last token before the parameters or the one
+ * following '/' in CDL.
+ * \param tokens        Tokens of the element statement.
+ * \return              Name of the subcircuit, empty if there is none.
+ **********************************************************************************************************************/
+QByteArray NetlistParser::getInstanceType(const QList<QByteArray> &tokens)
+{
+    QByteArray name;
+    for(int i = 1; i < tokens.count(); ++i) {
+        if(tokens[i] == "/") {
+            return tokens.value(i + 1);
+        }
+        else if(tokens[i].startsWith('/')) {
+            return tokens[i].mid(1);
+        }
+        else if(tokens[i].startsWith('$') || isParameter(tokens, i)) {
+            break;
+        }
+
+        name = tokens[i];
+    }
+
+    return name;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if the token is a parameter assignment, either 'name=value' or 'name = value'.
+ * \param tokens        Tokens of the statement.
+ * \param index         Index of the token to check.
+ **********************************************************************************************************************/
+bool NetlistParser::isParameter(const QList<QByteArray> &tokens, int index)
+{
+    return tokens[index].contains('=') || (index + 1 < tokens.count() && tokens[index + 1].startsWith('='));
+}
+
+/*!*********************************************************************************************************************
+ * \brief Removes an inline comment, it starts with a '$' standing alone. CDL keywords like '$PINS' or '$[nch]' are
+ * kept.
+ * \param line          Physical line of the netlist.
+ **********************************************************************************************************************/
+void NetlistParser::stripComment(QByteArray &line)
+{
+    int count = line.size();
+    for(int i = 1; i < count; ++i) {
+        if(line.at(i) == '$' && isBlank(line.at(i - 1)) && (i + 1 == count || isBlank(line.at(i + 1)))) {
+            line.truncate(i);
+            return;
+        }
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if the view contains a SPICE, CDL or Verilog netlist.
+ * \param viewName      Name of the view.
+ **********************************************************************************************************************/
+bool NetlistParser::isNetlistView(const QString &viewName)
+{
+    return viewName == "cdl" || viewName == "spice" || viewName == "verilog";
+}
+
+/*!*********************************************************************************************************************
+ * \brief Formats counts as 'name(count)' separated by commas.
+ * \param counts        Map of names to counts.
+ **********************************************************************************************************************/
+QString NetlistParser::formatCounts(const QMap<QString, int> &counts)
+{
+    QStringList items;
+
+    QMap<QString, int>::const_iterator it;
+    for(it = counts.constBegin(); it != counts.constEnd(); ++it) {
+        items<<QString("%1(%2)").arg(it.key()).arg(it.value());
+    }
+
+    return items.join(", ");
+}
@@ -0,0 +1,95 @@
+#ifndef NETLISTPARSER_H
+#define NETLISTPARSER_H
+
+#include <QMap>
+#include <QList>
+#include <QString>
+#include <QByteArray>
+#include <QStringList>
+
+class QIODevice;
+
+/*!*********************************************************************************************************************
+ * \brief The NetlistParser class reads SPICE and CDL netlists line by line and collects their subcircuits with ports,
+ * pin directions of '*.PININFO' comments, instance and device counts. Continuation lines ('+') are joined, inline
+ * comments after ' $' are dropped and files referenced by '.INCLUDE' and '.LIB' are listed, but not read. Only the
+ * current statement is kept in memory, so file size does not matter.
+ **********************************************************************************************************************/
+class NetlistParser
+{
+public:
+    /*!
+     * \brief The Subckt struct keeps a subcircuit definition.
+     */
+    struct Subckt {
+        QString                         name;               /*!< Name of the subcircuit. */
+        QStringList                     ports;              /*!< Ports in the order of the definition. */
+        QStringList                     pinInfo;            /*!< Port directions as '<port>:<direction>'. */
+        QMap<QString, int>              instances;          /*!< Numbers of instances per instantiated subcircuit. */
+        QMap<QString, int>              devices;            /*!< Numbers of primitive devices per element letter. */
+        int                             line;               /*!< Line of the '.SUBCKT' statement. */
+    };
+
+    NetlistParser();
+
+    bool                                parse(const QString &fileName);
+    bool                                parse(QIODevice *device, const QString &fileName);
+
+    QList<Subckt>                       getSubckts() const;
+    QStringList                         getIncludes() const;
+    qint64                              getLineCount() const;
+    QStringList                         getErrors() const;
+
+    static bool                         isNetlistView(const QString &viewName);
+    static QString                      formatCounts(const QMap<QString, int> &counts);
+    static QList<QByteArray>            splitTokens(const QByteArray &statement);
+    static QByteArray                   getInstanceType(const QList<QByteArray> &tokens);
+    static bool                         isParameter(const QList<QByteArray> &tokens, int index);
+    static void                         stripComment(QByteArray &line);
+
+private:
+    void                                parseStatement(const QByteArray &statement, int line);
+    void                                parseElement(const QList<QByteArray> &tokens);
+
+private:
+    QString                             m_fileName;         /*!< Path of the parsed file, used in error messages. */
+    QList<Subckt>                       m_subckts;          /*!< Subcircuits in the order of their definition. */
+    QList<int>                          m_openSubckts;      /*!< Indexes of subcircuits not closed by '.ENDS' yet. */
+    QStringList                         m_includes;         /*!< Files referenced by '.INCLUDE' and '.LIB'. */
+    qint64                              m_lineCount;        /*!< Number of lines read. */
+    QStringList                         m_errorList;        /*!< Errors found in the netlist. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Returns subcircuits in the order of their definition.
+ **********************************************************************************************************************/
+inline QList<NetlistParser::Subckt> NetlistParser::getSubckts() const
+{
+    return m_subckts;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns files referenced by '.INCLUDE' and '.LIB', a library section follows the file name in brackets.
+ **********************************************************************************************************************/
+inline QStringList NetlistParser::getIncludes() const
+{
+    return m_includes;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns number of lines read by the last parse() call.
+ **********************************************************************************************************************/
+inline qint64 NetlistParser::getLineCount() const
+{
+    return m_lineCount;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns errors found by the last parse() call.
+ **********************************************************************************************************************/
+inline QStringList NetlistParser::getErrors() const
+{
+    return m_errorList;
+}
+
+#endif // NETLISTPARSER_H
@@ -0,0 +1,440 @@
+#include <QDir>
+#include <QFile>
+#include <QThread>
+#include <QVector>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QThreadPool>
+
+#include "catalog.h"
+#include "netlistparser.h"
+#include "netlistsplitter.h"
+#include "perfcounters.h"
+#include "trace.h"
+
+/*!*********************************************************************************************************************
+ * \brief The ViewWriteJob class writes a single view file from its parts. The file is written under a temporary name
+ * and renamed, so a view is never left half written.
+ **********************************************************************************************************************/
+class ViewWriteJob : public QRunnable
+{
+public:
+    ViewWriteJob(const QString &viewPath, const QList<QByteArray> &parts, QString *errorMsg)
+        : m_viewPath(viewPath), m_parts(parts), m_errorMsg(errorMsg) {}
+
+    void run();
+
+private:
+    QString                             m_viewPath;         /*!< Path to the view file. */
+    QList<QByteArray>                   m_parts;            /*!< Texts written one after the other. */
+    QString                             *m_errorMsg;        /*!< Result slot, empty if the file has been written. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Joins the parts into a single buffer and writes it at once.
+ **********************************************************************************************************************/
+void ViewWriteJob::run()
+{
+    PerfTimer perfTimer(PerfCounters::JOB_DURATION);
+
+    int size = 0;
+    foreach(const QByteArray &part, m_parts) {
+        size += part.size();
+    }
+
+    QByteArray content;
+    content.reserve(size);
+    foreach(const QByteArray &part, m_parts) {
+        content += part;
+    }
+
+    QString tempPath = m_viewPath + ".tmp";
+
+    QFile file(tempPath);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        *m_errorMsg = QString("Can not write file '%1':\n%2.").arg(tempPath).arg(file.errorString());
+        PerfCounters::add(PerfCounters::JOBS_FAILED);
+        return;
+    }
+
+    bool isWritten = file.write(content) == content.size();
+    file.close();
+
+    if(!isWritten || file.error() != QFile::NoError) {
+        *m_errorMsg = QString("Can not write file '%1':\n%2.").arg(tempPath).arg(file.errorString());
+        QFile::remove(tempPath);
+        PerfCounters::add(PerfCounters::JOBS_FAILED);
+        return;
+    }
+
+    if(!Catalog::replaceFile(tempPath, m_viewPath)) {
+        *m_errorMsg = QString("Can not rename file '%1' to '%2'.").arg(tempPath).arg(m_viewPath);
+        QFile::remove(tempPath);
+        PerfCounters::add(PerfCounters::JOBS_FAILED);
+        return;
+    }
+
+    PerfCounters::add(PerfCounters::FILES_WRITTEN);
+    PerfCounters::add(PerfCounters::BYTES_WRITTEN, content.size());
+    PerfCounters::add(PerfCounters::JOBS_DONE);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Constructs an empty splitter.
+ **********************************************************************************************************************/
+NetlistSplitter::NetlistSplitter()
+{
+}
+
+/*!*********************************************************************************************************************
+ * \brief Reads the netlist line by line and keeps the text of its top level subcircuits. Subcircuits nested into
+ * others stay part of the enclosing one.
+ * \param fileName      Path to the SPICE or CDL file.
+ * \return              True if no errors were found, otherwise false and the reasons are in the error list.
+ **********************************************************************************************************************/
+bool NetlistSplitter::read(const QString &fileName)
+{
+    TRACE_SCOPE_ARG("netlist", "split_read", fileName);
+
+    m_fileName = fileName;
+    m_preamble.clear();
+    m_blocks.clear();
+    m_blockIds.clear();
+    m_errorList.clear();
+
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly)) {
+        m_errorList<<QString("Can not read file '%1':\n%2.").arg(fileName).arg(file.errorString());
+        return false;
+    }
+
+    Block block;
+    QByteArray statement;
+    bool isPreamble = false;
+    bool isLibSection = false;
+    int depth = 0;
+    int line = 0;
+    int blockLine = 0;
+    qint64 bytes = 0;
+
+    while(!file.atEnd()) {
+        QByteArray raw = file.readLine();
+        if(raw.isEmpty()) {
+            break;
+        }
+
+        bytes += raw.size();
+        line++;
+
+        if(!raw.endsWith('\n')) {
+            raw += '\n';
+        }
+
+        if(depth > 0) {
+            block.text += raw;
+        }
+
+        QByteArray trimmed = raw.trimmed();
+        if(trimmed.isEmpty() || trimmed.at(0) == '*') {
+            continue;
+        }
+
+        // Inline comments may name subcircuits, they are not part of the statement.
+        QByteArray code = trimmed;
+        NetlistParser::stripComment(code);
+
+        if(trimmed.at(0) == '+') {
+            if(depth > 0) {
+                statement += ' ';
+                statement += code.mid(1);
+            }
+            else if(isPreamble) {
+                m_preamble += raw;
+            }
+
+            continue;
+        }
+
+        addInstance(&block, statement);
+        statement.clear();
+        isPreamble = false;
+
+        QList<QByteArray> tokens = NetlistParser::splitTokens(code);
+        QByteArray keyword = tokens[0].toLower();
+
+        if(keyword == ".subckt") {
+            if(depth == 0) {
+                block = Block();
+                block.name = QString::fromLocal8Bit(tokens.value(1));
+                block.text = raw;
+                blockLine = line;
+            }
+
+            depth++;
+        }
+        else if(keyword == ".ends") {
+            if(depth == 0) {
+                m_errorList<<QString("'.ENDS' without '.SUBCKT' in line %1 of '%2'.").arg(line).arg(m_fileName);
+                continue;
+            }
+
+            if(--depth == 0) {
+                addBlock(block, blockLine);
+            }
+        }
+        else if(depth > 0) {
+            statement = code;
+        }
+        else if(keyword == ".lib" || keyword == ".endl") {
+            // '.LIB <section>' starts a section up to '.ENDL', '.LIB <file> <section>' references one of another file.
+            isLibSection = keyword == ".lib" && tokens.count() == 2;
+        }
+        else if(isLibSection) {
+            // Statements of a library section are only valid where the section is referenced, they are not copied.
+            continue;
+        }
+        else if(keyword.startsWith('.') && keyword != ".end" && keyword != ".include" && keyword != ".inc" &&
+                keyword != ".incl") {
+            // Included files are referenced relative to the netlist and would not be found from the view.
+            m_preamble += raw;
+            isPreamble = true;
+        }
+    }
+
+    if(depth > 0) {
+        m_errorList<<QString("Subcircuit '%1' in line %2 of '%3' is not closed by '.ENDS'.")
+                     .arg(block.name).arg(blockLine).arg(m_fileName);
+    }
+
+    PerfCounters::add(PerfCounters::FILES_READ);
+    PerfCounters::add(PerfCounters::BYTES_READ, bytes);
+
+    return m_errorList.isEmpty();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Writes the subcircuits to their views. Existing views are skipped unless they may be overwritten; with
+ * dependencies, every subcircuit instantiated on any level below and defined in the netlist follows the cell.
+ * \param libPath           Path to the library.
+ * \param viewName          Name of the view, 'cdl' or 'spice'.
+ * \param subckts           Names of the subcircuits to write, all if empty.
+ * \param withDependencies  State if instantiated subcircuits are copied into the view.
+ * \param overwrite         State if existing views are replaced.
+ * \param dryRun            State if views are only planned, nothing is written.
+ * \param jobs              Maximal number of files written at a time, 0 to use number of CPU cores.
+ * \return                  Number of written views.
+ **********************************************************************************************************************/
+int NetlistSplitter::write(const QString &libPath, const QString &viewName, const QStringList &subckts,
+                           bool withDependencies, bool overwrite, bool dryRun, int jobs)
+{
+    TRACE_SCOPE_ARG("netlist", "split_write", libPath);
+
+    m_report.clear();
+    m_errorList.clear();
+
+    QList<int> selected;
+    if(subckts.isEmpty()) {
+        for(int i = 0; i < m_blocks.count(); ++i) {
+            selected<<i;
+        }
+    }
+
+    foreach(const QString &name, subckts) {
+        QHash<QString, int>::const_iterator it = m_blockIds.constFind(name.toUpper());
+        if(it == m_blockIds.constEnd()) {
+            m_errorList<<QString("Subcircuit '%1' is not defined in '%2'.").arg(name).arg(m_fileName);
+            m_report<<(QStringList()<<name<<""<<"failed");
+            continue;
+        }
+
+        // A subcircuit requested twice, e.g. in another case, would make two jobs write the same file.
+        if(!selected.contains(it.value())) {
+            selected<<it.value();
+        }
+    }
+
+    QString viewDir = QDir::toNativeSeparators(libPath + "/" + viewName);
+    if(!dryRun && !selected.isEmpty() && !QDir().mkpath(viewDir)) {
+        m_errorList<<QString("Can not create folder '%1'.").arg(viewDir);
+        return 0;
+    }
+
+    QStringList cellNames;
+    QStringList viewPaths;
+    QList<QList<QByteArray> > contents;
+
+    foreach(int index, selected) {
+        const Block &block = m_blocks[index];
+        QString viewPath = Catalog::getViewPath(libPath, block.name, viewName);
+
+        if(block.name.contains('/') || block.name.contains('\\')) {
+            m_errorList<<QString("Subcircuit name '%1' can not be used as cell name.").arg(block.name);
+            m_report<<(QStringList()<<block.name<<""<<"failed");
+            continue;
+        }
+
+        PerfCounters::add(PerfCounters::STAT_CALLS);
+        if(!overwrite && QFileInfo(viewPath).exists()) {
+            m_report<<(QStringList()<<block.name<<viewPath<<"skipped");
+            continue;
+        }
+
+        if(dryRun) {
+            m_report<<(QStringList()<<block.name<<viewPath<<"planned");
+            continue;
+        }
+
+        QList<QByteArray> parts;
+        parts<<m_preamble<<block.text;
+
+        if(withDependencies) {
+            foreach(int dependency, getDependencies(index)) {
+                parts<<"\n"<<m_blocks[dependency].text;
+            }
+        }
+
+        cellNames<<block.name;
+        viewPaths<<viewPath;
+        contents<<parts;
+    }
+
+    if(viewPaths.isEmpty()) {
+        return 0;
+    }
+
+    QVector<QString> results(viewPaths.count());
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(jobs > 0 ? jobs : qMax(1, QThread::idealThreadCount()));
+
+    for(int i = 0; i < viewPaths.count(); ++i) {
+        pool.start(new ViewWriteJob(viewPaths[i], contents[i], &results[i]));
+    }
+
+    pool.waitForDone();
+
+    int written = 0;
+
+    for(int i = 0; i < viewPaths.count(); ++i) {
+        if(results[i].isEmpty()) {
+            m_report<<(QStringList()<<cellNames[i]<<viewPaths[i]<<"written");
+            written++;
+        }
+        else {
+            m_report<<(QStringList()<<cellNames[i]<<viewPaths[i]<<"failed");
+            m_errorList<<results[i];
+        }
+    }
+
+    return written;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns names of the subcircuits in the order of their definition.
+ **********************************************************************************************************************/
+QStringList NetlistSplitter::getSubcktNames() const
+{
+    QStringList names;
+
+    foreach(const Block &block, m_blocks) {
+        names<<block.name;
+    }
+
+    return names;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns names of the report columns.
+ **********************************************************************************************************************/
+QStringList NetlistSplitter::getColumns()
+{
+    return QStringList()<<"cell"<<"path"<<"status";
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns view name for the suffix of a netlist file: 'cdl' for '.cdl', 'spice' for '.sp', '.spi', '.spice' and
+ * '.cir', otherwise an empty string.
+ * \param fileName      Path to the netlist.
+ **********************************************************************************************************************/
+QString NetlistSplitter::getViewName(const QString &fileName)
+{
+    QString suffix = QFileInfo(fileName).suffix().toLower();
+
+    if(suffix == "cdl") {
+        return "cdl";
+    }
+    else if(suffix == "sp" || suffix == "spi" || suffix == "spice" || suffix == "cir") {
+        return "spice";
+    }
+
+    return QString();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Adds a finished subcircuit. Later definitions of the same name are reported and dropped.
+ * \param block         Finished subcircuit.
+ * \param line          Line of its '.SUBCKT' statement, used in error messages.
+ **********************************************************************************************************************/
+void NetlistSplitter::addBlock(const Block &block, int line)
+{
+    if(block.name.isEmpty()) {
+        m_errorList<<QString("Subcircuit without name in line %1 of '%2'.").arg(line).arg(m_fileName);
+        return;
+    }
+
+    QString key = block.name.toUpper();
+    if(m_blockIds.contains(key)) {
+        m_errorList<<QString("Subcircuit '%1' in line %2 of '%3' is already defined.").arg(block.name).arg(line)
+                     .arg(m_fileName);
+        return;
+    }
+
+    m_blockIds[key] = m_blocks.count();
+    m_blocks<<block;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns subcircuits defined in the netlist and instantiated by the subcircuit on any level, nearest first.
+ * \param block         Index of the subcircuit.
+ **********************************************************************************************************************/
+QList<int> NetlistSplitter::getDependencies(int block) const
+{
+    QList<int> dependencies;
+    QVector<bool> isReached(m_blocks.count(), false);
+    isReached[block] = true;
+
+    QList<int> queue;
+    queue<<block;
+
+    for(int i = 0; i < queue.count(); ++i) {
+        foreach(const QString &child, m_blocks[queue[i]].children) {
+            QHash<QString, int>::const_iterator it = m_blockIds.constFind(child.toUpper());
+            if(it == m_blockIds.constEnd() || isReached[it.value()]) {
+                continue;
+            }
+
+            isReached[it.value()] = true;
+            dependencies<<it.value();
+            queue<<it.value();
+        }
+    }
+
+    return dependencies;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Records the subcircuit instantiated by an 'X' element of the block.
+ * \param block         Subcircuit containing the element.
+ * \param statement     Element statement with its continuation lines joined.
+ **********************************************************************************************************************/
+void NetlistSplitter::addInstance(Block *block, const QByteArray &statement)
+{
+    if(statement.isEmpty() || (statement.at(0) != 'X' && statement.at(0) != 'x')) {
+        return;
+    }
+
+    QString name = QString::fromLocal8Bit(NetlistParser::getInstanceType(NetlistParser::splitTokens(statement)));
+    if(!name.isEmpty() && !block->children.contains(name)) {
+        block->children<<name;
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef NETLISTSPLITTER_H
+#define NETLISTSPLITTER_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QByteArray>
+#include <QStringList>
+
+/*!*********************************************************************************************************************
+ * \brief The NetlistSplitter class imports a netlist holding many subcircuits, as delivered by vendors, into per-cell
+ * views '<library>/<view>/<cell>.<view>'. The netlist is read once and the text of every top level subcircuit is kept
+ * with the names of the subcircuits it instantiates; control statements outside of subcircuits (e.g. '.GLOBAL',
+ * '.PARAM') are copied into every view, except includes and library sections ('.LIB' up to '.ENDL'). View files are
+ * written in parallel by a pool of jobs, each file with a single buffered write.
+ **********************************************************************************************************************/
+class NetlistSplitter
+{
+public:
+    NetlistSplitter();
+
+    bool                                read(const QString &fileName);
+    int                                 write(const QString &libPath, const QString &viewName,
+                                              const QStringList &subckts, bool withDependencies, bool overwrite,
+                                              bool dryRun = false, int jobs = 0);
+
+    QStringList                         getSubcktNames() const;
+    QList<QStringList>                  getReport() const;
+    QStringList                         getErrors() const;
+
+    static QStringList                  getColumns();
+    static QString                      getViewName(const QString &fileName);
+
+private:
+    /*!
+     * \brief The Block struct keeps the text of a subcircuit definition.
+     */
+    struct Block {
+        QString                         name;               /*!< Name of the subcircuit. */
+        QByteArray                      text;               /*!< Lines from '.SUBCKT' to '.ENDS'. */
+        QStringList                     children;           /*!< Instantiated subcircuits, each once. */
+    };
+
+    void                                addBlock(const Block &block, int line);
+    QList<int>                          getDependencies(int block) const;
+
+    static void                         addInstance(Block *block, const QByteArray &statement);
+
+private:
+    QString                             m_fileName;         /*!< Path of the read netlist, used in error messages. */
+    QByteArray                          m_preamble;         /*!< Control statements outside of subcircuits. */
+    QList<Block>                        m_blocks;           /*!< Subcircuits in the order of their definition. */
+    QHash<QString, int>                 m_blockIds;         /*!< Map of upper case subcircuit names to blocks. */
+    QList<QStringList>                  m_report;           /*!< Cell, path and status of every requested view. */
+    QStringList                         m_errorList;        /*!< Errors of reading and writing. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Returns rows of cell, view path and status ('written', 'skipped', 'failed' or 'planned') of the last write()
+ * call.
+ **********************************************************************************************************************/
+inline QList<QStringList> NetlistSplitter::getReport() const
+{
+    return m_report;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns errors of the last read() and write() calls.
+ **********************************************************************************************************************/
+inline QStringList NetlistSplitter::getErrors() const
+{
+    return m_errorList;
+}
+
+#endif // NETLISTSPLITTER_H
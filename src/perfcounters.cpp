@@ -0,0 +1,322 @@
+#include <algorithm>
+
+#include <QMutex>
+#include <QMutexLocker>
+
+#include "perfcounters.h"
+
+/*!
+ * \brief The PerfKeyStat struct keeps durations of a single key, e.g. of a library.
+ */
+struct PerfKeyStat {
+    qint64                      count;          /*!< Number of durations. */
+    qint64                      total;          /*!< Sum of durations in nanoseconds. */
+    qint64                      max;            /*!< Longest duration in nanoseconds. */
+};
+
+/*!
+ * \brief The PerfHistogram struct keeps durations of a histogram.
+ */
+struct PerfHistogram {
+    qint64                      buckets[PerfCounters::BUCKET_COUNT];    /*!< Counts of power of two microsecond buckets. */
+    qint64                      count;          /*!< Number of durations. */
+    qint64                      total;          /*!< Sum of durations in nanoseconds. */
+    qint64                      max;            /*!< Longest duration in nanoseconds. */
+    QMap<QString, PerfKeyStat>  keys;           /*!< Durations per key. */
+};
+
+/*!
+ * \brief Maximal number of keys shown per histogram, the ones with the longest total duration are chosen.
+ */
+static const int PERF_MAX_KEYS = 20;
+
+static QMutex s_perfMutex;
+static qint64 s_counters[PerfCounters::COUNTER_COUNT];
+static PerfHistogram s_histograms[PerfCounters::HISTOGRAM_COUNT];
+
+/*!*********************************************************************************************************************
+ * \brief Adds value to the counter.
+ * \param counter       Counter to increase.
+ * \param value         Value to add.
+ **********************************************************************************************************************/
+void PerfCounters::add(COUNTER counter, qint64 value)
+{
+    QMutexLocker locker(&s_perfMutex);
+    s_counters[counter] += value;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Adds duration to the histogram.
+ * \param histogram     Histogram to add to.
+ * \param nsecs         Duration in nanoseconds.
+ * \param key           Optional key to collect durations per item, e.g. per library.
+ **********************************************************************************************************************/
+void PerfCounters::addDuration(HISTOGRAM histogram, qint64 nsecs, const QString &key)
+{
+    QMutexLocker locker(&s_perfMutex);
+
+    PerfHistogram &data = s_histograms[histogram];
+    data.buckets[getBucket(nsecs / 1000)]++;
+    data.count++;
+    data.total += nsecs;
+    data.max = qMax(data.max, nsecs);
+
+    if(key.isEmpty()) {
+        return;
+    }
+
+    QMap<QString, PerfKeyStat>::iterator it = data.keys.find(key);
+    if(it == data.keys.end()) {
+        PerfKeyStat stat = { 0, 0, 0 };
+        it = data.keys.insert(key, stat);
+    }
+
+    it->count++;
+    it->total += nsecs;
+    it->max = qMax(it->max, nsecs);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Sets all counters and histograms to zero.
+ **********************************************************************************************************************/
+void PerfCounters::reset()
+{
+    QMutexLocker locker(&s_perfMutex);
+
+    for(int i = 0; i < COUNTER_COUNT; ++i) {
+        s_counters[i] = 0;
+    }
+
+    for(int i = 0; i < HISTOGRAM_COUNT; ++i) {
+        PerfHistogram &data = s_histograms[i];
+        std::fill(data.buckets, data.buckets + BUCKET_COUNT, 0);
+        data.count = 0;
+        data.total = 0;
+        data.max = 0;
+        data.keys.clear();
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns value of the counter.
+ * \param counter       Counter to read.
+ **********************************************************************************************************************/
+qint64 PerfCounters::getValue(COUNTER counter)
+{
+    QMutexLocker locker(&s_perfMutex);
+    return s_counters[counter];
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns number of durations added to the histogram.
+ * \param histogram     Histogram to read.
+ **********************************************************************************************************************/
+qint64 PerfCounters::getCount(HISTOGRAM histogram)
+{
+    QMutexLocker locker(&s_perfMutex);
+    return s_histograms[histogram].count;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns estimated percentile of the histogram in nanoseconds, it is the upper bound of the bucket holding it.
+ * \param histogram     Histogram to read.
+ * \param percent       Percentile from 0 to 100.
+ **********************************************************************************************************************/
+qint64 PerfCounters::getPercentile(HISTOGRAM histogram, int percent)
+{
+    QMutexLocker locker(&s_perfMutex);
+
+    const PerfHistogram &data = s_histograms[histogram];
+    if(!data.count) {
+        return 0;
+    }
+
+    qint64 rank = (data.count * percent + 99) / 100;
+    qint64 seen = 0;
+
+    for(int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += data.buckets[i];
+        if(seen >= rank && seen) {
+            return qMin(data.max, (qint64(1) << (i + 1)) * 1000);
+        }
+    }
+
+    return data.max;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns rows of metric name and formatted value of all counters and histograms. Histograms are followed by
+ * their slowest keys.
+ **********************************************************************************************************************/
+QList<QStringList> PerfCounters::getReport()
+{
+    QList<QStringList> rows;
+
+    qint64 counters[COUNTER_COUNT];
+    {
+        QMutexLocker locker(&s_perfMutex);
+        std::copy(s_counters, s_counters + COUNTER_COUNT, counters);
+    }
+
+    for(int i = 0; i < COUNTER_COUNT; ++i) {
+        COUNTER counter = COUNTER(i);
+        bool isBytes = counter == BYTES_READ || counter == BYTES_WRITTEN || counter == BYTES_PREFETCHED;
+
+        rows<<(QStringList()<<getCounterName(counter)
+                            <<(isBytes ? formatBytes(counters[i]) : QString::number(counters[i])));
+    }
+
+    qint64 lookups = counters[CACHE_HITS] + counters[CACHE_MISSES];
+    rows<<(QStringList()<<"Cache hit rate"
+                        <<(lookups ? QString("%1 %").arg(100.0 * counters[CACHE_HITS] / lookups, 0, 'f', 1) : "-"));
+
+    for(int i = 0; i < HISTOGRAM_COUNT; ++i) {
+        HISTOGRAM histogram = HISTOGRAM(i);
+
+        qint64 p50 = getPercentile(histogram, 50);
+        qint64 p90 = getPercentile(histogram, 90);
+        qint64 p99 = getPercentile(histogram, 99);
+
+        QMutexLocker locker(&s_perfMutex);
+        const PerfHistogram &data = s_histograms[i];
+
+        if(!data.count) {
+            rows<<(QStringList()<<getHistogramName(histogram)<<"-");
+            continue;
+        }
+
+        rows<<(QStringList()<<getHistogramName(histogram)
+                            <<QString("n=%1  mean=%2  p50<=%3  p90<=%4  p99<=%5  max=%6")
+                              .arg(data.count)
+                              .arg(formatDuration(data.total / data.count))
+                              .arg(formatDuration(p50))
+                              .arg(formatDuration(p90))
+                              .arg(formatDuration(p99))
+                              .arg(formatDuration(data.max)));
+
+        QList<QPair<qint64, QString> > keys;
+        QMap<QString, PerfKeyStat>::const_iterator it;
+        for(it = data.keys.constBegin(); it != data.keys.constEnd(); ++it) {
+            keys<<qMakePair(-it->total, it.key());
+        }
+
+        std::sort(keys.begin(), keys.end());
+
+        for(int j = 0; j < keys.count() && j < PERF_MAX_KEYS; ++j) {
+            PerfKeyStat stat = data.keys.value(keys[j].second);
+
+            rows<<(QStringList()<<"    " + keys[j].second
+                                <<QString("n=%1  mean=%2  max=%3  total=%4")
+                                  .arg(stat.count)
+                                  .arg(formatDuration(stat.total / stat.count))
+                                  .arg(formatDuration(stat.max))
+                                  .arg(formatDuration(stat.total)));
+        }
+    }
+
+    return rows;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns report as tab separated lines, e.g. to be pasted into a bug report.
+ **********************************************************************************************************************/
+QString PerfCounters::getReportText()
+{
+    QStringList lines;
+    foreach(const QStringList &row, getReport()) {
+        lines<<row.join("\t");
+    }
+
+    return lines.join("\n") + "\n";
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns display name of the counter.
+ * \param counter       Counter.
+ **********************************************************************************************************************/
+QString PerfCounters::getCounterName(COUNTER counter)
+{
+    switch(counter) {
+    case STAT_CALLS:        return "File stat calls";
+    case READDIR_CALLS:     return "Folder listings";
+    case FILES_READ:        return "Files read";
+    case BYTES_READ:        return "Bytes read";
+    case FILES_WRITTEN:     return "Files written";
+    case BYTES_WRITTEN:     return "Bytes written";
+    case JOBS_DONE:         return "Jobs done";
+    case JOBS_FAILED:       return "Jobs failed";
+    case CACHE_HITS:        return "Cache hits";
+    case CACHE_MISSES:      return "Cache misses";
+    case BYTES_PREFETCHED:  return "Bytes prefetched";
+    default:                break;
+    }
+
+    return QString();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns display name of the histogram.
+ * \param histogram     Histogram.
+ **********************************************************************************************************************/
+QString PerfCounters::getHistogramName(HISTOGRAM histogram)
+{
+    switch(histogram) {
+    case SCAN_DURATION:     return "Library scan";
+    case FILTER_LATENCY:    return "Filter latency";
+    case JOB_DURATION:      return "Job duration";
+    case LOAD_DURATION:     return "Project load";
+    default:                break;
+    }
+
+    return QString();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns bucket index of the duration: bucket i holds durations below 2^(i+1) microseconds.
+ * \param usecs         Duration in microseconds.
+ **********************************************************************************************************************/
+int PerfCounters::getBucket(qint64 usecs)
+{
+    int bucket = 0;
+    while(usecs > 1 && bucket < BUCKET_COUNT - 1) {
+        usecs >>= 1;
+        bucket++;
+    }
+
+    return bucket;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Formats duration with a unit suitable for its magnitude.
+ * \param nsecs         Duration in nanoseconds.
+ **********************************************************************************************************************/
+QString PerfCounters::formatDuration(qint64 nsecs)
+{
+    if(nsecs >= 1000000000) {
+        return QString("%1 s").arg(nsecs / 1e9, 0, 'f', 2);
+    }
+    else if(nsecs >= 1000000) {
+        return QString("%1 ms").arg(nsecs / 1e6, 0, 'f', 2);
+    }
+
+    return QString("%1 us").arg(nsecs / 1e3, 0, 'f', 1);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Formats number of bytes with a binary unit.
+ * \param bytes         Number of bytes.
+ **********************************************************************************************************************/
+QString PerfCounters::formatBytes(qint64 bytes)
+{
+    if(bytes >= (qint64(1) << 30)) {
+        return QString("%1 GiB").arg(bytes / double(qint64(1) << 30), 0, 'f', 2);
+    }
+    else if(bytes >= (1 << 20)) {
+        return QString("%1 MiB").arg(bytes / double(1 << 20), 0, 'f', 2);
+    }
+    else if(bytes >= (1 << 10)) {
+        return QString("%1 KiB").arg(bytes / double(1 << 10), 0, 'f', 2);
+    }
+
+    return QString("%1 B").arg(bytes);
+}
@@ -0,0 +1,107 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <QMap>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QElapsedTimer>
+
+/*!*********************************************************************************************************************
+ * \brief The PerfCounters class collects always-on counters and duration histograms of file system access, scans,
+ * filtering and jobs. It is shared by all threads; updates are serialized by a mutex, which costs far less than the
+ * file system calls being counted. Histograms use power of two buckets in microseconds, so percentiles are estimated
+ * as the upper bound of their bucket.
+ **********************************************************************************************************************/
+class PerfCounters
+{
+public:
+    /*!
+     * \brief The COUNTER enum specifies event counters.
+     */
+    enum COUNTER {
+        STAT_CALLS              = 0,
+        READDIR_CALLS,
+        FILES_READ,
+        BYTES_READ,
+        FILES_WRITTEN,
+        BYTES_WRITTEN,
+        JOBS_DONE,
+        JOBS_FAILED,
+        CACHE_HITS,
+        CACHE_MISSES,
+        BYTES_PREFETCHED,
+        COUNTER_COUNT
+    };
+
+    /*!
+     * \brief The HISTOGRAM enum specifies duration histograms.
+     */
+    enum HISTOGRAM {
+        SCAN_DURATION           = 0,
+        FILTER_LATENCY,
+        JOB_DURATION,
+        LOAD_DURATION,
+        HISTOGRAM_COUNT
+    };
+
+    enum {
+        BUCKET_COUNT            = 32
+    };
+
+    static void                 add(COUNTER counter, qint64 value = 1);
+    static void                 addDuration(HISTOGRAM histogram, qint64 nsecs, const QString &key = QString());
+    static void                 reset();
+
+    static qint64               getValue(COUNTER counter);
+    static qint64               getCount(HISTOGRAM histogram);
+    static qint64               getPercentile(HISTOGRAM histogram, int percent);
+
+    static QList<QStringList>   getReport();
+    static QString              getReportText();
+
+    static QString              getCounterName(COUNTER counter);
+    static QString              getHistogramName(HISTOGRAM histogram);
+
+private:
+    static int                  getBucket(qint64 usecs);
+    static QString              formatDuration(qint64 nsecs);
+    static QString              formatBytes(qint64 bytes);
+};
+
+/*!*********************************************************************************************************************
+ * \brief The PerfTimer class adds the time between its construction and destruction to a histogram.
+ **********************************************************************************************************************/
+class PerfTimer
+{
+public:
+    explicit PerfTimer(PerfCounters::HISTOGRAM histogram, const QString &key = QString());
+    ~PerfTimer();
+
+private:
+    PerfCounters::HISTOGRAM     m_histogram;    /*!< Histogram the duration is added to. */
+    QString                     m_key;          /*!< Optional key, e.g. path of the scanned library. */
+    QElapsedTimer               m_timer;        /*!< Timer started on construction. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Starts measuring.
+ * \param histogram     Histogram the duration is added to.
+ * \param key           Optional key to collect durations per item, e.g. per library.
+ **********************************************************************************************************************/
+inline PerfTimer::PerfTimer(PerfCounters::HISTOGRAM histogram, const QString &key)
+    : m_histogram(histogram),
+      m_key(key)
+{
+    m_timer.start();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Adds measured duration to the histogram.
+ **********************************************************************************************************************/
+inline PerfTimer::~PerfTimer()
+{
+    PerfCounters::addDuration(m_histogram, m_timer.nsecsElapsed(), m_key);
+}
+
+#endif // PERFCOUNTERS_H
@@ -0,0 +1,118 @@
+#include <QTimer>
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+#include <QClipboard>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QTreeWidget>
+#include <QApplication>
+
+#include "perfpanel.h"
+#include "perfcounters.h"
+
+/*!*********************************************************************************************************************
+ * \brief Constructs the panel, it is hidden until the user shows it.
+ * \param parent        Parent widget, by default is NULL.
+ **********************************************************************************************************************/
+PerfPanel::PerfPanel(QWidget *parent) :
+    QDockWidget(tr("Performance"), parent),
+    m_tree(new QTreeWidget),
+    m_timer(new QTimer(this))
+{
+    setObjectName("dockPerformance");
+
+    m_tree->setColumnCount(2);
+    m_tree->setHeaderLabels(QStringList()<<tr("Metric")<<tr("Value"));
+    m_tree->setRootIsDecorated(false);
+    m_tree->setAlternatingRowColors(true);
+
+    QPushButton *btnReset = new QPushButton(tr("Reset"));
+    btnReset->setStatusTip(tr("Set all counters to zero."));
+    connect(btnReset, SIGNAL(clicked()), this, SLOT(resetCounters()));
+
+    QPushButton *btnCopy = new QPushButton(tr("Copy"));
+    btnCopy->setStatusTip(tr("Copy counters to the clipboard."));
+    connect(btnCopy, SIGNAL(clicked()), this, SLOT(copyToClipboard()));
+
+    QHBoxLayout *buttons = new QHBoxLayout;
+    buttons->addStretch();
+    buttons->addWidget(btnReset);
+    buttons->addWidget(btnCopy);
+
+    QVBoxLayout *layout = new QVBoxLayout;
+    layout->setContentsMargins(2, 2, 2, 2);
+    layout->addWidget(m_tree);
+    layout->addLayout(buttons);
+
+    QWidget *widget = new QWidget;
+    widget->setLayout(layout);
+    setWidget(widget);
+
+    m_timer->setInterval(1000);
+    connect(m_timer, SIGNAL(timeout()), this, SLOT(refresh()));
+}
+
+/*!*********************************************************************************************************************
+ * \brief Updates the table with current values. Existing rows are reused, so the scroll position is kept.
+ **********************************************************************************************************************/
+void PerfPanel::refresh()
+{
+    QList<QStringList> rows = PerfCounters::getReport();
+
+    while(m_tree->topLevelItemCount() > rows.count()) {
+        delete m_tree->takeTopLevelItem(m_tree->topLevelItemCount() - 1);
+    }
+
+    for(int i = 0; i < rows.count(); ++i) {
+        QTreeWidgetItem *item = m_tree->topLevelItem(i);
+        if(!item) {
+            item = new QTreeWidgetItem;
+            m_tree->addTopLevelItem(item);
+        }
+
+        item->setText(0, rows[i].value(0));
+        item->setText(1, rows[i].value(1));
+    }
+
+    m_tree->resizeColumnToContents(0);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Sets all counters to zero.
+ **********************************************************************************************************************/
+void PerfPanel::resetCounters()
+{
+    PerfCounters::reset();
+    refresh();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Copies all counters to the clipboard as tab separated lines.
+ **********************************************************************************************************************/
+void PerfPanel::copyToClipboard()
+{
+    QApplication::clipboard()->setText(PerfCounters::getReportText());
+}
+
+/*!*********************************************************************************************************************
+ * \brief Starts refreshing when the panel is shown.
+ * \param event         Show event.
+ **********************************************************************************************************************/
+void PerfPanel::showEvent(QShowEvent *event)
+{
+    QDockWidget::showEvent(event);
+
+    refresh();
+    m_timer->start();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Stops refreshing while the panel is hidden, counters are still collected.
+ * \param event         Hide event.
+ **********************************************************************************************************************/
+void PerfPanel::hideEvent(QHideEvent *event)
+{
+    m_timer->stop();
+
+    QDockWidget::hideEvent(event);
+}
@@ -0,0 +1,34 @@
+#ifndef PERFPANEL_H
+#define PERFPANEL_H
+
+#include <QDockWidget>
+
+class QTimer;
+class QTreeWidget;
+
+/*!*********************************************************************************************************************
+ * \brief The PerfPanel class shows performance counters in a dockable panel. The values are refreshed every second
+ * while the panel is visible; they can be reset and copied to the clipboard as tab separated text.
+ **********************************************************************************************************************/
+class PerfPanel : public QDockWidget
+{
+    Q_OBJECT
+
+public:
+    explicit PerfPanel(QWidget *parent = 0);
+
+public slots:
+    void                                refresh();
+    void                                resetCounters();
+    void                                copyToClipboard();
+
+protected:
+    void                                showEvent(QShowEvent *event);
+    void                                hideEvent(QHideEvent *event);
+
+private:
+    QTreeWidget                         *m_tree;            /*!< Table of metric names and values. */
+    QTimer                              *m_timer;           /*!< Timer to refresh the values. */
+};
+
+#endif // PERFPANEL_H
@@ -0,0 +1,199 @@
+#include <QMap>
+#include <QLabel>
+#include <QTimer>
+#include <QComboBox>
+#include <QFileInfo>
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+#include <QPushButton>
+
+#include "previewpanel.h"
+#include "textview.h"
+
+/*!*********************************************************************************************************************
+ * \brief Interval in milliseconds the line index is polled while it is built.
+ **********************************************************************************************************************/
+static const int PREVIEW_POLL_INTERVAL = 200;
+
+/*!*********************************************************************************************************************
+ * \brief Default size in MB from which netlists and cell lists are previewed instead of opened with the editor,
+ * overridden by the LIBMAN_PREVIEW_MB environment variable.
+ **********************************************************************************************************************/
+static const qint64 PREVIEW_DEFAULT_MB = 64;
+
+/*!*********************************************************************************************************************
+ * \brief Constructs the panel, it is hidden until a file is previewed.
+ * \param parent        Parent widget, by default is NULL.
+ **********************************************************************************************************************/
+PreviewPanel::PreviewPanel(QWidget *parent) :
+    QDockWidget(tr("Preview"), parent),
+    m_view(new TextView),
+    m_status(new QLabel),
+    m_subckts(new QComboBox),
+    m_timer(new QTimer(this))
+{
+    setObjectName("dockPreview");
+
+    m_subckts->setEditable(true);
+    m_subckts->setInsertPolicy(QComboBox::NoInsert);
+    m_subckts->setMinimumContentsLength(24);
+    m_subckts->setStatusTip(tr("Jump to the definition of a subcircuit."));
+    connect(m_subckts, SIGNAL(activated(int)), this, SLOT(jumpToSubckt(int)));
+
+    QPushButton *btnClose = new QPushButton(tr("Close"));
+    btnClose->setStatusTip(tr("Close the previewed file."));
+    connect(btnClose, SIGNAL(clicked()), this, SLOT(closeFile()));
+
+    QHBoxLayout *header = new QHBoxLayout;
+    header->addWidget(m_status, 1);
+    header->addWidget(new QLabel(tr("Subcircuit:")));
+    header->addWidget(m_subckts);
+    header->addWidget(btnClose);
+
+    QVBoxLayout *layout = new QVBoxLayout;
+    layout->setContentsMargins(2, 2, 2, 2);
+    layout->addLayout(header);
+    layout->addWidget(m_view);
+
+    QWidget *widget = new QWidget;
+    widget->setLayout(layout);
+    setWidget(widget);
+
+    m_timer->setInterval(PREVIEW_POLL_INTERVAL);
+    connect(m_timer, SIGNAL(timeout()), this, SLOT(updateIndex()));
+}
+
+/*!*********************************************************************************************************************
+ * \brief Shows the file from its first line. Subcircuits are listed once they are set by setSubckts().
+ * \param fileName      Path to the text file.
+ * \return              True if the file has been opened, otherwise false and the reasons are in the error list.
+ **********************************************************************************************************************/
+bool PreviewPanel::open(const QString &fileName)
+{
+    closeFile();
+
+    if(!m_view->open(fileName)) {
+        return false;
+    }
+
+    setSubckts(fileName, QList<NetlistParser::Subckt>());
+
+    m_timer->start();
+    updateIndex();
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Lists the given subcircuits of the file by name. They are ignored if another file is shown meanwhile.
+ * \param fileName      Path to the text file the subcircuits belong to.
+ * \param subckts       Subcircuits of the file from the netlist index, empty if the file is not indexed.
+ **********************************************************************************************************************/
+void PreviewPanel::setSubckts(const QString &fileName, const QList<NetlistParser::Subckt> &subckts)
+{
+    if(fileName != m_view->getFileName()) {
+        return;
+    }
+
+    m_subckts->clear();
+    m_subcktLines.clear();
+
+    // The first definition wins if a netlist defines a subcircuit twice, as it does for the simulator.
+    QMap<QString, int> lines;
+    foreach(const NetlistParser::Subckt &subckt, subckts) {
+        if(!lines.contains(subckt.name)) {
+            lines[subckt.name] = subckt.line;
+        }
+    }
+
+    QMap<QString, int>::const_iterator it;
+    for(it = lines.constBegin(); it != lines.constEnd(); ++it) {
+        m_subckts->addItem(it.key());
+        m_subcktLines<<it.value();
+    }
+
+    m_subckts->setCurrentIndex(-1);
+    m_subckts->setEnabled(!m_subcktLines.isEmpty());
+    m_subckts->setToolTip(m_subcktLines.isEmpty() ? tr("Subcircuits are listed once the view is indexed by 'Info'.")
+                                                  : QString());
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns errors of opening the file.
+ **********************************************************************************************************************/
+QStringList PreviewPanel::getErrors() const
+{
+    return m_view->getErrors();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns the size from which files are previewed, set by the LIBMAN_PREVIEW_MB environment variable, 64 MB by
+ * default. A negative value disables the preview on double-click.
+ **********************************************************************************************************************/
+qint64 PreviewPanel::getThreshold()
+{
+    bool isNumber = false;
+    qint64 megabytes = QString::fromLocal8Bit(qgetenv("LIBMAN_PREVIEW_MB")).toLongLong(&isNumber);
+
+    if(isNumber && megabytes < 0) {
+        return -1;
+    }
+
+    return (isNumber ? megabytes : PREVIEW_DEFAULT_MB) * 1024 * 1024;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Closes the file, so it is no longer mapped, and hides the panel.
+ **********************************************************************************************************************/
+void PreviewPanel::closeFile()
+{
+    m_timer->stop();
+    m_view->close();
+
+    m_subckts->clear();
+    m_subcktLines.clear();
+    m_status->clear();
+
+    hide();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Shows the lines indexed so far and the progress. Polling stops once the whole file is indexed.
+ **********************************************************************************************************************/
+void PreviewPanel::updateIndex()
+{
+    const LineIndex &index = m_view->getLineIndex();
+    qint64 size = m_view->getFileSize();
+
+    // Read before the line count, so the last line is not missed if the build ends in between.
+    bool isDone = index.isDone();
+
+    m_view->updateLineCount();
+
+    QString status = QString("%1 - %2 lines").arg(QFileInfo(m_view->getFileName()).fileName())
+                                             .arg(index.getLineCount());
+
+    if(isDone) {
+        m_timer->stop();
+    }
+    else {
+        status += QString(", indexing %1 %").arg(size > 0 ? index.getIndexedBytes() * 100 / size : 100);
+    }
+
+    m_status->setText(status);
+    m_status->setToolTip(m_view->getFileName());
+}
+
+/*!*********************************************************************************************************************
+ * \brief Scrolls to the '.SUBCKT' statement of the chosen subcircuit.
+ * \param index         Index of the subcircuit in the combo box.
+ **********************************************************************************************************************/
+void PreviewPanel::jumpToSubckt(int index)
+{
+    if(index < 0 || index >= m_subcktLines.count()) {
+        return;
+    }
+
+    m_view->scrollToLine(m_subcktLines[index] - 1);
+    m_view->setFocus();
+}
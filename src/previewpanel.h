@@ -0,0 +1,47 @@
+#ifndef PREVIEWPANEL_H
+#define PREVIEWPANEL_H
+
+#include <QDockWidget>
+
+#include "netlistparser.h"
+
+class QLabel;
+class QTimer;
+class QComboBox;
+class TextView;
+
+/*!*********************************************************************************************************************
+ * \brief The PreviewPanel class shows a large text view or document read-only in a dockable panel, instead of
+ * launching an editor that loads the whole file. The subcircuits of an indexed netlist are listed, so the view can jump
+ * to their definition; the progress of the line index is shown while it is built.
+ **********************************************************************************************************************/
+class PreviewPanel : public QDockWidget
+{
+    Q_OBJECT
+
+public:
+    explicit PreviewPanel(QWidget *parent = 0);
+
+    bool                                open(const QString &fileName);
+    void                                setSubckts(const QString &fileName,
+                                                   const QList<NetlistParser::Subckt> &subckts);
+    QStringList                         getErrors() const;
+
+    static qint64                       getThreshold();
+
+public slots:
+    void                                closeFile();
+
+private slots:
+    void                                updateIndex();
+    void                                jumpToSubckt(int index);
+
+private:
+    TextView                            *m_view;            /*!< Memory mapped view of the file. */
+    QLabel                              *m_status;          /*!< File name, line count and indexing progress. */
+    QComboBox                           *m_subckts;         /*!< Subcircuits of the netlist, sorted by name. */
+    QTimer                              *m_timer;           /*!< Polls the line index while it is built. */
+    QList<int>                          m_subcktLines;      /*!< Line of the '.SUBCKT' statement per combo box item. */
+};
+
+#endif // PREVIEWPANEL_H
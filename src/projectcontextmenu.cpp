@@ -1,12 +1,17 @@
 #include <QMenu>
 #include <QFile>
 #include <QDebug>
+#include <QDialog>
 #include <QDateTime>
 #include <QFileInfo>
 #include <QSettings>
 #include <QMouseEvent>
 #include <QTextStream>
 #include <QFileDialog>
+#include <QApplication>
+#include <QInputDialog>
+#include <QTreeWidget>
+#include <QVBoxLayout>
 #include <QDesktopWidget>
 #include <QListWidgetItem>
 
@@ -17,7 +22,145 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 
+#include "backgroundjob.h"
+#include "catalog.h"
 #include "property.h"
+#include "viewcheck.h"
+#include "netlistindex.h"
+#include "netlistsplitter.h"
+#include "perfcounters.h"
+#include "trace.h"
+
+/*!*********************************************************************************************************************
+ * \brief The ImportNetlistJob class splits a netlist into per-cell views of a project and lists the new cells.
+ **********************************************************************************************************************/
+class ImportNetlistJob : public BackgroundJob
+{
+public:
+    ImportNetlistJob(MainWindow *window, const QString &fileName, const QString &libPath, const QString &projName,
+                     const QString &viewName, bool withDependencies)
+        : BackgroundJob(window), m_fileName(fileName), m_libPath(libPath), m_projName(projName),
+          m_viewName(viewName), m_withDependencies(withDependencies), m_written(0) {}
+
+    void run();
+    void finish();
+
+private:
+    QString                             m_fileName;         /*!< Path to the netlist. */
+    QString                             m_libPath;          /*!< Path to the project (library). */
+    QString                             m_projName;         /*!< Name of the project (library). */
+    QString                             m_viewName;         /*!< Name of the views, 'cdl' or 'spice'. */
+    bool                                m_withDependencies; /*!< State if instantiated subcircuits are copied. */
+    int                                 m_written;          /*!< Number of written views. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Reads the netlist and writes the views which do not exist yet.
+ **********************************************************************************************************************/
+void ImportNetlistJob::run()
+{
+    NetlistSplitter splitter;
+    splitter.read(m_fileName);
+    m_errorList<<splitter.getErrors();
+
+    m_written = splitter.write(m_libPath, m_viewName, QStringList(), m_withDependencies, false);
+    m_errorList<<splitter.getErrors();
+
+    m_info = QString("Imported %1 of %2 subcircuits of '%3' as '%4' views of project '%5'.\n").arg(m_written)
+             .arg(splitter.getSubcktNames().count()).arg(m_fileName).arg(m_viewName).arg(m_projName);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Reloads the cell list once if views have been written and prints the result.
+ **********************************************************************************************************************/
+void ImportNetlistJob::finish()
+{
+    if(m_written) {
+        reloadLibrary(m_libPath);
+    }
+
+    BackgroundJob::finish();
+}
+
+/*!*********************************************************************************************************************
+ * \brief The ProjectCheckJob class compares layout and netlist views of all cells of a project and shows the findings.
+ **********************************************************************************************************************/
+class ProjectCheckJob : public BackgroundJob
+{
+public:
+    ProjectCheckJob(MainWindow *window, const QString &projName, const QString &libPath)
+        : BackgroundJob(window), m_projName(projName), m_libPath(libPath) {}
+
+    void run();
+    void finish();
+
+private:
+    QString                             m_projName;         /*!< Name of the project (library). */
+    QString                             m_libPath;          /*!< Path to the project (library). */
+    QList<ViewCheck::Issue>             m_issues;           /*!< Findings of the check. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Brings the netlist views of the project up to date in the netlist index and checks all cells.
+ **********************************************************************************************************************/
+void ProjectCheckJob::run()
+{
+    QMap<QString, QString> libraries;
+    libraries[m_projName] = m_libPath;
+
+    ViewCheck check;
+    check.scanLibraries(getCatalog(), libraries);
+
+    QStringList viewPaths;
+    foreach(const QStringList &view, check.getNetlistViews()) {
+        viewPaths<<view[3];
+    }
+
+    updateNetlistIndex(viewPaths);
+    check.run(getNetlistIndex());
+
+    m_issues = check.getIssues();
+
+    m_info = QString("Checked %1 cells of project '%2': %3 errors, %4 warnings.\n").arg(check.getCellCount())
+             .arg(m_projName).arg(check.getErrorCount()).arg(m_issues.count() - check.getErrorCount());
+}
+
+/*!*********************************************************************************************************************
+ * \brief Prints the summary and lists the findings in a dialog, which is closed by the user.
+ **********************************************************************************************************************/
+void ProjectCheckJob::finish()
+{
+    BackgroundJob::finish();
+
+    if(m_issues.isEmpty()) {
+        return;
+    }
+
+    QDialog *dialog = new QDialog(m_window);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->setWindowTitle(QObject::tr("View Check: %1").arg(m_projName));
+    dialog->resize(900, 500);
+
+    QTreeWidget *report = new QTreeWidget(dialog);
+    report->setHeaderLabels(ViewCheck::getColumns());
+    report->setRootIsDecorated(false);
+    report->setAlternatingRowColors(true);
+
+    foreach(const ViewCheck::Issue &issue, m_issues) {
+        new QTreeWidgetItem(report, ViewCheck::toRow(issue));
+    }
+
+    report->setSortingEnabled(true);
+    report->sortByColumn(1, Qt::AscendingOrder);
+    for(int i = 0; i < report->columnCount() - 1; ++i) {
+        report->resizeColumnToContents(i);
+    }
+
+    QVBoxLayout *layout = new QVBoxLayout(dialog);
+    layout->addWidget(report);
+
+    dialog->show();
+}
 
 /*!******************************************************************************************************************
  * \brief Deletes folder recursevly.
@@ -65,11 +208,13 @@ void MainWindow::copyDir(const QString &sourceFolder, const QString &destFolder)
         destDir.mkdir(destFolder);
     }
 
+    PerfCounters::add(PerfCounters::READDIR_CALLS, 2);
+
     QStringList files = sourceDir.entryList(QDir::Files);
     for(int i = 0; i< files.count(); i++) {
         QString srcName = sourceFolder + "/" + files[i];
         QString destName = destFolder + "/" + files[i];
-        QFile::copy(srcName, destName);
+        Catalog::copyFile(srcName, destName);
     }
 
     files.clear();
@@ -231,6 +376,16 @@ void MainWindow::showLibraryMenu(const QPoint &pos)
         connect(projInfo, SIGNAL(triggered()), this, SLOT(showProjectInfo()));
         menu->addAction(projInfo);
 
+        QAction *projCheck = new QAction(tr("Check &Views"), this);
+        projCheck->setStatusTip(tr("Compare layout and netlist views of all cells."));
+        connect(projCheck, SIGNAL(triggered()), this, SLOT(checkProjectViews()));
+        menu->addAction(projCheck);
+
+        QAction *projImport = new QAction(tr("&Import Netlist..."), this);
+        projImport->setStatusTip(tr("Split a netlist into a view per subcircuit."));
+        connect(projImport, SIGNAL(triggered()), this, SLOT(importNetlist()));
+        menu->addAction(projImport);
+
         QMap<QString, QString> projects = getCurrentLibraries();
         if(projects.count() && currentItem && !currentItem->parent()) {
             QMenu *menuGroup = menu->addMenu("Group with");
@@ -305,6 +460,8 @@ void MainWindow::copySelectedProject()
  *******************************************************************************************************************/
 void MainWindow::pasteSelectedData()
 {
+    TRACE_SCOPE("file", "paste");
+
     if(!m_copyData.count()) {
         return;
     }
@@ -423,6 +580,8 @@ void MainWindow::pasteSelectedData()
                 itemView->setText(viewName);
                 m_ui->listViews->addItem(itemView);
 
+                m_cellFilter->clear();
+
                 setStateChanged();
             }
         }
@@ -468,6 +627,8 @@ void MainWindow::pasteSelectedData()
                 item->setText(viewName);
                 m_ui->listViews->addItem(item);
 
+                m_cellFilter->clear();
+
                 setStateChanged();
             }
         }
@@ -525,6 +686,8 @@ void MainWindow::addNewProject()
  *******************************************************************************************************************/
 void MainWindow::removeSelectedProject()
 {
+    TRACE_SCOPE("file", "remove_library");
+
     QList<QTreeWidgetItem *> items = m_ui->treeLibs->selectedItems();
     if(!items.count()) {
         return;
@@ -655,6 +818,68 @@ void MainWindow::showProjectInfo()
     showFolderInfo("Project", projName, libPath);
 }
 
+/*!******************************************************************************************************************
+ * \brief Compares layout and netlist views of all cells of the selected project in the background and lists the
+ * findings in a dialog, which can be sorted by any column.
+ *******************************************************************************************************************/
+void MainWindow::checkProjectViews()
+{
+    TRACE_SCOPE("gui", "check_views");
+
+    QList<QTreeWidgetItem *> items = m_ui->treeLibs->selectedItems();
+    if(!items.count()) {
+        return;
+    }
+
+    QString projName = items.first()->text(0);
+    QString libPath = getLibraryPath(projName);
+    if(projName.isEmpty() || !QFileInfo(libPath).isDir()) {
+        return;
+    }
+
+    m_backgroundQueue->start(new ProjectCheckJob(this, projName, libPath));
+}
+
+/*!******************************************************************************************************************
+ * \brief Imports a netlist with many subcircuits into per-cell 'cdl' or 'spice' views of the selected project in the
+ * background. Existing views are kept; the cell list is reloaded once when all views are written.
+ *******************************************************************************************************************/
+void MainWindow::importNetlist()
+{
+    TRACE_SCOPE("gui", "import_netlist");
+
+    QList<QTreeWidgetItem *> items = m_ui->treeLibs->selectedItems();
+    if(!items.count()) {
+        return;
+    }
+
+    QString projName = items.first()->text(0);
+    QString libPath = getLibraryPath(projName);
+    if(projName.isEmpty() || !QFileInfo(libPath).isDir()) {
+        return;
+    }
+
+    QString fileName = QFileDialog::getOpenFileName(this, tr("Import Netlist"), QString(),
+                                                    tr("Netlists (*.cdl *.sp *.spi *.spice *.cir);;All files (*)"));
+    if(fileName.isEmpty()) {
+        return;
+    }
+
+    QString viewName = NetlistSplitter::getViewName(fileName);
+    if(viewName.isEmpty()) {
+        bool ok = false;
+        viewName = QInputDialog::getItem(this, tr("Import Netlist"), tr("View:"), QStringList()<<"cdl"<<"spice", 0,
+                                         false, &ok);
+        if(!ok) {
+            return;
+        }
+    }
+
+    bool withDependencies = askUserForAction("Would you like to copy instantiated subcircuits into every view?");
+
+    m_backgroundQueue->start(new ImportNetlistJob(this, fileName, libPath, projName, viewName, withDependencies));
+}
+
 /*!******************************************************************************************************************
  * \brief Clears current buffer used for coping of data.
  *******************************************************************************************************************/
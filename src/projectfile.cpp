@@ -12,7 +12,10 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 
+#include "catalog.h"
+#include "catalogclient.h"
 #include "property.h"
+#include "trace.h"
 
 /*!******************************************************************************************************************
  * \brief Loads project file contence into LibMan.
@@ -20,65 +23,36 @@
  *******************************************************************************************************************/
 void MainWindow::loadProjectFile(const QString &fileName)
 {
-    QFile file(fileName);
-    if(!file.open(QFile::ReadOnly | QFile::Text)) {
-        QMessageBox::warning(this, tr("LibManager"),
-                             tr("Can not read file '%1':\n%2.")
-                             .arg(fileName)
-                             .arg(file.errorString()));
+    TRACE_SCOPE_ARG("project", "load", fileName);
+
+    if(!m_catalog->loadProjectFile(fileName)) {
+        QStringList errors = m_catalog->getErrors();
+        m_catalog->clearErrors();
+
+        QMessageBox::warning(this, tr("LibManager"), errors.join("\n"));
         error("Can not read file '" + fileName + "'.");
         return;
     }
 
-    QMap<QString, QStringList> combinedLibs;
-
-    QTextStream in(&file);
-    while (!in.atEnd()) {
-        QString line = in.readLine().remove("^\\s+").remove("\\s+$");
-
-        if(line.startsWith("#")) {
-            continue;
-        }
-
-        if(line.contains("GROUP")) {
-            #if QT_VERSION >= 0x050000
-                QStringList words = line.split(" ", Qt::SkipEmptyParts);
-            #else
-                QStringList words = line.split(" ", QString::SkipEmptyParts);
-            #endif
-            if(words.count() > 1) {
-                QString groupName = words[1];
-                QStringList groupItems;
-                for(int i = 2; i < words.count(); ++i) {
-                    groupItems<<words[i];
-                }
+    m_catalog->setClient(0);
+    if(m_client->connectToDaemon(fileName)) {
+        m_catalog->setClient(m_client);
+        info("Catalog daemon serves project '" + fileName + "'.");
+    }
 
-                combinedLibs[groupName] = groupItems;
-            }
-        }
-        else if(line.contains("PROJECT")) {
-            #if QT_VERSION >= 0x050000
-                QStringList words = line.split(" ", Qt::SkipEmptyParts);
-            #else
-                QStringList words = line.split(" ", QString::SkipEmptyParts);
-            #endif
-            if(words.count() == 3) {
-                QString libName = words[1];
-                QString libPath = words[2];
-
-                if(!libName.isEmpty() && QFileInfo(libPath).exists() && QFileInfo(libPath).isDir()) {
-                    QString key = getLibraryKeyPrefix() + libName;
-                    m_properties->set(key, libPath);
-                }
-            }
-        }
+    QMap<QString, QString> libraries = m_catalog->getLibraries();
+    QMap<QString, QString>::const_iterator it;
+    for(it = libraries.constBegin(); it != libraries.constEnd(); ++it) {
+        QString key = getLibraryKeyPrefix() + it.key();
+        m_properties->set(key, it.value());
     }
 
-    file.close();
+    QMap<QString, QStringList> combinedLibs = m_catalog->getCombinedLibs();
 
     m_ui->treeLibs->clear();
     m_ui->listGroups->clear();
     m_ui->listViews->clear();
+    m_cellFilter->clear();
 
     m_ui->txtLibSearch->clear();
     m_ui->txtCatSearch->clear();
@@ -0,0 +1,216 @@
+#include "recordwriter.h"
+
+/*!*********************************************************************************************************************
+ * \brief Constructs RecordWriter object.
+ * \param out         Stream where rows are written to.
+ * \param format      Output format.
+ * \param columns     Names of the columns. Used as TSV/CSV header and as JSON object keys.
+ **********************************************************************************************************************/
+RecordWriter::RecordWriter(QTextStream *out, FORMAT format, const QStringList &columns)
+    : m_out(out),
+      m_format(format),
+      m_columns(columns),
+      m_started(false),
+      m_finished(false),
+      m_rowCount(0)
+{
+}
+
+/*!*********************************************************************************************************************
+ * \brief Destructs RecordWriter object and closes the output if it has not been done yet.
+ **********************************************************************************************************************/
+RecordWriter::~RecordWriter()
+{
+    finish();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Writes a single row. Missing values are written as empty strings.
+ * \param values      Values of the row in the order of columns.
+ **********************************************************************************************************************/
+void RecordWriter::writeRow(const QStringList &values)
+{
+    if(!m_out || m_finished) {
+        return;
+    }
+
+    if(!m_started) {
+        writeHeader();
+        m_started = true;
+    }
+
+    if(m_format == TSV) {
+        for(int i = 0; i < m_columns.count(); ++i) {
+            if(i) {
+                *m_out<<"\t";
+            }
+
+            *m_out<<escapeTsv(values.value(i));
+        }
+
+        *m_out<<"\n";
+    }
+    else if(m_format == CSV) {
+        for(int i = 0; i < m_columns.count(); ++i) {
+            if(i) {
+                *m_out<<",";
+            }
+
+            *m_out<<escapeCsv(values.value(i));
+        }
+
+        *m_out<<"\n";
+    }
+    else {
+        *m_out<<(m_rowCount ? ",\n" : "\n")<<"  {";
+        for(int i = 0; i < m_columns.count(); ++i) {
+            if(i) {
+                *m_out<<", ";
+            }
+
+            *m_out<<"\""<<escapeJson(m_columns[i])<<"\": \""<<escapeJson(values.value(i))<<"\"";
+        }
+
+        *m_out<<"}";
+    }
+
+    m_rowCount++;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Writes format footer (and header if no rows have been written) and flushes the stream.
+ **********************************************************************************************************************/
+void RecordWriter::finish()
+{
+    if(!m_out || m_finished) {
+        return;
+    }
+
+    if(m_format == JSON) {
+        *m_out<<(m_started ? "\n]\n" : "[]\n");
+    }
+    else if(!m_started) {
+        writeHeader();
+    }
+
+    m_out->flush();
+
+    m_started = true;
+    m_finished = true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Writes TSV/CSV header line or opening bracket of JSON array.
+ **********************************************************************************************************************/
+void RecordWriter::writeHeader()
+{
+    if(m_format == TSV) {
+        *m_out<<m_columns.join("\t")<<"\n";
+    }
+    else if(m_format == CSV) {
+        for(int i = 0; i < m_columns.count(); ++i) {
+            *m_out<<(i ? "," : "")<<escapeCsv(m_columns[i]);
+        }
+
+        *m_out<<"\n";
+    }
+    else {
+        *m_out<<"[";
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Converts format name into FORMAT value.
+ * \param name        Name of the format (json, tsv, csv).
+ * \param format      Output value.
+ * \return            False if name is unknown.
+ **********************************************************************************************************************/
+bool RecordWriter::parseFormat(const QString &name, FORMAT *format)
+{
+    QString lower = name.toLower();
+
+    if(lower == "json") {
+        *format = JSON;
+    }
+    else if(lower == "tsv") {
+        *format = TSV;
+    }
+    else if(lower == "csv") {
+        *format = CSV;
+    }
+    else {
+        return false;
+    }
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Escapes string to be used as JSON string value.
+ * \param value       String to be escaped.
+ **********************************************************************************************************************/
+QString RecordWriter::escapeJson(const QString &value)
+{
+    QString escaped;
+    escaped.reserve(value.length());
+
+    for(int i = 0; i < value.length(); ++i) {
+        QChar c = value[i];
+        switch(c.unicode()) {
+            case '"':
+                escaped += "\\\"";
+                break;
+            case '\\':
+                escaped += "\\\\";
+                break;
+            case '\n':
+                escaped += "\\n";
+                break;
+            case '\r':
+                escaped += "\\r";
+                break;
+            case '\t':
+                escaped += "\\t";
+                break;
+            default:
+                if(c.unicode() < 0x20) {
+                    escaped += QString("\\u%1").arg(c.unicode(), 4, 16, QChar('0'));
+                }
+                else {
+                    escaped += c;
+                }
+                break;
+        }
+    }
+
+    return escaped;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Replaces tabs and line breaks which would break TSV row structure.
+ * \param value       String to be escaped.
+ **********************************************************************************************************************/
+QString RecordWriter::escapeTsv(const QString &value)
+{
+    QString escaped = value;
+    escaped.replace("\\", "\\\\");
+    escaped.replace("\t", "\\t");
+    escaped.replace("\n", "\\n");
+    escaped.replace("\r", "\\r");
+    return escaped;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Quotes string as CSV field if it contains separators, quotes or line breaks (RFC 4180).
+ * \param value       String to be escaped.
+ **********************************************************************************************************************/
+QString RecordWriter::escapeCsv(const QString &value)
+{
+    if(!value.contains(',') && !value.contains('"') && !value.contains('\n') && !value.contains('\r')) {
+        return value;
+    }
+
+    QString escaped = value;
+    escaped.replace("\"", "\"\"");
+    return "\"" + escaped + "\"";
+}
@@ -0,0 +1,47 @@
+#ifndef RECORDWRITER_H
+#define RECORDWRITER_H
+
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+
+/*!*********************************************************************************************************************
+ * \brief The RecordWriter class streams rows of a table as JSON, TSV or CSV. Rows are written as soon as they are added, so
+ * nothing is collected in memory.
+ **********************************************************************************************************************/
+class RecordWriter
+{
+public:
+    /*!
+     * \brief The FORMAT enum specifies supported output formats.
+     */
+    enum FORMAT {
+        JSON                    = 0,
+        TSV,
+        CSV
+    };
+
+    RecordWriter(QTextStream *out, FORMAT format, const QStringList &columns);
+    ~RecordWriter();
+
+    void                        writeRow(const QStringList &values);
+    void                        finish();
+
+    static bool                 parseFormat(const QString &name, FORMAT *format);
+    static QString              escapeJson(const QString &value);
+    static QString              escapeTsv(const QString &value);
+    static QString              escapeCsv(const QString &value);
+
+private:
+    void                        writeHeader();
+
+private:
+    QTextStream                 *m_out;         /*!< Stream where rows are written to. */
+    FORMAT                      m_format;       /*!< Output format. */
+    QStringList                 m_columns;      /*!< Names of the columns. */
+    bool                        m_started;      /*!< State if header has been written. */
+    bool                        m_finished;     /*!< State if footer has been written. */
+    qint64                      m_rowCount;     /*!< Number of written rows. */
+};
+
+#endif // RECORDWRITER_H
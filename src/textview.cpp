@@ -0,0 +1,336 @@
+#include <climits>
+
+#include <QPainter>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QScrollBar>
+#include <QPaintEvent>
+#include <QFontMetrics>
+
+#include "perfcounters.h"
+#include "textview.h"
+#include "trace.h"
+
+/*!*********************************************************************************************************************
+ * \brief Maximum number of bytes shown of a line. Longer lines, e.g. generated Verilog, are cut.
+ **********************************************************************************************************************/
+static const qint64 TEXT_VIEW_MAX_LINE_LENGTH = 4096;
+
+/*!*********************************************************************************************************************
+ * \brief Number of lines shown above a line scrolled to, so its context is visible.
+ **********************************************************************************************************************/
+static const qint64 TEXT_VIEW_CONTEXT_LINES = 3;
+
+/*!*********************************************************************************************************************
+ * \brief Returns width of the text in pixels.
+ * \param metrics       Metrics of the font.
+ * \param text          Text to measure.
+ **********************************************************************************************************************/
+static int getTextWidth(const QFontMetrics &metrics, const QString &text)
+{
+#if QT_VERSION >= 0x050B00
+    return metrics.horizontalAdvance(text);
+#else
+    return metrics.width(text);
+#endif
+}
+
+/*!*********************************************************************************************************************
+ * \brief Constructs an empty view with a fixed pitch font.
+ * \param parent        Parent widget, by default is NULL.
+ **********************************************************************************************************************/
+TextView::TextView(QWidget *parent)
+    : QAbstractScrollArea(parent),
+      m_data(0),
+      m_size(0),
+      m_modified(0),
+      m_lineCount(0),
+      m_currentLine(-1),
+      m_pendingLine(-1)
+{
+    QFont font("Monospace");
+    font.setStyleHint(QFont::TypeWriter);
+    setFont(font);
+
+    setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Stops indexing and unmaps the file.
+ **********************************************************************************************************************/
+TextView::~TextView()
+{
+    close();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Closes the current file and shows the given one from its first line.
+ * \param fileName      Path to the text file.
+ * \return              True if the file has been opened, otherwise false and the reasons are in the error list.
+ **********************************************************************************************************************/
+bool TextView::open(const QString &fileName)
+{
+    TRACE_SCOPE_ARG("preview", "open_text", fileName);
+
+    close();
+
+    m_file.setFileName(fileName);
+    if(!m_file.open(QIODevice::ReadOnly)) {
+        m_errorList<<QString("Can not read file '%1':\n%2.").arg(fileName).arg(m_file.errorString());
+        m_file.setFileName(QString());
+        return false;
+    }
+
+    m_size = m_file.size();
+    m_modified = QFileInfo(m_file).lastModified().toMSecsSinceEpoch();
+
+    PerfCounters::add(PerfCounters::FILES_READ);
+
+    uchar *data = m_size > 0 ? m_file.map(0, m_size) : 0;
+    if(data) {
+        m_data = reinterpret_cast<const char*>(data);
+    }
+    else if(m_size > 0) {
+        m_content = m_file.readAll();
+        if(m_content.size() != m_size) {
+            QString reason = m_file.errorString();
+            close();
+            m_errorList<<QString("Can not read file '%1':\n%2.").arg(fileName).arg(reason);
+            return false;
+        }
+
+        m_data = m_content.constData();
+
+        PerfCounters::add(PerfCounters::BYTES_READ, m_size);
+    }
+
+    m_index.start(m_data, m_size);
+
+    verticalScrollBar()->setValue(0);
+    horizontalScrollBar()->setValue(0);
+
+    updateLineCount();
+    updateScrollBars();
+    viewport()->update();
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Stops indexing, unmaps and closes the file and clears the view.
+ **********************************************************************************************************************/
+void TextView::close()
+{
+    m_index.stop();
+
+    if(m_data && m_content.isEmpty()) {
+        m_file.unmap(reinterpret_cast<uchar*>(const_cast<char*>(m_data)));
+    }
+
+    m_file.close();
+    m_file.setFileName(QString());
+
+    m_content.clear();
+    m_errorList.clear();
+
+    m_data = 0;
+    m_size = 0;
+    m_modified = 0;
+    m_lineCount = 0;
+    m_currentLine = -1;
+    m_pendingLine = -1;
+
+    updateScrollBars();
+    viewport()->update();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Highlights the line and scrolls it near the top of the view. A line not yet indexed is scrolled to as soon as
+ * the index reaches it.
+ * \param line          Number of the line starting with 0.
+ **********************************************************************************************************************/
+void TextView::scrollToLine(qint64 line)
+{
+    m_currentLine = line;
+    m_pendingLine = -1;
+
+    if(line >= m_lineCount) {
+        m_pendingLine = line;
+        return;
+    }
+
+    verticalScrollBar()->setValue(int(qMin(qMax(line - TEXT_VIEW_CONTEXT_LINES, qint64(0)), qint64(INT_MAX))));
+    viewport()->update();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Takes over the lines indexed since the last call: updates the scroll range, repaints newly indexed lines in
+ * the viewport and scrolls to a pending line once it is indexed. A file changed meanwhile is closed.
+ **********************************************************************************************************************/
+void TextView::updateLineCount()
+{
+    if(!m_index.isDone() && !checkFile()) {
+        return;
+    }
+
+    qint64 lineCount = m_index.getLineCount();
+    if(lineCount == m_lineCount) {
+        return;
+    }
+
+    qint64 oldCount = m_lineCount;
+    m_lineCount = lineCount;
+
+    updateScrollBars();
+
+    if(m_pendingLine >= 0 && m_pendingLine < m_lineCount) {
+        scrollToLine(m_pendingLine);
+    }
+    else if(verticalScrollBar()->value() + getVisibleLineCount() > oldCount) {
+        viewport()->update();
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Paints the lines in the viewport with their numbers. Only these lines are located and decoded. A file changed
+ * since it has been opened is closed and the reason painted instead.
+ * \param event         Paint event.
+ **********************************************************************************************************************/
+void TextView::paintEvent(QPaintEvent *event)
+{
+    bool isValid = checkFile();
+
+    QPainter painter(viewport());
+    painter.fillRect(event->rect(), palette().base());
+
+    if(!isValid || !m_data) {
+        painter.setPen(palette().color(QPalette::Text));
+        painter.drawText(viewport()->rect().adjusted(8, 8, -8, -8), Qt::AlignLeft | Qt::AlignTop | Qt::TextWordWrap,
+                         m_errorList.join("\n"));
+        return;
+    }
+
+    QFontMetrics metrics(font());
+    int lineHeight = metrics.height();
+    int gutterWidth = getGutterWidth();
+    int x = gutterWidth - horizontalScrollBar()->value();
+
+    qint64 firstLine = verticalScrollBar()->value();
+    qint64 lastLine = qMin(firstLine + getVisibleLineCount(), m_lineCount);
+
+    painter.setPen(palette().color(QPalette::Text));
+
+    for(qint64 line = firstLine; line < lastLine; ++line) {
+        int y = int(line - firstLine) * lineHeight;
+
+        if(line == m_currentLine) {
+            painter.fillRect(0, y, viewport()->width(), lineHeight, palette().alternateBase());
+        }
+
+        painter.drawText(x, y + metrics.ascent(), getLineText(line));
+    }
+
+    // The gutter is painted last, so it covers text scrolled to the left.
+    painter.fillRect(0, 0, gutterWidth - 4, viewport()->height(), palette().window());
+    painter.setPen(palette().color(QPalette::WindowText));
+
+    for(qint64 line = firstLine; line < lastLine; ++line) {
+        int y = int(line - firstLine) * lineHeight;
+
+        painter.drawText(0, y, gutterWidth - 8, lineHeight, Qt::AlignRight | Qt::AlignVCenter,
+                         QString::number(line + 1));
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Updates the scroll range to the new size of the viewport.
+ * \param event         Resize event.
+ **********************************************************************************************************************/
+void TextView::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+
+    updateScrollBars();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Sets the vertical range to the indexed lines and the horizontal range to the longest line shown.
+ **********************************************************************************************************************/
+void TextView::updateScrollBars()
+{
+    int visibleLines = getVisibleLineCount();
+    qint64 maximum = qMax(m_lineCount - visibleLines + 1, qint64(0));
+
+    verticalScrollBar()->setRange(0, int(qMin(maximum, qint64(INT_MAX))));
+    verticalScrollBar()->setPageStep(visibleLines);
+
+    QFontMetrics metrics(font());
+    int textWidth = int(TEXT_VIEW_MAX_LINE_LENGTH) * getTextWidth(metrics, "x") + getGutterWidth();
+
+    horizontalScrollBar()->setRange(0, m_lineCount > 0 ? qMax(textWidth - viewport()->width(), 0) : 0);
+    horizontalScrollBar()->setPageStep(viewport()->width());
+    horizontalScrollBar()->setSingleStep(getTextWidth(metrics, "x"));
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns false and closes the file if it is mapped and its size or modification time has changed since it
+ * has been opened. Pages of a truncated file can not be accessed any more, so the check is done before the mapping
+ * is read; it costs a single stat.
+ **********************************************************************************************************************/
+bool TextView::checkFile()
+{
+    if(!m_data || !m_content.isEmpty()) {
+        return true;
+    }
+
+    QFileInfo fileInfo(m_file.fileName());
+
+    PerfCounters::add(PerfCounters::STAT_CALLS);
+
+    if(fileInfo.size() == m_size && fileInfo.lastModified().toMSecsSinceEpoch() == m_modified) {
+        return true;
+    }
+
+    QString fileName = m_file.fileName();
+    close();
+
+    m_errorList<<QString("File '%1' has changed since it has been opened, please preview it again.").arg(fileName);
+    return false;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns the line decoded with the local encoding, tabs expanded to a width of eight.
+ * \param line          Number of the line starting with 0.
+ **********************************************************************************************************************/
+QString TextView::getLineText(qint64 line) const
+{
+    qint64 start = m_index.getLineStart(line);
+    if(start < 0) {
+        return QString();
+    }
+
+    qint64 length = qMin(m_index.getLineEnd(start) - start, TEXT_VIEW_MAX_LINE_LENGTH);
+    QString text = QString::fromLocal8Bit(m_data + start, int(length));
+
+    for(int i = text.indexOf('\t'); i >= 0; i = text.indexOf('\t', i)) {
+        text.replace(i, 1, QString(8 - i % 8, ' '));
+    }
+
+    return text;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns number of lines fitting into the viewport, a partly visible line included.
+ **********************************************************************************************************************/
+int TextView::getVisibleLineCount() const
+{
+    return viewport()->height() / QFontMetrics(font()).height() + 1;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns width of the line number gutter, wide enough for the highest line number.
+ **********************************************************************************************************************/
+int TextView::getGutterWidth() const
+{
+    return getTextWidth(QFontMetrics(font()), QString::number(qMax(m_lineCount, qint64(9999)))) + 12;
+}
@@ -0,0 +1,92 @@
+#ifndef TEXTVIEW_H
+#define TEXTVIEW_H
+
+#include <QFile>
+#include <QByteArray>
+#include <QStringList>
+#include <QAbstractScrollArea>
+
+#include "lineindex.h"
+
+/*!*********************************************************************************************************************
+ * \brief The TextView class shows a text file read-only without loading it. The file is memory mapped, or read if it
+ * can not be mapped; its lines are indexed in the background and only the lines in the viewport are decoded and
+ * painted, so multi-GB netlists open at once and can be scrolled while the index is built. A mapped file truncated by
+ * another process would crash the view on access, so its size and modification time are checked before painting and
+ * while indexing; a changed file is closed and the reason shown instead.
+ **********************************************************************************************************************/
+class TextView : public QAbstractScrollArea
+{
+public:
+    explicit TextView(QWidget *parent = 0);
+    ~TextView();
+
+    bool                                open(const QString &fileName);
+    void                                close();
+
+    QString                             getFileName() const;
+    QStringList                         getErrors() const;
+    qint64                              getFileSize() const;
+    const LineIndex&                    getLineIndex() const;
+
+    void                                scrollToLine(qint64 line);
+    void                                updateLineCount();
+
+protected:
+    void                                paintEvent(QPaintEvent *event);
+    void                                resizeEvent(QResizeEvent *event);
+
+private:
+    void                                updateScrollBars();
+    bool                                checkFile();
+    QString                             getLineText(qint64 line) const;
+
+    int                                 getVisibleLineCount() const;
+    int                                 getGutterWidth() const;
+
+private:
+    QFile                               m_file;             /*!< File shown, open while it is mapped. */
+    QByteArray                          m_content;          /*!< Content of the file if it could not be mapped. */
+    const char                          *m_data;            /*!< Mapped or read content of the file. */
+    qint64                              m_size;             /*!< Size of the file in bytes. */
+    qint64                              m_modified;         /*!< Modification time of the file in ms since epoch. */
+    LineIndex                           m_index;            /*!< Line offsets of the mapped content. */
+    qint64                              m_lineCount;        /*!< Lines known when the scroll bars were updated. */
+    qint64                              m_currentLine;      /*!< Highlighted line, -1 if there is none. */
+    qint64                              m_pendingLine;      /*!< Line to scroll to once it is indexed, -1 if none. */
+    QStringList                         m_errorList;        /*!< Errors of opening the file or of a changed file. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Returns path to the file shown, empty if no file is open.
+ **********************************************************************************************************************/
+inline QString TextView::getFileName() const
+{
+    return m_file.fileName();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns errors of opening the file, or the reason a file shown before has been closed.
+ **********************************************************************************************************************/
+inline QStringList TextView::getErrors() const
+{
+    return m_errorList;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns size of the file shown in bytes.
+ **********************************************************************************************************************/
+inline qint64 TextView::getFileSize() const
+{
+    return m_size;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns line index of the file shown.
+ **********************************************************************************************************************/
+inline const LineIndex& TextView::getLineIndex() const
+{
+    return m_index;
+}
+
+#endif // TEXTVIEW_H
@@ -121,6 +121,30 @@ void ToolManager::init()
 
     item->addSubProperty(subitem);
 
+    item = m_vmSettings->addProperty(QtVariantPropertyManager::groupTypeId(), tr("Multiple Files"));
+    m_pbSettings->addProperty( item );
+
+    foreach(const QString &toolName, QStringList()<<"Schematic"<<"Layout"<<"Editor"<<"PDF Reader") {
+        QString toolKey = getToolKey(toolName);
+
+        QtVariantProperty *toolItem = m_vmSettings->addProperty(QtVariantPropertyManager::groupTypeId(), toolName);
+
+        subitem = m_vmSettings->addProperty(QVariant::String, "File Arguments");
+        subitem->setToolTip("Arguments given for every file, '%f' is replaced by the path of the file...");
+        subitem->setValue(m_properties->exists(toolKey + "FileArguments") ?
+                          m_properties->get<QString>(toolKey + "FileArguments") : QString("%f"));
+        toolItem->addSubProperty(subitem);
+
+        subitem = m_vmSettings->addProperty(QVariant::Int, "Files Per Launch");
+        subitem->setToolTip("Maximum number of files opened by a single tool process, 0 for all at once...");
+        subitem->setAttribute("minimum", 0);
+        subitem->setValue(m_properties->exists(toolKey + "FilesPerLaunch") ?
+                          m_properties->get<int>(toolKey + "FilesPerLaunch") : 0);
+        toolItem->addSubProperty(subitem);
+
+        item->addSubProperty(toolItem);
+    }
+
     QtVariantEditorFactory *vf = new VariantFactory();
     m_pbSettings->setFactoryForManager(m_vmSettings, vf);
 
@@ -130,6 +154,19 @@ void ToolManager::init()
             SLOT(settingsChanged(QtProperty*, QVariant)));
 }
 
+/*!*********************************************************************************************************************
+ * \brief Returns the key of the tool in the LibMan settings.
+ * \param toolName     Name of the tool shown in the tool manager.
+ **********************************************************************************************************************/
+QString ToolManager::getToolKey(const QString &toolName)
+{
+    if(toolName == "PDF Reader") {
+        return "PdfReader";
+    }
+
+    return toolName;
+}
+
 /*!*********************************************************************************************************************
  * \brief The slot is triggered once user changes tool settings.
  **********************************************************************************************************************/
@@ -164,11 +201,24 @@ void ToolManager::on_btnOk_clicked()
                 QString toolName = p->propertyName();
                 QString toolPath = p->valueText();
 
-                if(toolName == "PDF Reader") {
-                    toolName = "PdfReader";
+                m_properties->set(getToolKey(toolName), toolPath);
+            }
+        }
+        else if( q->propertyName() == "Multiple Files" )
+        {
+            foreach(QtProperty *toolItem, q->subProperties()) {
+                QString toolKey = getToolKey(toolItem->propertyName());
+
+                foreach(QtProperty *p, toolItem->subProperties()) {
+                    QVariant value = m_vmSettings->value(p);
+
+                    if(p->propertyName() == "File Arguments") {
+                        m_properties->set(toolKey + "FileArguments", value.toString());
+                    }
+                    else if(p->propertyName() == "Files Per Launch") {
+                        m_properties->set(toolKey + "FilesPerLaunch", value.toInt());
+                    }
                 }
-
-                m_properties->set(toolName, toolPath);
             }
         }
     }
@@ -26,6 +26,8 @@ public:
     explicit ToolManager(QWidget *parent, Properties *properties);
     ~ToolManager();
 
+    static QString                      getToolKey(const QString &toolName);
+
 private slots:
     void                                settingsChanged(QtProperty*, QVariant);
 
@@ -0,0 +1,826 @@
+#include <QDir>
+#include <QFile>
+#include <QTimer>
+#include <QProcess>
+#include <QUuid>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHostAddress>
+
+#include "catalog.h"
+#include "toolsessions.h"
+#include "trace.h"
+
+/*!*********************************************************************************************************************
+ * \brief Time a session may take to answer a request before it is shown as 'no answer'. Late answers are still taken.
+ **********************************************************************************************************************/
+static const int REPLY_TIMEOUT_MS = 2000;
+
+/*!*********************************************************************************************************************
+ * \brief Time a started session may take until it connects and the interval of checking the timeouts. Tools like
+ * KLayout load their technology files first, which takes several seconds.
+ **********************************************************************************************************************/
+static const qint64 START_TIMEOUT_MS = 60000;
+static const int TIMEOUT_INTERVAL_MS = 500;
+
+/*!*********************************************************************************************************************
+ * \brief Number of launches kept for the launch panel and the interval of following started processes in /proc.
+ **********************************************************************************************************************/
+static const int LAUNCH_HISTORY_SIZE = 200;
+static const int PROCESS_INTERVAL_MS = 1000;
+
+/*!*********************************************************************************************************************
+ * \brief Python macro run by KLayout at start. It connects to the port of LibMan given by '-rd libman_port=<port>',
+ * identifies itself by the token given by '-rd libman_token=<token>' and loads every requested layout carrying the
+ * token into a new view of the running main window. A layout is confirmed only once it has been loaded.
+ **********************************************************************************************************************/
+static const char KLAYOUT_MACRO[] =
+    "# Written by LibMan, changes are overwritten.\n"
+    "import pya\n"
+    "\n"
+    "class LibManSession(object):\n"
+    "    def __init__(self, port, token):\n"
+    "        self.prefix = \"OPEN \" + token + \" \"\n"
+    "        self.hello = (\"HELLO \" + token + \"\\n\").encode(\"utf-8\")\n"
+    "        self.socket = pya.QTcpSocket()\n"
+    "        self.socket.connected = lambda: self.socket.write(self.hello)\n"
+    "        self.socket.readyRead = self.read\n"
+    "        self.socket.connectToHost(\"127.0.0.1\", port)\n"
+    "\n"
+    "    def read(self):\n"
+    "        while self.socket.canReadLine():\n"
+    "            line = bytes(self.socket.readLine()).decode(\"utf-8\").rstrip(\"\\r\\n\")\n"
+    "            if not line.startswith(self.prefix):\n"
+    "                continue\n"
+    "            path = line[len(self.prefix):]\n"
+    "            try:\n"
+    "                pya.MainWindow.instance().load_layout(path, 1)\n"
+    "                reply = \"OK \"\n"
+    "            except Exception:\n"
+    "                reply = \"FAILED \"\n"
+    "            self.socket.write((reply + path + \"\\n\").encode(\"utf-8\"))\n"
+    "            self.socket.flush()\n"
+    "\n"
+    "libman_session = LibManSession(int(libman_port), libman_token)\n";
+
+/*!*********************************************************************************************************************
+ * \brief The KLayoutAdapter class starts KLayout with a macro which receives files to open over a local TCP connection.
+ **********************************************************************************************************************/
+class KLayoutAdapter : public ToolAdapter
+{
+public:
+    QString getName() const
+    {
+        return "KLayout";
+    }
+
+    bool isSupported(const QString &program, const QStringList &) const
+    {
+        return QFileInfo(program).baseName().startsWith("klayout", Qt::CaseInsensitive);
+    }
+
+    bool getArguments(quint16 port, const QString &token, const QStringList &paths, QStringList *arguments,
+                      QStringList *errorList) const
+    {
+        QString macroFile = QDir::toNativeSeparators(Catalog::getCacheDir() + "/tools/libman_session.py");
+        QByteArray content(KLAYOUT_MACRO);
+
+        QFile file(macroFile);
+        if(!file.open(QIODevice::ReadOnly) || file.readAll() != content) {
+            file.close();
+
+            QDir().mkpath(QFileInfo(macroFile).absolutePath());
+
+            if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(content) != content.size()) {
+                *errorList<<QString("Can not write to file '%1':\n%2.").arg(macroFile).arg(file.errorString());
+                return false;
+            }
+        }
+
+        *arguments<<"-rd"<<QString("libman_port=%1").arg(port)<<"-rd"<<"libman_token=" + token<<"-rm"<<macroFile
+                  <<paths;
+        return true;
+    }
+};
+
+/*!*********************************************************************************************************************
+ * \brief The ToolStubAdapter class starts the stand-in tool 'libman --tool-stub', which is used to try sessions
+ * without a real tool.
+ **********************************************************************************************************************/
+class ToolStubAdapter : public ToolAdapter
+{
+public:
+    QString getName() const
+    {
+        return "tool stub";
+    }
+
+    bool isSupported(const QString &, const QStringList &arguments) const
+    {
+        return arguments.contains("--tool-stub");
+    }
+
+    bool getArguments(quint16 port, const QString &token, const QStringList &paths, QStringList *arguments,
+                      QStringList *) const
+    {
+        *arguments<<"--port"<<QString::number(port)<<"--token"<<token<<paths;
+        return true;
+    }
+};
+
+/*!*********************************************************************************************************************
+ * \brief Constructs ToolSessions object with adapters for KLayout and the stand-in tool.
+ * \param parent       Parent object, by default is NULL.
+ **********************************************************************************************************************/
+ToolSessions::ToolSessions(QObject *parent)
+    : QObject(parent),
+      m_server(new QTcpServer(this)),
+      m_timeoutTimer(new QTimer(this)),
+      m_processTimer(new QTimer(this)),
+      m_lastLaunchId(0),
+      m_resolveNsecs(0)
+{
+    m_clock.start();
+    m_requestTimer.invalidate();
+
+    connect(m_server, SIGNAL(newConnection()), this, SLOT(newConnection()));
+
+    m_timeoutTimer->setInterval(TIMEOUT_INTERVAL_MS);
+    connect(m_timeoutTimer, SIGNAL(timeout()), this, SLOT(checkSessions()));
+
+    m_processTimer->setInterval(PROCESS_INTERVAL_MS);
+    connect(m_processTimer, SIGNAL(timeout()), this, SLOT(updateProcesses()));
+
+    addAdapter(new KLayoutAdapter());
+    addAdapter(new ToolStubAdapter());
+}
+
+/*!*********************************************************************************************************************
+ * \brief Destructs ToolSessions object. Running sessions are not closed, they belong to the user; they only lose the
+ * connection to LibMan.
+ **********************************************************************************************************************/
+ToolSessions::~ToolSessions()
+{
+    qDeleteAll(m_adapters);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Adds an adapter, which is asked after the ones added before.
+ * \param adapter       Adapter, the ownership is taken.
+ **********************************************************************************************************************/
+void ToolSessions::addAdapter(ToolAdapter *adapter)
+{
+    m_adapters<<adapter;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Marks the start of a user request, e.g. a double-click. The time until its launches start is recorded as
+ * their resolve time.
+ **********************************************************************************************************************/
+void ToolSessions::beginRequest()
+{
+    m_requestTimer.start();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns the latest launches, the oldest first.
+ **********************************************************************************************************************/
+QList<ToolSessions::Launch> ToolSessions::getLaunches() const
+{
+    return m_launches;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Opens files with a tool. The files are sent to the running session of the tool without waiting for its
+ * answer; a session is started if there is none or it has been closed. Files requested while the session is starting
+ * are sent once it has connected.
+ * Tools without session get the files as described by the file arguments, several files per process.
+ * \param tool              Tool as configured in the tool manager, the program optionally followed by arguments.
+ * \param paths             Files to open, all of them are sent to a session with a single request.
+ * \param fileArguments     Arguments given for every file, see getFileArguments().
+ * \param filesPerLaunch    Maximum number of files passed to a single process of the tool, 0 for no limit.
+ * \return                  False if the tool can not be started, the reason is sent by message().
+ **********************************************************************************************************************/
+bool ToolSessions::open(const QString &tool, const QStringList &paths, const QString &fileArguments,
+                        int filesPerLaunch)
+{
+    QString program;
+    QStringList arguments;
+    splitTool(tool, &program, &arguments);
+
+    m_resolveNsecs = m_requestTimer.isValid() ? m_requestTimer.nsecsElapsed() : 0;
+
+    if(program.isEmpty()) {
+        emit message("Please specify tool first.", true);
+        return false;
+    }
+
+    ToolAdapter *adapter = getAdapter(program, arguments);
+    if(!adapter) {
+        return startDetached(program, arguments, paths, fileArguments, filesPerLaunch);
+    }
+
+    QMap<QString, Session>::iterator it = m_sessions.find(tool);
+    if(it != m_sessions.end()) {
+        Session &session = it.value();
+
+        if(!session.socket) {
+            session.pending<<paths;
+            return true;
+        }
+
+        TRACE_SCOPE_ARG("tool", "send", tool + " " + paths.join(" "));
+
+        int launchId = addLaunch(tool, "request", paths.count());
+        getLaunch(launchId)->state = "waiting";
+        emit launchesChanged();
+
+        send(session, launchId, paths);
+        return true;
+    }
+
+    return start(tool, adapter, program, arguments, paths, fileArguments, filesPerLaunch);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Splits a configured tool into program and arguments. A tool naming an existing file is taken as program as
+ * it is, so paths containing blanks still work.
+ * \param tool          Tool as configured in the tool manager.
+ * \param program       Program of the tool.
+ * \param arguments     Arguments of the tool.
+ **********************************************************************************************************************/
+void ToolSessions::splitTool(const QString &tool, QString *program, QStringList *arguments)
+{
+    arguments->clear();
+
+    if(QFileInfo(tool).isFile()) {
+        *program = tool;
+        return;
+    }
+
+    *arguments = Catalog::splitLine(tool);
+    *program = arguments->isEmpty() ? QString() : arguments->takeFirst();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns the arguments of the files to open. The blank separated file arguments are repeated for every file
+ * with '%f' replaced by its path; if they do not contain '%f', the path follows them.
+ * \param fileArguments     Arguments given for every file, e.g. '%f' or '-s %f'. Empty gives the paths only.
+ * \param paths             Files to open.
+ **********************************************************************************************************************/
+QStringList ToolSessions::getFileArguments(const QString &fileArguments, const QStringList &paths)
+{
+    QStringList pattern = Catalog::splitLine(fileArguments);
+    bool hasPath = fileArguments.contains("%f");
+
+    QStringList arguments;
+    foreach(const QString &path, paths) {
+        foreach(const QString &argument, pattern) {
+            arguments<<QString(argument).replace("%f", path);
+        }
+
+        if(!hasPath) {
+            arguments<<path;
+        }
+    }
+
+    return arguments;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Slot to accept connections. They are taken as session once their first line names the token of a session.
+ **********************************************************************************************************************/
+void ToolSessions::newConnection()
+{
+    while(m_server->hasPendingConnections()) {
+        QTcpSocket *socket = m_server->nextPendingConnection();
+
+        connect(socket, SIGNAL(readyRead()), this, SLOT(readReplies()));
+        connect(socket, SIGNAL(disconnected()), this, SLOT(closeConnection()));
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Slot to read complete lines of a connection. The line 'HELLO <token>' makes the connection the one of the
+ * session with the token and sends the files requested meanwhile; other connections are closed. Each 'OK <path>' or
+ * 'FAILED <path>' confirms a file of the oldest request of the session as loaded or not loaded by the tool.
+ **********************************************************************************************************************/
+void ToolSessions::readReplies()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+    if(!socket) {
+        return;
+    }
+
+    QMap<QString, Session>::iterator it = findSession(socket);
+
+    while(socket->canReadLine()) {
+        QString line = QString::fromUtf8(socket->readLine()).trimmed();
+
+        if(it == m_sessions.end()) {
+            it = line.startsWith("HELLO ") ? findSession(line.mid(6)) : m_sessions.end();
+
+            if(it == m_sessions.end() || it.value().socket) {
+                socket->abort();
+                return;
+            }
+
+            Session &session = it.value();
+            session.socket = socket;
+
+            if(session.pending.isEmpty()) {
+                setReady(session.launchId);
+            }
+            else {
+                send(session, session.launchId, session.pending);
+                session.pending.clear();
+            }
+
+            continue;
+        }
+
+        Session &session = it.value();
+
+        bool isFailed = line.startsWith("FAILED ");
+        if((!line.startsWith("OK ") && !isFailed) || session.requests.isEmpty()) {
+            continue;
+        }
+
+        if(isFailed) {
+            emit message(QString("Tool '%1' failed to open '%2'.").arg(it.key()).arg(line.mid(7)), true);
+        }
+
+        Request &request = session.requests.first();
+        if(--request.count > 0) {
+            continue;
+        }
+
+        setReady(request.launchId);
+
+        Launch *launch = getLaunch(request.launchId);
+        if(launch && launch->mode == "request") {
+            launch->state = "sent";
+            emit launchesChanged();
+        }
+
+        session.requests.removeFirst();
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Slot to drop a closed connection. The session of the connection has been closed by the user, the next request
+ * starts a new one.
+ **********************************************************************************************************************/
+void ToolSessions::closeConnection()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+    if(!socket) {
+        return;
+    }
+
+    QMap<QString, Session>::iterator it = findSession(socket);
+    if(it != m_sessions.end()) {
+        foreach(const Request &request, it.value().requests) {
+            Launch *launch = getLaunch(request.launchId);
+            if(launch && launch->mode == "request") {
+                launch->state = "no answer";
+            }
+        }
+
+        m_sessions.erase(it);
+        emit launchesChanged();
+    }
+
+    socket->deleteLater();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Slot to check the timeouts. Sessions not connected within the start timeout are dropped and their files
+ * reported as not opened; requests not confirmed within the reply timeout are shown as 'no answer'.
+ **********************************************************************************************************************/
+void ToolSessions::checkSessions()
+{
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    bool isWaiting = false;
+
+    QMap<QString, Session>::iterator it = m_sessions.begin();
+    while(it != m_sessions.end()) {
+        Session &session = it.value();
+
+        if(!session.socket && now - session.started >= START_TIMEOUT_MS) {
+            if(!session.pending.isEmpty()) {
+                emit message(QString("Tool '%1' has not connected to LibMan, failed to open:\n%2")
+                             .arg(it.key()).arg(session.pending.join("\n")), true);
+            }
+
+            it = m_sessions.erase(it);
+            continue;
+        }
+
+        isWaiting = isWaiting || !session.socket;
+
+        foreach(const Request &request, session.requests) {
+            Launch *launch = getLaunch(request.launchId);
+
+            if(now - request.sent < REPLY_TIMEOUT_MS) {
+                isWaiting = true;
+            }
+            else if(launch && launch->mode == "request" && launch->state == "waiting") {
+                launch->state = "no answer";
+                emit launchesChanged();
+            }
+        }
+
+        ++it;
+    }
+
+    if(!isWaiting) {
+        m_timeoutTimer->stop();
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Updates peak memory of the started processes which are still running. A process is taken as ended when it
+ * has left /proc or its id has been reused. Its exit status is not known: detached processes are not children of
+ * LibMan, so it can not wait for them.
+ **********************************************************************************************************************/
+void ToolSessions::updateProcesses()
+{
+    bool isRunning = false;
+
+    for(int i = 0; i < m_launches.count(); ++i) {
+        Launch &launch = m_launches[i];
+
+        if(launch.state != "running") {
+            continue;
+        }
+
+        qint64 processStart = -1;
+        qint64 peakRss = -1;
+
+        if(readProcess(launch.pid, &processStart, &peakRss) && processStart == launch.processStart) {
+            launch.peakRss = qMax(launch.peakRss, peakRss);
+            isRunning = true;
+            continue;
+        }
+
+        launch.state = "ended";
+
+        if(Trace::isEnabled()) {
+            qint64 duration = m_clock.nsecsElapsed() - launch.spawned;
+            Trace::addEvent("tool", "process", Trace::now() - duration, duration,
+                            QString("%1 pid %2, peak RSS %3 kB, exit status unavailable")
+                            .arg(launch.tool).arg(launch.pid).arg(launch.peakRss));
+        }
+    }
+
+    if(!isRunning) {
+        m_processTimer->stop();
+    }
+
+    emit launchesChanged();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Starts a session of the tool, which connects to LibMan with a new token. The tool is started detached if
+ * LibMan can not listen or the adapter can not prepare the session.
+ * \param tool              Tool as configured in the tool manager.
+ * \param adapter           Adapter of the tool.
+ * \param program           Program of the tool.
+ * \param arguments         Configured arguments of the tool.
+ * \param paths             Files to open.
+ * \param fileArguments     Arguments given for every file if the tool is started detached.
+ * \param filesPerLaunch    Maximum number of files per process if the tool is started detached.
+ **********************************************************************************************************************/
+bool ToolSessions::start(const QString &tool, ToolAdapter *adapter, const QString &program,
+                         const QStringList &arguments, const QStringList &paths, const QString &fileArguments,
+                         int filesPerLaunch)
+{
+    QStringList errorList;
+    QStringList sessionArguments = arguments;
+
+    quint16 port = listen(&errorList);
+    QString token = createToken();
+
+    if(port == 0 || !adapter->getArguments(port, token, paths, &sessionArguments, &errorList)) {
+        foreach(const QString &explain, errorList) {
+            emit message(explain, true);
+        }
+
+        return startDetached(program, arguments, paths, fileArguments, filesPerLaunch);
+    }
+
+    int launchId = addLaunch(tool, "session", paths.count());
+
+    TRACE_SCOPE_ARG("tool", "start_session", program + " " + sessionArguments.join(" "));
+
+    QElapsedTimer spawnTimer;
+    spawnTimer.start();
+
+    qint64 pid = 0;
+    bool isStarted = QProcess::startDetached(program, sessionArguments, QString(), &pid);
+
+    setSpawned(launchId, spawnTimer.nsecsElapsed(), isStarted, pid);
+
+    if(!isStarted) {
+        emit message(QString("Failed to start tool '%1'.").arg(program), true);
+        return false;
+    }
+
+    Session session;
+    session.token = token;
+    session.started = QDateTime::currentMSecsSinceEpoch();
+    session.socket = 0;
+    session.launchId = launchId;
+
+    m_sessions.insert(tool, session);
+    m_timeoutTimer->start();
+
+    emit message(QString("Started %1 session connecting to port %2.").arg(adapter->getName()).arg(port), false);
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Starts processes of the tool for the files, which are not kept as session. Files are split into groups of
+ * at most filesPerLaunch files, each group is passed to one process.
+ * \param program           Program of the tool.
+ * \param arguments         Configured arguments of the tool.
+ * \param paths             Files to open.
+ * \param fileArguments     Arguments given for every file, see getFileArguments().
+ * \param filesPerLaunch    Maximum number of files passed to a single process, 0 for no limit.
+ **********************************************************************************************************************/
+bool ToolSessions::startDetached(const QString &program, const QStringList &arguments, const QStringList &paths,
+                                 const QString &fileArguments, int filesPerLaunch)
+{
+    int count = filesPerLaunch > 0 ? filesPerLaunch : qMax(paths.count(), 1);
+
+    for(int i = 0; i == 0 || i < paths.count(); i += count) {
+        QStringList launchArguments = arguments + getFileArguments(fileArguments, paths.mid(i, count));
+
+        int launchId = addLaunch((QStringList()<<program<<arguments).join(" "), "process",
+                                 qMin(count, paths.count() - i));
+
+        TRACE_SCOPE_ARG("tool", "launch", program + " " + launchArguments.join(" "));
+
+        QElapsedTimer spawnTimer;
+        spawnTimer.start();
+
+        qint64 pid = 0;
+        bool isStarted = QProcess::startDetached(program, launchArguments, QString(), &pid);
+
+        setSpawned(launchId, spawnTimer.nsecsElapsed(), isStarted, pid);
+
+        if(!isStarted) {
+            emit message(QString("Failed to start tool '%1'.").arg(program), true);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Sends files to open to a connected session. The answers are read by readReplies() as they arrive.
+ * \param session       Connected session.
+ * \param launchId      Id of the launch the files belong to.
+ * \param paths         Files to open.
+ **********************************************************************************************************************/
+void ToolSessions::send(Session &session, int launchId, const QStringList &paths)
+{
+    if(paths.isEmpty()) {
+        return;
+    }
+
+    foreach(const QString &path, paths) {
+        session.socket->write("OPEN " + session.token.toUtf8() + " " + QFileInfo(path).absoluteFilePath().toUtf8()
+                              + "\n");
+    }
+
+    Request request;
+    request.launchId = launchId;
+    request.count = paths.count();
+    request.sent = QDateTime::currentMSecsSinceEpoch();
+
+    session.requests<<request;
+    m_timeoutTimer->start();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns the first adapter supporting the tool, NULL if the tool can not run as session.
+ * \param program       Program of the tool.
+ * \param arguments     Configured arguments of the tool.
+ **********************************************************************************************************************/
+ToolAdapter* ToolSessions::getAdapter(const QString &program, const QStringList &arguments) const
+{
+    foreach(ToolAdapter *adapter, m_adapters) {
+        if(adapter->isSupported(program, arguments)) {
+            return adapter;
+        }
+    }
+
+    return 0;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns the session connected by the socket, the end of the sessions if there is none.
+ * \param socket        Connection of the session.
+ **********************************************************************************************************************/
+QMap<QString, ToolSessions::Session>::iterator ToolSessions::findSession(QTcpSocket *socket)
+{
+    QMap<QString, Session>::iterator it;
+    for(it = m_sessions.begin(); it != m_sessions.end(); ++it) {
+        if(it.value().socket == socket) {
+            break;
+        }
+    }
+
+    return it;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns the session with the token, the end of the sessions if there is none.
+ * \param token         Token of the session.
+ **********************************************************************************************************************/
+QMap<QString, ToolSessions::Session>::iterator ToolSessions::findSession(const QString &token)
+{
+    QMap<QString, Session>::iterator it;
+    for(it = m_sessions.begin(); it != m_sessions.end(); ++it) {
+        if(!token.isEmpty() && it.value().token == token) {
+            break;
+        }
+    }
+
+    return it;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Records a new launch with the resolve time of the current request. The oldest launches are dropped.
+ * \param tool          Tool as configured in the tool manager.
+ * \param mode          'process', 'session' or 'request'.
+ * \param files         Number of files passed.
+ * \return              Id of the launch.
+ **********************************************************************************************************************/
+int ToolSessions::addLaunch(const QString &tool, const QString &mode, int files)
+{
+    Launch launch;
+    launch.id = ++m_lastLaunchId;
+    launch.time = QDateTime::currentDateTime();
+    launch.tool = tool;
+    launch.mode = mode;
+    launch.files = files;
+    launch.resolveNsecs = m_resolveNsecs;
+    launch.spawnNsecs = -1;
+    launch.readyNsecs = -1;
+    launch.pid = 0;
+    launch.peakRss = -1;
+    launch.spawned = m_clock.nsecsElapsed();
+    launch.processStart = -1;
+
+    m_launches<<launch;
+
+    while(m_launches.count() > LAUNCH_HISTORY_SIZE) {
+        m_launches.removeFirst();
+    }
+
+    if(Trace::isEnabled()) {
+        Trace::addEvent("tool", "resolve", Trace::now() - launch.resolveNsecs, launch.resolveNsecs, tool);
+    }
+
+    return launch.id;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Records the start of the process of a launch and follows it in /proc if it is available.
+ * \param launchId      Id of the launch.
+ * \param spawnNsecs    Time QProcess::startDetached() has taken.
+ * \param isStarted     True if the process has been started.
+ * \param pid           Process id.
+ **********************************************************************************************************************/
+void ToolSessions::setSpawned(int launchId, qint64 spawnNsecs, bool isStarted, qint64 pid)
+{
+    Launch *launch = getLaunch(launchId);
+    if(!launch) {
+        return;
+    }
+
+    launch->spawnNsecs = spawnNsecs;
+    launch->spawned = m_clock.nsecsElapsed();
+    launch->pid = isStarted ? pid : 0;
+    launch->state = isStarted ? "running" : "failed";
+
+    if(isStarted && !readProcess(pid, &launch->processStart, &launch->peakRss)) {
+        // No /proc on this system, or the process has already ended.
+        launch->state = QFile::exists("/proc/self/stat") ? "ended" : "started";
+    }
+
+    if(launch->state == "running") {
+        m_processTimer->start();
+    }
+
+    emit launchesChanged();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Records the time from the spawn of a launch until the tool has loaded its files, or until a session started
+ * without further files has connected. Only the first confirmation counts.
+ * \param launchId      Id of the launch.
+ **********************************************************************************************************************/
+void ToolSessions::setReady(int launchId)
+{
+    Launch *launch = getLaunch(launchId);
+    if(!launch || launch->readyNsecs >= 0) {
+        return;
+    }
+
+    launch->readyNsecs = m_clock.nsecsElapsed() - launch->spawned;
+
+    if(Trace::isEnabled()) {
+        Trace::addEvent("tool", "ready", Trace::now() - launch->readyNsecs, launch->readyNsecs, launch->tool);
+    }
+
+    emit launchesChanged();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns the launch with the given id, NULL if it has been dropped from the history.
+ * \param launchId      Id of the launch.
+ **********************************************************************************************************************/
+ToolSessions::Launch* ToolSessions::getLaunch(int launchId)
+{
+    for(int i = m_launches.count() - 1; i >= 0; --i) {
+        if(m_launches[i].id == launchId) {
+            return &m_launches[i];
+        }
+    }
+
+    return 0;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns the local TCP port sessions connect to. The server keeps listening once started, so no other process
+ * can take the port between the start of a tool and its connection.
+ * \param errorList     List to add errors to.
+ * \return              Port of the server, 0 if it can not listen.
+ **********************************************************************************************************************/
+quint16 ToolSessions::listen(QStringList *errorList)
+{
+    if(!m_server->isListening() && !m_server->listen(QHostAddress(QHostAddress::LocalHost), 0)) {
+        *errorList<<QString("Can not listen for tool sessions:\n%1.").arg(m_server->errorString());
+        return 0;
+    }
+
+    return m_server->serverPort();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns a new random token. Only a session given the token on its command line can connect as the session,
+ * and it only accepts requests carrying the token.
+ **********************************************************************************************************************/
+QString ToolSessions::createToken()
+{
+    return QUuid::createUuid().toString().remove('{').remove('}').remove('-');
+}
+
+/*!*********************************************************************************************************************
+ * \brief Reads start time and peak resident memory of a process from /proc.
+ * \param pid           Process id.
+ * \param processStart  Start time of the process in clock ticks since boot.
+ * \param peakRss       Peak resident memory (VmHWM) in kB.
+ * \return              False if the process does not exist, has ended or /proc is not available.
+ **********************************************************************************************************************/
+bool ToolSessions::readProcess(qint64 pid, qint64 *processStart, qint64 *peakRss)
+{
+    if(pid <= 0) {
+        return false;
+    }
+
+    QFile statFile(QString("/proc/%1/stat").arg(pid));
+    if(!statFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    // The command name may contain blanks and parentheses, the fields start after the last ')'.
+    QByteArray stat = statFile.readAll();
+    QList<QByteArray> fields = stat.mid(stat.lastIndexOf(')') + 2).split(' ');
+
+    if(fields.count() < 20 || fields[0] == "Z" || fields[0] == "X") {
+        return false;
+    }
+
+    *processStart = fields[19].toLongLong();
+
+    QFile statusFile(QString("/proc/%1/status").arg(pid));
+    if(statusFile.open(QIODevice::ReadOnly)) {
+        foreach(const QByteArray &line, statusFile.readAll().split('\n')) {
+            if(line.startsWith("VmHWM:")) {
+                *peakRss = line.mid(6).simplified().split(' ').value(0).toLongLong();
+                break;
+            }
+        }
+    }
+
+    return true;
+}
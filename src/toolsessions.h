@@ -0,0 +1,168 @@
+#ifndef TOOLSESSIONS_H
+#define TOOLSESSIONS_H
+
+#include <QMap>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QDateTime>
+#include <QStringList>
+#include <QElapsedTimer>
+
+class QTimer;
+class QTcpServer;
+class QTcpSocket;
+
+/*!*********************************************************************************************************************
+ * \brief The ToolAdapter class describes how a tool is started as a long-lived session. The session connects to the
+ * local TCP port of LibMan given at start, identifies itself by the line 'HELLO <token>' and then accepts lines
+ * 'OPEN <token> <path>', each answered by 'OK <path>' once the file has been loaded, or by 'FAILED <path>'. Lines
+ * without the token are ignored. Adapters for further tools are added by ToolSessions::addAdapter().
+ **********************************************************************************************************************/
+class ToolAdapter
+{
+public:
+    virtual ~ToolAdapter() {}
+
+    /*!
+     * \brief Returns the name of the adapter shown in messages.
+     */
+    virtual QString                     getName() const = 0;
+
+    /*!
+     * \brief Returns true if the adapter can start the tool as a session.
+     * \param program       Program of the configured tool.
+     * \param arguments     Arguments of the configured tool.
+     */
+    virtual bool                        isSupported(const QString &program, const QStringList &arguments) const = 0;
+
+    /*!
+     * \brief Adds the arguments, which follow the configured ones, to start a session.
+     * \param port          Local TCP port of LibMan the session has to connect to.
+     * \param token         Random token of the session.
+     * \param paths         Files the session opens at start.
+     * \param arguments     List to add the arguments to.
+     * \param errorList     List to add errors to.
+     * \return              False if the session can not be prepared.
+     */
+    virtual bool                        getArguments(quint16 port, const QString &token, const QStringList &paths,
+                                                     QStringList *arguments, QStringList *errorList) const = 0;
+};
+
+/*!*********************************************************************************************************************
+ * \brief The ToolSessions class keeps one running session per configured tool and sends files to open to it instead of
+ * starting a process for every file. Sessions connect to a local TCP server of LibMan, which is kept listening, and
+ * requests are answered asynchronously, so the UI never waits for a tool. Tools without an adapter are started
+ * detached for every request as before.
+ * Every launch and session request is recorded with its timing; started processes are followed in /proc for their
+ * peak memory until they end.
+ **********************************************************************************************************************/
+class ToolSessions : public QObject
+{
+    Q_OBJECT
+
+    /*!
+     * \brief The Request struct keeps files sent to a session which have not all been confirmed yet.
+     */
+    struct Request {
+        int                             launchId;           /*!< Id of the launch of the request. */
+        int                             count;              /*!< Files not yet confirmed. */
+        qint64                          sent;               /*!< Time the files have been sent in ms since epoch. */
+    };
+
+    /*!
+     * \brief The Session struct keeps a started tool session.
+     */
+    struct Session {
+        QString                         token;              /*!< Random token identifying the session. */
+        qint64                          started;            /*!< Start time in ms since epoch. */
+        QTcpSocket                      *socket;            /*!< Connection of the session, NULL until connected. */
+        QStringList                     pending;            /*!< Files waiting for the session to connect. */
+        QList<Request>                  requests;           /*!< Requests in the order they have been sent. */
+        int                             launchId;           /*!< Id of the launch which started the session. */
+    };
+
+public:
+    /*!
+     * \brief The Launch struct records a tool launch or a request sent to a running session. Durations are in
+     * nanoseconds, -1 if unknown. Processes are 'running', 'ended' or 'failed'; requests are 'waiting' until the
+     * session has confirmed all files, then 'sent', or 'no answer' if it has not in time.
+     */
+    struct Launch {
+        int                             id;                 /*!< Number of the launch, counting from 1. */
+        QDateTime                       time;               /*!< Time of the launch. */
+        QString                         tool;               /*!< Tool as configured in the tool manager. */
+        QString                         mode;               /*!< 'process', 'session' or 'request'. */
+        int                             files;              /*!< Number of files passed. */
+        qint64                          resolveNsecs;       /*!< From the user request up to the launch. */
+        qint64                          spawnNsecs;         /*!< Starting the process, -1 for requests. */
+        qint64                          readyNsecs;         /*!< Until the tool confirmed the files, -1 if it can not. */
+        qint64                          pid;                /*!< Process id, 0 if no process has been started. */
+        QString                         state;              /*!< State of the process or request, see above. */
+        qint64                          peakRss;            /*!< Peak resident memory in kB, -1 if unknown. */
+        qint64                          spawned;            /*!< Time of the spawn on the clock of the sessions. */
+        qint64                          processStart;       /*!< Start time of the process in /proc, detects reuse. */
+    };
+
+    explicit ToolSessions(QObject *parent = 0);
+    ~ToolSessions();
+
+    void                                addAdapter(ToolAdapter *adapter);
+
+    bool                                open(const QString &tool, const QStringList &paths,
+                                             const QString &fileArguments = "%f", int filesPerLaunch = 0);
+
+    void                                beginRequest();
+    QList<Launch>                       getLaunches() const;
+
+    static void                         splitTool(const QString &tool, QString *program, QStringList *arguments);
+    static QStringList                  getFileArguments(const QString &fileArguments, const QStringList &paths);
+
+signals:
+    void                                message(const QString &msg, bool isError);
+    void                                launchesChanged();
+
+private slots:
+    void                                newConnection();
+    void                                readReplies();
+    void                                closeConnection();
+    void                                checkSessions();
+    void                                updateProcesses();
+
+private:
+    bool                                start(const QString &tool, ToolAdapter *adapter, const QString &program,
+                                              const QStringList &arguments, const QStringList &paths,
+                                              const QString &fileArguments, int filesPerLaunch);
+    bool                                startDetached(const QString &program, const QStringList &arguments,
+                                                      const QStringList &paths, const QString &fileArguments,
+                                                      int filesPerLaunch);
+    void                                send(Session &session, int launchId, const QStringList &paths);
+    ToolAdapter*                        getAdapter(const QString &program, const QStringList &arguments) const;
+    QMap<QString, Session>::iterator    findSession(QTcpSocket *socket);
+    QMap<QString, Session>::iterator    findSession(const QString &token);
+
+    int                                 addLaunch(const QString &tool, const QString &mode, int files);
+    void                                setSpawned(int launchId, qint64 spawnNsecs, bool isStarted, qint64 pid);
+    void                                setReady(int launchId);
+    Launch*                             getLaunch(int launchId);
+
+    quint16                             listen(QStringList *errorList);
+
+    static QString                      createToken();
+    static bool                         readProcess(qint64 pid, qint64 *processStart, qint64 *peakRss);
+
+private:
+    QList<ToolAdapter*>                 m_adapters;         /*!< Registered adapters, owned by this object. */
+    QMap<QString, Session>              m_sessions;         /*!< Map of configured tools to their session. */
+    QTcpServer                          *m_server;          /*!< Server the sessions connect to. */
+    QTimer                              *m_timeoutTimer;    /*!< Timer checking sessions and requests for timeouts. */
+    QTimer                              *m_processTimer;    /*!< Timer following started processes in /proc. */
+
+    QList<Launch>                       m_launches;         /*!< Latest launches, the oldest first. */
+    int                                 m_lastLaunchId;     /*!< Id of the latest launch. */
+    QElapsedTimer                       m_clock;            /*!< Clock of spawn and ready times. */
+    QElapsedTimer                       m_requestTimer;     /*!< Started by beginRequest() for the resolve time. */
+    qint64                              m_resolveNsecs;     /*!< Resolve time of the request being opened. */
+};
+
+#endif // TOOLSESSIONS_H
@@ -0,0 +1,188 @@
+#include <cstring>
+#include <iostream>
+
+#include <QTimer>
+#include <QFileInfo>
+#include <QTcpSocket>
+#include <QHostAddress>
+#include <QCoreApplication>
+
+#include "toolstub.h"
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+/*!*********************************************************************************************************************
+ * \brief Constructs ToolStub object. The stub does not connect until start() is called.
+ * \param parent       Parent object, by default is NULL.
+ **********************************************************************************************************************/
+ToolStub::ToolStub(QObject *parent)
+    : QObject(parent),
+      m_socket(new QTcpSocket(this)),
+      m_port(0)
+{
+    connect(m_socket, SIGNAL(connected()), this, SLOT(sendHello()));
+    connect(m_socket, SIGNAL(readyRead()), this, SLOT(readRequest()));
+    connect(m_socket, SIGNAL(disconnected()), this, SLOT(closeConnection()));
+    connect(m_socket, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(closeConnection()));
+}
+
+/*!*********************************************************************************************************************
+ * \brief Destructs ToolStub object, the connection is closed with its socket.
+ **********************************************************************************************************************/
+ToolStub::~ToolStub()
+{
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if LibMan has been asked to run as stand-in tool. Used before any Qt application object exists.
+ * \param argc     Number of command line arguments.
+ * \param argv     Command line arguments.
+ **********************************************************************************************************************/
+bool ToolStub::isRequested(int argc, char *argv[])
+{
+    for(int i = 1; i < argc; ++i) {
+        if(std::strcmp(argv[i], "--tool-stub") == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Parses command line arguments and connects to LibMan after the startup delay.
+ * \param arguments     Command line arguments including the program name.
+ * \return              False if the arguments are not valid.
+ **********************************************************************************************************************/
+bool ToolStub::start(const QStringList &arguments)
+{
+    int delay = 0;
+
+    for(int i = 1; i < arguments.count(); ++i) {
+        QString key = arguments[i];
+
+        if(key == "--tool-stub") {
+            continue;
+        }
+        else if(key == "--port" && i + 1 < arguments.count()) {
+            m_port = arguments[++i].toUShort();
+        }
+        else if(key == "--token" && i + 1 < arguments.count()) {
+            m_token = arguments[++i];
+        }
+        else if(key == "--startup-delay" && i + 1 < arguments.count()) {
+            delay = arguments[++i].toInt();
+        }
+        else if(key == "--trace" && i + 1 < arguments.count()) {
+            ++i;
+        }
+        else if(key.startsWith("--")) {
+            cerr<<"[ERROR] Incorrect input argument '"<<key.toStdString()<<"'."<<endl;
+            return false;
+        }
+        else {
+            m_files<<key;
+        }
+    }
+
+    if(m_port == 0 || m_token.isEmpty()) {
+        cerr<<"[ERROR] No port or token given. Please use '--port <port> --token <token>'."<<endl;
+        return false;
+    }
+
+    QTimer::singleShot(qMax(delay, 0), this, SLOT(connectToLibMan()));
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Opens the files of the command line and connects to LibMan.
+ **********************************************************************************************************************/
+void ToolStub::connectToLibMan()
+{
+    foreach(const QString &path, m_files) {
+        openFile(path);
+    }
+
+    m_socket->connectToHost(QHostAddress(QHostAddress::LocalHost), m_port);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Slot to identify the session to LibMan once connected.
+ **********************************************************************************************************************/
+void ToolStub::sendHello()
+{
+    m_socket->write("HELLO " + m_token.toUtf8() + "\n");
+
+    log(QString("Connected to port %1.").arg(m_port));
+}
+
+/*!*********************************************************************************************************************
+ * \brief Slot to answer complete request lines. 'OPEN <token> <path>' is confirmed by 'OK <path>' once the file is
+ * opened, or by 'FAILED <path>', as a tool adapter does; 'QUIT <token>' closes the stub. Lines without the token of the session are refused.
+ **********************************************************************************************************************/
+void ToolStub::readRequest()
+{
+    QString openPrefix = "OPEN " + m_token + " ";
+
+    while(m_socket->canReadLine()) {
+        QString line = QString::fromUtf8(m_socket->readLine()).trimmed();
+
+        if(line.startsWith(openPrefix)) {
+            QString path = line.mid(openPrefix.length());
+
+            m_socket->write((openFile(path) ? "OK " : "FAILED ") + path.toUtf8() + "\n");
+            m_socket->flush();
+        }
+        else if(line == "QUIT " + m_token) {
+            m_socket->write("OK QUIT\n");
+            m_socket->flush();
+
+            log("Quit requested.");
+            QCoreApplication::quit();
+        }
+        else if(!line.isEmpty()) {
+            m_socket->write("ERROR Unknown request.\n");
+        }
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Slot to quit once LibMan has closed the connection, or refused it. No further requests can arrive then.
+ **********************************************************************************************************************/
+void ToolStub::closeConnection()
+{
+    // A connection closed by LibMan signals an error and the disconnection, quit only once.
+    disconnect(m_socket, 0, this, 0);
+
+    log(QString("Disconnected from LibMan: %1.").arg(m_socket->errorString()));
+    QCoreApplication::quit();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Logs the file as opened, or an error if it does not exist.
+ * \param path          Path to the file.
+ * \return              False if the file does not exist.
+ **********************************************************************************************************************/
+bool ToolStub::openFile(const QString &path) const
+{
+    QFileInfo fileInfo(path);
+    if(!fileInfo.isFile()) {
+        cerr<<"[ERROR] Can not open '"<<path.toStdString()<<"'."<<endl;
+        return false;
+    }
+
+    log(QString("Opened '%1' (%2 bytes).").arg(fileInfo.absoluteFilePath()).arg(fileInfo.size()));
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Writes an info message to standard output.
+ * \param msg           Message text.
+ **********************************************************************************************************************/
+void ToolStub::log(const QString &msg) const
+{
+    cout<<"[INFO] "<<msg.toStdString()<<endl;
+}
@@ -0,0 +1,43 @@
+#ifndef TOOLSTUB_H
+#define TOOLSTUB_H
+
+#include <QObject>
+#include <QStringList>
+
+class QTcpSocket;
+
+/*!*********************************************************************************************************************
+ * \brief The ToolStub class implements a stand-in tool started by 'libman --tool-stub'. It connects to ToolSessions
+ * and answers its requests like a tool adapter does and logs the files it is asked to open, so sessions can be tried
+ * without KLayout or an editor. An optional startup delay imitates the loading time of a real tool.
+ **********************************************************************************************************************/
+class ToolStub : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ToolStub(QObject *parent = 0);
+    ~ToolStub();
+
+    bool                                start(const QStringList &arguments);
+
+    static bool                         isRequested(int argc, char *argv[]);
+
+private slots:
+    void                                connectToLibMan();
+    void                                sendHello();
+    void                                readRequest();
+    void                                closeConnection();
+
+private:
+    bool                                openFile(const QString &path) const;
+    void                                log(const QString &msg) const;
+
+private:
+    QTcpSocket                          *m_socket;          /*!< Connection to LibMan. */
+    quint16                             m_port;             /*!< Local TCP port of LibMan. */
+    QString                             m_token;            /*!< Token identifying the session. */
+    QStringList                         m_files;            /*!< Files given on the command line. */
+};
+
+#endif // TOOLSTUB_H
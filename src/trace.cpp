@@ -0,0 +1,348 @@
+#include <cstring>
+#include <iostream>
+
+#include <QFile>
+#include <QList>
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+#include <QTextStream>
+#include <QMutexLocker>
+#include <QThreadStorage>
+#include <QCoreApplication>
+
+#include "trace.h"
+#include "recordwriter.h"
+
+using std::cerr;
+using std::endl;
+
+/*!
+ * \brief The TraceEvent struct keeps a finished trace point.
+ */
+struct TraceEvent {
+    const char                      *category;      /*!< Category of the event. */
+    const char                      *name;          /*!< Name of the event. */
+    qint64                          start;          /*!< Start time in nanoseconds since start of tracing. */
+    qint64                          duration;       /*!< Duration in nanoseconds. */
+    QString                         detail;         /*!< Optional argument of the event. */
+};
+
+/*!
+ * \brief The TraceBuffer struct keeps the events of a single thread until they are appended to the trace file. When
+ * its thread ends, the buffer is written and reused by the next new thread, so pool threads do not accumulate buffers.
+ */
+struct TraceBuffer {
+    int                             threadId;       /*!< Sequential thread number shown in the trace. */
+    QString                         threadName;     /*!< Name of the thread shown in the trace. */
+    QMutex                          mutex;          /*!< Guards events against concurrent writing of the trace. */
+    QVector<TraceEvent>             events;         /*!< Events not yet written, TRACE_BUFFER_SIZE at most. */
+    int                             count;          /*!< Number of events not yet written. */
+    bool                            isUsed;         /*!< State if a running thread owns the buffer. */
+    bool                            isNameWritten;  /*!< State if the thread name has been written to the trace. */
+};
+
+/*!
+ * \brief The TraceThread struct links a thread to its buffer. It is deleted with the thread and hands the buffer back.
+ */
+struct TraceThread {
+    TraceBuffer                     *buffer;        /*!< Buffer owned by the registry. */
+
+    ~TraceThread();
+};
+
+QAtomicInt Trace::s_enabled(0);
+QElapsedTimer Trace::s_clock;
+
+static QString s_traceFile;
+static qint64 s_pid = 0;
+static QFile *s_file = 0;
+static int s_threadCount = 0;
+static QMutex s_fileMutex;
+static QMutex s_registryMutex;
+static QList<TraceBuffer*> s_buffers;
+static QThreadStorage<TraceThread*> s_threadBuffers;
+
+/*!*********************************************************************************************************************
+ * \brief Appends the events of the buffer to the trace file and empties it. The caller holds the buffer mutex. Events
+ * are dropped if no trace file is open.
+ * \param buffer        Buffer to write.
+ **********************************************************************************************************************/
+static void writeBuffer(TraceBuffer *buffer)
+{
+    if(!buffer->count) {
+        return;
+    }
+
+    QMutexLocker locker(&s_fileMutex);
+
+    if(s_file) {
+        QTextStream out(s_file);
+
+        if(!buffer->isNameWritten) {
+            out<<",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":"<<s_pid<<",\"tid\":"<<buffer->threadId
+               <<",\"args\":{\"name\":\""<<RecordWriter::escapeJson(buffer->threadName)<<"\"}}";
+            buffer->isNameWritten = true;
+        }
+
+        for(int i = 0; i < buffer->count; ++i) {
+            const TraceEvent &event = buffer->events[i];
+
+            out<<",\n{\"name\":\""<<event.name<<"\",\"cat\":\""<<event.category<<"\",\"ph\":\"X\""
+               <<",\"ts\":"<<QString::number(event.start / 1000.0, 'f', 3)
+               <<",\"dur\":"<<QString::number(event.duration / 1000.0, 'f', 3)
+               <<",\"pid\":"<<s_pid<<",\"tid\":"<<buffer->threadId;
+
+            if(!event.detail.isEmpty()) {
+                out<<",\"args\":{\"detail\":\""<<RecordWriter::escapeJson(event.detail)<<"\"}";
+            }
+
+            out<<"}";
+        }
+
+        out.flush();
+    }
+
+    for(int i = 0; i < buffer->count; ++i) {
+        buffer->events[i].detail.clear();
+    }
+
+    buffer->count = 0;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Writes the remaining events of the ending thread and frees its buffer for the next new thread.
+ **********************************************************************************************************************/
+TraceThread::~TraceThread()
+{
+    {
+        QMutexLocker locker(&buffer->mutex);
+        writeBuffer(buffer);
+    }
+
+    QMutexLocker locker(&s_registryMutex);
+    buffer->isUsed = false;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns buffer of the calling thread. On the first call a free buffer is taken or a new one is registered.
+ **********************************************************************************************************************/
+static TraceBuffer* getThreadBuffer()
+{
+    if(s_threadBuffers.hasLocalData()) {
+        return s_threadBuffers.localData()->buffer;
+    }
+
+    TraceBuffer *buffer = 0;
+    int threadId = 0;
+
+    {
+        QMutexLocker locker(&s_registryMutex);
+
+        foreach(TraceBuffer *freeBuffer, s_buffers) {
+            if(!freeBuffer->isUsed) {
+                buffer = freeBuffer;
+                break;
+            }
+        }
+
+        if(!buffer) {
+            buffer = new TraceBuffer;
+            buffer->events.resize(Trace::TRACE_BUFFER_SIZE);
+            buffer->count = 0;
+            s_buffers<<buffer;
+        }
+
+        buffer->isUsed = true;
+        threadId = ++s_threadCount;
+    }
+
+    QThread *thread = QThread::currentThread();
+    QCoreApplication *app = QCoreApplication::instance();
+
+    QString threadName;
+    if(app && thread == app->thread()) {
+        threadName = "main";
+    }
+    else if(thread && !thread->objectName().isEmpty()) {
+        threadName = QString("%1 %2").arg(thread->objectName()).arg(threadId);
+    }
+    else {
+        threadName = QString("worker %1").arg(threadId);
+    }
+
+    {
+        QMutexLocker locker(&buffer->mutex);
+        buffer->threadId = threadId;
+        buffer->threadName = threadName;
+        buffer->isNameWritten = false;
+    }
+
+    TraceThread *traceThread = new TraceThread;
+    traceThread->buffer = buffer;
+    s_threadBuffers.setLocalData(traceThread);
+
+    return buffer;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Opens the trace file and starts recording of trace events. Events recorded before are dropped.
+ * \param fileName      File the trace is written to.
+ * \return              True if tracing has been started, false if the file can not be written.
+ **********************************************************************************************************************/
+bool Trace::start(const QString &fileName)
+{
+    if(fileName.isEmpty() || isEnabled()) {
+        return false;
+    }
+
+    {
+        QMutexLocker locker(&s_registryMutex);
+        foreach(TraceBuffer *buffer, s_buffers) {
+            QMutexLocker bufferLocker(&buffer->mutex);
+            buffer->count = 0;
+            buffer->isNameWritten = false;
+        }
+    }
+
+    {
+        QMutexLocker locker(&s_fileMutex);
+
+        s_file = new QFile(fileName);
+        if(!s_file->open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+            delete s_file;
+            s_file = 0;
+            return false;
+        }
+
+        s_pid = QCoreApplication::applicationPid();
+
+        QTextStream out(s_file);
+        out<<"{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        out<<"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":"<<s_pid<<",\"tid\":0,\"args\":{\"name\":\"libman\"}}";
+        out.flush();
+    }
+
+    s_traceFile = fileName;
+    s_clock.start();
+    s_enabled.fetchAndStoreOrdered(1);
+
+    return true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Stops recording, writes the events still buffered by all threads and closes the trace file.
+ * \return              False if tracing was not started or the file can not be written.
+ **********************************************************************************************************************/
+bool Trace::stop()
+{
+    if(!isEnabled()) {
+        return false;
+    }
+
+    s_enabled.fetchAndStoreOrdered(0);
+
+    {
+        QMutexLocker locker(&s_registryMutex);
+        foreach(TraceBuffer *buffer, s_buffers) {
+            QMutexLocker bufferLocker(&buffer->mutex);
+            writeBuffer(buffer);
+        }
+    }
+
+    QMutexLocker locker(&s_fileMutex);
+
+    QTextStream out(s_file);
+    out<<"\n]}\n";
+    out.flush();
+
+    bool isWritten = s_file->error() == QFile::NoError;
+
+    s_file->close();
+    delete s_file;
+    s_file = 0;
+
+    return isWritten;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Adds an event to the buffer of the calling thread. A full buffer is appended to the trace file, so no events
+ * are lost and a long session does not grow in memory.
+ * \param category      Category of the event, string literal.
+ * \param name          Name of the event, string literal.
+ * \param start         Start time in nanoseconds.
+ * \param duration      Duration in nanoseconds.
+ * \param detail        Optional argument of the event.
+ **********************************************************************************************************************/
+void Trace::addEvent(const char *category, const char *name, qint64 start, qint64 duration, const QString &detail)
+{
+    TraceBuffer *buffer = getThreadBuffer();
+
+    QMutexLocker locker(&buffer->mutex);
+
+    TraceEvent &event = buffer->events[buffer->count];
+    event.category = category;
+    event.name = name;
+    event.start = start;
+    event.duration = duration;
+    event.detail = detail;
+
+    buffer->count++;
+
+    if(buffer->count == TRACE_BUFFER_SIZE) {
+        writeBuffer(buffer);
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns trace file requested by '--trace <file>' or by the LIBMAN_TRACE environment variable. Used before any
+ * Qt application object exists.
+ * \param argc     Number of command line arguments.
+ * \param argv     Command line arguments.
+ **********************************************************************************************************************/
+QString Trace::getRequestedFile(int argc, char *argv[])
+{
+    for(int i = 1; i + 1 < argc; ++i) {
+        if(std::strcmp(argv[i], "--trace") == 0) {
+            return QString::fromLocal8Bit(argv[i + 1]);
+        }
+    }
+
+    return QString::fromLocal8Bit(qgetenv("LIBMAN_TRACE"));
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns file the trace is written to or an empty string if tracing has never been started.
+ **********************************************************************************************************************/
+QString Trace::getFileName()
+{
+    return s_traceFile;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Starts tracing if the file name is not empty.
+ * \param fileName      File the trace is written to.
+ **********************************************************************************************************************/
+TraceSession::TraceSession(const QString &fileName)
+{
+    if(!fileName.isEmpty() && !Trace::start(fileName)) {
+        cerr<<"[ERROR] Can not write trace to '"<<fileName.toStdString()<<"'."<<endl;
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Writes the trace if tracing is on.
+ **********************************************************************************************************************/
+TraceSession::~TraceSession()
+{
+    if(!Trace::isEnabled()) {
+        return;
+    }
+
+    if(Trace::stop()) {
+        cerr<<"[INFO] Trace written to '"<<Trace::getFileName().toStdString()<<"'."<<endl;
+    }
+    else {
+        cerr<<"[ERROR] Can not write trace to '"<<Trace::getFileName().toStdString()<<"'."<<endl;
+    }
+}
@@ -0,0 +1,138 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <QString>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+
+/*!*********************************************************************************************************************
+ * \brief The Trace class records durations of scoped trace points into per-thread buffers and writes them as Chrome
+ * trace JSON, which can be opened in Perfetto (ui.perfetto.dev) or chrome://tracing. Tracing is switched on by the
+ * '--trace <file>' argument or the LIBMAN_TRACE environment variable and costs a single flag check otherwise. A buffer
+ * is appended to the trace file when it holds TRACE_BUFFER_SIZE events, when its thread ends and when tracing stops,
+ * so long sessions do not grow in memory.
+ **********************************************************************************************************************/
+class Trace
+{
+public:
+    enum {
+        TRACE_BUFFER_SIZE           = 65536
+    };
+
+    static bool                     start(const QString &fileName);
+    static bool                     stop();
+
+    static bool                     isEnabled();
+    static qint64                   now();
+
+    static void                     addEvent(const char *category, const char *name, qint64 start, qint64 duration,
+                                             const QString &detail);
+
+    static QString                  getRequestedFile(int argc, char *argv[]);
+    static QString                  getFileName();
+
+private:
+    static QAtomicInt               s_enabled;
+    static QElapsedTimer            s_clock;
+};
+
+/*!*********************************************************************************************************************
+ * \brief The TraceScope class records the time between its construction and destruction as a single trace event. It
+ * is used through the TRACE_SCOPE and TRACE_SCOPE_ARG macros.
+ **********************************************************************************************************************/
+class TraceScope
+{
+public:
+    TraceScope(const char *category, const char *name);
+    TraceScope(const char *category, const char *name, const QString &detail);
+    ~TraceScope();
+
+private:
+    const char                      *m_category;    /*!< Category of the event, must be a string literal. */
+    const char                      *m_name;        /*!< Name of the event, must be a string literal. */
+    QString                         m_detail;       /*!< Optional argument shown with the event. */
+    qint64                          m_start;        /*!< Start time in nanoseconds or -1 if tracing is off. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief The TraceSession class starts tracing into the given file and completes the trace when it goes out of scope.
+ **********************************************************************************************************************/
+class TraceSession
+{
+public:
+    explicit TraceSession(const QString &fileName);
+    ~TraceSession();
+};
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+
+/*!
+ * \brief Records duration of the enclosing scope as event 'name' of 'category'.
+ */
+#define TRACE_SCOPE(category, name) \
+    TraceScope TRACE_CONCAT(traceScope, __LINE__)(category, name)
+
+/*!
+ * \brief Records duration of the enclosing scope with an argument, e.g. path of the scanned library.
+ */
+#define TRACE_SCOPE_ARG(category, name, detail) \
+    TraceScope TRACE_CONCAT(traceScope, __LINE__)(category, name, Trace::isEnabled() ? QString(detail) : QString())
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if trace events are recorded.
+ **********************************************************************************************************************/
+inline bool Trace::isEnabled()
+{
+#if QT_VERSION >= 0x050000
+    return s_enabled.loadAcquire() != 0;
+#else
+    return int(s_enabled) != 0;
+#endif
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns time since start of tracing in nanoseconds.
+ **********************************************************************************************************************/
+inline qint64 Trace::now()
+{
+    return s_clock.nsecsElapsed();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Starts a trace event if tracing is on.
+ * \param category      Category of the event, string literal.
+ * \param name          Name of the event, string literal.
+ **********************************************************************************************************************/
+inline TraceScope::TraceScope(const char *category, const char *name)
+    : m_category(category),
+      m_name(name),
+      m_start(Trace::isEnabled() ? Trace::now() : -1)
+{
+}
+
+/*!*********************************************************************************************************************
+ * \brief Starts a trace event with an argument if tracing is on.
+ * \param category      Category of the event, string literal.
+ * \param name          Name of the event, string literal.
+ * \param detail        Argument of the event.
+ **********************************************************************************************************************/
+inline TraceScope::TraceScope(const char *category, const char *name, const QString &detail)
+    : m_category(category),
+      m_name(name),
+      m_detail(detail),
+      m_start(Trace::isEnabled() ? Trace::now() : -1)
+{
+}
+
+/*!*********************************************************************************************************************
+ * \brief Records the event into the buffer of the current thread.
+ **********************************************************************************************************************/
+inline TraceScope::~TraceScope()
+{
+    if(m_start >= 0 && Trace::isEnabled()) {
+        Trace::addEvent(m_category, m_name, m_start, Trace::now() - m_start, m_detail);
+    }
+}
+
+#endif // TRACE_H
@@ -0,0 +1,879 @@
+#include <cstring>
+
+#include <QFile>
+
+#include "verilogscanner.h"
+#include "perfcounters.h"
+#include "trace.h"
+
+/*!*********************************************************************************************************************
+ * \brief Keywords which can not be the type of an instance, sorted for binary search.
+ **********************************************************************************************************************/
+static const char *const VERILOG_KEYWORDS[] = {
+    "always", "always_comb", "always_ff", "always_latch", "assign", "automatic", "begin", "case", "casex", "casez",
+    "default", "defparam", "else", "end", "endcase", "endfunction", "endgenerate", "endmodule", "endprimitive",
+    "endspecify", "endtable", "endtask", "event", "for", "force", "forever", "function", "generate", "genvar", "if",
+    "initial", "inout", "input", "integer", "localparam", "logic", "macromodule", "module", "output", "parameter",
+    "primitive", "real", "realtime", "reg", "release", "repeat", "signed", "specify", "specparam", "supply0",
+    "supply1", "table", "task", "time", "tri", "tri0", "tri1", "triand", "trior", "unsigned", "var", "wand", "while",
+    "wire", "wor"
+};
+
+/*!*********************************************************************************************************************
+ * \brief Gate and switch primitives, counted as devices. Sorted for binary search.
+ **********************************************************************************************************************/
+static const char *const VERILOG_PRIMITIVES[] = {
+    "and", "buf", "bufif0", "bufif1", "cmos", "nand", "nmos", "nor", "not", "notif0", "notif1", "or", "pmos",
+    "pulldown", "pullup", "rcmos", "rnmos", "rpmos", "rtran", "rtranif0", "rtranif1", "tran", "tranif0", "tranif1",
+    "xnor", "xor"
+};
+
+/*!*********************************************************************************************************************
+ * \brief Compiler directives, any other name after '`' is a macro. Sorted for binary search.
+ **********************************************************************************************************************/
+static const char *const VERILOG_DIRECTIVES[] = {
+    "begin_keywords", "celldefine", "default_nettype", "define", "else", "elsif", "end_keywords", "endcelldefine",
+    "endif", "ifdef", "ifndef", "include", "line", "nounconnected_drive", "pragma", "resetall", "timescale",
+    "unconnected_drive", "undef", "undefineall"
+};
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if the word is in the sorted list.
+ * \param list          Sorted list of words.
+ * \param count         Number of words in the list.
+ * \param start         First character of the word.
+ * \param length        Length of the word.
+ **********************************************************************************************************************/
+static bool isInList(const char *const *list, int count, const char *start, int length)
+{
+    int low = 0;
+    int high = count - 1;
+
+    while(low <= high) {
+        int middle = (low + high) / 2;
+
+        int result = std::strncmp(list[middle], start, length);
+        if(result == 0 && list[middle][length] != '\0') {
+            result = 1;
+        }
+
+        if(result == 0) {
+            return true;
+        }
+        else if(result < 0) {
+            low = middle + 1;
+        }
+        else {
+            high = middle - 1;
+        }
+    }
+
+    return false;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if the character separates tokens.
+ * \param c             Character to check.
+ **********************************************************************************************************************/
+static inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if the character may continue an identifier.
+ * \param c             Character to check.
+ **********************************************************************************************************************/
+static inline bool isIdentifierChar(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '$';
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns position after the next occurrence of the two characters or the end.
+ * \param position      Position to search from.
+ * \param end           End of the text.
+ * \param first         First character of the pair, searched by memchr().
+ * \param second        Second character of the pair.
+ **********************************************************************************************************************/
+static const char* skipPast(const char *position, const char *end, char first, char second)
+{
+    while(position < end) {
+        const char *found = static_cast<const char*>(std::memchr(position, first, end - position));
+        if(!found || found + 1 >= end) {
+            return end;
+        }
+
+        if(found[1] == second) {
+            return found + 2;
+        }
+
+        position = found + 1;
+    }
+
+    return end;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns position after the end of the line or the end.
+ * \param position      Position to search from.
+ * \param end           End of the text.
+ **********************************************************************************************************************/
+static const char* skipLine(const char *position, const char *end)
+{
+    const char *found = static_cast<const char*>(std::memchr(position, '\n', end - position));
+
+    return found ? found + 1 : end;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Constructs an empty scanner.
+ **********************************************************************************************************************/
+VerilogScanner::VerilogScanner()
+    : m_position(0),
+      m_end(0),
+      m_lineStart(0),
+      m_line(1),
+      m_hasPushedBack(false)
+{
+}
+
+/*!*********************************************************************************************************************
+ * \brief Scans the Verilog file. The file is mapped into memory, or read if it can not be mapped.
+ * \param fileName      Path to the Verilog file.
+ * \return              True if no errors were found, otherwise false and the reasons are in the error list.
+ **********************************************************************************************************************/
+bool VerilogScanner::scan(const QString &fileName)
+{
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly)) {
+        m_modules.clear();
+        m_includes.clear();
+        m_errorList.clear();
+        m_errorList<<QString("Can not read file '%1':\n%2.").arg(fileName).arg(file.errorString());
+        return false;
+    }
+
+    qint64 size = file.size();
+
+    PerfCounters::add(PerfCounters::FILES_READ);
+    PerfCounters::add(PerfCounters::BYTES_READ, size);
+
+    uchar *data = size > 0 ? file.map(0, size) : 0;
+    if(data) {
+        bool isScanned = scan(reinterpret_cast<const char*>(data), size, fileName);
+        file.unmap(data);
+
+        return isScanned;
+    }
+
+    QByteArray content = file.readAll();
+
+    return scan(content.constData(), content.size(), fileName);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Scans Verilog text for modules.
+ * \param data          Text to scan, it does not need to be terminated.
+ * \param size          Size of the text in bytes.
+ * \param fileName      Name of the file used in error messages.
+ * \return              True if no errors were found, otherwise false and the reasons are in the error list.
+ **********************************************************************************************************************/
+bool VerilogScanner::scan(const char *data, qint64 size, const QString &fileName)
+{
+    TRACE_SCOPE_ARG("netlist", "scan_verilog", fileName);
+
+    m_position = data;
+    m_end = data + size;
+    m_lineStart = data;
+    m_line = 1;
+    m_hasPushedBack = false;
+
+    m_fileName = fileName;
+    m_modules.clear();
+    m_includes.clear();
+    m_errorList.clear();
+
+    for(;;) {
+        Token token = next();
+        if(token.type == END_OF_FILE) {
+            break;
+        }
+
+        if(isWord(token, "module") || isWord(token, "macromodule")) {
+            scanModule();
+        }
+        else if(isWord(token, "primitive")) {
+            skipBlock("endprimitive");
+        }
+    }
+
+    return m_errorList.isEmpty();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns the next token. Comments, attributes and compiler directives are skipped, files of '`include' are
+ * recorded and macro calls are returned as numbers, so they never match an identifier.
+ **********************************************************************************************************************/
+VerilogScanner::Token VerilogScanner::next()
+{
+    if(m_hasPushedBack) {
+        m_hasPushedBack = false;
+        return m_pushedBack;
+    }
+
+    while(m_position < m_end) {
+        char c = *m_position;
+
+        if(isSpace(c)) {
+            ++m_position;
+            continue;
+        }
+
+        char following = m_position + 1 < m_end ? m_position[1] : '\0';
+
+        if(c == '/' && following == '/') {
+            m_position = skipLine(m_position + 2, m_end);
+            continue;
+        }
+
+        if(c == '/' && following == '*') {
+            m_position = skipPast(m_position + 2, m_end, '*', '/');
+            continue;
+        }
+
+        // Attribute '(* ... *)', but not the event control '@(*)'.
+        if(c == '(' && following == '*' && (m_position + 2 >= m_end || m_position[2] != ')')) {
+            m_position = skipPast(m_position + 2, m_end, '*', ')');
+            continue;
+        }
+
+        Token token;
+        token.start = m_position;
+
+        if(c == '`') {
+            const char *name = ++m_position;
+            while(m_position < m_end && isIdentifierChar(*m_position)) {
+                ++m_position;
+            }
+
+            int length = int(m_position - name);
+
+            if(!isInList(VERILOG_DIRECTIVES, int(sizeof(VERILOG_DIRECTIVES) / sizeof(VERILOG_DIRECTIVES[0])), name,
+                         length)) {
+                token.type = NUMBER;
+                token.length = int(m_position - token.start);
+                return token;
+            }
+
+            skipDirective(name, length);
+            continue;
+        }
+
+        if((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_') {
+            while(m_position < m_end && isIdentifierChar(*m_position)) {
+                ++m_position;
+            }
+
+            token.type = IDENTIFIER;
+        }
+        else if(c == '\\') {
+            token.start = ++m_position;
+            while(m_position < m_end && !isSpace(*m_position)) {
+                ++m_position;
+            }
+
+            token.type = IDENTIFIER;
+        }
+        else if((c >= '0' && c <= '9') || c == '\'') {
+            ++m_position;
+            while(m_position < m_end && (isIdentifierChar(*m_position) || *m_position == '\'' || *m_position == '.'
+                                                                        || *m_position == '?')) {
+                ++m_position;
+            }
+
+            token.type = NUMBER;
+        }
+        else if(c == '"') {
+            const char *position = m_position + 1;
+            for(;;) {
+                const char *quote = static_cast<const char*>(std::memchr(position, '"', m_end - position));
+                if(!quote) {
+                    position = m_end;
+                    break;
+                }
+
+                // A quote is escaped by an odd number of backslashes.
+                const char *backslash = quote;
+                while(backslash > position && backslash[-1] == '\\') {
+                    --backslash;
+                }
+
+                position = quote + 1;
+                if((quote - backslash) % 2 == 0) {
+                    break;
+                }
+            }
+
+            token.start = m_position + 1;
+            token.length = qMax(0, int(position - token.start) - 1);
+            token.type = STRING;
+            m_position = position;
+            return token;
+        }
+        else {
+            ++m_position;
+            token.type = SYMBOL;
+        }
+
+        token.length = int(m_position - token.start);
+        return token;
+    }
+
+    Token token;
+    token.type = END_OF_FILE;
+    token.start = m_end;
+    token.length = 0;
+
+    return token;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns the token by the next call of next().
+ * \param token         Token to return again.
+ **********************************************************************************************************************/
+void VerilogScanner::pushBack(const Token &token)
+{
+    m_pushedBack = token;
+    m_hasPushedBack = true;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Skips arguments of the compiler directive whose name has just been read.
+ * \param name          First character of the directive name after '`'.
+ * \param length        Length of the directive name.
+ **********************************************************************************************************************/
+void VerilogScanner::skipDirective(const char *name, int length)
+{
+    if(length == 7 && std::strncmp(name, "include", 7) == 0) {
+        Token file = next();
+        if(file.type == STRING) {
+            m_includes<<getText(file);
+        }
+    }
+    else if(length == 6 && std::strncmp(name, "define", 6) == 0) {
+        // Macro bodies are continued by a backslash at the end of the line.
+        for(;;) {
+            const char *lineStart = m_position;
+            const char *lineEnd = static_cast<const char*>(std::memchr(lineStart, '\n', m_end - lineStart));
+            if(!lineEnd) {
+                m_position = m_end;
+                break;
+            }
+
+            const char *last = lineEnd;
+            if(last > lineStart && last[-1] == '\r') {
+                --last;
+            }
+
+            m_position = lineEnd + 1;
+            if(last == lineStart || last[-1] != '\\') {
+                break;
+            }
+        }
+    }
+    else if((length == 9 && std::strncmp(name, "timescale", 9) == 0) ||
+            (length == 4 && std::strncmp(name, "line", 4) == 0) ||
+            (length == 6 && std::strncmp(name, "pragma", 6) == 0) ||
+            (length == 14 && std::strncmp(name, "begin_keywords", 14) == 0) ||
+            (length == 17 && std::strncmp(name, "unconnected_drive", 17) == 0)) {
+        m_position = skipLine(m_position, m_end);
+    }
+    else if((length == 5 && std::strncmp(name, "ifdef", 5) == 0) ||
+            (length == 6 && std::strncmp(name, "ifndef", 6) == 0) ||
+            (length == 5 && std::strncmp(name, "elsif", 5) == 0) ||
+            (length == 5 && std::strncmp(name, "undef", 5) == 0) ||
+            (length == 15 && std::strncmp(name, "default_nettype", 15) == 0)) {
+        next();
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Skips tokens up to the matching closing symbol, the opening one has just been read.
+ * \param open          Opening symbol.
+ * \param close         Closing symbol.
+ **********************************************************************************************************************/
+void VerilogScanner::skipGroup(char open, char close)
+{
+    int depth = 1;
+
+    for(;;) {
+        Token token = next();
+        if(token.type == END_OF_FILE) {
+            return;
+        }
+
+        if(isSymbol(token, open)) {
+            depth++;
+        }
+        else if(isSymbol(token, close) && --depth == 0) {
+            return;
+        }
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Skips tokens up to the ';' ending the statement. Stops before 'endmodule' if the ';' is missing.
+ **********************************************************************************************************************/
+void VerilogScanner::skipStatement()
+{
+    int depth = 0;
+
+    for(;;) {
+        Token token = next();
+        if(token.type == END_OF_FILE) {
+            return;
+        }
+
+        if(token.type == SYMBOL) {
+            char c = *token.start;
+            if(c == '(' || c == '[' || c == '{') {
+                depth++;
+            }
+            else if(c == ')' || c == ']' || c == '}') {
+                depth--;
+            }
+            else if(c == ';' && depth <= 0) {
+                return;
+            }
+        }
+        else if(isWord(token, "endmodule")) {
+            pushBack(token);
+            return;
+        }
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Skips tokens up to the keyword ending the block. Stops before 'endmodule' if the keyword is missing.
+ * \param endKeyword    Keyword ending the block.
+ **********************************************************************************************************************/
+void VerilogScanner::skipBlock(const char *endKeyword)
+{
+    for(;;) {
+        Token token = next();
+        if(token.type == END_OF_FILE || isWord(token, endKeyword)) {
+            return;
+        }
+
+        if(isWord(token, "endmodule")) {
+            pushBack(token);
+            return;
+        }
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Skips tokens up to the 'endcase' ending the case statement, nested case statements included. Stops before
+ * 'endmodule' if the keyword is missing.
+ **********************************************************************************************************************/
+void VerilogScanner::skipCase()
+{
+    int depth = 1;
+
+    for(;;) {
+        Token token = next();
+        if(token.type == END_OF_FILE) {
+            return;
+        }
+
+        if(isWord(token, "case") || isWord(token, "casex") || isWord(token, "casez")) {
+            depth++;
+        }
+        else if(isWord(token, "endcase") && --depth == 0) {
+            return;
+        }
+        else if(isWord(token, "endmodule")) {
+            pushBack(token);
+            return;
+        }
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Scans module header and body, 'module' has just been read. Instances are statements of the form
+ * '<type> [#(...)] <name> [range] (...) [, <name> (...)] ;' whose type is not a keyword.
+ **********************************************************************************************************************/
+void VerilogScanner::scanModule()
+{
+    Token name = next();
+    if(name.type != IDENTIFIER) {
+        pushBack(name);
+        return;
+    }
+
+    NetlistParser::Subckt module;
+    module.name = getText(name);
+    module.line = getLine(name.start);
+
+    for(;;) {
+        Token token = next();
+        if(token.type == END_OF_FILE || isSymbol(token, ';')) {
+            break;
+        }
+
+        if(isSymbol(token, '#')) {
+            token = next();
+            if(isSymbol(token, '(')) {
+                skipGroup('(', ')');
+            }
+        }
+        else if(isSymbol(token, '(')) {
+            scanPorts(&module);
+        }
+    }
+
+    bool isClosed = false;
+
+    for(;;) {
+        Token token = next();
+        if(token.type == END_OF_FILE) {
+            break;
+        }
+
+        if(token.type != IDENTIFIER) {
+            if(isSymbol(token, '@') || isSymbol(token, '#')) {
+                token = next();
+                if(isSymbol(token, '(')) {
+                    skipGroup('(', ')');
+                }
+            }
+            else if(isSymbol(token, ':')) {
+                // Label of a block, e.g. 'begin : gen_bits'.
+                next();
+            }
+            else if(isSymbol(token, '(')) {
+                skipGroup('(', ')');
+            }
+
+            continue;
+        }
+
+        if(isWord(token, "endmodule")) {
+            isClosed = true;
+            break;
+        }
+
+        if(!isKeyword(token)) {
+            scanInstances(&module, token);
+        }
+        else if(isWord(token, "input")) {
+            scanDeclaration(&module, "I");
+        }
+        else if(isWord(token, "output")) {
+            scanDeclaration(&module, "O");
+        }
+        else if(isWord(token, "inout")) {
+            scanDeclaration(&module, "B");
+        }
+        else if(isWord(token, "if") || isWord(token, "for") || isWord(token, "while") || isWord(token, "repeat")) {
+            token = next();
+            if(isSymbol(token, '(')) {
+                skipGroup('(', ')');
+            }
+            else {
+                pushBack(token);
+            }
+        }
+        else if(isWord(token, "function")) {
+            skipBlock("endfunction");
+        }
+        else if(isWord(token, "task")) {
+            skipBlock("endtask");
+        }
+        else if(isWord(token, "specify")) {
+            skipBlock("endspecify");
+        }
+        else if(isWord(token, "table")) {
+            skipBlock("endtable");
+        }
+        else if(isWord(token, "case") || isWord(token, "casex") || isWord(token, "casez")) {
+            skipCase();
+        }
+        else if(!isWord(token, "begin") && !isWord(token, "end") && !isWord(token, "else") &&
+                !isWord(token, "endcase") && !isWord(token, "generate") && !isWord(token, "endgenerate") &&
+                !isWord(token, "always") && !isWord(token, "always_comb") && !isWord(token, "always_ff") &&
+                !isWord(token, "always_latch") && !isWord(token, "initial") && !isWord(token, "forever") &&
+                !isWord(token, "default")) {
+            // Declarations, assignments and parameters.
+            skipStatement();
+        }
+    }
+
+    if(!isClosed) {
+        m_errorList<<QString("Module '%1' in line %2 of '%3' is not closed by 'endmodule'.")
+                     .arg(module.name).arg(module.line).arg(m_fileName);
+    }
+
+    m_modules<<module;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Scans port list of the module header, '(' has just been read. A port is the last identifier before ',' or the
+ * closing ')'; directions of ANSI style headers hold for the following ports.
+ * \param module        Module to add ports to.
+ **********************************************************************************************************************/
+void VerilogScanner::scanPorts(NetlistParser::Subckt *module)
+{
+    int depth = 0;
+    bool isDefault = false;
+    QString direction;
+    QString port;
+
+    for(;;) {
+        Token token = next();
+        if(token.type == END_OF_FILE) {
+            return;
+        }
+
+        if(token.type == SYMBOL) {
+            char c = *token.start;
+            bool isEnd = false;
+
+            if(c == '(' || c == '[' || c == '{') {
+                depth++;
+            }
+            else if(c == ')' || c == ']' || c == '}') {
+                isEnd = depth == 0;
+                depth--;
+            }
+
+            if(isEnd || (depth == 0 && c == ',')) {
+                if(!port.isEmpty()) {
+                    module->ports<<port;
+                    if(!direction.isEmpty()) {
+                        module->pinInfo<<port + ":" + direction;
+                    }
+                }
+
+                if(isEnd) {
+                    return;
+                }
+
+                port.clear();
+                isDefault = false;
+            }
+            else if(depth == 0 && c == '=') {
+                isDefault = true;
+            }
+
+            continue;
+        }
+
+        if(depth > 0 || isDefault || token.type != IDENTIFIER) {
+            continue;
+        }
+
+        if(isWord(token, "input")) {
+            direction = "I";
+        }
+        else if(isWord(token, "output")) {
+            direction = "O";
+        }
+        else if(isWord(token, "inout")) {
+            direction = "B";
+        }
+        else if(!isKeyword(token)) {
+            port = getText(token);
+        }
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Scans port declaration of a non-ANSI module body, the direction keyword has just been read.
+ * \param module        Module to add port directions to.
+ * \param direction     Direction of the declared ports (I, O or B).
+ **********************************************************************************************************************/
+void VerilogScanner::scanDeclaration(NetlistParser::Subckt *module, const QString &direction)
+{
+    int depth = 0;
+    bool isDefault = false;
+
+    for(;;) {
+        Token token = next();
+        if(token.type == END_OF_FILE) {
+            return;
+        }
+
+        if(token.type == SYMBOL) {
+            char c = *token.start;
+            if(c == '(' || c == '[' || c == '{') {
+                depth++;
+            }
+            else if(c == ')' || c == ']' || c == '}') {
+                depth--;
+            }
+            else if(depth <= 0 && c == ';') {
+                return;
+            }
+            else if(depth <= 0 && c == ',') {
+                isDefault = false;
+            }
+            else if(depth <= 0 && c == '=') {
+                isDefault = true;
+            }
+
+            continue;
+        }
+
+        if(isWord(token, "endmodule")) {
+            pushBack(token);
+            return;
+        }
+
+        if(depth > 0 || isDefault || token.type != IDENTIFIER || isKeyword(token)) {
+            continue;
+        }
+
+        QString port = getText(token);
+        if(module->ports.contains(port)) {
+            module->pinInfo<<port + ":" + direction;
+        }
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Scans a statement starting with an identifier which is not a keyword. It is counted if it instantiates the
+ * type, otherwise it is skipped.
+ * \param module        Module to add instances to.
+ * \param type          First token of the statement.
+ **********************************************************************************************************************/
+void VerilogScanner::scanInstances(NetlistParser::Subckt *module, const Token &type)
+{
+    bool isGate = isPrimitive(type);
+
+    Token token = next();
+    if(isSymbol(token, '#')) {
+        token = next();
+        if(isSymbol(token, '(')) {
+            skipGroup('(', ')');
+        }
+
+        token = next();
+    }
+
+    int count = 0;
+
+    for(;;) {
+        if(token.type == IDENTIFIER) {
+            token = next();
+            while(isSymbol(token, '[')) {
+                skipGroup('[', ']');
+                token = next();
+            }
+        }
+        else if(!isGate) {
+            break;
+        }
+
+        if(!isSymbol(token, '(')) {
+            break;
+        }
+
+        skipGroup('(', ')');
+        count++;
+
+        token = next();
+        if(!isSymbol(token, ',')) {
+            break;
+        }
+
+        token = next();
+    }
+
+    if(count) {
+        if(isGate) {
+            module->devices[getText(type)] += count;
+        }
+        else {
+            module->instances[getText(type)] += count;
+        }
+    }
+
+    if(!isSymbol(token, ';')) {
+        pushBack(token);
+        skipStatement();
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns line number of the position. Positions have to be requested in increasing order.
+ * \param position      Position in the scanned text.
+ **********************************************************************************************************************/
+int VerilogScanner::getLine(const char *position)
+{
+    while(m_lineStart < position) {
+        const char *found = static_cast<const char*>(std::memchr(m_lineStart, '\n', position - m_lineStart));
+        if(!found) {
+            m_lineStart = position;
+            break;
+        }
+
+        m_line++;
+        m_lineStart = found + 1;
+    }
+
+    return m_line;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if the token is the symbol.
+ * \param token         Token to check.
+ * \param c             Symbol.
+ **********************************************************************************************************************/
+bool VerilogScanner::isSymbol(const Token &token, char c)
+{
+    return token.type == SYMBOL && *token.start == c;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if the token is the identifier.
+ * \param token         Token to check.
+ * \param word          Identifier.
+ **********************************************************************************************************************/
+bool VerilogScanner::isWord(const Token &token, const char *word)
+{
+    return token.type == IDENTIFIER && std::strncmp(token.start, word, token.length) == 0
+                                    && word[token.length] == '\0';
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if the token is a keyword.
+ * \param token         Token to check.
+ **********************************************************************************************************************/
+bool VerilogScanner::isKeyword(const Token &token)
+{
+    return token.type == IDENTIFIER &&
+           isInList(VERILOG_KEYWORDS, int(sizeof(VERILOG_KEYWORDS) / sizeof(VERILOG_KEYWORDS[0])), token.start,
+                    token.length);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if the token is a gate or switch primitive.
+ * \param token         Token to check.
+ **********************************************************************************************************************/
+bool VerilogScanner::isPrimitive(const Token &token)
+{
+    return token.type == IDENTIFIER &&
+           isInList(VERILOG_PRIMITIVES, int(sizeof(VERILOG_PRIMITIVES) / sizeof(VERILOG_PRIMITIVES[0])), token.start,
+                    token.length);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns text of the token.
+ * \param token         Token.
+ **********************************************************************************************************************/
+QString VerilogScanner::getText(const Token &token)
+{
+    return QString::fromLatin1(token.start, token.length);
+}
@@ -0,0 +1,108 @@
+#ifndef VERILOGSCANNER_H
+#define VERILOGSCANNER_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "netlistparser.h"
+
+/*!*********************************************************************************************************************
+ * \brief The VerilogScanner class tokenizes Verilog files and collects module names, ports with their directions and
+ * instantiated module types, without preprocessing or elaborating them. Modules are returned as subcircuits, so they
+ * are indexed and linked like SPICE and CDL views; gate primitives are counted as devices. Comments and strings are
+ * skipped by memchr(), which the C library implements with vector instructions, and the file is memory mapped.
+ **********************************************************************************************************************/
+class VerilogScanner
+{
+public:
+    /*!
+     * \brief The TOKEN enum specifies token types.
+     */
+    enum TOKEN {
+        END_OF_FILE                     = 0,
+        IDENTIFIER,
+        NUMBER,
+        STRING,
+        SYMBOL
+    };
+
+    /*!
+     * \brief The Token struct points into the scanned text.
+     */
+    struct Token {
+        TOKEN                           type;               /*!< Type of the token. */
+        const char                      *start;             /*!< First character. */
+        int                             length;             /*!< Number of characters. */
+    };
+
+    VerilogScanner();
+
+    bool                                scan(const QString &fileName);
+    bool                                scan(const char *data, qint64 size, const QString &fileName);
+
+    QList<NetlistParser::Subckt>        getSubckts() const;
+    QStringList                         getIncludes() const;
+    QStringList                         getErrors() const;
+
+private:
+    Token                               next();
+    void                                pushBack(const Token &token);
+    void                                skipDirective(const char *name, int length);
+    void                                skipGroup(char open, char close);
+    void                                skipStatement();
+    void                                skipBlock(const char *endKeyword);
+    void                                skipCase();
+
+    void                                scanModule();
+    void                                scanPorts(NetlistParser::Subckt *module);
+    void                                scanDeclaration(NetlistParser::Subckt *module, const QString &direction);
+    void                                scanInstances(NetlistParser::Subckt *module, const Token &type);
+
+    int                                 getLine(const char *position);
+
+    static bool                         isSymbol(const Token &token, char c);
+    static bool                         isWord(const Token &token, const char *word);
+    static bool                         isKeyword(const Token &token);
+    static bool                         isPrimitive(const Token &token);
+    static QString                      getText(const Token &token);
+
+private:
+    const char                          *m_position;        /*!< Next character to scan. */
+    const char                          *m_end;             /*!< End of the scanned text. */
+    const char                          *m_lineStart;       /*!< Position up to which lines have been counted. */
+    int                                 m_line;             /*!< Line number at m_lineStart. */
+    Token                               m_pushedBack;       /*!< Token returned again by next(). */
+    bool                                m_hasPushedBack;    /*!< State if m_pushedBack is valid. */
+
+    QString                             m_fileName;         /*!< Path of the scanned file, used in error messages. */
+    QList<NetlistParser::Subckt>        m_modules;          /*!< Modules in the order of their definition. */
+    QStringList                         m_includes;         /*!< Files referenced by '`include'. */
+    QStringList                         m_errorList;        /*!< Errors found in the file. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Returns modules in the order of their definition.
+ **********************************************************************************************************************/
+inline QList<NetlistParser::Subckt> VerilogScanner::getSubckts() const
+{
+    return m_modules;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns files referenced by '`include'.
+ **********************************************************************************************************************/
+inline QStringList VerilogScanner::getIncludes() const
+{
+    return m_includes;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns errors found by the last scan() call.
+ **********************************************************************************************************************/
+inline QStringList VerilogScanner::getErrors() const
+{
+    return m_errorList;
+}
+
+#endif // VERILOGSCANNER_H
@@ -0,0 +1,424 @@
+#include <algorithm>
+
+#include <QSet>
+#include <QThread>
+#include <QVector>
+#include <QRunnable>
+#include <QThreadPool>
+
+#include "catalog.h"
+#include "viewcheck.h"
+#include "netlistindex.h"
+#include "perfcounters.h"
+#include "trace.h"
+
+#include "gds/gdsscanner.h"
+
+/*!*********************************************************************************************************************
+ * \brief Returns name of a bus bit without its index, 'A[3]' and 'A<3>' give 'A'.
+ * \param name          Upper case name of a label or port.
+ **********************************************************************************************************************/
+static QString getBusName(const QString &name)
+{
+    for(int i = 1; i < name.size(); ++i) {
+        if(name.at(i) == '[' || name.at(i) == '<') {
+            return name.left(i);
+        }
+    }
+
+    return name;
+}
+
+/*!*********************************************************************************************************************
+ * \brief The ViewCheckJob class checks the views of a single cell into its slot of the results, so jobs do not share
+ * any data.
+ **********************************************************************************************************************/
+class ViewCheckJob : public QRunnable
+{
+public:
+    ViewCheckJob(const QString &library, const QString &cell, const QString &gdsPath,
+                 const QMap<QString, NetlistIndex::View> &netlists, QList<ViewCheck::Issue> *issues)
+        : m_library(library), m_cell(cell), m_gdsPath(gdsPath), m_netlists(netlists), m_issues(issues) {}
+
+    void run();
+
+private:
+    void                                addIssue(const QString &view, const QString &severity, const QString &check,
+                                                 const QString &message);
+    void                                checkNetlist(const QString &viewName, const NetlistIndex::View &netlist,
+                                                     const GdsScanner &layout);
+    void                                checkPins(const QString &viewName, const GdsScanner::Structure &structure,
+                                                  const NetlistParser::Subckt &subckt);
+
+private:
+    QString                             m_library;          /*!< Name of the library. */
+    QString                             m_cell;             /*!< Name of the cell. */
+    QString                             m_gdsPath;          /*!< Path to the layout view, empty if there is none. */
+    QMap<QString, NetlistIndex::View>   m_netlists;         /*!< Indexed netlist views by view name. */
+    QList<ViewCheck::Issue>             *m_issues;          /*!< Result slot, owned by ViewCheck::run(). */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Scans the layout and compares it with every netlist view of the cell.
+ **********************************************************************************************************************/
+void ViewCheckJob::run()
+{
+    PerfTimer perfTimer(PerfCounters::JOB_DURATION);
+
+    if(m_gdsPath.isEmpty()) {
+        addIssue("", "error", "missing_view", QString("No 'gds' view for the netlist views '%1'.")
+                                              .arg(QStringList(m_netlists.keys()).join(", ")));
+        PerfCounters::add(PerfCounters::JOBS_DONE);
+        return;
+    }
+
+    if(m_netlists.isEmpty()) {
+        addIssue("", "error", "missing_view", "No netlist view for the 'gds' view.");
+        PerfCounters::add(PerfCounters::JOBS_DONE);
+        return;
+    }
+
+    GdsScanner layout;
+    if(!layout.scan(m_gdsPath)) {
+        foreach(const QString &explain, layout.getErrors()) {
+            addIssue("gds", "error", "read_error", explain);
+        }
+
+        PerfCounters::add(PerfCounters::JOBS_FAILED);
+        return;
+    }
+
+    QMap<QString, NetlistIndex::View>::const_iterator it;
+    for(it = m_netlists.constBegin(); it != m_netlists.constEnd(); ++it) {
+        checkNetlist(it.key(), it.value(), layout);
+    }
+
+    PerfCounters::add(PerfCounters::JOBS_DONE);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Adds a finding to the result slot.
+ * \param view          Name of the view the finding is about, empty for the cell.
+ * \param severity      'error' or 'warning'.
+ * \param check         Name of the failed check.
+ * \param message       Description of the finding.
+ **********************************************************************************************************************/
+void ViewCheckJob::addIssue(const QString &view, const QString &severity, const QString &check,
+                            const QString &message)
+{
+    ViewCheck::Issue issue;
+    issue.library = m_library;
+    issue.cell = m_cell;
+    issue.view = view;
+    issue.severity = severity;
+    issue.check = check;
+    issue.message = message;
+
+    *m_issues<<issue;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Matches the top structures of the layout with the top subcircuits of the netlist, those not instantiated
+ * within the view. A pair named like the cell is preferred; if names differ and both sides have a single top, their
+ * pins are compared anyway.
+ * \param viewName      Name of the netlist view.
+ * \param netlist       Indexed netlist view.
+ * \param layout        Scanned layout view.
+ **********************************************************************************************************************/
+void ViewCheckJob::checkNetlist(const QString &viewName, const NetlistIndex::View &netlist, const GdsScanner &layout)
+{
+    foreach(const QString &explain, netlist.errors) {
+        addIssue(viewName, "error", "read_error", explain);
+    }
+
+    if(netlist.subckts.isEmpty()) {
+        addIssue(viewName, "error", "top_name", "Netlist defines no subcircuit.");
+        return;
+    }
+
+    QSet<QString> instantiated;
+    foreach(const NetlistParser::Subckt &subckt, netlist.subckts) {
+        foreach(const QString &name, subckt.instances.keys()) {
+            instantiated.insert(name.toUpper());
+        }
+    }
+
+    QMap<QString, int> netlistTops;
+    for(int i = 0; i < netlist.subckts.count(); ++i) {
+        QString name = netlist.subckts[i].name.toUpper();
+        if(!instantiated.contains(name)) {
+            netlistTops[name] = i;
+        }
+    }
+
+    QList<GdsScanner::Structure> structures = layout.getStructures();
+    QSet<QString> layoutTopNames;
+    foreach(const QString &name, layout.getTopStructures()) {
+        layoutTopNames.insert(name);
+    }
+
+    QMap<QString, int> layoutTops;
+    for(int i = 0; i < structures.count(); ++i) {
+        if(layoutTopNames.contains(structures[i].name)) {
+            layoutTops[structures[i].name.toUpper()] = i;
+        }
+    }
+
+    if(layoutTops.isEmpty()) {
+        addIssue("gds", "error", "top_name", "Layout defines no structure.");
+        return;
+    }
+
+    QString match = m_cell.toUpper();
+    if(!layoutTops.contains(match) || !netlistTops.contains(match)) {
+        match.clear();
+
+        foreach(const QString &name, layoutTops.keys()) {
+            if(netlistTops.contains(name)) {
+                match = name;
+                break;
+            }
+        }
+    }
+
+    if(match.isEmpty()) {
+        QStringList layoutNames;
+        foreach(int index, layoutTops) {
+            layoutNames<<structures[index].name;
+        }
+
+        QStringList netlistNames;
+        foreach(int index, netlistTops) {
+            netlistNames<<netlist.subckts[index].name;
+        }
+
+        addIssue(viewName, "error", "top_name", QString("Layout top structure '%1' does not match subcircuit '%2'.")
+                                               .arg(layoutNames.join(", ")).arg(netlistNames.join(", ")));
+
+        if(layoutTops.count() == 1 && netlistTops.count() == 1) {
+            checkPins(viewName, structures[layoutTops.begin().value()],
+                      netlist.subckts[netlistTops.begin().value()]);
+        }
+
+        return;
+    }
+
+    checkPins(viewName, structures[layoutTops[match]], netlist.subckts[netlistTops[match]]);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Compares labels of the layout structure with ports of the subcircuit, case insensitive. A label of a bus bit
+ * matches a port named like the whole bus.
+ * \param viewName      Name of the netlist view.
+ * \param structure     Top structure of the layout.
+ * \param subckt        Top subcircuit of the netlist.
+ **********************************************************************************************************************/
+void ViewCheckJob::checkPins(const QString &viewName, const GdsScanner::Structure &structure,
+                             const NetlistParser::Subckt &subckt)
+{
+    QSet<QString> ports;
+    foreach(const QString &port, subckt.ports) {
+        ports.insert(port.toUpper());
+    }
+
+    QSet<QString> labels;
+    QSet<QString> labelBuses;
+
+    foreach(const QString &label, structure.labels) {
+        QString name = label.toUpper();
+        if(labels.contains(name)) {
+            continue;
+        }
+
+        labels.insert(name);
+        labelBuses.insert(getBusName(name));
+
+        if(!ports.contains(name) && !ports.contains(getBusName(name))) {
+            addIssue(viewName, "error", "missing_pin", QString("Label '%1' of structure '%2' is not a port of subcircuit "
+                                                               "'%3'.").arg(label).arg(structure.name).arg(subckt.name));
+        }
+    }
+
+    foreach(const QString &port, subckt.ports) {
+        QString name = port.toUpper();
+        if(!labels.contains(name) && !labelBuses.contains(name)) {
+            addIssue(viewName, "warning", "unlabeled_port", QString("Port '%1' of subcircuit '%2' has no label in "
+                                                                    "structure '%3'.").arg(port).arg(subckt.name)
+                                                                    .arg(structure.name));
+        }
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief The IssueLess struct orders findings by a single field.
+ **********************************************************************************************************************/
+struct IssueLess {
+    explicit IssueLess(QString ViewCheck::Issue::*field) : m_field(field) {}
+
+    bool operator()(const ViewCheck::Issue &first, const ViewCheck::Issue &second) const
+    {
+        return (first.*m_field).compare(second.*m_field, Qt::CaseInsensitive) < 0;
+    }
+
+    QString ViewCheck::Issue::*         m_field;            /*!< Compared field. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Constructs an empty check.
+ **********************************************************************************************************************/
+ViewCheck::ViewCheck()
+{
+}
+
+/*!*********************************************************************************************************************
+ * \brief Collects the cells and views of the libraries.
+ * \param catalog       Catalog used to scan the libraries.
+ * \param libraries     Map of library names to library paths.
+ **********************************************************************************************************************/
+void ViewCheck::scanLibraries(const Catalog &catalog, const QMap<QString, QString> &libraries)
+{
+    TRACE_SCOPE("check", "scan_libraries");
+
+    m_cells.clear();
+
+    QMap<QString, QString>::const_iterator it;
+    for(it = libraries.constBegin(); it != libraries.constEnd(); ++it) {
+        QMap<QString, QStringList> cells = catalog.scanLibrary(it.value());
+
+        QMap<QString, QStringList>::const_iterator cit;
+        for(cit = cells.constBegin(); cit != cells.constEnd(); ++cit) {
+            Cell cell;
+            cell.library = it.key();
+            cell.name = cit.key();
+            cell.libPath = it.value();
+            cell.views = cit.value();
+
+            m_cells<<cell;
+        }
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns netlist views of the scanned cells, they have to be indexed before run() is called.
+ * \return              Rows of library, cell, view and view path in library and cell order.
+ **********************************************************************************************************************/
+QList<QStringList> ViewCheck::getNetlistViews() const
+{
+    QList<QStringList> views;
+
+    foreach(const Cell &cell, m_cells) {
+        foreach(const QString &viewName, cell.views) {
+            if(NetlistParser::isNetlistView(viewName)) {
+                views<<(QStringList()<<cell.library<<cell.name<<viewName
+                                     <<Catalog::getViewPath(cell.libPath, cell.name, viewName));
+            }
+        }
+    }
+
+    return views;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Checks all scanned cells having a layout or a netlist view in parallel.
+ * \param index         Index holding the netlist views of the cells.
+ * \param jobs          Maximal number of cells checked at a time, 0 to use number of CPU cores.
+ * \return              Number of findings.
+ **********************************************************************************************************************/
+int ViewCheck::run(const NetlistIndex &index, int jobs)
+{
+    TRACE_SCOPE("check", "view_check");
+
+    m_issues.clear();
+
+    QVector<QList<Issue> > results(m_cells.count());
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(jobs > 0 ? jobs : qMax(1, QThread::idealThreadCount()));
+
+    for(int i = 0; i < m_cells.count(); ++i) {
+        const Cell &cell = m_cells[i];
+
+        QString gdsPath;
+        QMap<QString, NetlistIndex::View> netlists;
+
+        foreach(const QString &viewName, cell.views) {
+            QString viewPath = Catalog::getViewPath(cell.libPath, cell.name, viewName);
+
+            if(viewName == "gds") {
+                gdsPath = viewPath;
+            }
+            else if(NetlistParser::isNetlistView(viewName)) {
+                netlists[viewName] = index.getView(viewPath);
+            }
+        }
+
+        if(gdsPath.isEmpty() && netlists.isEmpty()) {
+            continue;
+        }
+
+        pool.start(new ViewCheckJob(cell.library, cell.name, gdsPath, netlists, &results[i]));
+    }
+
+    pool.waitForDone();
+
+    foreach(const QList<Issue> &issues, results) {
+        m_issues<<issues;
+    }
+
+    return m_issues.count();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns number of findings with severity 'error'.
+ **********************************************************************************************************************/
+int ViewCheck::getErrorCount() const
+{
+    int count = 0;
+
+    foreach(const Issue &issue, m_issues) {
+        if(issue.severity == "error") {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns names of the report columns.
+ **********************************************************************************************************************/
+QStringList ViewCheck::getColumns()
+{
+    return QStringList()<<"library"<<"cell"<<"view"<<"severity"<<"check"<<"message";
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns the finding as a row of the report.
+ * \param issue         Finding of the check.
+ **********************************************************************************************************************/
+QStringList ViewCheck::toRow(const Issue &issue)
+{
+    return QStringList()<<issue.library<<issue.cell<<issue.view<<issue.severity<<issue.check<<issue.message;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Sorts findings by a report column. Findings with equal values keep their library and cell order.
+ * \param issues        Findings to sort.
+ * \param column        Name of the column.
+ * \return              False if the column is unknown.
+ **********************************************************************************************************************/
+bool ViewCheck::sortIssues(QList<Issue> *issues, const QString &column)
+{
+    // Fields in the order of the report columns.
+    static QString Issue::*const fields[] = {&Issue::library, &Issue::cell, &Issue::view, &Issue::severity,
+                                             &Issue::check, &Issue::message};
+
+    int index = getColumns().indexOf(column);
+    if(index < 0) {
+        return false;
+    }
+
+    std::stable_sort(issues->begin(), issues->end(), IssueLess(fields[index]));
+
+    return true;
+}
@@ -0,0 +1,79 @@
+#ifndef VIEWCHECK_H
+#define VIEWCHECK_H
+
+#include <QMap>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+class Catalog;
+class NetlistIndex;
+
+/*!*********************************************************************************************************************
+ * \brief The ViewCheck class compares layout and netlist views of library cells: a cell should have both a 'gds' and a
+ * netlist view, the top structure of the layout should be named like a top subcircuit of the netlist, and every label
+ * of that structure should be a port of the subcircuit. Netlist ports are taken from the NetlistIndex, layouts are
+ * scanned for structures and labels by a pool of jobs, one cell per job.
+ **********************************************************************************************************************/
+class ViewCheck
+{
+public:
+    /*!
+     * \brief The Issue struct is a single finding of the check.
+     */
+    struct Issue {
+        QString                         library;            /*!< Name of the library. */
+        QString                         cell;               /*!< Name of the cell. */
+        QString                         view;               /*!< Netlist view compared to the layout, if any. */
+        QString                         severity;           /*!< 'error' or 'warning'. */
+        QString                         check;              /*!< Name of the failed check. */
+        QString                         message;            /*!< Description of the finding. */
+    };
+
+    ViewCheck();
+
+    void                                scanLibraries(const Catalog &catalog, const QMap<QString, QString> &libraries);
+    QList<QStringList>                  getNetlistViews() const;
+
+    int                                 run(const NetlistIndex &index, int jobs = 0);
+
+    QList<Issue>                        getIssues() const;
+    int                                 getCellCount() const;
+    int                                 getErrorCount() const;
+
+    static QStringList                  getColumns();
+    static QStringList                  toRow(const Issue &issue);
+    static bool                         sortIssues(QList<Issue> *issues, const QString &column);
+
+private:
+    /*!
+     * \brief The Cell struct keeps the views of a cell to check.
+     */
+    struct Cell {
+        QString                         library;            /*!< Name of the library. */
+        QString                         name;               /*!< Name of the cell. */
+        QString                         libPath;            /*!< Path to the library. */
+        QStringList                     views;              /*!< Names of the cell views. */
+    };
+
+    QList<Cell>                         m_cells;            /*!< Cells in library and cell order. */
+    QList<Issue>                        m_issues;           /*!< Findings of the last run in cell order. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Returns findings of the last run in library and cell order.
+ **********************************************************************************************************************/
+inline QList<ViewCheck::Issue> ViewCheck::getIssues() const
+{
+    return m_issues;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns number of scanned cells.
+ **********************************************************************************************************************/
+inline int ViewCheck::getCellCount() const
+{
+    return m_cells.count();
+}
+
+#endif // VIEWCHECK_H
@@ -12,9 +12,236 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 
+#include "catalog.h"
 #include "property.h"
+#include "netlistindex.h"
+#include "libertyindex.h"
+#include "lefindex.h"
+#include "netlistdiff.h"
+#include "trace.h"
+#include "backgroundjob.h"
+#include "gds/gdsdiff.h"
 #include "gds/gdsreader.h"
 
+/*!*********************************************************************************************************************
+ * \brief The NetlistInfoJob class brings netlist views up to date in the netlist index and prints their subcircuits.
+ **********************************************************************************************************************/
+class NetlistInfoJob : public BackgroundJob
+{
+public:
+    NetlistInfoJob(MainWindow *window, const QStringList &viewPaths) : BackgroundJob(window), m_viewPaths(viewPaths) {}
+
+    void run();
+
+private:
+    QStringList                         m_viewPaths;        /*!< Paths to SPICE, CDL and Verilog views. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Parses the views if they have changed since they were indexed and formats their subcircuits.
+ **********************************************************************************************************************/
+void NetlistInfoJob::run()
+{
+    updateNetlistIndex(m_viewPaths);
+
+    foreach(const QString &viewPath, m_viewPaths) {
+        NetlistIndex::View view = getNetlistIndex().getView(viewPath);
+
+        m_info += "Netlist: " + viewPath + "\n";
+        foreach(const NetlistParser::Subckt &subckt, view.subckts) {
+            m_info += "\tSubcircuit: " + subckt.name + "\n";
+            m_info += "\t\tPorts: " + subckt.ports.join(" ") + "\n";
+
+            if(!subckt.pinInfo.isEmpty()) {
+                m_info += "\t\tPin Info: " + subckt.pinInfo.join(" ") + "\n";
+            }
+
+            if(!subckt.devices.isEmpty()) {
+                m_info += "\t\tDevices: " + NetlistParser::formatCounts(subckt.devices) + "\n";
+            }
+
+            if(!subckt.instances.isEmpty()) {
+                m_info += "\t\tInstances: " + NetlistParser::formatCounts(subckt.instances) + "\n";
+            }
+        }
+
+        if(!view.includes.isEmpty()) {
+            m_info += "\tIncludes: " + view.includes.join(", ") + "\n";
+        }
+
+        m_errorList<<view.errors;
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief The LibertyInfoJob class brings the index of a Liberty view up to date and prints the cell of the group.
+ **********************************************************************************************************************/
+class LibertyInfoJob : public BackgroundJob
+{
+public:
+    LibertyInfoJob(MainWindow *window, const QString &viewPath, const QString &groupName)
+        : BackgroundJob(window), m_viewPath(viewPath), m_groupName(groupName) {}
+
+    void run();
+
+private:
+    QString                             m_viewPath;         /*!< Path to the Liberty view. */
+    QString                             m_groupName;        /*!< Name of the group (cell). */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Scans the view if it has changed since it was indexed and formats the cell.
+ **********************************************************************************************************************/
+void LibertyInfoJob::run()
+{
+    LibertyIndex index;
+    bool isIndexed = index.update(m_viewPath);
+
+    m_errorList<<index.getErrors();
+
+    if(!isIndexed) {
+        return;
+    }
+
+    if(!index.contains(m_groupName)) {
+        m_errorList<<QString("Cell '%1' not found in '%2'.").arg(m_groupName).arg(m_viewPath);
+        return;
+    }
+
+    m_info = "Liberty: " + m_viewPath + "\n";
+    if(!index.getLibraryName().isEmpty()) {
+        m_info += "\tLibrary: " + index.getLibraryName() + "\n";
+    }
+
+    LibertyIndex::Cell cell = index.getCell(m_groupName);
+
+    m_info += "\tCell: " + cell.name + "\n";
+    m_info += "\t\tArea: " + cell.area + "\n";
+    m_info += "\t\tPins: " + LibertyIndex::formatPins(cell.pins) + "\n";
+    m_info += QString("\t\tBytes: %1-%2\n").arg(cell.offset).arg(cell.offset + cell.length);
+}
+
+/*!*********************************************************************************************************************
+ * \brief The LefInfoJob class scans the LEF view of a group, links its macros to the cells of the library and prints
+ * them.
+ **********************************************************************************************************************/
+class LefInfoJob : public BackgroundJob
+{
+public:
+    LefInfoJob(MainWindow *window, const QString &libName, const QString &libPath, const QString &groupName)
+        : BackgroundJob(window), m_libName(libName), m_libPath(libPath), m_groupName(groupName) {}
+
+    void run();
+
+private:
+    QString                             m_libName;          /*!< Name of the project (library). */
+    QString                             m_libPath;          /*!< Path to the project (library). */
+    QString                             m_groupName;        /*!< Name of the group (cell) holding the LEF view. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Scans the LEF view, brings the netlist views of the macros up to date in the netlist index and formats the
+ * macros.
+ **********************************************************************************************************************/
+void LefInfoJob::run()
+{
+    QMap<QString, QString> libraries;
+    libraries[m_libName] = m_libPath;
+
+    LefIndex lefIndex;
+    lefIndex.scanLibraries(getCatalog(), libraries, m_groupName);
+    lefIndex.update();
+
+    QStringList viewPaths;
+    foreach(const QStringList &view, lefIndex.getNetlistViews()) {
+        viewPaths<<view[3];
+    }
+
+    if(!viewPaths.isEmpty()) {
+        updateNetlistIndex(viewPaths);
+        lefIndex.link(getNetlistIndex());
+    }
+
+    m_info = "LEF: " + Catalog::getViewPath(m_libPath, m_groupName, "lef") + "\n";
+    foreach(const LefIndex::Entry &entry, lefIndex.getEntries()) {
+        m_info += "\tMacro: " + entry.macro.name + "\n";
+
+        if(!entry.macro.className.isEmpty()) {
+            m_info += "\t\tClass: " + entry.macro.className + "\n";
+        }
+
+        if(!entry.macro.width.isEmpty()) {
+            m_info += "\t\tSize: " + entry.macro.width + " x " + entry.macro.height + "\n";
+        }
+
+        m_info += "\t\tPins: " + LefScanner::formatPins(entry.macro.pins) + "\n";
+
+        if(!entry.macro.obsLayers.isEmpty()) {
+            m_info += "\t\tObstructions: " + entry.macro.obsLayers.join(" ") + "\n";
+        }
+
+        m_info += "\t\tViews: " + (entry.views.isEmpty() ? QString("no cell '%1'").arg(entry.macro.name)
+                                                           : entry.views.join(" ")) + "\n";
+
+        if(!entry.unmatchedPins.isEmpty()) {
+            m_info += "\t\tUnmatched Pins: " + entry.unmatchedPins.join(" ") + "\n";
+        }
+    }
+
+    m_errorList<<lefIndex.getErrors();
+}
+
+/*!*********************************************************************************************************************
+ * \brief The CompareViewJob class compares an older version of a layout or netlist view with the view and prints the
+ * changes.
+ **********************************************************************************************************************/
+class CompareViewJob : public BackgroundJob
+{
+public:
+    CompareViewJob(MainWindow *window, const QString &oldFile, const QString &viewPath, bool isLayout)
+        : BackgroundJob(window), m_oldFile(oldFile), m_viewPath(viewPath), m_isLayout(isLayout) {}
+
+    void run();
+
+private:
+    QString                             m_oldFile;          /*!< Path to the older version. */
+    QString                             m_viewPath;         /*!< Path to the view. */
+    bool                                m_isLayout;         /*!< True for a GDS view, otherwise a netlist view. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Compares the files and formats the changes.
+ **********************************************************************************************************************/
+void CompareViewJob::run()
+{
+    QList<QStringList> changes;
+    int identicalCount = 0;
+
+    if(m_isLayout) {
+        GdsDiff diff;
+        diff.diff(m_oldFile, m_viewPath);
+
+        changes = diff.getChanges();
+        m_errorList<<diff.getErrors();
+        identicalCount = diff.getIdenticalCount();
+    }
+    else {
+        NetlistDiff diff;
+        diff.diff(m_oldFile, m_viewPath);
+
+        changes = diff.getChanges();
+        m_errorList<<diff.getErrors();
+        identicalCount = diff.getIdenticalCount();
+    }
+
+    m_info = "Compare: " + m_oldFile + " -> " + m_viewPath + "\n";
+    foreach(const QStringList &change, changes) {
+        m_info += "\t" + change.join(" ").trimmed() + "\n";
+    }
+
+    m_info += QString("\t%1 changes, %2 identical cells skipped.\n").arg(changes.count()).arg(identicalCount);
+}
+
 /*!*********************************************************************************************************************
  * \brief Displays menu for view widget.
  * \param pos       Point(x, y) where menu will be displayed.
@@ -70,8 +297,23 @@ void MainWindow::showViewMenu(const QPoint &pos)
 
     QList<QListWidgetItem *> items = m_ui->listViews->selectedItems();
     if(items.count()) {
+        // Open and delete take all selected views of all selected cells, the other actions a single view of one cell.
+        bool isSingle = items.count() == 1 && m_ui->listGroups->selectedItems().count() == 1;
+
+        QAction *openViews = new QAction(tr("&Open"), this);
+        openViews->setStatusTip(tr("Open selected views of all selected cells."));
+        connect(openViews, SIGNAL(triggered()), this, SLOT(openSelectedViews()));
+        menu->addAction(openViews);
+
+        QAction *previewView = new QAction(tr("Pre&view"), this);
+        previewView->setStatusTip(tr("Show view read-only in the preview panel."));
+        previewView->setEnabled(isSingle);
+        connect(previewView, SIGNAL(triggered()), this, SLOT(previewSelectedView()));
+        menu->addAction(previewView);
+
         QAction *copyView = new QAction(tr("&Copy"), this);
         copyView->setStatusTip(tr("Copy view."));
+        copyView->setEnabled(isSingle);
         connect(copyView, SIGNAL(triggered()), this, SLOT(copySelectedView()));
         menu->addAction(copyView);
 
@@ -82,8 +324,18 @@ void MainWindow::showViewMenu(const QPoint &pos)
 
         QAction *viewInfo = new QAction(tr("&Info"), this);
         viewInfo->setStatusTip(tr("Detele view."));
+        viewInfo->setEnabled(isSingle);
         connect(viewInfo, SIGNAL(triggered()), this, SLOT(showViewInfo()));
         menu->addAction(viewInfo);
+
+        QString viewName = getCurrentViewName();
+        if(viewName == "gds" || viewName == "cdl" || viewName == "spice") {
+            QAction *compare = new QAction(tr("C&ompare..."), this);
+            compare->setStatusTip(tr("Compare view with another version."));
+            compare->setEnabled(isSingle);
+            connect(compare, SIGNAL(triggered()), this, SLOT(compareView()));
+            menu->addAction(compare);
+        }
     }
 
     menu->popup(QCursor::pos());
@@ -122,6 +374,7 @@ void MainWindow::addNewSpiceView()
         QListWidgetItem *viewId = new QListWidgetItem;
         viewId->setText("spice");
         m_ui->listViews->addItem(viewId);
+        m_cellFilter->clear();
     }
 
     m_ui->listViews->sortItems();
@@ -173,6 +426,7 @@ void MainWindow::addNewLayoutView()
         QListWidgetItem *viewId = new QListWidgetItem;
         viewId->setText("gds");
         m_ui->listViews->addItem(viewId);
+        m_cellFilter->clear();
     }
 
     m_ui->listViews->sortItems();
@@ -208,6 +462,7 @@ void MainWindow::addNewSchematicView()
         QListWidgetItem *viewId = new QListWidgetItem;
         viewId->setText("cdl");
         m_ui->listViews->addItem(viewId);
+        m_cellFilter->clear();
     }
 
     m_ui->listViews->sortItems();
@@ -223,6 +478,11 @@ void MainWindow::copySelectedView()
         return;
     }
 
+    // Paste takes a single view, so nothing is copied if several views or cells are selected.
+    if(m_ui->listViews->selectedItems().count() != 1 || m_ui->listGroups->selectedItems().count() != 1) {
+        return;
+    }
+
     QString groupName = getCurrentGroupName();
     if(groupName.isEmpty()) {
         return;
@@ -253,17 +513,19 @@ void MainWindow::addViewToBeCopied(const QString &viewPath)
 }
 
 /*!*********************************************************************************************************************
- * \brief Removes selected view.
+ * \brief Removes the selected views of all selected groups (cells).
  **********************************************************************************************************************/
 void MainWindow::removeSelectedView()
 {
+    TRACE_SCOPE("file", "remove_view");
+
     QString libPath = getCurrentLibraryPath();
     if(!QFileInfo(libPath).exists()) {
         return;
     }
 
-    QString groupName = getCurrentGroupName();
-    if(groupName.isEmpty()) {
+    QStringList groupNames = getSelectedGroupNames();
+    if(groupNames.isEmpty()) {
         return;
     }
 
@@ -280,14 +542,17 @@ void MainWindow::removeSelectedView()
             QListWidgetItem *item = m_ui->listViews->item(j);
             if(refText == item->text()) {
                 if(deleteFiles) {
-                    QString viewPath = getViewPath(libPath, groupName, refText);
-                    if(QFileInfo(viewPath).exists()) {
-                        info(QString("Removing view '%1'").arg(viewPath));
-                        QFile::remove(viewPath);
+                    foreach(const QString &groupName, groupNames) {
+                        QString viewPath = getViewPath(libPath, groupName, refText);
+                        if(QFileInfo(viewPath).exists()) {
+                            info(QString("Removing view '%1'").arg(viewPath), false);
+                            QFile::remove(viewPath);
+                        }
                     }
                 }
 
                 m_ui->listViews->takeItem(j);
+                m_cellFilter->clear();
                 break;
             }
         }
@@ -319,5 +584,118 @@ void MainWindow::showViewInfo()
     QString viewPath = getViewPath(libPath, groupName, viewName);
 
     showFolderInfo("View", viewName, viewPath);
+
+    if(NetlistParser::isNetlistView(viewName)) {
+        showNetlistInfo(libPath, groupName, QStringList()<<viewName);
+    }
+    else if(viewName == "liberty") {
+        showLibertyInfo(viewPath, groupName);
+    }
+    else if(viewName == "lef") {
+        showLefInfo(libPath, groupName);
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Compares the view with another version of it chosen by the user and prints the changed subcircuits or
+ * structures into the MainWindow output window. The view is the new version; the files are compared in the
+ * background.
+ **********************************************************************************************************************/
+void MainWindow::compareView()
+{
+    QString viewName = getCurrentViewName();
+    QString groupName = getCurrentGroupName();
+    QString libPath = getCurrentLibraryPath();
+    if(viewName.isEmpty() || groupName.isEmpty() || !QFileInfo(libPath).isDir()) {
+        return;
+    }
+
+    QString viewPath = getViewPath(libPath, groupName, viewName);
+
+    QString oldFile = QFileDialog::getOpenFileName(this, tr("Compare with"), QFileInfo(viewPath).absolutePath(),
+                                                   tr("All files (*)"));
+    if(oldFile.isEmpty()) {
+        return;
+    }
+
+    m_backgroundQueue->start(new CompareViewJob(this, oldFile, viewPath, viewName == "gds"));
+}
+
+/*!*********************************************************************************************************************
+ * \brief Prints macros of the LEF view into the MainWindow output window together with the views of the library cell
+ * named like each macro and the pins which do not match the ports of its netlist views. The library is scanned and the
+ * netlist views are indexed in the background.
+ * \param libPath     Path to the project (library).
+ * \param groupName   Name of the group (cell) holding the LEF view.
+ **********************************************************************************************************************/
+void MainWindow::showLefInfo(const QString &libPath, const QString &groupName)
+{
+    m_backgroundQueue->start(new LefInfoJob(this, getCurrentLibraryName(), libPath, groupName));
+}
+
+/*!*********************************************************************************************************************
+ * \brief Prints area, pins and position of the Liberty cell of the group into the MainWindow output window. The file
+ * is scanned in the background and only if it has changed since it was indexed.
+ * \param viewPath    Path to the Liberty view.
+ * \param groupName   Name of the group (cell).
+ **********************************************************************************************************************/
+void MainWindow::showLibertyInfo(const QString &viewPath, const QString &groupName)
+{
+    m_backgroundQueue->start(new LibertyInfoJob(this, viewPath, groupName));
 }
 
+/*!*********************************************************************************************************************
+ * \brief Prints subcircuits, ports and devices of netlist views into the MainWindow output window. Views are taken
+ * from the netlist index and parsed only if they have changed since they were indexed, in the background.
+ * \param libPath     Path to the project (library).
+ * \param groupName   Name of the group (cell).
+ * \param views       Names of the views, views other than SPICE, CDL and Verilog are skipped.
+ **********************************************************************************************************************/
+void MainWindow::showNetlistInfo(const QString &libPath, const QString &groupName, const QStringList &views)
+{
+    QStringList viewPaths;
+    foreach(const QString &viewName, views) {
+        if(NetlistParser::isNetlistView(viewName)) {
+            viewPaths<<Catalog::getViewPath(libPath, groupName, viewName);
+        }
+    }
+
+    if(viewPaths.isEmpty()) {
+        return;
+    }
+
+    m_backgroundQueue->start(new NetlistInfoJob(this, viewPaths));
+}
+
+/*!*********************************************************************************************************************
+ * \brief Opens the selected views of all selected groups (cells).
+ **********************************************************************************************************************/
+void MainWindow::openSelectedViews()
+{
+    QStringList viewNames;
+    foreach(QListWidgetItem *item, m_ui->listViews->selectedItems()) {
+        viewNames<<item->text();
+    }
+
+    openViews(viewNames);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Shows the current view of the current group (cell) in the preview panel, whatever its size.
+ **********************************************************************************************************************/
+void MainWindow::previewSelectedView()
+{
+    QString viewName = getCurrentViewName();
+    QString groupName = getCurrentGroupName();
+    if(viewName.isEmpty() || groupName.isEmpty()) {
+        return;
+    }
+
+    QString viewPath = getViewPath(getCurrentLibraryPath(), groupName, viewName);
+    if(!QFileInfo(viewPath).isFile()) {
+        error(QString("Failed to find view '%1'\n").arg(viewPath));
+        return;
+    }
+
+    previewFile(viewPath);
+}
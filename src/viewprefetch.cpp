@@ -0,0 +1,174 @@
+#include <QtGlobal>
+
+#if defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+
+#include <QFile>
+#include <QRunnable>
+#include <QByteArray>
+
+#include "perfcounters.h"
+#include "viewprefetch.h"
+#include "trace.h"
+
+/*!*********************************************************************************************************************
+ * \brief Size of the chunks files are prefetched in. A cancelled request stops after the current chunk.
+ **********************************************************************************************************************/
+static const qint64 PREFETCH_CHUNK_SIZE = 4 * 1024 * 1024;
+
+/*!*********************************************************************************************************************
+ * \brief Default memory budget of a request in MB, overridden by the LIBMAN_PREFETCH_MB environment variable.
+ **********************************************************************************************************************/
+static const qint64 PREFETCH_DEFAULT_MB = 256;
+
+/*!*********************************************************************************************************************
+ * \brief The PrefetchJob class prefetches the files of a single request until they are done, the budget is used up or
+ * a newer request has been made.
+ **********************************************************************************************************************/
+class PrefetchJob : public QRunnable
+{
+public:
+    PrefetchJob(const QStringList &paths, qint64 budget, QAtomicInt *generation)
+        : m_paths(paths), m_budget(budget), m_generation(generation),
+          m_id(generation->fetchAndAddOrdered(0)) {}
+
+    void run();
+
+private:
+    bool                                isCancelled() const;
+    qint64                              prefetchFile(const QString &path, qint64 budget) const;
+
+private:
+    QStringList                         m_paths;            /*!< Files in the order they are prefetched. */
+    qint64                              m_budget;           /*!< Maximum bytes to prefetch. */
+    QAtomicInt                          *m_generation;      /*!< Latest request number, owned by ViewPrefetch. */
+    int                                 m_id;               /*!< Request number of this job. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Prefetches the files one after another within the budget.
+ **********************************************************************************************************************/
+void PrefetchJob::run()
+{
+    if(isCancelled()) {
+        return;
+    }
+
+    TRACE_SCOPE_ARG("prefetch", "prefetch_views", m_paths.join(" "));
+
+    qint64 budget = m_budget;
+
+#if defined(Q_OS_LINUX)
+    // Never push out more than half of the free memory, the tool needs the rest.
+    qint64 available = qint64(sysconf(_SC_AVPHYS_PAGES)) * sysconf(_SC_PAGESIZE);
+    if(available > 0) {
+        budget = qMin(budget, available / 2);
+    }
+#endif
+
+    foreach(const QString &path, m_paths) {
+        if(budget <= 0 || isCancelled()) {
+            break;
+        }
+
+        budget -= prefetchFile(path, budget);
+    }
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns true if a newer request has been made or the prefetch has been cancelled.
+ **********************************************************************************************************************/
+bool PrefetchJob::isCancelled() const
+{
+    return m_generation->fetchAndAddOrdered(0) != m_id;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Prefetches the beginning of the file up to the budget, chunk by chunk. Chunks are read, not only advised as
+ * by readahead() or posix_fadvise(), which return before the data is cached; so the job never has more than one chunk
+ * in flight and stops soon after a cancel. Missing or unreadable files are skipped, the tool reports them when it
+ * opens the view.
+ * \param path          Path to the file.
+ * \param budget        Maximum bytes to prefetch.
+ * \return              Number of bytes prefetched.
+ **********************************************************************************************************************/
+qint64 PrefetchJob::prefetchFile(const QString &path, qint64 budget) const
+{
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+
+    qint64 size = qMin(file.size(), budget);
+    qint64 offset = 0;
+
+    QByteArray buffer(int(qMin(PREFETCH_CHUNK_SIZE, size)), 0);
+
+    while(offset < size && !isCancelled()) {
+        qint64 length = qMin(PREFETCH_CHUNK_SIZE, size - offset);
+
+        if(file.read(buffer.data(), length) != length) {
+            break;
+        }
+
+        offset += length;
+    }
+
+    PerfCounters::add(PerfCounters::BYTES_PREFETCHED, offset);
+
+    return offset;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Constructs ViewPrefetch object with the default budget.
+ **********************************************************************************************************************/
+ViewPrefetch::ViewPrefetch()
+    : m_generation(0),
+      m_budget(getDefaultBudget())
+{
+    m_pool.setMaxThreadCount(1);
+}
+
+/*!*********************************************************************************************************************
+ * \brief Cancels the running request and waits for its current chunk.
+ **********************************************************************************************************************/
+ViewPrefetch::~ViewPrefetch()
+{
+    cancel();
+    m_pool.waitForDone();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Cancels the running request and prefetches the files in the given order in the background.
+ * \param paths         Files to prefetch, the most wanted first.
+ **********************************************************************************************************************/
+void ViewPrefetch::prefetch(const QStringList &paths)
+{
+    cancel();
+
+    if(m_budget <= 0 || paths.isEmpty()) {
+        return;
+    }
+
+    m_pool.start(new PrefetchJob(paths, m_budget, &m_generation));
+}
+
+/*!*********************************************************************************************************************
+ * \brief Cancels the running request, queued requests are dropped before they start.
+ **********************************************************************************************************************/
+void ViewPrefetch::cancel()
+{
+    m_generation.ref();
+}
+
+/*!*********************************************************************************************************************
+ * \brief Returns the budget per request set by the LIBMAN_PREFETCH_MB environment variable, 256 MB by default.
+ **********************************************************************************************************************/
+qint64 ViewPrefetch::getDefaultBudget()
+{
+    bool isNumber = false;
+    qint64 megabytes = QString::fromLocal8Bit(qgetenv("LIBMAN_PREFETCH_MB")).toLongLong(&isNumber);
+
+    return (isNumber && megabytes >= 0 ? megabytes : PREFETCH_DEFAULT_MB) * 1024 * 1024;
+}
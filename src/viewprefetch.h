@@ -0,0 +1,52 @@
+#ifndef VIEWPREFETCH_H
+#define VIEWPREFETCH_H
+
+#include <QAtomicInt>
+#include <QStringList>
+#include <QThreadPool>
+
+/*!*********************************************************************************************************************
+ * \brief The ViewPrefetch class warms the page cache with view files in a background thread, so a tool opening them
+ * does not wait for cold reads, which dominate on NFS. Files are read chunk by chunk into a buffer, so each chunk is
+ * complete before the next one starts. At most the memory budget is prefetched per request and only one request runs
+ * at a time, so quick clicks never queue more than one chunk of reads: a new request or cancel() stops the running
+ * one after its current chunk.
+ **********************************************************************************************************************/
+class ViewPrefetch
+{
+public:
+    ViewPrefetch();
+    ~ViewPrefetch();
+
+    void                                prefetch(const QStringList &paths);
+    void                                cancel();
+
+    qint64                              getBudget() const;
+    void                                setBudget(qint64 bytes);
+
+    static qint64                       getDefaultBudget();
+
+private:
+    QThreadPool                         m_pool;             /*!< Single thread running the prefetch jobs. */
+    QAtomicInt                          m_generation;       /*!< Number of the latest request, older jobs stop. */
+    qint64                              m_budget;           /*!< Maximum bytes prefetched per request, 0 disables. */
+};
+
+/*!*********************************************************************************************************************
+ * \brief Returns maximum number of bytes prefetched per request.
+ **********************************************************************************************************************/
+inline qint64 ViewPrefetch::getBudget() const
+{
+    return m_budget;
+}
+
+/*!*********************************************************************************************************************
+ * \brief Sets maximum number of bytes prefetched per request, 0 disables prefetching.
+ * \param bytes         Budget in bytes.
+ **********************************************************************************************************************/
+inline void ViewPrefetch::setBudget(qint64 bytes)
+{
+    m_budget = bytes;
+}
+
+#endif // VIEWPREFETCH_H